@@ -10,11 +10,14 @@
 #include "client/Client.h"
 
 #include "cabl/devices/DeviceFactory.h"
+#include "cabl/devices/DisplayMirror.h"
+#include "cabl/devices/PageCache.h"
 
 #include "cabl/gfx/Canvas.h"
 #include "cabl/gfx/LedArray.h"
 #include "cabl/gfx/LedMatrix.h"
 #include "cabl/gfx/TextDisplay.h"
+#include "cabl/gfx/TextLayout.h"
 
 #include "cabl/util/Version.h"
 
@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include <future>
+#include <mutex>
+
 #include "cabl/comm/DiscoveryPolicy.h"
 #include "cabl/devices/Coordinator.h"
 
@@ -25,7 +28,14 @@ public:
   Client(DiscoveryPolicy = {});
   ~Client();
   
-  void init();
+  //! Connects the first matching device
+  /*!
+     In PumpMode::Thread the device is brought up on a thread of its own. By default init() waits
+     for it, so that device() can be used as soon as init() returns; pass false to return straight
+     away and get the device in initDevice() once it is connected.
+     \param waitForDevice_ Whether to return only once the device has been connected
+  */
+  void init(bool waitForDevice_ = true);
 
   virtual void disconnected();
   virtual void buttonChanged(Device::Button button_, bool buttonState_, bool shiftPressed_);
@@ -41,7 +51,7 @@ public:
 protected:
   Coordinator::tDevicePtr device()
   {
-    return m_pDevice;
+    return std::atomic_load(&m_pDevice);
   }
   void requestDeviceUpdate()
   {
@@ -49,10 +59,11 @@ protected:
   }
 
 private:
-  void onInitDevice();
+  void onInitDevice(Coordinator::tDevicePtr pDevice_);
   void onRender();
 
   void devicesListChanged(Coordinator::tCollDeviceDescriptor devices_);
+  void connectPending();
 
   uint8_t encoderValue(bool valueIncreased_,
     unsigned step_,
@@ -61,7 +72,12 @@ private:
 	unsigned maxValue_);
 
   std::string m_clientId;
-  Coordinator::tDevicePtr m_pDevice;
+  Coordinator::tDevicePtr m_pDevice; //!< Published once its callbacks are installed
+
+  std::mutex m_mtxConnecting;
+  std::future<void> m_connecting;
+  bool m_connectPending{false};
+  Coordinator::tCollDeviceDescriptor m_pendingDeviceDescriptors; //!< The latest list, if pending
   DiscoveryPolicy m_discoveryPolicy;
 
   std::atomic<bool> m_update{true};
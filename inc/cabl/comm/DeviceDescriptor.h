@@ -88,6 +88,25 @@ public:
     m_local = local_;
   }
 
+  //! The USB bus the device is connected to, zero if unknown
+  unsigned busNumber() const
+  {
+    return m_busNumber;
+  }
+
+  //! The port of the device on its hub, zero if unknown
+  unsigned portNumber() const
+  {
+    return m_portNumber;
+  }
+
+  //! Set where the device is connected, which is not part of its identity
+  void setUsbLocation(unsigned busNumber_, unsigned portNumber_)
+  {
+    m_busNumber = busNumber_;
+    m_portNumber = portNumber_;
+  }
+
   bool operator==(const DeviceDescriptor& other_) const
   {
     return (m_name == other_.m_name) && (m_type == other_.m_type)
@@ -161,6 +180,8 @@ private:
   unsigned m_portIdIn;
   unsigned m_portIdOut;
   bool m_local{false};
+  unsigned m_busNumber{0};
+  unsigned m_portNumber{0};
 };
 
 //--------------------------------------------------------------------------------------------------
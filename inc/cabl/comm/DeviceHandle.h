@@ -9,7 +9,9 @@
 
 #include <cstdint>
 #include <functional>
+#include <vector>
 
+#include "cabl/comm/Transfer.h"
 #include "cabl/util/Types.h"
 
 namespace sl
@@ -19,7 +21,6 @@ namespace cabl
 
 //--------------------------------------------------------------------------------------------------
 
-class Transfer;
 class DeviceHandleImpl;
 
 //--------------------------------------------------------------------------------------------------
@@ -29,6 +30,7 @@ class DeviceHandle
 
 public:
   using tCbRead = std::function<void(Transfer)>;
+  using tCollTransfers = std::vector<Transfer>;
 
   explicit DeviceHandle(tPtr<DeviceHandleImpl>);
   ~DeviceHandle();
@@ -38,8 +40,33 @@ public:
   bool read(Transfer&, uint8_t);
   bool write(const Transfer&, uint8_t);
 
+  //! Append every message currently available on the endpoint to the collection
+  /*!
+     \param transfers_  The collection the received messages are appended to
+     \param endpoint_   The endpoint to read from
+     \return            true if at least one message has been received
+  */
+  bool readBatch(tCollTransfers& transfers_, uint8_t endpoint_);
+
+  //! Send a collection of messages using as few driver calls as possible
+  /*!
+     \param transfers_  The messages to be sent, in order
+     \param endpoint_   The endpoint to write to
+     \return            true if all messages have been sent
+  */
+  bool writeBatch(const tCollTransfers& transfers_, uint8_t endpoint_);
+
   void readAsync(uint8_t, tCbRead);
 
+  //! Collect the pending asynchronous reads when the driver runs without its own thread
+  /*!
+     The caller hands them to its read callback, possibly after releasing the locks it holds while
+     polling, so the callback can write to the device
+     \param transfers_  The collection the received messages are appended to
+     \return            true if at least one message has been received
+  */
+  bool poll(tCollTransfers& transfers_);
+
 private:
   tPtr<DeviceHandleImpl> m_pImpl;
 };
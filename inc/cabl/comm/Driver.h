@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <string>
 
@@ -48,17 +49,30 @@ public:
     SAM3X8E,
     MAX3421E,
     MIDI,
+    ALSA,
   };
 
   using tCollDeviceDescriptor = std::vector<DeviceDescriptor>;
   using tCbHotplug = std::function<void(const DeviceDescriptor&, bool)>;
 
-  explicit Driver(Type type_);
+  //! Constructor
+  /*!
+     \param type_        The driver type
+     \param manualPump_  If true, the driver doesn't start any thread of its own and its events
+                         are only processed when poll() is called
+  */
+  explicit Driver(Type type_, bool manualPump_ = false);
 
   tCollDeviceDescriptor enumerate();
   tPtr<DeviceHandle> connect(const DeviceDescriptor&);
   void setHotplugCallback(tCbHotplug);
 
+  //! Process pending driver events (transfer completions, hotplug notifications)
+  /*!
+     \param timeout_  Maximum time to wait for an event, zero to return immediately
+  */
+  void poll(std::chrono::microseconds timeout_);
+
 private:
   tPtr<DriverImpl> m_pImpl;
 };
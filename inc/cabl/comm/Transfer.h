@@ -8,7 +8,9 @@
 #pragma once
 
 #include "cabl/util/Types.h"
+#include <array>
 #include <cstdint>
+#include <initializer_list>
 
 #ifdef CABL_USE_NETWORK
 #include <cereal/cereal.hpp>
@@ -22,46 +24,140 @@ namespace cabl
 
 //--------------------------------------------------------------------------------------------------
 
+/**
+  \class Transfer
+  \brief A message exchanged with a device
+
+  Payloads of up to kInlineCapacity bytes (MIDI messages, LED reports...) are stored in the transfer
+  itself, so that building and sending them doesn't allocate. Larger ones (display frames) are
+  stored on the heap, or borrowed from the caller with Transfer::borrow().
+  The inline buffer fits the largest LED report (89 bytes, the Maschine Jam touch strips) and is
+  kept no larger, as every transfer of a collection carries it.
+*/
+
 class Transfer final
 {
 
 public:
+  static constexpr size_t kInlineCapacity = 96;
+
+  //! A read-only view of the payload, which stays valid until the transfer is modified
+  class View
+  {
+  public:
+    View(const uint8_t* pData_, size_t size_) : m_pData(pData_), m_size(size_)
+    {
+    }
+
+    View(const tRawData& data_) : m_pData(data_.data()), m_size(data_.size())
+    {
+    }
+
+    const uint8_t* data() const noexcept
+    {
+      return m_pData;
+    }
+
+    size_t size() const noexcept
+    {
+      return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+      return m_size == 0;
+    }
+
+    const uint8_t* begin() const noexcept
+    {
+      return m_pData;
+    }
+
+    const uint8_t* end() const noexcept
+    {
+      return m_pData + m_size;
+    }
+
+    const uint8_t& operator[](size_t i) const
+    {
+      return m_pData[i];
+    }
+
+    operator tRawData() const
+    {
+      return tRawData(begin(), end());
+    }
+
+    friend bool operator==(const View& lhs_, const View& rhs_);
+    friend bool operator!=(const View& lhs_, const View& rhs_)
+    {
+      return !(lhs_ == rhs_);
+    }
+
+  private:
+    const uint8_t* m_pData;
+    size_t m_size;
+  };
+
   Transfer() = default;
   explicit Transfer(unsigned length_);
 
+  Transfer(std::initializer_list<uint8_t> data_);
   Transfer(tRawData data_);
+  Transfer(const uint8_t* pData_, size_t length_);
   Transfer(const tRawData& header_, const tRawData& data_);
   Transfer(const tRawData& header_, const uint8_t* pData_, size_t dataLength_);
+  Transfer(std::initializer_list<uint8_t> header_, const uint8_t* pData_, size_t dataLength_);
+
+  Transfer(const Transfer& other_);
+  Transfer(Transfer&& other_) noexcept;
+  Transfer& operator=(const Transfer& other_);
+  Transfer& operator=(Transfer&& other_) noexcept;
+
+  //! A transfer referencing the caller's data rather than copying it
+  /*!
+     The data must stay valid and unchanged for as long as the transfer is in use, which is the
+     case for the display buffers written synchronously by the device tick(). Writing to the
+     transfer through operator[] copies the data first, and so does copying the transfer (moving
+     it doesn't).
+  */
+  static Transfer borrow(const uint8_t* pData_, size_t length_);
 
   bool operator==(const Transfer& other_) const;
   bool operator!=(const Transfer& other_) const;
 
   operator bool() const
   {
-    return (m_data.size() > 0);
+    return (m_size > 0);
   }
 
   inline uint8_t& operator[](int i)
   {
-    return m_data[i];
+    return writableData()[i];
   }
 
   inline const uint8_t& operator[](int i) const
   {
-    return m_data[i];
+    return bytes()[i];
   }
 
   void reset();
 
-  const tRawData& data() const
+  View data() const
   {
-    return m_data;
+    return View(bytes(), m_size);
   }
   void setData(const uint8_t*, size_t);
 
   size_t size() const noexcept
   {
-    return m_data.size();
+    return m_size;
+  }
+
+  //! \return TRUE if the payload is stored in the transfer itself
+  bool isInline() const noexcept
+  {
+    return m_storage == Storage::Inline;
   }
 
 private:
@@ -69,13 +165,42 @@ private:
   friend class cereal::access;
 #endif
 
+  enum class Storage : uint8_t
+  {
+    Inline,
+    Heap,
+    Borrowed,
+  };
+
+  template <class Archive>
+  void save(Archive& archive) const
+  {
+    archive(static_cast<tRawData>(data()));
+  }
+
   template <class Archive>
-  void serialize(Archive& archive)
+  void load(Archive& archive)
   {
-    archive(m_data);
+    tRawData data;
+    archive(data);
+    *this = Transfer(std::move(data));
   }
 
-  tRawData m_data;
+  const uint8_t* bytes() const noexcept
+  {
+    return m_storage == Storage::Inline
+             ? m_inline.data()
+             : (m_storage == Storage::Heap ? m_heap.data() : m_pBorrowed);
+  }
+
+  uint8_t* writableData();
+  uint8_t* allocate(size_t length_);
+
+  Storage m_storage{Storage::Inline};
+  size_t m_size{0};
+  const uint8_t* m_pBorrowed{nullptr};
+  tRawData m_heap; //!< Keeps its capacity when the transfer goes back to inline storage
+  std::array<uint8_t, kInlineCapacity> m_inline;
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,147 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+//! The kinds of traffic exchanged with a device, from the highest to the lowest priority
+enum class Traffic : uint8_t
+{
+  Input,   //!< Input reports and MIDI messages read from the device
+  Leds,    //!< LED updates and other short messages written to the device
+  Display, //!< Display frames
+  Count,
+};
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class TrafficMeter
+  \brief Counts the bytes exchanged with a device and paces its display frames
+
+  The display allowance is a token bucket: every display byte written consumes a token, and
+  displayFrameDue() defers the next frame while the bucket is empty. The frame is then sent on a
+  later tick with the latest content, so the display frame rate drops to what the allowance
+  affords. Counting is real-time safe and can be done from any thread, the display pacing must
+  be done from the I/O thread.
+*/
+
+class TrafficMeter
+{
+public:
+  using tClock = std::chrono::steady_clock;
+
+  //! The largest burst of display traffic, as the time it takes to earn it at the allowance rate
+  static constexpr std::chrono::milliseconds kMaxBurst{50};
+
+  struct Rates
+  {
+    double input;   //!< Bytes per second
+    double leds;    //!< Bytes per second
+    double display; //!< Bytes per second
+    bool displayDeferred; //!< TRUE if some display frames have been deferred
+  };
+
+  void add(Traffic traffic_, size_t bytes_) noexcept;
+
+  //! Total number of bytes of the given kind
+  uint64_t bytes(Traffic traffic_) const noexcept
+  {
+    return m_bytes[static_cast<size_t>(traffic_)];
+  }
+
+  //! The traffic rates since the previous call
+  Rates sample(tClock::time_point now_ = tClock::now());
+
+  //! Set the display bytes per second, zero doesn't limit the display traffic
+  void setDisplayAllowance(double bytesPerSecond_);
+
+  double displayAllowance() const
+  {
+    return m_displayAllowance;
+  }
+
+  //! \return TRUE if a display frame can be sent now, FALSE if it has to be deferred
+  bool displayFrameDue(tClock::time_point now_ = tClock::now());
+
+private:
+  using tCounters = std::array<std::atomic<uint64_t>, static_cast<size_t>(Traffic::Count)>;
+
+  tCounters m_bytes{};
+  std::array<uint64_t, static_cast<size_t>(Traffic::Count)> m_sampledBytes{};
+  tClock::time_point m_lastSample{tClock::now()};
+
+  std::atomic<double> m_displayAllowance{0.0};
+  std::atomic<bool> m_displayDeferred{false};
+  std::atomic<double> m_displayCredit{0.0}; //!< Spent by add() from any thread
+  tClock::time_point m_lastRefill{tClock::now()};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class BandwidthBudget
+  \brief Shares the bandwidth of a USB bus among the devices connected to it
+
+  Input traffic is served first, then LED updates, and displays share what is left: when the
+  displays of the devices on a bus want more than that, each one gets the same allowance (those
+  needing less than their share leave the rest to the others). Devices whose bus is unknown (e.g.
+  MIDI ports) are measured but never throttled.
+*/
+
+class BandwidthBudget
+{
+public:
+  //! Practical bulk throughput of a high-speed (USB 2.0) bus, in bytes per second
+  static constexpr double kDefaultBusCapacity = 32.0 * 1024 * 1024;
+
+  //! The share of a bus always left to the displays, even if input and LEDs use up the rest
+  static constexpr double kMinDisplayShare = 0.1;
+
+  //! How often the Coordinator measures the traffic and updates the allowances
+  static constexpr std::chrono::milliseconds kUpdateInterval{100};
+
+  struct Demand
+  {
+    unsigned bus; //!< Zero if unknown
+    TrafficMeter::Rates rates;
+  };
+
+  //! Compute the display allowance of each device
+  /*!
+     \param demands_  The traffic measured on each device
+     \return          The display allowances in bytes per second, in the same order as the
+                      demands, zero if the display traffic of a device is not limited
+  */
+  std::vector<double> allocate(const std::vector<Demand>& demands_) const;
+
+  //! Set the capacity of a bus, in bytes per second
+  void setBusCapacity(unsigned bus_, double bytesPerSecond_);
+
+  double busCapacity(unsigned bus_) const;
+
+private:
+  std::map<unsigned, double> m_busCapacities;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
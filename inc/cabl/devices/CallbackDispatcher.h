@@ -0,0 +1,168 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "cabl/util/SpscQueue.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class CallbackDispatcher
+  \brief Times the client callbacks of a device and moves them off the I/O thread if they are slow
+
+  Callbacks run on the I/O thread by default, so one which blocks (a slow render or a UI handler
+  waiting on a lock) stalls every connected device. Each invocation is timed: the ones taking
+  longer than budget() are logged and counted.
+  If offloading is enabled, a device whose callbacks of a given kind (e.g. its render callback)
+  overrun the budget several times in a row gets a dispatch thread of its own: from then on its
+  callbacks are queued and invoked on that thread, while the I/O thread skips the device whenever
+  its callbacks are running. A slow client then only delays the updates of its own device.
+*/
+
+class CallbackDispatcher
+{
+public:
+  struct Event
+  {
+    enum class Type : uint8_t
+    {
+      Render,
+      Disconnect,
+      Button,
+      Encoder,
+      Key,
+      Control,
+      Count,
+    };
+
+    Type type;
+    unsigned index;
+    double value;
+    bool state;
+    bool shift;
+  };
+
+  using tHandler = std::function<void(const Event&)>;
+
+  static constexpr std::chrono::microseconds kDefaultBudget{10000};
+
+  //! Maximum number of callbacks waiting on the dispatch thread, the next ones are dropped
+  static constexpr size_t kQueueSize = 256;
+
+  //! Constructor
+  /*!
+     \param handler_  Invokes the client callback matching an event
+  */
+  explicit CallbackDispatcher(tHandler handler_);
+  ~CallbackDispatcher();
+
+  CallbackDispatcher(const CallbackDispatcher&) = delete;
+  CallbackDispatcher& operator=(const CallbackDispatcher&) = delete;
+
+  //! Invoke the callback for an event, or queue it if the callbacks have been offloaded
+  /*!
+     While offloaded, renders are coalesced: a render is only queued once the previous one has
+     returned. Disconnect callbacks are always invoked on the calling thread, once the callbacks
+     running on the dispatch thread (if any) have returned.
+  */
+  void dispatch(const Event& event_);
+
+  //! Stop invoking callbacks, once the ones running on the dispatch thread have returned
+  /*!
+     The events dispatched from then on are dropped. Called before the state the callbacks use is
+     destroyed.
+  */
+  void stop();
+
+  //! Set the time a callback may take, zero disables the watchdog
+  void setBudget(std::chrono::microseconds budget_);
+
+  std::chrono::microseconds budget() const
+  {
+    return std::chrono::microseconds(m_budget.load());
+  }
+
+  //! Offload the callbacks after the given number of consecutive overruns of the same callback
+  /*!
+     \param consecutiveOverruns_  The number of overruns, zero never offloads the callbacks
+  */
+  void setOffloadThreshold(unsigned consecutiveOverruns_);
+
+  //! Number of callbacks which took longer than budget()
+  uint64_t overruns() const
+  {
+    return m_overruns;
+  }
+
+  //! Number of events dropped because the dispatch thread queue was full
+  uint64_t droppedEvents() const
+  {
+    return m_droppedEvents;
+  }
+
+  //! \return TRUE if the callbacks are invoked on the dispatch thread
+  bool offloaded() const
+  {
+    return m_offloaded;
+  }
+
+  //! Held by the dispatch thread while it invokes callbacks
+  /*!
+     The I/O thread holds it while it accesses the device state the callbacks may touch (canvases,
+     LEDs...).
+  */
+  std::mutex& callbackMutex()
+  {
+    return m_mtxCallbacks;
+  }
+
+private:
+  using tClock = std::chrono::steady_clock;
+
+  bool invoke(const Event& event_);
+  void run();
+
+  tHandler m_handler;
+
+  std::atomic<int64_t> m_budget{kDefaultBudget.count()};
+  std::atomic<unsigned> m_offloadThreshold{0};
+  std::array<std::atomic<unsigned>, static_cast<size_t>(Event::Type::Count)>
+    m_consecutiveOverruns{}; //!< Per callback type
+  std::atomic<uint64_t> m_overruns{0};
+  std::atomic<uint64_t> m_droppedEvents{0};
+
+  std::atomic<bool> m_offloaded{false};
+  std::atomic<bool> m_renderQueued{false};
+  std::atomic<bool> m_running{false};
+  std::atomic<bool> m_stopped{false};
+  SpscQueue<Event, kQueueSize> m_events;
+  std::mutex m_mtxProducers; //!< Some devices report input from a MIDI thread as well
+  std::mutex m_mtxCallbacks;
+  std::mutex m_mtxWakeUp;
+  std::condition_variable m_cvWakeUp;
+  std::thread m_thread;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -8,11 +8,15 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <future>
 #include <map>
 #include <thread>
+#include <vector>
 
 #include "cabl/comm/DeviceDescriptor.h"
 #include "cabl/comm/Driver.h"
+#include "cabl/devices/BandwidthBudget.h"
 #include "cabl/devices/Device.h"
 
 //--------------------------------------------------------------------------------------------------
@@ -27,6 +31,18 @@ namespace cabl
 class Coordinator
 {
 public:
+  //! How the I/O loop is driven
+  enum class PumpMode
+  {
+    Thread, //!< The Coordinator runs its own I/O thread (default)
+    Manual, //!< No internal threads, the host application calls poll() from its own loop
+  };
+
+  using tClock = std::chrono::steady_clock;
+
+  //! Interval between two calls to poll() when there is no pending work
+  static constexpr std::chrono::milliseconds kPollInterval{1};
+
   using tCollDeviceDescriptor = std::vector<DeviceDescriptor>;
   using tDevicePtr = std::shared_ptr<Device>;
   using tCollDevices = std::map<DeviceDescriptor, tDevicePtr>;
@@ -36,6 +52,37 @@ public:
   using tCollDrivers = std::map<Driver::Type, tDriverPtr>;
   using tCbDevicesListChanged = std::function<void(tCollDeviceDescriptor)>;
   using tCollCbDevicesListChanged = std::map<tClientId, tCbDevicesListChanged>;
+  using tCbInitDevice = std::function<void(tDevicePtr)>;
+
+  struct DeviceMemoryUsage
+  {
+    DeviceDescriptor deviceDescriptor;
+    bool connected;
+    size_t residentBytes;
+    size_t frameArenaHighWaterMark;    //!< Largest amount of per-frame scratch memory used
+    size_t frameArenaFallbacks;        //!< Scratch buffers that didn't fit in the frame arena
+  };
+  using tCollDeviceMemoryUsage = std::vector<DeviceMemoryUsage>;
+
+  struct DeviceBandwidthUsage
+  {
+    DeviceDescriptor deviceDescriptor;
+    unsigned busNumber;      //!< Zero if unknown, in which case the device is never throttled
+    unsigned portNumber;     //!< Zero if unknown
+    double inputRate;        //!< Bytes per second
+    double ledsRate;         //!< Bytes per second
+    double displayRate;      //!< Bytes per second
+    double displayAllowance; //!< Bytes per second, zero if the display traffic is not limited
+    bool displayThrottled;   //!< TRUE if some display frames have been deferred
+  };
+  using tCollDeviceBandwidthUsage = std::vector<DeviceBandwidthUsage>;
+
+  struct DeviceStartupTime
+  {
+    DeviceDescriptor deviceDescriptor;
+    Device::StartupTime startupTime;
+  };
+  using tCollDeviceStartupTime = std::vector<DeviceStartupTime>;
 
   static Coordinator& instance()
   {
@@ -43,6 +90,19 @@ public:
     return instance;
   }
 
+  //! Select how the I/O loop is driven
+  /*!
+     Must be called before the Coordinator is first used, i.e. before any Client is created.
+     \param pumpMode_  The pump mode
+     \return           false if the Coordinator has already been created
+  */
+  static bool setPumpMode(PumpMode pumpMode_);
+
+  static PumpMode pumpMode()
+  {
+    return s_pumpMode;
+  }
+
   ~Coordinator();
 
   tClientId registerClient(tCbDevicesListChanged);
@@ -52,7 +112,61 @@ public:
 
   tCollDeviceDescriptor enumerate(bool forceScan_ = false);
 
-  tDevicePtr connect(const DeviceDescriptor&);
+  //! Connect to a device and initialize it
+  /*!
+     \param cbInitDevice_  Invoked once the device is initialized and before the I/O thread serves
+                           it, e.g. to install the device callbacks
+  */
+  tDevicePtr connect(const DeviceDescriptor&, tCbInitDevice cbInitDevice_ = nullptr);
+
+  //! Connect to a device and initialize it on a thread of its own
+  /*!
+     Several devices can be connected at once, each one being initialized while the others are,
+     and while the I/O thread serves the devices already connected.
+  */
+  std::future<tDevicePtr> connectAsync(
+    const DeviceDescriptor&, tCbInitDevice cbInitDevice_ = nullptr);
+
+  //! Run the I/O loop from the calling thread (PumpMode::Manual only)
+  /*!
+     Processes driver events and hotplug notifications, then ticks the connected devices (reads,
+     LED and display flushes) until the budget is exhausted. Devices that have not been ticked
+     are served first on the next call. While all the devices are idle, the next call is due when
+     the first of them polls its input again, see Device::inputPolling().
+     \param budget_  Maximum time to spend in this call
+     \return         The time at which poll() should be called again
+  */
+  tClock::time_point poll(std::chrono::microseconds budget_);
+
+  //! Report the memory held by each known device, connected or not
+  /*!
+     Disconnected devices are kept around so they can be reused on reconnect, but their display
+     buffers are returned to the BufferPool, see BufferPool::pooledBytes().
+  */
+  tCollDeviceMemoryUsage memoryUsage();
+
+  //! Report the traffic of each connected device and its share of the bus bandwidth
+  /*!
+     The traffic is measured every BandwidthBudget::kUpdateInterval, and the display allowances
+     of the devices sharing a bus are updated accordingly.
+  */
+  tCollDeviceBandwidthUsage bandwidthUsage();
+
+  //! Report how long each connected device took to initialize and to show its first frame
+  tCollDeviceStartupTime startupTimes();
+
+  //! Number of iterations of the I/O loop, or of calls to poll(), since the Coordinator started
+  uint64_t wakeUps() const
+  {
+    return m_wakeUps;
+  }
+
+  //! Set the capacity of a USB bus, BandwidthBudget::kDefaultBusCapacity by default
+  /*!
+     \param busNumber_       The bus number, see DeviceDescriptor::busNumber()
+     \param bytesPerSecond_  The bandwidth shared by the devices connected to the bus
+  */
+  void setBusCapacity(unsigned busNumber_, double bytesPerSecond_);
 
 private:
   Coordinator();
@@ -60,6 +174,7 @@ private:
   void scan();
   bool checkAndAddDeviceDescriptor(const DeviceDescriptor&);
   void devicesListChanged();
+  void updateBandwidthBudget(tClock::time_point now_);
 
   tDriverPtr driver(Driver::Type);
 
@@ -68,16 +183,30 @@ private:
   std::atomic<bool> m_clientRegistered{false};
 
   std::atomic<bool> m_scanDone{false};
+  std::atomic<bool> m_scanRequested{false};
+  size_t m_nextDevice{0};
+  std::atomic<uint64_t> m_wakeUps{0};
   std::mutex m_mtxDevices;
   std::mutex m_mtxDeviceDescriptors;
+  std::mutex m_mtxConnect;
+  std::mutex m_mtxDrivers;
 
   tCollDrivers m_collDrivers;
+  std::vector<tDriverPtr> m_polledDrivers; //!< Copy of m_collDrivers made by poll()
 
   tCollCbDevicesListChanged m_collCbDevicesListChanged;
   tCollDeviceDescriptor m_collDeviceDescriptors;
   tCollDevices m_collDevices;
 
+  BandwidthBudget m_bandwidthBudget;
+  tClock::time_point m_nextBandwidthUpdate;
+  std::vector<Device*> m_budgetedDevices;
+  std::vector<BandwidthBudget::Demand> m_bandwidthDemands;
+  tCollDeviceBandwidthUsage m_collBandwidthUsage;
+
   static std::atomic<unsigned> s_clientCount;
+  static std::atomic<PumpMode> s_pumpMode;
+  static std::atomic<bool> s_instantiated;
 };
 
 //--------------------------------------------------------------------------------------------------
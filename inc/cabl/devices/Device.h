@@ -8,7 +8,12 @@
 #pragma once
 
 // STL includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <initializer_list>
 #include <mutex>
 
 #if defined(_WIN32) || defined(__APPLE__) || defined(__linux)
@@ -19,9 +24,17 @@
 
 #include "cabl/comm/DeviceDescriptor.h"
 #include "cabl/comm/DeviceHandle.h"
+#include "cabl/devices/BandwidthBudget.h"
+#include "cabl/devices/CallbackDispatcher.h"
 #include "cabl/devices/DeviceRegistrar.h"
+#include "cabl/devices/InputMask.h"
+#include "cabl/devices/InputPolling.h"
+#include "cabl/devices/MidiMapping.h"
 
 #include "cabl/util/Color.h"
+#include "cabl/util/FrameArena.h"
+#include "cabl/util/SeqLock.h"
+#include "cabl/util/SpscQueue.h"
 
 namespace sl
 {
@@ -29,6 +42,7 @@ namespace cabl
 {
 
 class Canvas;
+class DisplayMirror;
 class TextDisplay;
 class LedArray;
 
@@ -232,6 +246,27 @@ public:
   using tCbKeyChanged = std::function<void(unsigned index_, double, bool shiftKey_)>;
   using tCbControlChanged = std::function<void(unsigned pot_, double val_, bool shiftKey_)>;
 
+  //! The state of the controls of a device, as last reported by the device
+  struct InputState
+  {
+    static constexpr size_t kNumKeys = 128;
+    static constexpr size_t kNumEncoders = 32;
+    static constexpr size_t kNumControls = 32;
+
+    bool button(Button button_) const
+    {
+      unsigned index = static_cast<unsigned>(button_);
+      return ((buttons[index / 32] >> (index % 32)) & 1) != 0;
+    }
+
+    std::array<uint32_t, 8> buttons;            //!< One bit per Button, set while held
+    std::array<float, kNumKeys> keys;           //!< Key and pad values, zero once released
+    std::array<int32_t, kNumEncoders> encoders; //!< Steps since connection, positive if increased
+    std::array<float, kNumControls> controls;   //!< Potentiometer and touch strip values
+    bool shift;                                 //!< TRUE if shift was held on the last change
+    uint32_t changes;                           //!< Number of input changes since connection
+  };
+
   Device() = default;
   virtual ~Device() = default;
 
@@ -263,6 +298,27 @@ public:
 
   virtual void sendMidiMsg(tRawData);
 
+  //! Send a MIDI message without allocating, used by the MIDI mapping on the I/O thread
+  virtual void sendMidiBytes(const uint8_t* pData_, size_t length_);
+
+  //! Real-time safe variants of the LED setters
+  /*!
+     These never lock and never allocate, so they can be called from an audio callback. The
+     updates are queued and applied on the I/O thread on the next tick; only one thread at a time
+     may post to a given device.
+     \return FALSE if the queue is full and the update was dropped
+  */
+  bool postButtonLed(Button, const Color&) noexcept;
+
+  bool postKeyLed(unsigned, const Color&) noexcept;
+
+  bool postLedArrayValue(size_t ledArrayIndex_,
+    double value_,
+    const Color& color_,
+    Alignment alignment_ = Alignment::Left) noexcept;
+
+  static constexpr size_t kLedQueueSize = 256;
+
   void setCallbackDisconnect(tCbDisconnect cbDisconnect_);
 
   void setCallbackRender(tCbRender cbRender_);
@@ -277,13 +333,110 @@ public:
 
   bool hasDeviceHandle();
 
+  //! Number of bytes held by the pixel buffers of the displays and LED matrices
+  size_t residentMemory();
+
+  //! Scratch memory for the current frame, reset after every tick
+  /*!
+     Only valid from the render callback and from the driver code that flushes the device state,
+     which never run concurrently (even when the callbacks are offloaded).
+  */
+  FrameArena& frameArena()
+  {
+    return m_frameArena;
+  }
+
+  //! Times the client callbacks and optionally moves them off the I/O thread
+  /*!
+     The callbacks which take longer than CallbackDispatcher::budget() are logged and counted,
+     see CallbackDispatcher::setOffloadThreshold() to run the callbacks of a device which keeps
+     overrunning on a thread of its own.
+  */
+  CallbackDispatcher& callbackDispatcher()
+  {
+    return m_callbackDispatcher;
+  }
+
+  //! Stop invoking the client callbacks, once those running on the dispatch thread have returned
+  /*!
+     The callbacks may use the members of the derived classes (e.g. a render callback drawing on
+     their canvases), so this must be called before those are destroyed. The devices created by
+     the DeviceFactory call it before their destructor runs.
+  */
+  void stopCallbacks();
+
+  //! A consistent snapshot of the device controls
+  /*!
+     Can be called from any thread at any rate, it never locks nor waits for the callbacks: a
+     client rendering at a fixed frame rate may read the state of the controls instead of
+     tracking it from the callbacks. Compare InputState::changes to skip unchanged snapshots.
+  */
+  InputState inputState() const
+  {
+    return m_inputState.read();
+  }
+
+  //! Send MIDI messages as soon as the input is read, without waiting for the callbacks
+  /*!
+     \param rules_   The mapping table, see MidiMapping::Rule
+     \param output_  Receives the MIDI messages on the I/O thread, the default is the MIDI output
+                     of the device
+  */
+  void setMidiMapping(MidiMapping::tRules rules_, MidiMapping::tOutput output_ = nullptr);
+
+  const MidiMapping& midiMapping() const
+  {
+    return m_midiMapping;
+  }
+
+  //! The input the client is interested in, the driver skips decoding the rest
+  /*!
+     See InputMask::usage() for the reports skipped and the CPU time saved.
+  */
+  InputMask& inputMask()
+  {
+    return m_inputMask;
+  }
+
+  //! How often the input is polled, see InputPolling::Settings
+  /*!
+     Only the drivers which check inputPollDue() adapt their polling, the others poll on every
+     tick.
+  */
+  InputPolling& inputPolling()
+  {
+    return m_inputPolling;
+  }
+
+  using tClock = std::chrono::steady_clock;
+
+  //! How long the device took to start after being connected
+  struct StartupTime
+  {
+    std::chrono::microseconds init;       //!< Spent initializing the device
+    std::chrono::microseconds firstFrame; //!< Until the first display frame, zero until then
+  };
+
+  StartupTime startupTime() const
+  {
+    return {std::chrono::microseconds(m_initDuration), std::chrono::microseconds(m_firstFrame)};
+  }
+
 protected:
   virtual bool tick() = 0;
 
-  bool writeToDeviceHandle(const Transfer& transfer_, uint8_t endpoint_) const;
+  //! Write to the device, the bytes written are accounted to the given kind of traffic
+  bool writeToDeviceHandle(
+    const Transfer& transfer_, uint8_t endpoint_, Traffic traffic_ = Traffic::Leds) const;
 
   bool readFromDeviceHandle(Transfer& transfer_, uint8_t endpoint_) const;
 
+  bool writeToDeviceHandle(const DeviceHandle::tCollTransfers& transfers_,
+    uint8_t endpoint_,
+    Traffic traffic_ = Traffic::Leds) const;
+
+  bool readFromDeviceHandle(DeviceHandle::tCollTransfers& transfers_, uint8_t endpoint_) const;
+
   void readFromDeviceHandleAsync(uint8_t endpoint_, DeviceHandle::tCbRead cbRead_) const;
 
   void buttonChanged(Button button_, bool buttonState_, bool shiftPressed_);
@@ -294,16 +447,100 @@ protected:
 
   void controlChanged(unsigned potentiometer_, double value_, bool shiftPressed_);
 
+  //! FALSE if no control of the class is consumed, neither by the client nor by the MIDI mapping
+  bool inputWanted(InputMask::Class class_) const noexcept;
+
+  //! Decode a report unless none of the classes it carries is consumed
+  /*!
+     Reports carrying buttons are always decoded, since the other controls are reported with the
+     Shift state they hold. The report is accounted to the first class, see InputMask::usage().
+     \return FALSE if the report has been skipped
+  */
+  template <typename TDecode>
+  bool decodeInput(std::initializer_list<InputMask::Class> classes_, TDecode decode_)
+  {
+    InputMask::Class accounted = *classes_.begin();
+    if (std::none_of(classes_.begin(), classes_.end(), [this](InputMask::Class class_) {
+          return class_ == InputMask::Class::Buttons || inputWanted(class_);
+        }))
+    {
+      m_inputMask.countSkipped(accounted);
+      return false;
+    }
+    if (!m_inputMask.countDecoded(accounted))
+    {
+      decode_();
+      return true;
+    }
+    tClock::time_point start = tClock::now();
+    decode_();
+    m_inputMask.recordDecodeTime(accounted, tClock::now() - start);
+    return true;
+  }
+
+  //! \return FALSE if the next display frame must wait, to stay within the bus bandwidth budget
+  /*!
+     A deferred frame must be kept dirty, so that it is sent with the latest content on a later
+     tick. See Coordinator::bandwidthUsage().
+  */
+  bool displayFrameDue();
+
+  //! \return FALSE if the input must not be polled on this tick, as the device is idle
+  bool inputPollDue();
+
 private:
+  struct LedCommand
+  {
+    enum class Type : uint8_t
+    {
+      ButtonLed,
+      KeyLed,
+      LedArrayValue,
+    };
+
+    Type type;
+    unsigned index;
+    double value;
+    Color color;
+    Alignment alignment;
+  };
+
   bool onTick();
 
-  void onConnect();
+  void applyLedCommands();
+
+  void onPoll();
+
+  //! Initialize the device, the I/O thread skips it meanwhile
+  /*!
+     \param connectStart_  When the connection started, the startup time is measured from there
+     \param cbInit_        Invoked after init(), before the I/O thread serves the device
+  */
+  void onConnect(tClock::time_point connectStart_ = tClock::now(),
+    const std::function<void()>& cbInit_ = nullptr);
 
   void onDisconnect();
 
   void render();
 
-  bool m_connected{false};
+  void invokeCallback(const CallbackDispatcher::Event& event_);
+
+  void setDisplayMirror(DisplayMirror* pDisplayMirror_);
+
+  void countWritten(Traffic traffic_, size_t bytes_) const;
+
+  //! When the device must be ticked again, in the past if it has output in flight
+  tClock::time_point nextTick() const;
+
+  //! Keeps the changes of the controls nobody consumes from the callbacks, \return FALSE if so
+  bool acceptInput(InputMask::Class class_, unsigned index_) noexcept;
+
+  std::atomic<bool> m_connected{false};
+  std::mutex m_mtxConnect;
+  tClock::time_point m_connectStart;
+  std::atomic<int64_t> m_initDuration{0};
+  mutable std::atomic<int64_t> m_firstFrame{0};
+  mutable std::atomic<bool> m_firstFramePending{false};
   tCbDisconnect m_cbDisconnect;
   tCbRender m_cbRender;
 
@@ -315,7 +552,35 @@ private:
   mutable std::mutex m_mtxDeviceHandle;
   tPtr<DeviceHandle> m_pDeviceHandle;
 
+  mutable DeviceHandle::tCbRead m_cbPolled;
+  DeviceHandle::tCollTransfers m_polled;
+
+  SpscQueue<LedCommand, kLedQueueSize> m_ledCommands;
+
+  FrameArena m_frameArena;
+
+  mutable TrafficMeter m_trafficMeter;
+
+  SeqLock<InputState> m_inputState;
+
+  MidiMapping m_midiMapping;
+
+  InputMask m_inputMask;
+
+  InputPolling m_inputPolling;
+  bool m_tickWrote{false}; //!< TRUE if the last tick wrote to the device
+
+  std::mutex m_mtxDisplayMirror;
+  DisplayMirror* m_pDisplayMirror{nullptr};
+
+  // Last, so that the dispatch thread is stopped before the rest of Device is destroyed. The
+  // derived classes are gone by then, see stopCallbacks()
+  CallbackDispatcher m_callbackDispatcher{
+    [this](const CallbackDispatcher::Event& event_) { invokeCallback(event_); }};
+
   friend class Coordinator;
+  friend class DeviceDriverAccess;
+  friend class DisplayMirror;
 };
 
 //--------------------------------------------------------------------------------------------------
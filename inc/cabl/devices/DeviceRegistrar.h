@@ -35,9 +35,14 @@ class DeviceRegistrar
 public:
   explicit DeviceRegistrar(const DeviceDescriptor& deviceDescriptor_)
   {
-    // Register the factory function for a specific device descriptor
-    DeviceFactory::instance().registerClass(deviceDescriptor_,
-      [](void) -> std::shared_ptr<Device> { return std::shared_ptr<Device>(new T); });
+    // Register the factory function for a specific device descriptor. The callbacks are stopped
+    // before the device is destroyed, they may use the members of T
+    DeviceFactory::instance().registerClass(deviceDescriptor_, [](void) -> std::shared_ptr<Device> {
+      return std::shared_ptr<Device>(new T, [](T* pDevice_) {
+        pDevice_->stopCallbacks();
+        delete pDevice_;
+      });
+    });
   }
 };
 
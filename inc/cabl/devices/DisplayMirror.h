@@ -0,0 +1,179 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cabl/util/BufferPool.h"
+#include "cabl/util/Types.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+class Canvas;
+class Device;
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class DisplayMirror
+  \brief Publishes copies of the displays of a device, e.g. for monitoring or streaming them
+
+  Once a DisplayMirror is attached to a device, the I/O thread copies the pixel buffers of its
+  graphic displays and LED matrices and the content of its text displays after each flush, at most
+  maxFrameRate() times per second. The copies are handed to a background thread, which converts
+  them to RGBA and (optionally) PNG and calls the frame callback. The I/O thread never waits for
+  the background thread: if it's still busy with the previous frame, the newest copy replaces the
+  pending one and droppedFrames() is incremented.
+  The device must outlive the mirror.
+*/
+
+class DisplayMirror
+{
+public:
+  using tClock = std::chrono::steady_clock;
+
+  static constexpr double kDefaultMaxFrameRate = 10.0;
+
+  struct Image
+  {
+    enum class Source : uint8_t
+    {
+      GraphicDisplay,
+      LedMatrix,
+    };
+
+    Source source;
+    size_t index;     //!< The display or LED matrix index
+    unsigned width;   //!< Width in pixels
+    unsigned height;  //!< Height in pixels
+    tRawData native;  //!< The pixel buffer in the device format, as sent to the device
+    tRawData rgba;    //!< width * height RGBA pixels, empty if the canvas can't be decoded
+    tRawData png;     //!< The RGBA pixels as a PNG file, empty unless PNG encoding is enabled
+  };
+
+  struct Text
+  {
+    size_t index;     //!< The text display index
+    unsigned width;   //!< Number of columns
+    unsigned height;  //!< Number of rows
+    tRawData data;    //!< The display content, as returned by TextDisplay::displayData()
+  };
+
+  struct Frame
+  {
+    uint64_t sequence;          //!< Number of frames captured before this one
+    tClock::time_point time;    //!< Capture time
+    std::vector<Image> images;  //!< Graphic displays first, then LED matrices
+    std::vector<Text> texts;
+  };
+
+  //! Called on the background thread for each frame
+  using tCbFrame = std::function<void(const Frame&)>;
+
+  DisplayMirror(Device& device_, tCbFrame cbFrame_);
+
+  ~DisplayMirror();
+
+  DisplayMirror(const DisplayMirror&) = delete;
+  DisplayMirror& operator=(const DisplayMirror&) = delete;
+
+  //! Cap the number of frames captured per second, 0 for no cap
+  void setMaxFrameRate(double framesPerSecond_);
+
+  double maxFrameRate() const
+  {
+    return m_maxFrameRate;
+  }
+
+  //! Encode each image as PNG too (disabled by default)
+  void setPngEncoding(bool enabled_)
+  {
+    m_pngEncoding = enabled_;
+  }
+
+  //! Number of frames copied by the I/O thread
+  uint64_t capturedFrames() const
+  {
+    return m_capturedFrames;
+  }
+
+  //! Number of frames replaced by a newer one before the background thread could publish them
+  uint64_t droppedFrames() const
+  {
+    return m_droppedFrames;
+  }
+
+  //! Copy the device displays, called by the device on the I/O thread after each flush
+  /*!
+     Once the copy buffers have been allocated (during the first frames) this neither allocates
+     nor waits for locks.
+  */
+  void capture(Device& device_);
+
+private:
+  struct Surface
+  {
+    Image::Source source;
+    size_t index;
+    unsigned width;
+    unsigned height;
+    const Canvas* pCanvas;
+    size_t size;
+    BufferPool::tBuffer pBuffer;
+    tPtr<Canvas> pDecoder; //!< A copy of the canvas, only used by the background thread
+  };
+
+  struct Snapshot
+  {
+    bool prepared{false};
+    uint64_t sequence{0};
+    tClock::time_point time;
+    std::vector<Surface> surfaces;
+    std::vector<Text> texts;
+  };
+
+  void prepare(Snapshot& snapshot_, Device& device_);
+
+  void run();
+
+  void publish(Snapshot& snapshot_);
+
+  Device& m_device;
+  tCbFrame m_cbFrame;
+
+  std::atomic<double> m_maxFrameRate{kDefaultMaxFrameRate};
+  std::atomic<bool> m_pngEncoding{false};
+  std::atomic<uint64_t> m_capturedFrames{0};
+  std::atomic<uint64_t> m_droppedFrames{0};
+  tClock::time_point m_nextCapture;
+
+  Snapshot m_capturing;  //!< Owned by the I/O thread
+  Snapshot m_pending;    //!< Guarded by m_mtxPending
+  Snapshot m_publishing; //!< Owned by the background thread
+
+  std::mutex m_mtxPending;
+  std::condition_variable m_cvPending;
+  bool m_hasPending{false};
+  bool m_running{true};
+
+  std::thread m_thread;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
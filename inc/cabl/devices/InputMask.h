@@ -0,0 +1,127 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace sl
+{
+namespace cabl
+{
+
+class Device;
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class InputMask
+  \brief The input of a device the client is interested in
+
+  Everything is subscribed by default. The drivers skip decoding the reports of the classes
+  nobody consumes (e.g. the pads of a Maschine for a transport-only client) and, when a class has
+  an endpoint of its own, they don't read it at all. The controls of the skipped reports are not
+  tracked: the callbacks, Device::inputState() and the MIDI mapping only see them again from the
+  first report decoded after they are subscribed. Input mapped by the MIDI mapping is always
+  decoded, and so are the reports carrying buttons, which hold the Shift state: the masked
+  controls they carry are tracked by Device::inputState(), but never reach the callbacks.
+  Can be changed from any thread, the I/O thread picks the changes up on the next report.
+*/
+
+class InputMask
+{
+public:
+  enum class Class : uint8_t
+  {
+    Buttons,
+    Encoders,
+    Keys,     //!< Keys and pads
+    Controls, //!< Potentiometers and touch strips
+  };
+
+  static constexpr size_t kNumClasses = 4;
+  static constexpr unsigned kNumIndices = 256;
+
+  //! The cost of the input of a class, as decoded by the driver
+  struct Usage
+  {
+    uint64_t reportsDecoded;
+    uint64_t reportsSkipped;
+    uint64_t eventsSkipped;              //!< Decoded, but dropped before the callbacks
+    std::chrono::nanoseconds decodeTime; //!< Average decoding time of a report, zero if unknown
+
+    //! CPU time saved by the reports skipped, estimated from the ones decoded
+    std::chrono::nanoseconds saved() const
+    {
+      return decodeTime * static_cast<int64_t>(reportsSkipped);
+    }
+  };
+
+  InputMask();
+
+  InputMask(const InputMask&) = delete;
+  InputMask& operator=(const InputMask&) = delete;
+
+  //! Subscribe to a range of controls of a class, all of them by default
+  void subscribe(Class class_, unsigned first_ = 0, unsigned count_ = kNumIndices);
+
+  //! Unsubscribe from a range of controls of a class, all of them by default
+  void unsubscribe(Class class_, unsigned first_ = 0, unsigned count_ = kNumIndices);
+
+  //! Subscribe to everything
+  void reset();
+
+  bool wants(Class class_, unsigned index_) const noexcept
+  {
+    if (index_ >= kNumIndices)
+    {
+      return false;
+    }
+    const Bits& bits = m_bits[static_cast<size_t>(class_)];
+    return ((bits[index_ / 32].load(std::memory_order_relaxed) >> (index_ % 32)) & 1) != 0;
+  }
+
+  //! TRUE if any control of the class is subscribed
+  bool wantsAny(Class class_) const noexcept;
+
+  Usage usage(Class class_) const;
+
+private:
+  using Bits = std::array<std::atomic<uint32_t>, kNumIndices / 32>;
+
+  struct Counters
+  {
+    std::atomic<uint64_t> reportsDecoded{0};
+    std::atomic<uint64_t> reportsSkipped{0};
+    std::atomic<uint64_t> eventsSkipped{0};
+    std::atomic<int64_t> decodeTimeNs{0};
+  };
+
+  //! Only one every kTimingInterval reports is timed, to keep the clock off the hot path
+  static constexpr uint64_t kTimingInterval = 16;
+
+  void set(Class class_, unsigned first_, unsigned count_, bool subscribed_);
+
+  //! \return TRUE if the decoding of this report should be timed
+  bool countDecoded(Class class_) noexcept;
+  void recordDecodeTime(Class class_, std::chrono::nanoseconds time_) noexcept;
+  void countSkipped(Class class_) noexcept;
+  void countSkippedEvent(Class class_) noexcept;
+
+  std::array<Bits, kNumClasses> m_bits;
+  std::array<Counters, kNumClasses> m_counters;
+
+  friend class Device;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,101 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class InputPolling
+  \brief Adapts how often the input of a device is polled to whether it is being used
+
+  The input is polled on every tick while the controls are being used. Once nothing changed for
+  Settings::idleAfter, the polling interval starts at Settings::idle and doubles on every poll up
+  to Settings::floor; the first input change brings it back to Settings::active. The I/O thread
+  sleeps until the next poll is due when no device has anything else to do, so an idle controller
+  costs a few hundred wake-ups per second instead of a busy loop. The first touch after a pause
+  is picked up within Settings::floor.
+  The settings can be changed from any thread, the rest is driven by the I/O thread.
+*/
+
+class InputPolling
+{
+public:
+  using tClock = std::chrono::steady_clock;
+
+  struct Settings
+  {
+    std::chrono::microseconds active{0};      //!< While in use, zero polls on every tick
+    std::chrono::microseconds idle{1000};     //!< First interval once idle
+    std::chrono::microseconds floor{4000};    //!< Longest interval, zero never backs off
+    std::chrono::milliseconds idleAfter{250}; //!< Time without input changes before backing off
+  };
+
+  InputPolling() = default;
+
+  InputPolling(const InputPolling&) = delete;
+  InputPolling& operator=(const InputPolling&) = delete;
+
+  void setSettings(const Settings& settings_);
+
+  Settings settings() const;
+
+  //! Number of times the input has been polled
+  uint64_t polls() const
+  {
+    return m_polls;
+  }
+
+  //! The current polling interval
+  std::chrono::microseconds interval() const
+  {
+    return std::chrono::microseconds(m_intervalUs);
+  }
+
+  //! Start over as if the controls were just used, e.g. when the device is connected
+  void reset(tClock::time_point now_ = tClock::now());
+
+  //! \return TRUE if the input should be polled now, in which case the poll is counted
+  bool due(tClock::time_point now_ = tClock::now()) noexcept;
+
+  //! Signal an input change, the next poll is due after Settings::active
+  void activity() noexcept
+  {
+    m_activity.store(true, std::memory_order_relaxed);
+  }
+
+  //! When the next poll is due, in the past if the input has never been polled
+  tClock::time_point next() const noexcept;
+
+private:
+  std::atomic<int64_t> m_activeUs{0};
+  std::atomic<int64_t> m_idleUs{1000};
+  std::atomic<int64_t> m_floorUs{4000};
+  std::atomic<int64_t> m_idleAfterUs{250000};
+
+  std::atomic<bool> m_activity{false};
+  std::atomic<int64_t> m_intervalUs{0};
+  std::atomic<uint64_t> m_polls{0};
+
+  // Only accessed by the I/O thread
+  tClock::time_point m_lastPoll;
+  tClock::time_point m_lastActivity{tClock::now()};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,141 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class MidiMapping
+  \brief Translates the input of a device into MIDI messages, on the thread reading the input
+
+  The most common use of a controller is playing notes and sending control changes: a mapping
+  table loaded with load() sends them as soon as the input is decoded, without waiting for the
+  client callbacks. Translating never allocates nor locks, so it doesn't delay the I/O thread.
+  The client callbacks are still invoked for the mapped input, after the MIDI message is sent.
+*/
+
+class MidiMapping
+{
+public:
+  enum class Source : uint8_t
+  {
+    Button,  //!< Value 1 when pressed, 0 when released
+    Key,     //!< Keys and pads, value in [0, 1], 0 when released
+    Encoder, //!< Value 1 when increased, -1 when decreased
+    Control, //!< Potentiometers and touch strips, value in [0, 1]
+  };
+
+  enum class Message : uint8_t
+  {
+    Note,                  //!< Note on/off, the velocity is the value of the key
+    NoteWithPressure,      //!< Same as Note, then polyphonic aftertouch while the key is held
+    ControlChange,         //!< Absolute value, encoders are accumulated from the center
+    RelativeControlChange, //!< Encoders only: 1 when increased, 127 when decreased
+    PitchBend,             //!< Keys and controls only
+  };
+
+  //! Maps a range of consecutive controls of the same kind to consecutive notes or controllers
+  struct Rule
+  {
+    Source source;
+    unsigned first;  //!< Index of the first control (e.g. Device::Button or pad index)
+    unsigned count;  //!< Number of controls
+    Message message;
+    uint8_t channel; //!< MIDI channel, [0, 15]
+    uint8_t number;  //!< Note or controller number of the first control
+  };
+
+  using tRules = std::vector<Rule>;
+  using tOutput = std::function<void(const uint8_t* pData_, size_t length_)>;
+
+  static constexpr size_t kNumButtons = 256;
+  static constexpr size_t kNumKeys = 128;
+  static constexpr size_t kNumEncoders = 32;
+  static constexpr size_t kNumControls = 32;
+
+  MidiMapping();
+  ~MidiMapping();
+
+  MidiMapping(const MidiMapping&) = delete;
+  MidiMapping& operator=(const MidiMapping&) = delete;
+
+  //! Replace the mapping table, can be called from any thread
+  /*!
+     Waits for the input being translated with the previous table, if any.
+     \param rules_   The mapping rules, later rules take precedence over earlier ones
+     \param output_  Receives the MIDI messages, on the thread reading the input
+  */
+  void load(tRules rules_, tOutput output_);
+
+  //! Remove the mapping table
+  void clear();
+
+  //! Translate an input change into a MIDI message
+  /*!
+     \return TRUE if a message has been sent
+  */
+  bool translate(Source source_, unsigned index_, double value_) noexcept;
+
+  //! TRUE if the current table maps any control of the given kind
+  bool maps(Source source_) const noexcept
+  {
+    return ((m_sources >> static_cast<unsigned>(source_)) & 1) != 0;
+  }
+
+  //! Number of MIDI messages sent
+  uint64_t messagesSent() const
+  {
+    return m_messagesSent;
+  }
+
+private:
+  struct Table
+  {
+    tRules rules;
+    tOutput output;
+    std::array<int16_t, kNumButtons> buttons;
+    std::array<int16_t, kNumKeys> keys;
+    std::array<int16_t, kNumEncoders> encoders;
+    std::array<int16_t, kNumControls> controls;
+  };
+
+  void replace(Table* pTable_, uint8_t sources_);
+
+  bool translate(const Table& table_, Source source_, unsigned index_, double value_) noexcept;
+
+  std::atomic<Table*> m_pTable{nullptr};
+  std::atomic<unsigned> m_nTranslating{0};
+  std::mutex m_mtxLoad;
+
+  // Only accessed by the thread reading the input
+  std::bitset<kNumButtons> m_heldButtons;
+  std::bitset<kNumKeys> m_heldKeys;
+  std::array<uint8_t, kNumEncoders> m_encoderValues;
+  std::array<uint8_t, kNumControls> m_controlValues;
+
+  std::atomic<uint64_t> m_messagesSent{0};
+  std::atomic<uint8_t> m_sources{0}; //!< One bit per Source in the current table
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,136 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cabl/devices/Device.h"
+#include "cabl/util/BufferPool.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class PageCache
+  \brief A cache of named, pre-rendered UI pages of a device
+
+  A page is the content of the graphic displays, LED matrices and text displays of a device,
+  along with the button and key LEDs set through the cache. show() swaps the pixel buffers of the
+  requested page into the displays instead of copying or re-rendering them, and only sends the
+  LEDs that differ from the ones of the previous page.
+  Pages which are not being shown are kept within maxBytes(), the least recently shown ones are
+  evicted first. The cache must be used from the thread that renders the device (i.e. from the
+  render callback).
+*/
+
+class PageCache
+{
+public:
+  static constexpr size_t kDefaultMaxBytes = 4 * 1024 * 1024;
+
+  PageCache(Device& device_, size_t maxBytes_ = kDefaultMaxBytes);
+
+  ~PageCache();
+
+  PageCache(const PageCache&) = delete;
+  PageCache& operator=(const PageCache&) = delete;
+
+  //! Make a page the one shown on the device
+  /*!
+     The current content of the device is stored as the previously shown page.
+     \param name_  The page name
+     \return       TRUE if the page has been restored from the cache, FALSE if it is a new or
+                   evicted page: in that case the displays and the LEDs have been cleared and the
+                   page has to be rendered
+  */
+  bool show(const std::string& name_);
+
+  //! The name of the page being shown, empty if none
+  const std::string& activePage() const
+  {
+    return m_activePage;
+  }
+
+  //! Is a page cached (or being shown)?
+  bool contains(const std::string& name_) const;
+
+  //! Drop a page, e.g. because its content is out of date
+  void invalidate(const std::string& name_);
+
+  //! Drop all of the pages but the one being shown
+  void clear();
+
+  //! Set a button LED on the device and record it in the page being shown
+  void setButtonLed(Device::Button button_, const Color& color_);
+
+  //! Set a key LED on the device and record it in the page being shown
+  void setKeyLed(unsigned index_, const Color& color_);
+
+  void setMaxBytes(size_t maxBytes_);
+
+  size_t maxBytes() const
+  {
+    return m_maxBytes;
+  }
+
+  //! Number of bytes held by the cache, including the page being shown
+  size_t cachedBytes() const
+  {
+    return m_cachedBytes;
+  }
+
+  //! Number of pages, including the page being shown
+  size_t size() const
+  {
+    return m_pages.size();
+  }
+
+private:
+  struct Page
+  {
+    // One per graphic display followed by one per LED matrix. For the page being shown these
+    // are spare buffers, its content lives in the canvases of the device.
+    std::vector<BufferPool::tBuffer> canvasBuffers;
+    std::vector<tRawData> textDisplays;
+    std::map<Device::Button, Color> buttonLeds;
+    std::map<unsigned, Color> keyLeds;
+    size_t bytes{0};
+    std::list<std::string>::iterator itLru;
+  };
+
+  std::vector<Canvas*> canvases() const;
+
+  void store(Page& page_);
+  void restore(Page& page_);
+  void clearDevice();
+
+  void updateLeds(const Page* pPrevious_, const Page& next_);
+
+  void erase(std::map<std::string, Page>::iterator it_);
+  void trim();
+
+  Device& m_device;
+  size_t m_maxBytes;
+  size_t m_cachedBytes{0};
+
+  std::map<std::string, Page> m_pages;
+  std::list<std::string> m_lru; //!< Most recently shown first
+  std::string m_activePage;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
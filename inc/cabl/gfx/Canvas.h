@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <string>
 
+#include "cabl/util/BufferPool.h"
 #include "cabl/util/Color.h"
 #include "cabl/util/Types.h"
 
@@ -132,6 +133,16 @@ public:
    */
   virtual void fill(uint8_t value_);
 
+  //! The color a pixel takes when the Canvas is filled with a pattern
+  /*!
+   Lets a part of the Canvas be filled the way fill() fills all of it, whatever its pixel format.
+   \param value_  The value of a pattern of eight pixels, as passed to fill()
+   \param x_      The X coordinate of the pixel
+   \param y_      The Y coordinate of the pixel
+   \return        The color of the pixel after fill(value_)
+   */
+  virtual Color fillColor(uint8_t value_, unsigned x_, unsigned y_) const;
+
   /** @} */ // End of group Fill
 
   //--------------------------------------------------------------------------------------------------
@@ -333,6 +344,59 @@ public:
 
   virtual void resetDirtyFlags() const = 0;
 
+  //! Give the pixel buffer back to the BufferPool
+  /*!
+     The buffer is transparently reacquired (and cleared) on the next access.
+  */
+  virtual void releaseBuffer()
+  {
+  }
+
+  //! Number of bytes currently held by the pixel buffer
+  virtual size_t residentBytes() const
+  {
+    return 0;
+  }
+
+  //! Exchange the pixel buffer with another one of bufferSize() bytes, in constant time
+  /*!
+     The whole canvas is marked as dirty.
+     \param buffer_  The buffer to swap in, receives the previous pixel buffer
+     \return         FALSE if the canvas doesn't support swapping, buffer_ is left untouched
+  */
+  virtual bool swapBuffer(BufferPool::tBuffer& buffer_)
+  {
+    return false;
+  }
+
+  //! Show a frame stored elsewhere (e.g. in a memory-mapped file) without copying it
+  /*!
+     The frame replaces the content of the pixel buffer: it is what gets sent to the device and
+     what pixel() returns. Drawing on the canvas copies the frame into the pixel buffer first.
+     The frame must stay valid until then, until another frame is attached or until detachFrame()
+     is called. The whole canvas is marked as dirty.
+     \param pFrame_  bufferSize() bytes, in the layout of the pixel buffer
+     \return         FALSE if the canvas doesn't support external frames
+  */
+  virtual bool attachFrame(const uint8_t* pFrame_)
+  {
+    return false;
+  }
+
+  //! Copy the attached frame (if any) into the pixel buffer, so that the frame can be released
+  virtual void detachFrame()
+  {
+  }
+
+  //! A copy of the canvas with the same concrete type, used to decode copies of its pixel buffer
+  /*!
+     \return The copy, or nullptr if the canvas can't be copied
+  */
+  virtual tPtr<Canvas> clone() const
+  {
+    return nullptr;
+  }
+
 
 protected:
   virtual uint8_t* data() = 0;
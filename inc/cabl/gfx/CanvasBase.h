@@ -8,9 +8,11 @@
 #pragma once
 
 #include "Canvas.h"
-#include <array>
+#include <algorithm>
 #include <bitset>
 
+#include "cabl/util/BufferPool.h"
+
 //--------------------------------------------------------------------------------------------------
 
 namespace sl
@@ -24,17 +26,49 @@ namespace cabl
   \class CanvasBase
   \brief The canvas base class
 
+  The pixel buffer comes from the BufferPool. It goes back to the pool when the device owning the
+  canvas disconnects, and a cleared one is acquired on the next access.
+  A canvas doesn't lock itself. Draw on the canvases of a device from its render callback only.
+  The I/O thread reads them, and releases their buffers on disconnection, while it holds the lock
+  the render callback runs under. The input callbacks may run on a driver thread instead: they
+  should only record what to draw, and leave the drawing to the next render. Drawing from any other
+  thread can race with the sending of a frame or with the release of the buffer.
 */
 template <unsigned W, unsigned H, unsigned SIZE = W* H * 3, unsigned NCHUNKS = 1>
 class CanvasBase : public Canvas
 {
 
 public:
-  CanvasBase()
+  CanvasBase() : m_pData(BufferPool::instance().acquire(SIZE))
   {
     setDirty();
   }
 
+  CanvasBase(const CanvasBase& other_)
+    : Canvas(other_)
+    , m_pData(BufferPool::instance().acquire(SIZE))
+    , m_chunkDirtyFlags(other_.m_chunkDirtyFlags)
+  {
+    std::copy_n(other_.data(), SIZE, m_pData.get());
+  }
+
+  CanvasBase& operator=(const CanvasBase& other_)
+  {
+    if (this != &other_)
+    {
+      Canvas::operator=(other_);
+      m_pFrame = nullptr;
+      std::copy_n(other_.data(), SIZE, data());
+      m_chunkDirtyFlags = other_.m_chunkDirtyFlags;
+    }
+    return *this;
+  }
+
+  ~CanvasBase() override
+  {
+    releaseBuffer();
+  }
+
   unsigned width() const noexcept override
   {
     return W;
@@ -57,7 +91,8 @@ public:
 
   const uint8_t* buffer() override
   {
-    return m_data.data();
+    // Read-only access, an attached frame is sent as is
+    return static_cast<const CanvasBase*>(this)->data();
   }
 
   unsigned bufferSize() const override
@@ -67,7 +102,54 @@ public:
 
   const uint8_t* data() const override
   {
-    return m_data.data();
+    if (m_pFrame)
+    {
+      return m_pFrame;
+    }
+    if (!m_pData)
+    {
+      m_pData = BufferPool::instance().acquire(SIZE);
+    }
+    return m_pData.get();
+  }
+
+  void releaseBuffer() override
+  {
+    m_pFrame = nullptr;
+    BufferPool::instance().release(SIZE, std::move(m_pData));
+  }
+
+  size_t residentBytes() const override
+  {
+    return m_pData ? SIZE : 0;
+  }
+
+  bool swapBuffer(BufferPool::tBuffer& buffer_) override
+  {
+    if (!buffer_)
+    {
+      return false;
+    }
+    data();
+    std::swap(m_pData, buffer_);
+    setDirty();
+    return true;
+  }
+
+  bool attachFrame(const uint8_t* pFrame_) override
+  {
+    if (pFrame_ == nullptr)
+    {
+      return false;
+    }
+    m_pFrame = pFrame_;
+    setDirty();
+    return true;
+  }
+
+  void detachFrame() override
+  {
+    data();
   }
 
   /**
@@ -129,7 +211,17 @@ public:
 protected:
   uint8_t* data() override
   {
-    return m_data.data();
+    if (!m_pData)
+    {
+      m_pData = BufferPool::instance().acquire(SIZE);
+    }
+    if (m_pFrame)
+    {
+      // Copy on write
+      std::copy_n(m_pFrame, SIZE, m_pData.get());
+      m_pFrame = nullptr;
+    }
+    return m_pData.get();
   }
 
 private:
@@ -181,7 +273,8 @@ private:
 
 #pragma warning( pop )
 
-  std::array<uint8_t, SIZE> m_data{};               //!< The raw Canvas data
+  mutable BufferPool::tBuffer m_pData;              //!< The raw Canvas data, from the BufferPool
+  const uint8_t* m_pFrame{nullptr};                 //!< An attached frame, shown instead of m_pData
   mutable std::bitset<NCHUNKS> m_chunkDirtyFlags{}; //!< Chunk-specific dirty flags
 };
 
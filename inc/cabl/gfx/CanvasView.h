@@ -0,0 +1,147 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include "Canvas.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class CanvasView
+  \brief A rectangular window onto another canvas
+
+  The view has no pixel storage of its own: coordinates are translated and clipped, then every
+  draw call goes to the parent canvas, which takes care of the pixel format and of its dirty
+  chunks. The parent must outlive the view.
+*/
+
+class CanvasView : public Canvas
+{
+
+public:
+  //! Constructor
+  /*!
+   \param parent_  The canvas the view draws into
+   \param x_       The X coordinate of the upper-left corner of the view in the parent canvas
+   \param y_       The Y coordinate of the upper-left corner of the view in the parent canvas
+   \param w_       The width of the view, clipped to the parent canvas
+   \param h_       The height of the view, clipped to the parent canvas
+   */
+  CanvasView(Canvas& parent_, unsigned x_, unsigned y_, unsigned w_, unsigned h_);
+
+  unsigned width() const noexcept override
+  {
+    return m_width;
+  }
+
+  unsigned height() const noexcept override
+  {
+    return m_height;
+  }
+
+  unsigned canvasWidthInBytes() const override
+  {
+    return m_parent.canvasWidthInBytes();
+  }
+
+  unsigned numberOfChunks() const override
+  {
+    return m_parent.numberOfChunks();
+  }
+
+  unsigned xOffset() const noexcept
+  {
+    return m_x;
+  }
+
+  unsigned yOffset() const noexcept
+  {
+    return m_y;
+  }
+
+  Canvas& parent() const noexcept
+  {
+    return m_parent;
+  }
+
+  void white() override;
+  void black() override;
+  void invert() override;
+  void fill(uint8_t value_) override;
+  Color fillColor(uint8_t value_, unsigned x_, unsigned y_) const override;
+
+  void setPixel(
+    unsigned x_, unsigned y_, const Color& color_, bool bSetDirtyChunk_ = true) override;
+  Color pixel(unsigned x_, unsigned y_) const override;
+
+  //! The parent buffer, the view itself starts at xOffset(), yOffset()
+  const uint8_t* buffer() override
+  {
+    return m_parent.buffer();
+  }
+
+  unsigned bufferSize() const override
+  {
+    return m_parent.bufferSize();
+  }
+
+  const uint8_t* data() const override
+  {
+    return static_cast<const Canvas&>(m_parent).data();
+  }
+
+  //! Mark the parent chunks covered by the view as dirty
+  void setDirty() override;
+
+  //! Is any of the parent chunks covered by the view dirty?
+  bool dirty() const override;
+
+  bool dirtyChunk(unsigned chunk_) const override
+  {
+    return m_parent.dirtyChunk(chunk_);
+  }
+
+  void setDirtyChunk(unsigned yStart_) const override;
+
+  //! Dirty flags belong to the parent, which resets them once its content has been sent
+  void resetDirtyFlags() const override
+  {
+  }
+
+protected:
+  uint8_t* data() override
+  {
+    return const_cast<uint8_t*>(static_cast<const Canvas&>(m_parent).data());
+  }
+
+private:
+  //! TRUE if the view spans the whole parent, which then fills and inverts its buffer at once
+  bool coversParent() const
+  {
+    return m_x == 0 && m_y == 0 && m_width == m_parent.width() && m_height == m_parent.height();
+  }
+
+  //! Set every pixel of the view, the dirty flags are left untouched
+  void paint(const Color& color_);
+
+  Canvas& m_parent;
+  unsigned m_x;
+  unsigned m_y;
+  unsigned m_width;
+  unsigned m_height;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -61,7 +61,7 @@ public:
 
   const uint8_t* buffer() override
   {
-    return m_data.data();
+    return data();
   }
 
   unsigned bufferSize() const override
@@ -71,9 +71,23 @@ public:
 
   const uint8_t* data() const override
   {
+    if (m_data.empty())
+    {
+      m_data.resize(m_size);
+    }
     return m_data.data();
   }
 
+  void releaseBuffer() override
+  {
+    std::vector<uint8_t>().swap(m_data);
+  }
+
+  size_t residentBytes() const override
+  {
+    return m_data.capacity();
+  }
+
   /**
    * @defgroup Access Access and state queries functions
    * @ingroup GDisplay
@@ -142,6 +156,10 @@ public:
 protected:
   uint8_t* data() override
   {
+    if (m_data.empty())
+    {
+      m_data.resize(m_size);
+    }
     return m_data.data();
   }
 
@@ -152,7 +170,7 @@ private:
   unsigned m_size;
   unsigned m_nChunks;
 
-  std::vector<uint8_t> m_data;                 //!< The raw Canvas data
+  mutable std::vector<uint8_t> m_data;         //!< The raw Canvas data
   mutable std::vector<bool> m_chunkDirtyFlags; //!< Chunk-specific dirty flags
 };
 
@@ -0,0 +1,152 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "cabl/util/Types.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+class Canvas;
+class MappedFile;
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class FramePlayer
+  \brief Plays a file of pre-rendered frames on a graphic display
+
+  The file is a sequence of frames in the layout of the display pixel buffer (e.g. RGB565 with a
+  2048 bytes line stride for the Push 2 display, 1 bpp rows for the Maschine MK2 displays), each
+  one Canvas::bufferSize() bytes. The file is memory-mapped and each frame is attached to the
+  canvas by pointer (see Canvas::attachFrame()), so frames are neither copied nor converted before
+  being sent to the device.
+  Frames are paced against the time playback started from rather than against the previous frame,
+  so that timing errors don't accumulate; when update() is called late the frames that should have
+  been shown in the meantime are skipped and counted in droppedFrames().
+  The player must be used from the thread that renders the device, i.e. update() is meant to be
+  called from the render callback.
+*/
+
+class FramePlayer
+{
+public:
+  using tClock = std::chrono::steady_clock;
+
+  static constexpr double kDefaultFrameRate = 30.0;
+
+  FramePlayer(Canvas& canvas_);
+
+  ~FramePlayer();
+
+  FramePlayer(const FramePlayer&) = delete;
+  FramePlayer& operator=(const FramePlayer&) = delete;
+
+  //! Map a frame file and show its first frame
+  /*!
+     \param path_  The file path
+     \return       FALSE if the file can't be mapped, if its size isn't a multiple of the canvas
+                   buffer size or if the canvas doesn't support attached frames
+  */
+  bool open(const std::string& path_);
+
+  //! Stop playing and unmap the file, the canvas keeps a copy of the frame being shown
+  void close();
+
+  bool isOpen() const
+  {
+    return m_numFrames > 0;
+  }
+
+  size_t numFrames() const
+  {
+    return m_numFrames;
+  }
+
+  void setFrameRate(double framesPerSecond_);
+
+  double frameRate() const
+  {
+    return m_frameRate;
+  }
+
+  //! Restart from the first frame after the last one (enabled by default)
+  void setLooping(bool looping_)
+  {
+    m_looping = looping_;
+  }
+
+  bool looping() const
+  {
+    return m_looping;
+  }
+
+  //! Start playing from the current frame
+  void play(tClock::time_point now_ = tClock::now());
+
+  void stop()
+  {
+    m_playing = false;
+  }
+
+  bool playing() const
+  {
+    return m_playing;
+  }
+
+  //! Show a frame, playback continues from it
+  void seek(size_t frame_, tClock::time_point now_ = tClock::now());
+
+  size_t currentFrame() const
+  {
+    return m_currentFrame;
+  }
+
+  //! Number of frames skipped because update() wasn't called in time
+  uint64_t droppedFrames() const
+  {
+    return m_droppedFrames;
+  }
+
+  //! Show the frame due at the given time
+  /*!
+     \param now_  The current time
+     \return      TRUE if a different frame is being shown
+  */
+  bool update(tClock::time_point now_ = tClock::now());
+
+private:
+  void show(size_t frame_);
+
+  tClock::duration frameDuration(uint64_t nFrames_) const;
+
+  Canvas& m_canvas;
+  tPtr<MappedFile> m_pFile;
+  size_t m_frameSize{0};
+  size_t m_numFrames{0};
+
+  double m_frameRate{kDefaultFrameRate};
+  bool m_looping{true};
+  bool m_playing{false};
+
+  tClock::time_point m_start; //!< When frame 0 of the current pass was (or would have been) due
+  uint64_t m_position{0};     //!< Frames since m_start, not wrapped around
+  size_t m_currentFrame{0};
+  uint64_t m_droppedFrames{0};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,182 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Canvas.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class RgbaCanvas
+  \brief An offscreen canvas with 32 bit pixels and aligned rows
+
+  Pixels are stored as red, green, blue and alpha bytes, so that a pixel is a single word and
+  rows can be processed with vector loads and stores. Every row starts on a kRowAlignment
+  boundary, the stride is padded accordingly. This is the preferred source for blits toward the
+  device displays, which convert whole rows at once rather than pixel by pixel (see toRgb565()).
+  The alpha channel is opaque for every pixel drawn, and is otherwise ignored.
+*/
+
+class RgbaCanvas : public Canvas
+{
+public:
+  //! Alignment of the rows, in bytes
+  static constexpr unsigned kRowAlignment = 64;
+
+  RgbaCanvas(unsigned w_, unsigned h_, unsigned nChunks_ = 1);
+
+  RgbaCanvas(const RgbaCanvas& other_);
+  RgbaCanvas& operator=(const RgbaCanvas&) = delete;
+
+  unsigned width() const noexcept override
+  {
+    return m_width;
+  }
+
+  unsigned height() const noexcept override
+  {
+    return m_height;
+  }
+
+  unsigned canvasWidthInBytes() const noexcept override
+  {
+    return m_stride * sizeof(uint32_t);
+  }
+
+  unsigned numberOfChunks() const noexcept override
+  {
+    return m_nChunks;
+  }
+
+  //! Number of pixels from the start of a row to the start of the next one
+  unsigned stride() const noexcept
+  {
+    return m_stride;
+  }
+
+  //! The pixels of a row, aligned to kRowAlignment
+  const uint32_t* row(unsigned y_) const
+  {
+    return pixels() + y_ * m_stride;
+  }
+
+  //! The pixels of a row, the caller marks the dirty chunks
+  uint32_t* row(unsigned y_)
+  {
+    return pixels() + y_ * m_stride;
+  }
+
+  //! A pixel in the layout of the canvas
+  static uint32_t pack(uint8_t red_, uint8_t green_, uint8_t blue_, uint8_t alpha_ = 0xFF);
+
+  void fill(uint8_t value_) override;
+  void invert() override;
+
+  void setPixel(
+    unsigned x_, unsigned y_, const Color& color_, bool bSetDirtyChunk_ = true) override;
+  Color pixel(unsigned x_, unsigned y_) const override;
+
+  void lineHorizontal(unsigned x_, unsigned y_, unsigned w_, const Color& color_) override;
+
+  void putCanvas(const Canvas& c_,
+    unsigned xDest_,
+    unsigned yDest_,
+    unsigned xSource_ = 0,
+    unsigned ySource_ = 0,
+    unsigned w_ = 0,
+    unsigned h_ = 0) override;
+
+  //! Convert part of a row to 16 bit RGB565, big endian (as the Push 2 display)
+  /*!
+     \param x_      The X coordinate of the first pixel
+     \param y_      The row
+     \param w_      Number of pixels, which must be within the row
+     \param pDest_  Receives 2 * w_ bytes
+  */
+  void toRgb565(unsigned x_, unsigned y_, unsigned w_, uint8_t* pDest_) const;
+
+  //! Convert part of a row to 8 bit monochrome, the brightest channel of each pixel
+  /*!
+     \param x_      The X coordinate of the first pixel
+     \param y_      The row
+     \param w_      Number of pixels, which must be within the row
+     \param pDest_  Receives w_ bytes
+  */
+  void toMono(unsigned x_, unsigned y_, unsigned w_, uint8_t* pDest_) const;
+
+  const uint8_t* buffer() override
+  {
+    return data();
+  }
+
+  unsigned bufferSize() const override
+  {
+    return m_height * canvasWidthInBytes();
+  }
+
+  const uint8_t* data() const override
+  {
+    return reinterpret_cast<const uint8_t*>(pixels());
+  }
+
+  void releaseBuffer() override
+  {
+    std::vector<uint32_t>().swap(m_storage);
+  }
+
+  size_t residentBytes() const override
+  {
+    return m_storage.capacity() * sizeof(uint32_t);
+  }
+
+  void setDirty() override;
+  bool dirty() const override;
+  bool dirtyChunk(unsigned chunk_) const override;
+  void setDirtyChunk(unsigned yStart_) const override;
+  void resetDirtyFlags() const override;
+
+  tPtr<Canvas> clone() const override
+  {
+    return tPtr<Canvas>(new RgbaCanvas(*this));
+  }
+
+protected:
+  uint8_t* data() override
+  {
+    return reinterpret_cast<uint8_t*>(pixels());
+  }
+
+private:
+  static constexpr unsigned kWordsPerRowAlignment = kRowAlignment / sizeof(uint32_t);
+
+  //! The aligned pixel buffer, allocated (opaque black) if it has been released
+  uint32_t* pixels() const;
+
+  unsigned m_width;
+  unsigned m_height;
+  unsigned m_stride;
+  unsigned m_nChunks;
+
+  //! Over-allocated by one alignment, the pixels start at m_offset
+  mutable std::vector<uint32_t> m_storage;
+  mutable size_t m_offset{0};
+  mutable std::vector<bool> m_chunkDirtyFlags;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,138 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <initializer_list>
+#include <vector>
+
+#include "Canvas.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class SpanningCanvas
+  \brief A single logical drawing surface laid over several canvases
+
+  Each draw call is routed to the canvas that covers the pixel, with coordinates translated to
+  that canvas, so e.g. the two Maschine MK2 displays can be used as one 512x64 surface. The
+  logical size is the bounding box of all of the canvases, pixels falling in a gap are ignored.
+  The canvases must outlive the spanning canvas.
+*/
+
+class SpanningCanvas : public Canvas
+{
+
+public:
+  struct Region
+  {
+    Canvas* pCanvas;
+    unsigned x;
+    unsigned y;
+  };
+
+  using tCollRegions = std::vector<Region>;
+
+  SpanningCanvas() = default;
+
+  //! Constructor, places the canvases next to each other from left to right
+  /*!
+   \param canvases_  The canvases, in display order
+   */
+  SpanningCanvas(std::initializer_list<Canvas*> canvases_);
+
+  //! Add a canvas to the logical surface
+  /*!
+   \param pCanvas_  The canvas
+   \param x_        The X coordinate of its upper-left corner in the logical surface
+   \param y_        The Y coordinate of its upper-left corner in the logical surface
+   */
+  void addCanvas(Canvas* pCanvas_, unsigned x_, unsigned y_);
+
+  const tCollRegions& regions() const noexcept
+  {
+    return m_regions;
+  }
+
+  unsigned width() const noexcept override
+  {
+    return m_width;
+  }
+
+  unsigned height() const noexcept override
+  {
+    return m_height;
+  }
+
+  //! There is no contiguous backing store
+  unsigned canvasWidthInBytes() const noexcept override
+  {
+    return 0;
+  }
+
+  //! The chunks of all of the canvases, in the order they were added
+  unsigned numberOfChunks() const override;
+
+  void invert() override;
+  void fill(uint8_t value_) override;
+  Color fillColor(uint8_t value_, unsigned x_, unsigned y_) const override;
+
+  void setPixel(
+    unsigned x_, unsigned y_, const Color& color_, bool bSetDirtyChunk_ = true) override;
+  Color pixel(unsigned x_, unsigned y_) const override;
+
+  const uint8_t* buffer() override
+  {
+    return nullptr;
+  }
+
+  unsigned bufferSize() const override
+  {
+    return 0;
+  }
+
+  const uint8_t* data() const override
+  {
+    return nullptr;
+  }
+
+  void setDirty() override;
+
+  bool dirty() const override;
+
+  bool dirtyChunk(unsigned chunk_) const override;
+
+  void setDirtyChunk(unsigned yStart_) const override;
+
+  //! Dirty flags belong to the canvases, which reset them once their content has been sent
+  void resetDirtyFlags() const override
+  {
+  }
+
+protected:
+  uint8_t* data() override
+  {
+    return nullptr;
+  }
+
+private:
+  const Region* region(unsigned x_, unsigned y_) const;
+
+  tCollRegions m_regions;
+  unsigned m_width{0};
+  unsigned m_height{0};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
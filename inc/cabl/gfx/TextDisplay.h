@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <cstdint>
@@ -147,6 +148,20 @@ public:
 
   virtual unsigned dataSize() const = 0;
 
+  //! Overwrite the whole display content, e.g. with a copy of displayData()
+  /*!
+     \param pData_   The display data
+     \param length_  The data length, at most dataSize() bytes are copied
+  */
+  void setDisplayData(const uint8_t* pData_, size_t length_)
+  {
+    std::copy_n(pData_, std::min<size_t>(length_, dataSize()), data());
+    for (unsigned row = 0; row < height(); row++)
+    {
+      setDirty(row);
+    }
+  }
+
   /** @} */ // End of group Utility
 
   /** @} */ // End of group TextDisplay
@@ -0,0 +1,170 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cabl/util/Color.h"
+#include "cabl/util/Types.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+class Canvas;
+
+//--------------------------------------------------------------------------------------------------
+
+//! How text is laid out within a box
+struct TextStyle
+{
+  std::string font;                   //!< The font name, as passed to FontManager::getFont()
+  unsigned spacing{0};                //!< Pixels added between characters
+  unsigned lineSpacing{1};            //!< Pixels added between lines
+  Alignment alignment{Alignment::Left};
+  bool wrap{false};                   //!< Break lines between words to fit the box width
+  bool ellipsis{true};                //!< End truncated lines with "..." rather than clipping them
+};
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class TextLayout
+  \brief Measures, fits and draws text within a box, caching the laid-out text
+
+  Each (text, style, box size) combination is laid out once into a 1 bpp bitmap (a glyph run):
+  drawing it again, e.g. redrawing an unchanged label on every frame, is a single
+  Canvas::putBitmap() call. The least recently drawn runs are evicted once the cache holds
+  maxEntries() of them.
+  Text is split into lines at '\n'. Lines which don't fit the box width are wrapped (if enabled)
+  and then either truncated with an ellipsis or clipped; lines which don't fit the box height are
+  dropped, ending the last visible one with an ellipsis.
+*/
+
+class TextLayout
+{
+public:
+  static constexpr size_t kDefaultMaxEntries = 128;
+
+  TextLayout(size_t maxEntries_ = kDefaultMaxEntries);
+
+  //! Width in pixels covered by a line of text, from the first to the last glyph column
+  static unsigned measure(
+    const std::string& text_, const std::string& font_, unsigned spacing_ = 0);
+
+  //! Shorten a line of text to fit width_ pixels, ending it with "..." if it had to be shortened
+  static std::string ellipsize(const std::string& text_,
+    unsigned width_,
+    const std::string& font_,
+    unsigned spacing_ = 0);
+
+  //! Break a line of text between words so that each line fits width_ pixels
+  /*!
+     Words which are wider than width_ are broken between characters.
+  */
+  static std::vector<std::string> wrap(const std::string& text_,
+    unsigned width_,
+    const std::string& font_,
+    unsigned spacing_ = 0);
+
+  //! Lay out text within a width_ x height_ box, one string per line
+  static std::vector<std::string> layout(
+    const std::string& text_, unsigned width_, unsigned height_, const TextStyle& style_);
+
+  //! Draw text within the box at (x_, y_), laying it out only if it's not cached
+  void draw(Canvas& canvas_,
+    unsigned x_,
+    unsigned y_,
+    unsigned width_,
+    unsigned height_,
+    const std::string& text_,
+    const Color& color_,
+    const TextStyle& style_ = TextStyle());
+
+  //! Drop all of the cached runs
+  void clear();
+
+  size_t maxEntries() const
+  {
+    return m_maxEntries;
+  }
+
+  //! Number of cached runs
+  size_t size() const
+  {
+    return m_runs.size();
+  }
+
+  //! Number of draw() calls served from the cache
+  uint64_t hits() const
+  {
+    return m_hits;
+  }
+
+  //! Number of draw() calls which had to lay out the text
+  uint64_t misses() const
+  {
+    return m_misses;
+  }
+
+private:
+  //! What a run has been laid out from, compared field by field so that lookups don't allocate
+  struct Key
+  {
+    size_t hash;
+    std::string text;
+    unsigned boxWidth;
+    unsigned boxHeight;
+    TextStyle style;
+  };
+
+  struct Run
+  {
+    Key key;
+    unsigned width;  //!< Bitmap width, a multiple of 8 as required by Canvas::putBitmap()
+    unsigned height;
+    tRawData bitmap;
+  };
+
+  using tRuns = std::list<Run>;
+  using tIndex = std::unordered_multimap<size_t, tRuns::iterator>;
+
+  static size_t hash(
+    const std::string& text_, unsigned width_, unsigned height_, const TextStyle& style_);
+
+  static bool matches(const Key& key_,
+    const std::string& text_,
+    unsigned width_,
+    unsigned height_,
+    const TextStyle& style_);
+
+  //! The index entry of a run, all of the cached runs are indexed
+  tIndex::iterator indexEntry(tRuns::iterator run_);
+
+  static void render(Run& run_,
+    unsigned width_,
+    unsigned height_,
+    const std::string& text_,
+    const TextStyle& style_);
+
+  size_t m_maxEntries;
+  tRuns m_runs; //!< Most recently drawn first
+  tIndex m_index; //!< The runs by key hash
+  uint64_t m_hits{0};
+  uint64_t m_misses{0};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
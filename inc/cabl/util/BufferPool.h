@@ -0,0 +1,89 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class BufferPool
+  \brief A process-wide pool of raw buffers, grouped by size
+
+  Canvases give their pixel buffers back to the pool when their device disconnects, and a device
+  of the same kind plugged in later reuses them instead of allocating new ones. Idle buffers are
+  kept up to maxPooledBytes(), anything above that limit is freed.
+*/
+
+class BufferPool
+{
+public:
+  using tBuffer = std::unique_ptr<uint8_t[]>;
+
+  static constexpr size_t kDefaultMaxPooledBytes = 2 * 1024 * 1024;
+
+  static BufferPool& instance()
+  {
+    // Never destroyed, so canvases owned by other singletons can be released at exit
+    static BufferPool* pInstance = new BufferPool;
+    return *pInstance;
+  }
+
+  //! Get a zero-filled buffer, reusing an idle one of the same size if available
+  /*!
+     \param size_  The buffer size in bytes
+     \return       The buffer, or nullptr if size_ is 0
+  */
+  tBuffer acquire(size_t size_);
+
+  //! Give a buffer back to the pool
+  /*!
+     \param size_    The buffer size in bytes, as passed to acquire()
+     \param buffer_  The buffer
+  */
+  void release(size_t size_, tBuffer buffer_);
+
+  //! Free all idle buffers
+  void clear();
+
+  void setMaxPooledBytes(size_t maxPooledBytes_);
+
+  size_t maxPooledBytes() const;
+
+  //! Number of bytes currently held by idle buffers
+  size_t pooledBytes() const;
+
+  //! Number of bytes currently handed out to callers
+  size_t acquiredBytes() const;
+
+private:
+  BufferPool() = default;
+
+  void trim();
+
+  mutable std::mutex m_mtxBuffers;
+  std::map<size_t, std::vector<tBuffer>> m_buffers;
+  size_t m_pooledBytes{0};
+  size_t m_acquiredBytes{0};
+  size_t m_maxPooledBytes{kDefaultMaxPooledBytes};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
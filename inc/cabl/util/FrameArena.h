@@ -0,0 +1,154 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class FrameArena
+  \brief A bump allocator for scratch memory that only lives for the duration of a frame
+
+  Each device owns one, which is reset after every tick: the render callback and the code that
+  flushes the device state can use it for transient buffers instead of the heap. Requests that
+  don't fit are served from the heap, and the arena grows to the high-water mark on the next
+  reset, so that in steady state no frame allocates.
+*/
+
+class FrameArena
+{
+public:
+  static constexpr size_t kDefaultCapacity = 16 * 1024;
+
+  explicit FrameArena(size_t capacity_ = kDefaultCapacity);
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  //! Get a block of scratch memory, valid until the next reset()
+  /*!
+     \param size_       The block size in bytes
+     \param alignment_  The block alignment, must be a power of two
+     \return            The block, never nullptr
+  */
+  void* allocate(size_t size_, size_t alignment_ = alignof(std::max_align_t));
+
+  //! Get an uninitialized array of trivially destructible objects, valid until the next reset()
+  template <typename T>
+  T* allocate(size_t count_)
+  {
+    return static_cast<T*>(allocate(count_ * sizeof(T), alignof(T)));
+  }
+
+  //! Release all of the blocks, growing the arena if the last frame didn't fit
+  void reset();
+
+  size_t capacity() const
+  {
+    return m_capacity;
+  }
+
+  //! Number of bytes used in the current frame, including heap fallbacks
+  size_t used() const
+  {
+    return m_used;
+  }
+
+  //! Largest number of bytes used in a frame
+  size_t highWaterMark() const
+  {
+    return m_highWaterMark;
+  }
+
+  //! Number of blocks served from the heap because the arena was full
+  size_t fallbackAllocations() const
+  {
+    return m_fallbackAllocations;
+  }
+
+private:
+  std::unique_ptr<uint8_t[]> m_pBuffer;
+  size_t m_capacity;
+  size_t m_offset{0};
+  size_t m_used{0};
+
+  std::vector<std::unique_ptr<uint8_t[]>> m_fallbackBlocks;
+
+  // Can be read from other threads
+  std::atomic<size_t> m_highWaterMark{0};
+  std::atomic<size_t> m_fallbackAllocations{0};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class ArenaAllocator
+  \brief Standard allocator drawing from a FrameArena, e.g. for a std::vector of scratch data
+
+  Memory is only reclaimed when the arena is reset, the container must not outlive the frame.
+*/
+
+template <typename T>
+class ArenaAllocator
+{
+public:
+  using value_type = T;
+
+  ArenaAllocator(FrameArena& arena_) noexcept : m_pArena(&arena_)
+  {
+  }
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other_) noexcept : m_pArena(other_.arena())
+  {
+  }
+
+  T* allocate(size_t count_)
+  {
+    return m_pArena->allocate<T>(count_);
+  }
+
+  void deallocate(T*, size_t) noexcept
+  {
+  }
+
+  FrameArena* arena() const noexcept
+  {
+    return m_pArena;
+  }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other_) const noexcept
+  {
+    return m_pArena == other_.arena();
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other_) const noexcept
+  {
+    return m_pArena != other_.arena();
+  }
+
+private:
+  FrameArena* m_pArena;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,162 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+//! A row of a mapping table, e.g. a Device::Button and the device LED it's associated to
+template <typename K, typename V>
+struct Mapping
+{
+  K key;
+  V value;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+//! Number of values an enum with an 8 or 16 bit underlying type can take
+template <typename E>
+constexpr size_t enumRange()
+{
+  using tUnderlying = typename std::underlying_type<E>::type;
+  return static_cast<size_t>(std::numeric_limits<tUnderlying>::max()) + 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+namespace detail
+{
+
+template <size_t... Is>
+struct IndexSequence
+{
+};
+
+template <typename A, typename B>
+struct ConcatIndexSequences;
+
+template <size_t... As, size_t... Bs>
+struct ConcatIndexSequences<IndexSequence<As...>, IndexSequence<Bs...>>
+{
+  using type = IndexSequence<As..., (sizeof...(As) + Bs)...>;
+};
+
+// Logarithmic depth, so that 256-entry tables stay well below the template depth limit
+template <size_t N>
+struct MakeIndexSequence
+  : ConcatIndexSequences<typename MakeIndexSequence<N / 2>::type,
+      typename MakeIndexSequence<N - N / 2>::type>
+{
+};
+
+template <>
+struct MakeIndexSequence<0>
+{
+  using type = IndexSequence<>;
+};
+
+template <>
+struct MakeIndexSequence<1>
+{
+  using type = IndexSequence<0>;
+};
+
+template <typename K, typename V, size_t M>
+constexpr V findValue(const Mapping<K, V> (&table_)[M], K key_, V default_, size_t i_ = 0)
+{
+  return i_ == M ? default_
+                 : (table_[i_].key == key_ ? table_[i_].value
+                                           : findValue(table_, key_, default_, i_ + 1));
+}
+
+template <typename K, typename V, size_t M>
+constexpr K findKey(const Mapping<K, V> (&table_)[M], V value_, K default_, size_t i_ = 0)
+{
+  return i_ == M ? default_
+                 : (table_[i_].value == value_ ? table_[i_].key
+                                               : findKey(table_, value_, default_, i_ + 1));
+}
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class LookupTable
+  \brief A dense array generated at compile time from a mapping table
+
+  Replaces switch statements mapping one enum to another: the mapping is declared once as a
+  constexpr array of Mapping rows, either direction of it can be expanded into a LookupTable, and
+  each lookup is a bounds check and a load. Keys must convert to indices in [0, N), keys without a
+  row (and keys out of range) map to the default value.
+*/
+
+template <typename K, typename V, size_t N>
+class LookupTable
+{
+public:
+  struct Reverse
+  {
+  };
+
+  //! Expand a mapping table, using the first row when a key appears more than once
+  template <size_t M>
+  constexpr LookupTable(const Mapping<K, V> (&table_)[M], V default_)
+    : LookupTable(table_, default_, typename detail::MakeIndexSequence<N>::type{})
+  {
+  }
+
+  //! Expand the reverse of a mapping table, i.e. look up keys by value
+  template <size_t M>
+  constexpr LookupTable(const Mapping<V, K> (&table_)[M], V default_, Reverse)
+    : LookupTable(table_, default_, Reverse{}, typename detail::MakeIndexSequence<N>::type{})
+  {
+  }
+
+  constexpr V operator[](K key_) const noexcept
+  {
+    return static_cast<size_t>(key_) < N ? m_values[static_cast<size_t>(key_)] : m_default;
+  }
+
+  static constexpr size_t size()
+  {
+    return N;
+  }
+
+private:
+  template <size_t M, size_t... Is>
+  constexpr LookupTable(
+    const Mapping<K, V> (&table_)[M], V default_, detail::IndexSequence<Is...>)
+    : m_values{detail::findValue(table_, static_cast<K>(Is), default_)...}, m_default(default_)
+  {
+  }
+
+  template <size_t M, size_t... Is>
+  constexpr LookupTable(
+    const Mapping<V, K> (&table_)[M], V default_, Reverse, detail::IndexSequence<Is...>)
+    : m_values{detail::findKey(table_, static_cast<K>(Is), default_)...}, m_default(default_)
+  {
+  }
+
+  V m_values[N];
+  V m_default;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
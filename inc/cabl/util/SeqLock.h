@@ -0,0 +1,124 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class SeqLock
+  \brief A value written by a few threads and read by any number of threads without locking
+
+  Readers never block the writers: read() copies the value and retries if it was modified in the
+  meantime, so it is lock-free but not wait-free. Writers are serialized by spinning on the
+  sequence number, they are expected to be rare and short (e.g. an input event).
+  The value is published as a sequence of atomic words, which keeps concurrent copies well
+  defined.
+*/
+
+template <typename T>
+class SeqLock
+{
+  static_assert(std::is_trivially_copyable<T>::value, "The value must be trivially copyable");
+
+public:
+  SeqLock() = default;
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  //! Modify the value and publish it
+  /*!
+     \param modify_  Called with a reference to the value, which it may modify
+  */
+  template <class F>
+  void modify(F modify_) noexcept
+  {
+    uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+    do
+    {
+      while ((sequence & 1) != 0)
+      {
+        sequence = m_sequence.load(std::memory_order_relaxed);
+      }
+    } while (!m_sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire));
+    std::atomic_thread_fence(std::memory_order_release);
+
+    modify_(m_value);
+    tWords words{};
+    std::memcpy(words.data(), &m_value, sizeof(T));
+    for (size_t i = 0; i < kNumWords; i++)
+    {
+      m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    m_sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  //! Replace the value
+  void write(const T& value_) noexcept
+  {
+    modify([&value_](T& current_) { current_ = value_; });
+  }
+
+  //! A consistent copy of the value
+  T read() const noexcept
+  {
+    tWords words;
+    while (true)
+    {
+      uint32_t sequence = m_sequence.load(std::memory_order_acquire);
+      if ((sequence & 1) != 0)
+      {
+        continue;
+      }
+      for (size_t i = 0; i < kNumWords; i++)
+      {
+        words[i] = m_words[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (m_sequence.load(std::memory_order_relaxed) == sequence)
+      {
+        break;
+      }
+    }
+
+    T value;
+    std::memcpy(&value, words.data(), sizeof(T));
+    return value;
+  }
+
+  //! Number of times the value has been modified
+  uint32_t version() const noexcept
+  {
+    return m_sequence.load(std::memory_order_acquire) / 2;
+  }
+
+private:
+  static constexpr size_t kNumWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+  using tWords = std::array<uint32_t, kNumWords>;
+
+  std::atomic<uint32_t> m_sequence{0};
+  std::array<std::atomic<uint32_t>, kNumWords> m_words{};
+  T m_value{}; //!< Only accessed by the writer holding an odd sequence number
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,101 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class SpscQueue
+  \brief Bounded single-producer/single-consumer queue
+
+  push() and pop() are wait-free, never allocate and never lock, so the producer can be a
+  real-time thread (e.g. an audio callback). The storage is allocated along with the queue.
+  Exactly one thread may push and exactly one thread may pop at any given time.
+*/
+
+template <typename T, size_t N>
+class SpscQueue
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "The capacity must be a power of two");
+
+public:
+  //! Enqueue an element
+  /*!
+   \param value_  The element
+   \return        FALSE if the queue is full, in which case the element is dropped
+   */
+  bool push(const T& value_) noexcept
+  {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == N)
+    {
+      return false;
+    }
+
+    m_data[head & (N - 1)] = value_;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  //! Dequeue an element
+  /*!
+   \param value_  Receives the oldest element of the queue
+   \return        FALSE if the queue is empty
+   */
+  bool pop(T& value_) noexcept
+  {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+
+    value_ = m_data[tail & (N - 1)];
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const noexcept
+  {
+    return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+  }
+
+  size_t size() const noexcept
+  {
+    return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+  }
+
+  static constexpr size_t capacity() noexcept
+  {
+    return N;
+  }
+
+private:
+  static constexpr size_t kCacheLineSize = 64;
+
+  // Producer and consumer indices are padded apart to avoid false sharing. Padding rather than
+  // alignas, as over-aligned types can't be heap-allocated reliably before C++17.
+  std::atomic<size_t> m_head{0};
+  char m_padding[kCacheLineSize - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> m_tail{0};
+  std::array<T, N> m_data;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -40,44 +40,71 @@ Client::Client(DiscoveryPolicy discoveryPolicy_)
 Client::~Client()
 {
   Coordinator::instance().unregisterClient(m_clientId);
+
+  std::future<void> connecting;
+  {
+    std::lock_guard<std::mutex> lock(m_mtxConnecting);
+    m_connectPending = false;
+    connecting = std::move(m_connecting);
+  }
+  if (connecting.valid())
+  {
+    connecting.wait();
+  }
 }
 
 //--------------------------------------------------------------------------------------------------
 
-void Client::init()
+void Client::init(bool waitForDevice_)
 {
   devicesListChanged(Coordinator::instance().enumerate());
+  if (!waitForDevice_)
+  {
+    return;
+  }
+
+  std::future<void> connecting;
+  {
+    std::lock_guard<std::mutex> lock(m_mtxConnecting);
+    connecting = std::move(m_connecting);
+  }
+  if (connecting.valid())
+  {
+    connecting.wait();
+  }
 }
 
 //--------------------------------------------------------------------------------------------------
 
-void Client::onInitDevice()
+void Client::onInitDevice(Coordinator::tDevicePtr pDevice_)
 {
   M_LOG("[Client] onInitDevice");
 
-  if (!m_pDevice)
+  if (!pDevice_)
   {
     return;
   }
 
-  for (size_t i = 0; i < m_pDevice->numOfGraphicDisplays(); i++)
+  // Runs before the I/O thread serves the device, which then never sees it half set up
+  for (size_t i = 0; i < pDevice_->numOfGraphicDisplays(); i++)
   {
-    m_pDevice->graphicDisplay(i)->black();
+    pDevice_->graphicDisplay(i)->black();
   }
 
-  for (size_t i = 0; i < m_pDevice->numOfTextDisplays(); i++)
+  for (size_t i = 0; i < pDevice_->numOfTextDisplays(); i++)
   {
-    m_pDevice->textDisplay(i)->clear();
+    pDevice_->textDisplay(i)->clear();
   }
 
-  m_pDevice->setCallbackDisconnect(std::bind(&Client::disconnected, this));
-  m_pDevice->setCallbackRender(std::bind(&Client::onRender, this));
+  pDevice_->setCallbackDisconnect(std::bind(&Client::disconnected, this));
+  pDevice_->setCallbackRender(std::bind(&Client::onRender, this));
 
-  m_pDevice->setCallbackButtonChanged(std::bind(&Client::buttonChanged, this, _1, _2, _3));
-  m_pDevice->setCallbackEncoderChanged(std::bind(&Client::encoderChanged, this, _1, _2, _3));
-  m_pDevice->setCallbackKeyChanged(std::bind(&Client::keyChanged, this, _1, _2, _3));
-  m_pDevice->setCallbackControlChanged(std::bind(&Client::controlChanged, this, _1, _2, _3));
+  pDevice_->setCallbackButtonChanged(std::bind(&Client::buttonChanged, this, _1, _2, _3));
+  pDevice_->setCallbackEncoderChanged(std::bind(&Client::encoderChanged, this, _1, _2, _3));
+  pDevice_->setCallbackKeyChanged(std::bind(&Client::keyChanged, this, _1, _2, _3));
+  pDevice_->setCallbackControlChanged(std::bind(&Client::controlChanged, this, _1, _2, _3));
 
+  std::atomic_store(&m_pDevice, pDevice_);
   initDevice();
 
   m_update = true;
@@ -95,7 +122,8 @@ void Client::disconnected()
 void Client::onRender()
 {
   bool expected = true;
-  if (m_update.compare_exchange_weak(expected, false) && m_pDevice && m_pDevice->hasDeviceHandle())
+  Coordinator::tDevicePtr pDevice = device();
+  if (m_update.compare_exchange_weak(expected, false) && pDevice && pDevice->hasDeviceHandle())
   {
     render();
   }
@@ -150,17 +178,60 @@ void Client::devicesListChanged(Coordinator::tCollDeviceDescriptor deviceDescrip
 {
   M_LOG("[Client] devicesListChanged : " << deviceDescriptors_.size() << " devices");
 
-  for (const auto& deviceDescriptor : deviceDescriptors_)
   {
-    if (!m_discoveryPolicy.matches(deviceDescriptor))
+    std::lock_guard<std::mutex> lock(m_mtxConnecting);
+    m_pendingDeviceDescriptors = std::move(deviceDescriptors_);
+    bool connecting = m_connectPending;
+    m_connectPending = true;
+    if (connecting)
+    {
+      return; // The list is picked up once the device being connected is up
+    }
+
+    if (Coordinator::pumpMode() == Coordinator::PumpMode::Thread)
+    {
+      // The devices of several clients are brought up concurrently, and the caller (the I/O
+      // thread or the hotplug handler) is not held up while a device is being initialized
+      m_connecting = std::async(std::launch::async, &Client::connectPending, this);
+      return;
+    }
+  }
+
+  // The host application pumps the I/O loop and expects no thread of ours
+  connectPending();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Client::connectPending()
+{
+  while (true)
+  {
+    Coordinator::tCollDeviceDescriptor deviceDescriptors;
+    {
+      std::lock_guard<std::mutex> lock(m_mtxConnecting);
+      if (!m_connectPending || m_pendingDeviceDescriptors.empty())
+      {
+        m_connectPending = false;
+        return;
+      }
+      deviceDescriptors.swap(m_pendingDeviceDescriptors);
+    }
+
+    Coordinator::tDevicePtr pDevice = device();
+    if (pDevice && pDevice->hasDeviceHandle())
     {
       continue;
     }
-    if ((m_pDevice && !m_pDevice->hasDeviceHandle()) || !m_pDevice)
+
+    for (const auto& deviceDescriptor : deviceDescriptors)
     {
-      m_pDevice = Coordinator::instance().connect(deviceDescriptor);
-      onInitDevice();
-      break;
+      if (m_discoveryPolicy.matches(deviceDescriptor))
+      {
+        Coordinator::instance().connect(deviceDescriptor,
+          [this](Coordinator::tDevicePtr pDevice_) { onInitDevice(pDevice_); });
+        break;
+      }
     }
   }
 }
@@ -50,6 +50,20 @@ bool DeviceHandle::write(const Transfer& transfer_, uint8_t endpoint_)
 
 //--------------------------------------------------------------------------------------------------
 
+bool DeviceHandle::readBatch(tCollTransfers& transfers_, uint8_t endpoint_)
+{
+  return m_pImpl->readBatch(transfers_, endpoint_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool DeviceHandle::writeBatch(const tCollTransfers& transfers_, uint8_t endpoint_)
+{
+  return m_pImpl->writeBatch(transfers_, endpoint_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 void DeviceHandle::readAsync(uint8_t endpoint_, DeviceHandle::tCbRead cbRead_)
 {
   m_pImpl->readAsync(endpoint_, cbRead_);
@@ -57,5 +71,12 @@ void DeviceHandle::readAsync(uint8_t endpoint_, DeviceHandle::tCbRead cbRead_)
 
 //--------------------------------------------------------------------------------------------------
 
+bool DeviceHandle::poll(tCollTransfers& transfers_)
+{
+  return m_pImpl->poll(transfers_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 } // namespace cabl
 } // namespace sl
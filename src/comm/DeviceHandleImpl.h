@@ -8,6 +8,7 @@
 #pragma once
 
 #include "cabl/comm/DeviceHandle.h"
+#include "cabl/comm/Transfer.h"
 
 namespace sl
 {
@@ -16,10 +17,6 @@ namespace cabl
 
 //--------------------------------------------------------------------------------------------------
 
-class Transfer;
-
-//--------------------------------------------------------------------------------------------------
-
 class DeviceHandleImpl
 {
 
@@ -31,9 +28,37 @@ public:
   virtual bool read(Transfer&, uint8_t) = 0;
   virtual bool write(const Transfer&, uint8_t) = 0;
 
+  virtual bool readBatch(DeviceHandle::tCollTransfers& transfers_, uint8_t endpoint_)
+  {
+    Transfer transfer;
+    if (read(transfer, endpoint_) && transfer)
+    {
+      transfers_.push_back(std::move(transfer));
+      return true;
+    }
+    return false;
+  }
+
+  virtual bool writeBatch(const DeviceHandle::tCollTransfers& transfers_, uint8_t endpoint_)
+  {
+    for (const auto& transfer : transfers_)
+    {
+      if (!write(transfer, endpoint_))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
   virtual void readAsync(uint8_t, DeviceHandle::tCbRead)
   {
   }
+
+  virtual bool poll(DeviceHandle::tCollTransfers&)
+  {
+    return false;
+  }
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -21,6 +21,10 @@
 #include "comm/drivers/MIDI/DriverMIDI.h"
 #endif
 
+#if defined(CABL_USE_ALSA)
+#include "comm/drivers/ALSA/DriverALSA.h"
+#endif
+
 //--------------------------------------------------------------------------------------------------
 
 namespace sl
@@ -30,7 +34,7 @@ namespace cabl
 
 //--------------------------------------------------------------------------------------------------
 
-Driver::Driver(Type type_)
+Driver::Driver(Type type_, bool manualPump_)
 {
   switch (type_)
   {
@@ -47,11 +51,16 @@ Driver::Driver(Type type_)
       m_pImpl.reset(new DriverHIDAPI);
       break;
     case Type::LibUSB:
-      m_pImpl.reset(new DriverLibUSB);
+      m_pImpl.reset(new DriverLibUSB(manualPump_));
       break;
     case Type::MIDI:
       m_pImpl.reset(new DriverMIDI);
       break;
+#endif
+#if defined(CABL_USE_ALSA)
+    case Type::ALSA:
+      m_pImpl.reset(new DriverALSA(manualPump_));
+      break;
 #endif
     case Type::Probe:
     default:
@@ -83,5 +92,12 @@ void Driver::setHotplugCallback(Driver::tCbHotplug cbHotplug_)
 
 //--------------------------------------------------------------------------------------------------
 
+void Driver::poll(std::chrono::microseconds timeout_)
+{
+  m_pImpl->poll(timeout_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 } // namespace cabl
 } // namespace sl
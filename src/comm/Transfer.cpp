@@ -6,7 +6,9 @@
 ##########      ############################################################# shaduzlabs.com #####*/
 
 #include "cabl/comm/Transfer.h"
-#include <iostream>
+
+#include <algorithm>
+#include <cstring>
 
 namespace sl
 {
@@ -15,40 +17,144 @@ namespace cabl
 
 //--------------------------------------------------------------------------------------------------
 
+constexpr size_t Transfer::kInlineCapacity;
+
+//--------------------------------------------------------------------------------------------------
+
+bool operator==(const Transfer::View& lhs_, const Transfer::View& rhs_)
+{
+  return lhs_.size() == rhs_.size()
+         && (lhs_.size() == 0 || std::memcmp(lhs_.data(), rhs_.data(), lhs_.size()) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 Transfer::Transfer(unsigned length_)
 {
-  m_data.resize(length_);
+  std::fill_n(allocate(length_), length_, 0);
 }
 
 //--------------------------------------------------------------------------------------------------
 
-Transfer::Transfer(tRawData data_) : m_data(std::move(data_))
+Transfer::Transfer(std::initializer_list<uint8_t> data_)
 {
+  std::copy(data_.begin(), data_.end(), allocate(data_.size()));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Transfer::Transfer(tRawData data_)
+{
+  if (data_.size() <= kInlineCapacity)
+  {
+    std::copy(data_.begin(), data_.end(), allocate(data_.size()));
+    return;
+  }
+  // Large payloads are adopted rather than copied
+  m_size = data_.size();
+  m_heap = std::move(data_);
+  m_storage = Storage::Heap;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Transfer::Transfer(const uint8_t* pData_, size_t length_)
+{
+  std::copy(pData_, pData_ + length_, allocate(length_));
 }
 
 //--------------------------------------------------------------------------------------------------
 
 Transfer::Transfer(const tRawData& header_, const tRawData& data_)
 {
-  m_data.resize(header_.size() + data_.size());
-  std::copy(header_.begin(), header_.end(), m_data.begin());
-  std::copy(data_.begin(), data_.end(), &m_data[header_.size()]);
+  uint8_t* pData = allocate(header_.size() + data_.size());
+  std::copy(data_.begin(), data_.end(), std::copy(header_.begin(), header_.end(), pData));
 }
 
 //--------------------------------------------------------------------------------------------------
 
 Transfer::Transfer(const tRawData& header_, const uint8_t* pData_, size_t dataLength_)
 {
-  m_data.resize(header_.size() + dataLength_);
-  std::copy(header_.begin(), header_.end(), m_data.begin());
-  std::copy(pData_, pData_ + dataLength_, &m_data[header_.size()]);
+  uint8_t* pData = allocate(header_.size() + dataLength_);
+  std::copy(pData_, pData_ + dataLength_, std::copy(header_.begin(), header_.end(), pData));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Transfer::Transfer(
+  std::initializer_list<uint8_t> header_, const uint8_t* pData_, size_t dataLength_)
+{
+  uint8_t* pData = allocate(header_.size() + dataLength_);
+  std::copy(pData_, pData_ + dataLength_, std::copy(header_.begin(), header_.end(), pData));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Transfer::Transfer(const Transfer& other_)
+{
+  *this = other_;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Transfer::Transfer(Transfer&& other_) noexcept
+{
+  *this = std::move(other_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Transfer& Transfer::operator=(const Transfer& other_)
+{
+  if (this == &other_)
+  {
+    return *this;
+  }
+  // A copy owns its data, borrowed data included: it may outlive the lender
+  const uint8_t* pData = other_.bytes();
+  std::copy(pData, pData + other_.m_size, allocate(other_.m_size));
+  return *this;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Transfer& Transfer::operator=(Transfer&& other_) noexcept
+{
+  if (this == &other_)
+  {
+    return *this;
+  }
+  m_storage = other_.m_storage;
+  m_size = other_.m_size;
+  m_pBorrowed = other_.m_pBorrowed;
+  if (m_storage == Storage::Heap)
+  {
+    m_heap.swap(other_.m_heap);
+  }
+  else if (m_storage == Storage::Inline)
+  {
+    std::memcpy(m_inline.data(), other_.m_inline.data(), m_size);
+  }
+  other_.reset();
+  return *this;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Transfer Transfer::borrow(const uint8_t* pData_, size_t length_)
+{
+  Transfer transfer;
+  transfer.m_storage = Storage::Borrowed;
+  transfer.m_pBorrowed = pData_;
+  transfer.m_size = length_;
+  return transfer;
 }
 
 //--------------------------------------------------------------------------------------------------
 
 bool Transfer::operator==(const Transfer& other_) const
 {
-  return (m_data == other_.m_data);
+  return data() == other_.data();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -62,7 +168,10 @@ bool Transfer::operator!=(const Transfer& other_) const
 
 void Transfer::reset()
 {
-  m_data.clear();
+  m_storage = Storage::Inline;
+  m_size = 0;
+  m_pBorrowed = nullptr;
+  m_heap.clear();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -74,8 +183,36 @@ void Transfer::setData(const uint8_t* data_, size_t length_)
     return;
   }
 
-  m_data.resize(length_);
-  std::copy(data_, (data_ + length_), m_data.begin());
+  std::copy(data_, (data_ + length_), allocate(length_));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+uint8_t* Transfer::writableData()
+{
+  if (m_storage == Storage::Borrowed)
+  {
+    const uint8_t* pBorrowed = m_pBorrowed;
+    std::copy(pBorrowed, pBorrowed + m_size, allocate(m_size));
+  }
+  return const_cast<uint8_t*>(bytes());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+uint8_t* Transfer::allocate(size_t length_)
+{
+  m_size = length_;
+  m_pBorrowed = nullptr;
+  if (length_ <= kInlineCapacity)
+  {
+    m_storage = Storage::Inline;
+    m_heap.clear();
+    return m_inline.data();
+  }
+  m_storage = Storage::Heap;
+  m_heap.resize(length_);
+  return m_heap.data();
 }
 
 //--------------------------------------------------------------------------------------------------
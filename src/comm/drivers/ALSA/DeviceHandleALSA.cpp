@@ -0,0 +1,266 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "comm/drivers/ALSA/DeviceHandleALSA.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <poll.h>
+
+#include "cabl/util/Log.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+DeviceHandleALSA::DeviceHandleALSA(
+  snd_rawmidi_t* pMidiIn_, snd_rawmidi_t* pMidiOut_, bool manualPump_)
+  : m_pMidiIn(pMidiIn_), m_pMidiOut(pMidiOut_), m_manualPump(manualPump_)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+
+DeviceHandleALSA::~DeviceHandleALSA()
+{
+  disconnect();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void DeviceHandleALSA::disconnect()
+{
+  m_reading = false;
+  if (m_readThread.joinable())
+  {
+    m_readThread.join();
+  }
+
+  if (m_pMidiIn != nullptr)
+  {
+    snd_rawmidi_close(m_pMidiIn);
+    m_pMidiIn = nullptr;
+  }
+
+  if (m_pMidiOut != nullptr)
+  {
+    snd_rawmidi_close(m_pMidiOut);
+    m_pMidiOut = nullptr;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool DeviceHandleALSA::read(Transfer& transfer_, uint8_t /* endpoint_ */)
+{
+  if (m_reading)
+  {
+    return false; // The parser and the input buffer belong to the read thread
+  }
+
+  if (m_pending.empty())
+  {
+    DeviceHandle::tCollTransfers transfers;
+    receive(transfers);
+    std::move(transfers.begin(), transfers.end(), std::back_inserter(m_pending));
+  }
+
+  if (m_pending.empty())
+  {
+    return false;
+  }
+
+  transfer_ = std::move(m_pending.front());
+  m_pending.pop_front();
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool DeviceHandleALSA::write(const Transfer& transfer_, uint8_t /* endpoint_ */)
+{
+  return send(transfer_.data().data(), transfer_.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool DeviceHandleALSA::readBatch(DeviceHandle::tCollTransfers& transfers_, uint8_t /* endpoint_ */)
+{
+  if (m_reading)
+  {
+    return false; // The parser and the input buffer belong to the read thread
+  }
+
+  size_t nTransfers = transfers_.size();
+  std::move(m_pending.begin(), m_pending.end(), std::back_inserter(transfers_));
+  m_pending.clear();
+
+  receive(transfers_);
+  return transfers_.size() > nTransfers;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool DeviceHandleALSA::writeBatch(
+  const DeviceHandle::tCollTransfers& transfers_, uint8_t /* endpoint_ */)
+{
+  // Coalesce all messages into a single buffer so that they reach the kernel with one syscall
+  m_outputBuffer.clear();
+  for (const auto& transfer : transfers_)
+  {
+    m_outputBuffer.insert(m_outputBuffer.end(), transfer.data().begin(), transfer.data().end());
+  }
+
+  return send(m_outputBuffer.data(), m_outputBuffer.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void DeviceHandleALSA::readAsync(uint8_t /* endpoint_ */, DeviceHandle::tCbRead cbRead_)
+{
+  if (m_pMidiIn == nullptr || m_reading)
+  {
+    return;
+  }
+
+  m_cbRead = cbRead_;
+  if (m_manualPump)
+  {
+    return; // messages are dispatched by poll()
+  }
+
+  m_reading = true;
+  m_readThread = std::thread([this]() {
+    DeviceHandle::tCollTransfers transfers;
+    while (m_reading)
+    {
+      if (!waitForDescriptors(m_pMidiIn, POLLIN, kReadPollIntervalMs))
+      {
+        continue;
+      }
+
+      transfers.clear();
+      receive(transfers);
+      for (auto& transfer : transfers)
+      {
+        m_cbRead(std::move(transfer));
+      }
+    }
+  });
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool DeviceHandleALSA::poll(DeviceHandle::tCollTransfers& transfers_)
+{
+  if (!m_manualPump || !m_cbRead)
+  {
+    return false;
+  }
+
+  return readBatch(transfers_, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool DeviceHandleALSA::receive(DeviceHandle::tCollTransfers& transfers_)
+{
+  if (m_pMidiIn == nullptr)
+  {
+    return false;
+  }
+
+  while (true)
+  {
+    ssize_t nBytes = snd_rawmidi_read(m_pMidiIn, m_inputBuffer.data(), m_inputBuffer.size());
+    if (nBytes == -EAGAIN)
+    {
+      return true;
+    }
+    else if (nBytes < 0)
+    {
+      M_LOG("[DeviceHandleALSA] read error: " << snd_strerror(static_cast<int>(nBytes)));
+      return false;
+    }
+
+    m_parser.parse(m_inputBuffer.data(),
+      static_cast<size_t>(nBytes),
+      [&transfers_](const uint8_t* pMessage_, size_t length_) {
+        transfers_.emplace_back(pMessage_, length_);
+      });
+
+    if (static_cast<size_t>(nBytes) < m_inputBuffer.size())
+    {
+      return true;
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool DeviceHandleALSA::send(const uint8_t* pData_, size_t length_)
+{
+  if (m_pMidiOut == nullptr)
+  {
+    return false;
+  }
+
+  while (length_ > 0)
+  {
+    ssize_t nBytes = snd_rawmidi_write(m_pMidiOut, pData_, length_);
+    if (nBytes == -EAGAIN)
+    {
+      if (!waitForDescriptors(m_pMidiOut, POLLOUT, kWriteTimeoutMs))
+      {
+        M_LOG("[DeviceHandleALSA] write timeout");
+        return false;
+      }
+      continue;
+    }
+    else if (nBytes < 0)
+    {
+      M_LOG("[DeviceHandleALSA] write error: " << snd_strerror(static_cast<int>(nBytes)));
+      return false;
+    }
+
+    pData_ += nBytes;
+    length_ -= static_cast<size_t>(nBytes);
+  }
+
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool DeviceHandleALSA::waitForDescriptors(
+  snd_rawmidi_t* pRawMidi_, unsigned short events_, int timeoutMs_)
+{
+  std::array<struct pollfd, 4> descriptors;
+  int nDescriptors = std::min(snd_rawmidi_poll_descriptors_count(pRawMidi_),
+    static_cast<int>(descriptors.size()));
+  nDescriptors = snd_rawmidi_poll_descriptors(
+    pRawMidi_, descriptors.data(), static_cast<unsigned>(nDescriptors));
+
+  if (nDescriptors <= 0 || ::poll(descriptors.data(), nDescriptors, timeoutMs_) <= 0)
+  {
+    return false;
+  }
+
+  unsigned short revents = 0;
+  snd_rawmidi_poll_descriptors_revents(
+    pRawMidi_, descriptors.data(), static_cast<unsigned>(nDescriptors), &revents);
+  return (revents & events_) != 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
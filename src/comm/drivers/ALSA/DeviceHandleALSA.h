@@ -0,0 +1,73 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <thread>
+
+#include <alsa/asoundlib.h>
+
+#include "comm/DeviceHandleImpl.h"
+#include "comm/drivers/ALSA/RawMidiParser.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+class DeviceHandleALSA : public DeviceHandleImpl
+{
+public:
+  DeviceHandleALSA(snd_rawmidi_t* pMidiIn_, snd_rawmidi_t* pMidiOut_, bool manualPump_ = false);
+  ~DeviceHandleALSA() override;
+
+  void disconnect() override;
+
+  //! Fails while the read thread started by readAsync() consumes the input
+  bool read(Transfer&, uint8_t) override;
+  bool write(const Transfer&, uint8_t) override;
+
+  //! Fails while the read thread started by readAsync() consumes the input
+  bool readBatch(DeviceHandle::tCollTransfers&, uint8_t) override;
+  bool writeBatch(const DeviceHandle::tCollTransfers&, uint8_t) override;
+
+  void readAsync(uint8_t endpoint_, DeviceHandle::tCbRead) override;
+
+  bool poll(DeviceHandle::tCollTransfers&) override;
+
+  static constexpr size_t kInputBufferSize = 1024;
+  static constexpr int kWriteTimeoutMs = 50;
+  static constexpr int kReadPollIntervalMs = 20;
+
+private:
+  bool receive(DeviceHandle::tCollTransfers&);
+  bool send(const uint8_t* pData_, size_t length_);
+  bool waitForDescriptors(snd_rawmidi_t*, unsigned short events_, int timeoutMs_);
+
+  snd_rawmidi_t* m_pMidiIn{nullptr};
+  snd_rawmidi_t* m_pMidiOut{nullptr};
+  bool m_manualPump;
+
+  std::array<uint8_t, kInputBufferSize> m_inputBuffer;
+  RawMidiParser m_parser;
+  std::deque<Transfer> m_pending;
+  tRawData m_outputBuffer;
+
+  std::thread m_readThread;
+  std::atomic<bool> m_reading{false};
+  DeviceHandle::tCbRead m_cbRead;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
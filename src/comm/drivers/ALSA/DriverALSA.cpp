@@ -0,0 +1,238 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "DriverALSA.h"
+
+#include <chrono>
+#include <future>
+#include <set>
+#include <thread>
+
+#include "DeviceHandleALSA.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+DriverALSA::DriverALSA(bool manualPump_) : m_manualPump(manualPump_)
+{
+  M_LOG("[DriverALSA] initialization");
+}
+
+//--------------------------------------------------------------------------------------------------
+
+DriverALSA::~DriverALSA()
+{
+  M_LOG("[DriverALSA] exit");
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Driver::tCollDeviceDescriptor DriverALSA::enumerate()
+{
+  M_LOG("[DriverALSA] enumerate");
+  Driver::tCollDeviceDescriptor collDevices;
+  std::set<std::string> presentPorts;
+  std::vector<std::future<void>> pendingFutures;
+
+  for (const auto& port : ports())
+  {
+    std::string key{port.hwId + "/" + port.name};
+    presentPorts.insert(key);
+
+    {
+      std::lock_guard<std::mutex> lock(m_mtxIdentities);
+      if (m_identities.find(key) != m_identities.end())
+      {
+        continue;
+      }
+    }
+
+    M_LOG("[DriverALSA] probing " << port.name << " (" << port.hwId << ")");
+    pendingFutures.push_back(std::async(std::launch::async, [this, port, key]() {
+      DeviceDescriptor deviceDescriptor(port.name, DeviceDescriptor::Type::Unknown, 0, 0);
+      if (identify(port, deviceDescriptor))
+      {
+        std::lock_guard<std::mutex> lock(m_mtxIdentities);
+        m_identities.emplace(key, deviceDescriptor);
+      }
+    }));
+  }
+
+  for (auto& f : pendingFutures)
+  {
+    f.wait();
+  }
+
+  std::lock_guard<std::mutex> lock(m_mtxIdentities);
+  auto it = m_identities.begin();
+  while (it != m_identities.end())
+  {
+    if (presentPorts.find(it->first) == presentPorts.end())
+    {
+      it = m_identities.erase(it);
+      continue;
+    }
+
+    if (it->second)
+    {
+      collDevices.push_back(it->second);
+    }
+    it++;
+  }
+
+  return collDevices;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+tPtr<DeviceHandleImpl> DriverALSA::connect(const DeviceDescriptor& device_)
+{
+  M_LOG("[DriverALSA] connecting to " << device_.name() << ":" << device_.vendorId() << ":"
+                                      << device_.productId());
+
+  snd_rawmidi_t* pMidiIn = nullptr;
+  snd_rawmidi_t* pMidiOut = nullptr;
+  std::string portHwId{hwId(device_.portIdIn())};
+  int result = snd_rawmidi_open(&pMidiIn, &pMidiOut, portHwId.c_str(), SND_RAWMIDI_NONBLOCK);
+  if (result < 0)
+  {
+    M_LOG("[DriverALSA] cannot open " << portHwId << ": " << snd_strerror(result));
+    return nullptr;
+  }
+
+  return tPtr<DeviceHandleImpl>(new DeviceHandleALSA(pMidiIn, pMidiOut, m_manualPump));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+DriverALSA::tCollPorts DriverALSA::ports()
+{
+  tCollPorts collPorts;
+
+  snd_rawmidi_info_t* pInfo;
+  snd_rawmidi_info_alloca(&pInfo);
+
+  int card = -1;
+  while (snd_card_next(&card) >= 0 && card >= 0)
+  {
+    snd_ctl_t* pCtl;
+    std::string ctlName{"hw:" + std::to_string(card)};
+    if (snd_ctl_open(&pCtl, ctlName.c_str(), 0) < 0)
+    {
+      continue;
+    }
+
+    int device = -1;
+    while (snd_ctl_rawmidi_next_device(pCtl, &device) >= 0 && device >= 0)
+    {
+      snd_rawmidi_info_set_device(pInfo, static_cast<unsigned>(device));
+      snd_rawmidi_info_set_subdevice(pInfo, 0);
+
+      snd_rawmidi_info_set_stream(pInfo, SND_RAWMIDI_STREAM_OUTPUT);
+      if (snd_ctl_rawmidi_info(pCtl, pInfo) < 0)
+      {
+        continue;
+      }
+      unsigned nSubdevicesOut = snd_rawmidi_info_get_subdevices_count(pInfo);
+
+      snd_rawmidi_info_set_stream(pInfo, SND_RAWMIDI_STREAM_INPUT);
+      if (snd_ctl_rawmidi_info(pCtl, pInfo) < 0)
+      {
+        continue;
+      }
+      unsigned nSubdevicesIn = snd_rawmidi_info_get_subdevices_count(pInfo);
+
+      for (unsigned sub = 0; sub < std::min(nSubdevicesIn, nSubdevicesOut); sub++)
+      {
+        snd_rawmidi_info_set_subdevice(pInfo, sub);
+        if (snd_ctl_rawmidi_info(pCtl, pInfo) < 0)
+        {
+          continue;
+        }
+
+        std::string name{snd_rawmidi_info_get_subdevice_name(pInfo)};
+        if (name.empty())
+        {
+          name = snd_rawmidi_info_get_name(pInfo);
+        }
+
+        unsigned portId = (static_cast<unsigned>(card) << 16)
+                          | (static_cast<unsigned>(device) << 8) | sub;
+        collPorts.push_back({hwId(portId), name, portId});
+      }
+    }
+    snd_ctl_close(pCtl);
+  }
+
+  return collPorts;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::string DriverALSA::hwId(unsigned portId_)
+{
+  return "hw:" + std::to_string((portId_ >> 16) & 0xFF) + "," + std::to_string((portId_ >> 8) & 0xFF)
+         + "," + std::to_string(portId_ & 0xFF);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool DriverALSA::identify(const Port& port_, DeviceDescriptor& deviceDescriptor_)
+{
+  snd_rawmidi_t* pMidiIn = nullptr;
+  snd_rawmidi_t* pMidiOut = nullptr;
+  if (snd_rawmidi_open(&pMidiIn, &pMidiOut, port_.hwId.c_str(), SND_RAWMIDI_NONBLOCK) < 0)
+  {
+    // Busy or gone: don't cache anything, try again on the next scan
+    return false;
+  }
+
+  DeviceHandleALSA handle(pMidiIn, pMidiOut);
+  if (!handle.write(Transfer({0xF0, 0x7E, 0x00, 0x06, 0x01, 0xF7}), 0))
+  {
+    return true;
+  }
+
+  DeviceHandle::tCollTransfers transfers;
+  auto start = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(kIdentityTimeoutMs))
+  {
+    transfers.clear();
+    handle.readBatch(transfers, 0);
+    for (const auto& reply : transfers)
+    {
+      if (reply.size() >= 8 && reply[0] == 0xF0 && reply[1] == 0x7E && reply[3] == 0x06
+          && reply[4] == 0x02)
+      {
+        unsigned vendorId = reply[5];
+        unsigned productId = (reply[6] << 8) | reply[7];
+        deviceDescriptor_ = DeviceDescriptor(port_.name,
+          DeviceDescriptor::Type::MIDI,
+          vendorId,
+          productId,
+          "",
+          port_.portId,
+          port_.portId);
+        M_LOG("[DriverALSA] found device: " << vendorId << ":" << productId);
+        return true;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  M_LOG("[DriverALSA] identity reply timeout on " << port_.hwId);
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,73 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <alsa/asoundlib.h>
+
+#include "comm/DeviceHandleImpl.h"
+#include "comm/DriverImpl.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class DriverALSA
+  \brief Native Linux MIDI driver based on ALSA rawmidi
+
+  Ports are discovered through the control interface, so enumerating never opens a port. The
+  identity request is only sent the first time a port shows up, and its result is cached until the
+  port disappears.
+*/
+
+class DriverALSA : public DriverImpl
+{
+public:
+  struct Port
+  {
+    std::string hwId;
+    std::string name;
+    unsigned portId;
+  };
+
+  using tCollPorts = std::vector<Port>;
+
+  DriverALSA(bool manualPump_ = false);
+  ~DriverALSA() override;
+
+  Driver::tCollDeviceDescriptor enumerate() override;
+  tPtr<DeviceHandleImpl> connect(const DeviceDescriptor&) override;
+
+  //! List the rawmidi ports that have both an input and an output stream, without opening them
+  static tCollPorts ports();
+
+  static std::string hwId(unsigned portId_);
+
+  static constexpr int kIdentityTimeoutMs = 500;
+
+private:
+  static bool identify(const Port&, DeviceDescriptor&);
+
+  bool m_manualPump;
+
+  std::mutex m_mtxIdentities;
+  std::map<std::string, DeviceDescriptor> m_identities;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
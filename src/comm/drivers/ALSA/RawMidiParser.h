@@ -0,0 +1,158 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "cabl/util/Types.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class RawMidiParser
+  \brief Splits a raw MIDI byte stream into complete messages
+
+  Handles running status, system exclusive messages and realtime bytes interleaved with other
+  messages. The parser keeps its state between calls, so a message may be split across reads.
+*/
+
+class RawMidiParser
+{
+public:
+  //! Parse a chunk of the byte stream
+  /*!
+     \param pData_      Pointer to the received bytes
+     \param length_     Number of received bytes
+     \param cbMessage_  Invoked as cbMessage_(const uint8_t*, size_t) for each complete message
+  */
+  template <typename TCallback>
+  void parse(const uint8_t* pData_, size_t length_, TCallback&& cbMessage_)
+  {
+    for (size_t i = 0; i < length_; i++)
+    {
+      uint8_t byte = pData_[i];
+
+      if (byte >= 0xF8)
+      {
+        cbMessage_(&byte, 1);
+        continue;
+      }
+
+      if (m_inSysex)
+      {
+        if (byte & 0x80)
+        {
+          m_inSysex = false;
+          if (byte == 0xF7)
+          {
+            m_sysex.push_back(byte);
+            cbMessage_(m_sysex.data(), m_sysex.size());
+            continue;
+          }
+        }
+        else
+        {
+          m_sysex.push_back(byte);
+          continue;
+        }
+      }
+
+      if (byte == 0xF0)
+      {
+        m_runningStatus = 0;
+        m_inSysex = true;
+        m_sysex.clear();
+        m_sysex.push_back(byte);
+      }
+      else if (byte & 0x80)
+      {
+        m_runningStatus = (byte < 0xF0) ? byte : 0;
+        m_message[0] = byte;
+        m_length = 1;
+        m_expected = dataLength(byte);
+        if (m_expected == 0)
+        {
+          if (byte != 0xF7)
+          {
+            cbMessage_(m_message.data(), 1);
+          }
+          m_length = 0;
+        }
+      }
+      else if (m_length > 0 || m_runningStatus != 0)
+      {
+        if (m_length == 0)
+        {
+          m_message[0] = m_runningStatus;
+          m_length = 1;
+          m_expected = dataLength(m_runningStatus);
+        }
+        m_message[m_length++] = byte;
+        if (m_length > m_expected)
+        {
+          cbMessage_(m_message.data(), m_length);
+          m_length = 0;
+        }
+      }
+    }
+  }
+
+  void reset()
+  {
+    m_runningStatus = 0;
+    m_length = 0;
+    m_expected = 0;
+    m_inSysex = false;
+    m_sysex.clear();
+  }
+
+private:
+  static unsigned dataLength(uint8_t status_)
+  {
+    switch (status_ & 0xF0)
+    {
+      case 0xC0:
+      case 0xD0:
+        return 1;
+      case 0xF0:
+      {
+        switch (status_)
+        {
+          case 0xF1:
+          case 0xF3:
+            return 1;
+          case 0xF2:
+            return 2;
+          default:
+            return 0;
+        }
+      }
+      default:
+        return 2;
+    }
+  }
+
+  uint8_t m_runningStatus{0};
+  unsigned m_length{0};
+  unsigned m_expected{0};
+  std::array<uint8_t, 3> m_message{};
+
+  bool m_inSysex{false};
+  tRawData m_sysex;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
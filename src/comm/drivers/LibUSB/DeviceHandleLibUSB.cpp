@@ -116,8 +116,10 @@ void DeviceHandleLibUSB::readAsyncImpl(uint8_t endpoint_)
     cbTransfer,
     this,
     kLibUSBReadTimeout);
-  libusb_submit_transfer(pTransfer);
-  //!\todo check libusb_submit_transfer return code
+  if (libusb_submit_transfer(pTransfer) != LIBUSB_SUCCESS)
+  {
+    libusb_free_transfer(pTransfer);
+  }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -128,13 +130,15 @@ void DeviceHandleLibUSB::cbTransfer(libusb_transfer* pTransfer_)
   if (pSelf->m_cbRead && pTransfer_->status == LIBUSB_TRANSFER_COMPLETED
       && pTransfer_->actual_length > 0)
   {
-    tRawData data(pTransfer_->buffer, pTransfer_->buffer + pTransfer_->actual_length);
-    pSelf->m_cbRead({data});
+    pSelf->m_cbRead(
+      Transfer(pTransfer_->buffer, static_cast<size_t>(pTransfer_->actual_length)));
   }
-  if (pSelf->m_pCurrentDevice)
+  // The transfer is resubmitted as is, rather than allocating a new one for every read
+  if (pSelf->m_pCurrentDevice && libusb_submit_transfer(pTransfer_) == LIBUSB_SUCCESS)
   {
-    pSelf->readAsyncImpl(pTransfer_->endpoint);
+    return;
   }
+  libusb_free_transfer(pTransfer_);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -96,7 +96,7 @@ namespace cabl
 
 //--------------------------------------------------------------------------------------------------
 
-DriverLibUSB::DriverLibUSB() : m_usbThreadRunning(true)
+DriverLibUSB::DriverLibUSB(bool manualPump_) : m_usbThreadRunning(!manualPump_)
 {
   libusb_init(&m_pContext);
 #if !defined(NDEBUG)
@@ -114,13 +114,16 @@ DriverLibUSB::DriverLibUSB() : m_usbThreadRunning(true)
     this,
     m_pHotplugHandle);
 
-  m_usbThread = std::thread([this]() {
-    while (m_usbThreadRunning)
-    {
-      libusb_handle_events(m_pContext);
-      //      std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
-  });
+  if (m_usbThreadRunning)
+  {
+    m_usbThread = std::thread([this]() {
+      while (m_usbThreadRunning)
+      {
+        libusb_handle_events(m_pContext);
+        //      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+  }
 
   M_LOG("[LibUSB] initialization");
 }
@@ -183,6 +186,7 @@ Driver::tCollDeviceDescriptor DriverLibUSB::enumerate()
     libusb_close(pHandle);
     DeviceDescriptor deviceDescriptor(
       strProd, DeviceDescriptor::Type::USB, descriptor.idVendor, descriptor.idProduct, strSerialNum);
+    deviceDescriptor.setUsbLocation(libusb_get_bus_number(device), libusb_get_port_number(device));
     collDeviceDescriptor.push_back(deviceDescriptor);
   }
 
@@ -254,6 +258,21 @@ void DriverLibUSB::setHotplugCallback(Driver::tCbHotplug cbHotplug_)
 
 //--------------------------------------------------------------------------------------------------
 
+void DriverLibUSB::poll(std::chrono::microseconds timeout_)
+{
+  if (m_usbThread.joinable())
+  {
+    return; // events are handled by the driver thread
+  }
+
+  struct timeval tv;
+  tv.tv_sec = static_cast<long>(timeout_.count() / 1000000);
+  tv.tv_usec = static_cast<long>(timeout_.count() % 1000000);
+  libusb_handle_events_timeout_completed(m_pContext, &tv, nullptr);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 void DriverLibUSB::hotplug(const DeviceDescriptor& deviceDescriptor_, bool plugged_)
 {
   if (m_cbHotplug)
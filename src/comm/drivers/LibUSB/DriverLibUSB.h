@@ -28,13 +28,14 @@ namespace cabl
 class DriverLibUSB : public DriverImpl
 {
 public:
-  DriverLibUSB();
+  DriverLibUSB(bool manualPump_ = false);
   ~DriverLibUSB() override;
 
   Driver::tCollDeviceDescriptor enumerate() override;
   tPtr<DeviceHandleImpl> connect(const DeviceDescriptor&) override;
 
   void setHotplugCallback(Driver::tCbHotplug) override;
+  void poll(std::chrono::microseconds) override;
 
   void hotplug(const DeviceDescriptor&, bool);
 
@@ -51,7 +51,13 @@ void DeviceHandleMIDI::disconnect()
 
 bool DeviceHandleMIDI::read(Transfer& transfer_, uint8_t /* endpoint_ */)
 {
-  m_midiIn.getMessage(const_cast<std::vector<unsigned char>*>(&(transfer_.data())));
+  m_midiIn.getMessage(&m_inputMessage);
+  if (m_inputMessage.empty())
+  {
+    transfer_.reset();
+    return false;
+  }
+  transfer_.setData(m_inputMessage.data(), m_inputMessage.size());
   return transfer_;
 }
 
@@ -61,7 +67,9 @@ bool DeviceHandleMIDI::write(const Transfer& transfer_, uint8_t /* endpoint_ */)
 {
   try
   {
-    m_midiOut.sendMessage(const_cast<std::vector<unsigned char>*>(&(transfer_.data())));
+    // RtMidi only sends vectors, whose capacity is reused from one message to the next
+    m_outputMessage.assign(transfer_.data().begin(), transfer_.data().end());
+    m_midiOut.sendMessage(&m_outputMessage);
   }
   catch (RtMidiError)
   {
@@ -73,6 +81,25 @@ bool DeviceHandleMIDI::write(const Transfer& transfer_, uint8_t /* endpoint_ */)
 
 //--------------------------------------------------------------------------------------------------
 
+bool DeviceHandleMIDI::readBatch(DeviceHandle::tCollTransfers& transfers_, uint8_t /* endpoint_ */)
+{
+  bool received{false};
+  std::vector<unsigned char> message;
+  while (true)
+  {
+    m_midiIn.getMessage(&message);
+    if (message.empty())
+    {
+      break;
+    }
+    transfers_.emplace_back(message.data(), message.size());
+    received = true;
+  }
+  return received;
+}
+
+//--------------------------------------------------------------------------------------------------
+
 void DeviceHandleMIDI::readAsync(uint8_t /* endpoint_ */, DeviceHandle::tCbRead cbRead_)
 {
   m_cbRead = cbRead_;
@@ -90,7 +117,7 @@ void DeviceHandleMIDI::onMidiMessage(
   }
 
   DeviceHandleMIDI* pSelf = static_cast<DeviceHandleMIDI*>(pUserData_);
-  pSelf->m_cbRead(tRawData{pMessage_->begin(), pMessage_->end()});
+  pSelf->m_cbRead(Transfer(pMessage_->data(), pMessage_->size()));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -38,6 +38,8 @@ public:
   bool read(Transfer&, uint8_t) override;
   bool write(const Transfer&, uint8_t) override;
 
+  bool readBatch(DeviceHandle::tCollTransfers&, uint8_t) override;
+
   void readAsync(uint8_t endpoint_, DeviceHandle::tCbRead) override;
 
   static void onMidiMessage(
@@ -48,6 +50,9 @@ private:
   RtMidiOut m_midiOut;
 
   DeviceHandle::tCbRead m_cbRead;
+
+  std::vector<unsigned char> m_inputMessage;
+  std::vector<unsigned char> m_outputMessage;
 };
 
 //--------------------------------------------------------------------------------------------------
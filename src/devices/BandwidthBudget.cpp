@@ -0,0 +1,177 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/devices/BandwidthBudget.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+constexpr std::chrono::milliseconds TrafficMeter::kMaxBurst;
+constexpr double BandwidthBudget::kDefaultBusCapacity;
+constexpr double BandwidthBudget::kMinDisplayShare;
+constexpr std::chrono::milliseconds BandwidthBudget::kUpdateInterval;
+
+//--------------------------------------------------------------------------------------------------
+
+void TrafficMeter::add(Traffic traffic_, size_t bytes_) noexcept
+{
+  m_bytes[static_cast<size_t>(traffic_)].fetch_add(bytes_, std::memory_order_relaxed);
+  if (traffic_ == Traffic::Display && m_displayAllowance > 0.0)
+  {
+    // std::atomic<double> has no fetch_sub() before C++20
+    double credit = m_displayCredit.load(std::memory_order_relaxed);
+    while (!m_displayCredit.compare_exchange_weak(
+      credit, credit - static_cast<double>(bytes_), std::memory_order_relaxed))
+    {
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TrafficMeter::Rates TrafficMeter::sample(tClock::time_point now_)
+{
+  double elapsed = std::chrono::duration<double>(now_ - m_lastSample).count();
+  m_lastSample = now_;
+
+  std::array<double, static_cast<size_t>(Traffic::Count)> rates{};
+  for (size_t i = 0; i < rates.size(); i++)
+  {
+    uint64_t bytes = m_bytes[i];
+    if (elapsed > 0.0)
+    {
+      rates[i] = static_cast<double>(bytes - m_sampledBytes[i]) / elapsed;
+    }
+    m_sampledBytes[i] = bytes;
+  }
+
+  return {rates[static_cast<size_t>(Traffic::Input)],
+    rates[static_cast<size_t>(Traffic::Leds)],
+    rates[static_cast<size_t>(Traffic::Display)],
+    m_displayDeferred.exchange(false)};
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void TrafficMeter::setDisplayAllowance(double bytesPerSecond_)
+{
+  m_displayAllowance = std::max(bytesPerSecond_, 0.0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool TrafficMeter::displayFrameDue(tClock::time_point now_)
+{
+  double allowance = m_displayAllowance;
+  if (allowance <= 0.0)
+  {
+    return true;
+  }
+
+  double elapsed = std::chrono::duration<double>(now_ - m_lastRefill).count();
+  m_lastRefill = now_;
+  double maxCredit = allowance * std::chrono::duration<double>(kMaxBurst).count();
+  double credit = m_displayCredit.load(std::memory_order_relaxed);
+  double refilled = 0.0;
+  do
+  {
+    refilled = std::min(credit + allowance * elapsed, maxCredit);
+  } while (!m_displayCredit.compare_exchange_weak(credit, refilled, std::memory_order_relaxed));
+
+  // A frame larger than the credit is still sent, the following ones wait for the debt to be paid
+  if (refilled > 0.0)
+  {
+    return true;
+  }
+  m_displayDeferred = true;
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::vector<double> BandwidthBudget::allocate(const std::vector<Demand>& demands_) const
+{
+  std::vector<double> allowances(demands_.size(), 0.0);
+
+  std::map<unsigned, std::vector<size_t>> buses;
+  for (size_t i = 0; i < demands_.size(); i++)
+  {
+    if (demands_[i].bus != 0)
+    {
+      buses[demands_[i].bus].push_back(i);
+    }
+  }
+
+  for (const auto& bus : buses)
+  {
+    double capacity = busCapacity(bus.first);
+    double available = capacity;
+    std::vector<double> displayDemands;
+    for (size_t i : bus.second)
+    {
+      const TrafficMeter::Rates& rates = demands_[i].rates;
+      available -= rates.input + rates.leds;
+      // A device whose frames are being deferred would use more than it got
+      displayDemands.push_back(
+        rates.displayDeferred ? std::numeric_limits<double>::infinity() : rates.display);
+    }
+    available = std::max(available, capacity * kMinDisplayShare);
+
+    // Max-min fair share: the displays needing less than an equal share are served in full, and
+    // the others split what remains
+    std::sort(displayDemands.begin(), displayDemands.end());
+    double share = 0.0;
+    size_t nLeft = displayDemands.size();
+    for (double demand : displayDemands)
+    {
+      if (demand * nLeft > available)
+      {
+        share = available / nLeft;
+        break;
+      }
+      available -= demand;
+      nLeft--;
+    }
+
+    if (share > 0.0)
+    {
+      for (size_t i : bus.second)
+      {
+        allowances[i] = share;
+      }
+    }
+  }
+
+  return allowances;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void BandwidthBudget::setBusCapacity(unsigned bus_, double bytesPerSecond_)
+{
+  m_busCapacities[bus_] = bytesPerSecond_;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+double BandwidthBudget::busCapacity(unsigned bus_) const
+{
+  auto it = m_busCapacities.find(bus_);
+  return it != m_busCapacities.end() ? it->second : kDefaultBusCapacity;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,234 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/devices/CallbackDispatcher.h"
+
+#include "cabl/util/Log.h"
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+using namespace sl::cabl;
+
+//--------------------------------------------------------------------------------------------------
+
+const char* callbackName(CallbackDispatcher::Event::Type type_)
+{
+  switch (type_)
+  {
+    case CallbackDispatcher::Event::Type::Render:
+      return "render";
+    case CallbackDispatcher::Event::Type::Disconnect:
+      return "disconnect";
+    case CallbackDispatcher::Event::Type::Button:
+      return "button";
+    case CallbackDispatcher::Event::Type::Encoder:
+      return "encoder";
+    case CallbackDispatcher::Event::Type::Key:
+      return "key";
+    case CallbackDispatcher::Event::Type::Control:
+    default:
+      return "control";
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+constexpr std::chrono::microseconds CallbackDispatcher::kDefaultBudget;
+constexpr size_t CallbackDispatcher::kQueueSize;
+
+//--------------------------------------------------------------------------------------------------
+
+CallbackDispatcher::CallbackDispatcher(tHandler handler_) : m_handler(std::move(handler_))
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+
+CallbackDispatcher::~CallbackDispatcher()
+{
+  stop();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CallbackDispatcher::stop()
+{
+  {
+    // The dispatch thread is started under this lock
+    std::lock_guard<std::mutex> lock(m_mtxProducers);
+    m_stopped = true;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mtxWakeUp);
+    m_running = false;
+  }
+  m_cvWakeUp.notify_one();
+  if (m_thread.joinable())
+  {
+    m_thread.join();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CallbackDispatcher::setBudget(std::chrono::microseconds budget_)
+{
+  m_budget = budget_.count();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CallbackDispatcher::setOffloadThreshold(unsigned consecutiveOverruns_)
+{
+  m_offloadThreshold = consecutiveOverruns_;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CallbackDispatcher::dispatch(const Event& event_)
+{
+  if (m_stopped)
+  {
+    return;
+  }
+
+  if (event_.type == Event::Type::Disconnect)
+  {
+    std::unique_lock<std::mutex> lock(m_mtxCallbacks, std::defer_lock);
+    if (m_offloaded)
+    {
+      lock.lock();
+    }
+    invoke(event_);
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(m_mtxProducers);
+  if (!m_offloaded)
+  {
+    lock.unlock();
+    unsigned threshold = m_offloadThreshold;
+    std::atomic<unsigned>& consecutiveOverruns =
+      m_consecutiveOverruns[static_cast<size_t>(event_.type)];
+    if (!invoke(event_))
+    {
+      consecutiveOverruns = 0;
+    }
+    else if (threshold > 0 && ++consecutiveOverruns >= threshold)
+    {
+      lock.lock();
+      if (!m_offloaded && !m_stopped)
+      {
+        M_LOG("[CallbackDispatcher] " << consecutiveOverruns << " consecutive overruns of the "
+                                      << callbackName(event_.type)
+                                      << " callback, the callbacks are offloaded");
+        m_running = true;
+        m_thread = std::thread(&CallbackDispatcher::run, this);
+        m_offloaded = true;
+      }
+    }
+    return;
+  }
+
+  if (event_.type == Event::Type::Render && m_renderQueued.exchange(true))
+  {
+    return;
+  }
+  if (!m_events.push(event_))
+  {
+    m_droppedEvents++;
+    if (event_.type == Event::Type::Render)
+    {
+      m_renderQueued = false;
+    }
+    return;
+  }
+  lock.unlock();
+
+  // The dispatch thread only holds m_mtxWakeUp to check the queue, never while invoking the
+  // callbacks: taking it here orders the push before that check, so the wake-up can't be lost
+  {
+    std::lock_guard<std::mutex> wakeUp(m_mtxWakeUp);
+  }
+  m_cvWakeUp.notify_one();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool CallbackDispatcher::invoke(const Event& event_)
+{
+  int64_t budget = m_budget;
+  if (budget <= 0)
+  {
+    m_handler(event_);
+    return false;
+  }
+
+  tClock::time_point start = tClock::now();
+  m_handler(event_);
+  int64_t elapsed =
+    std::chrono::duration_cast<std::chrono::microseconds>(tClock::now() - start).count();
+  if (elapsed <= budget)
+  {
+    return false;
+  }
+
+  m_overruns++;
+  M_LOG("[CallbackDispatcher] " << callbackName(event_.type) << " callback took " << elapsed
+                                << " us (budget: " << budget << " us, overruns: " << m_overruns
+                                << ")");
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CallbackDispatcher::run()
+{
+  std::unique_lock<std::mutex> wakeUp(m_mtxWakeUp);
+  while (m_running)
+  {
+    m_cvWakeUp.wait(wakeUp, [this]() { return !m_events.empty() || !m_running; });
+    if (!m_running)
+    {
+      break;
+    }
+    wakeUp.unlock();
+    {
+      std::lock_guard<std::mutex> lock(m_mtxCallbacks);
+      Event event;
+      // Once stopped, the events still queued are dropped
+      while (!m_stopped && m_events.pop(event))
+      {
+        invoke(event);
+        if (event.type == Event::Type::Render)
+        {
+          m_renderQueued = false;
+        }
+      }
+    }
+    wakeUp.lock();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
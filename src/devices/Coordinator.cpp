@@ -23,6 +23,52 @@ namespace cabl
 //--------------------------------------------------------------------------------------------------
 
 std::atomic<unsigned> Coordinator::s_clientCount{0};
+std::atomic<Coordinator::PumpMode> Coordinator::s_pumpMode{Coordinator::PumpMode::Thread};
+std::atomic<bool> Coordinator::s_instantiated{false};
+constexpr std::chrono::milliseconds Coordinator::kPollInterval;
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+#if defined(CABL_USE_ALSA)
+const Driver::Type kMidiDriver = Driver::Type::ALSA;
+#else
+const Driver::Type kMidiDriver = Driver::Type::MIDI;
+#endif
+
+//--------------------------------------------------------------------------------------------------
+
+//! Identical controllers without a serial number can't be told apart: unless they share the same
+//! bus, their location is left unknown rather than guessed
+void setUsbLocation(
+  DeviceDescriptor& deviceDescriptor_, const Driver::tCollDeviceDescriptor& usbDeviceDescriptors_)
+{
+  unsigned nMatches = 0;
+  unsigned busNumber = 0;
+  unsigned portNumber = 0;
+  for (const auto& usbDeviceDescriptor : usbDeviceDescriptors_)
+  {
+    if (usbDeviceDescriptor.vendorId() == deviceDescriptor_.vendorId()
+        && usbDeviceDescriptor.productId() == deviceDescriptor_.productId()
+        && usbDeviceDescriptor.serialNumber() == deviceDescriptor_.serialNumber())
+    {
+      if (nMatches++ == 0)
+      {
+        busNumber = usbDeviceDescriptor.busNumber();
+        portNumber = usbDeviceDescriptor.portNumber();
+      }
+      else
+      {
+        busNumber = busNumber == usbDeviceDescriptor.busNumber() ? busNumber : 0;
+        portNumber = 0;
+      }
+    }
+  }
+  deviceDescriptor_.setUsbLocation(busNumber, portNumber);
+}
+
+} // namespace
 
 //--------------------------------------------------------------------------------------------------
 
@@ -44,6 +90,10 @@ Coordinator::tClientId Coordinator::registerClient(tCbDevicesListChanged cbDevic
   m_collCbDevicesListChanged[clientId] = cbDevicesListChanged_;
 
   m_clientRegistered = true;
+  if (s_pumpMode == PumpMode::Thread)
+  {
+    run();
+  }
   return clientId;
 }
 
@@ -56,8 +106,27 @@ void Coordinator::unregisterClient(tClientId clientId_)
 
 //--------------------------------------------------------------------------------------------------
 
+bool Coordinator::setPumpMode(PumpMode pumpMode_)
+{
+  if (s_instantiated)
+  {
+    M_LOG("[Coordinator] the pump mode must be set before the Coordinator is created");
+    return false;
+  }
+
+  s_pumpMode = pumpMode_;
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
 void Coordinator::run()
 {
+  if (s_pumpMode == PumpMode::Manual)
+  {
+    return;
+  }
+
   bool expected = false;
   if (!m_running.compare_exchange_strong(expected, true))
   {
@@ -65,23 +134,42 @@ void Coordinator::run()
   }
 
   m_cablThread = std::thread([this]() {
-    while(!m_clientRegistered)
+    while (!m_clientRegistered && m_running)
     {
-      std::this_thread::yield();;
+      std::this_thread::sleep_for(kPollInterval);
     }
     scan();
     while (m_running)
     {
-      std::lock_guard<std::mutex> lock(m_mtxDevices);
-      for (const auto& device : m_collDevices)
+      tClock::time_point wakeUp = tClock::time_point::max();
       {
-        if (device.second)
+        std::lock_guard<std::mutex> lock(m_mtxDevices);
+        for (const auto& device : m_collDevices)
         {
-          device.second->onTick();
-          //! \todo Check tick() result
+          if (device.second)
+          {
+            device.second->onTick();
+            //! \todo Check tick() result
+            wakeUp = std::min(wakeUp, device.second->nextTick());
+          }
         }
+        updateBandwidthBudget(tClock::now());
+      }
+      m_wakeUps++;
+
+      // Sleep while every device is idle and waiting for its next input poll
+      if (wakeUp == tClock::time_point::max())
+      {
+        wakeUp = tClock::now() + kPollInterval;
+      }
+      if (wakeUp > tClock::now())
+      {
+        std::this_thread::sleep_until(wakeUp);
+      }
+      else
+      {
+        std::this_thread::yield();
       }
-      std::this_thread::yield();
     }
   });
 }
@@ -100,12 +188,14 @@ Coordinator::tCollDeviceDescriptor Coordinator::enumerate(bool forceScan_)
 
 //--------------------------------------------------------------------------------------------------
 
-Coordinator::tDevicePtr Coordinator::connect(const DeviceDescriptor& deviceDescriptor_)
+Coordinator::tDevicePtr Coordinator::connect(
+  const DeviceDescriptor& deviceDescriptor_, tCbInitDevice cbInitDevice_)
 {
   if (!deviceDescriptor_)
   {
     return nullptr;
   }
+  tClock::time_point connectStart = tClock::now();
 
 #if defined(_WIN32) || defined(__APPLE__) || defined(__linux)
   Driver::Type driverType;
@@ -118,7 +208,7 @@ Coordinator::tDevicePtr Coordinator::connect(const DeviceDescriptor& deviceDescr
     }
     case DeviceDescriptor::Type::MIDI:
     {
-      driverType = Driver::Type::MIDI;
+      driverType = kMidiDriver;
       break;
     }
     case DeviceDescriptor::Type::USB:
@@ -129,24 +219,181 @@ Coordinator::tDevicePtr Coordinator::connect(const DeviceDescriptor& deviceDescr
     }
   }
 #endif
-  auto deviceHandle = driver(driverType)->connect(deviceDescriptor_);
+  tPtr<DeviceHandle> deviceHandle;
+  {
+    // Opening a device is quick, and not every driver can open devices concurrently
+    std::lock_guard<std::mutex> lock(m_mtxConnect);
+    deviceHandle = driver(driverType)->connect(deviceDescriptor_);
+  }
+
+  tDevicePtr device;
+  {
+    std::lock_guard<std::mutex> lock(m_mtxDevices);
+    auto it = m_collDevices.find(deviceDescriptor_);
+    if (it != m_collDevices.end())
+    {
+      device = it->second;
+    }
+  }
 
   if (deviceHandle)
   {
-    auto device = m_collDevices.find(deviceDescriptor_);
-    if (device != m_collDevices.end())
+    if (device)
     {
-      device->second->setDeviceHandle(std::move(deviceHandle));
+      device->setDeviceHandle(std::move(deviceHandle));
     }
     else
     {
-      auto device = DeviceFactory::instance().device(deviceDescriptor_, std::move(deviceHandle));
+      device = DeviceFactory::instance().device(deviceDescriptor_, std::move(deviceHandle));
+      std::lock_guard<std::mutex> lock(m_mtxDevices);
       m_collDevices.insert(std::pair<DeviceDescriptor, tDevicePtr>(deviceDescriptor_, device));
     }
-    m_collDevices[deviceDescriptor_]->onConnect();
+
+    // The I/O thread keeps serving the other devices while this one is initialized
+    device->onConnect(connectStart, [&device, &cbInitDevice_]() {
+      if (cbInitDevice_)
+      {
+        cbInitDevice_(device);
+      }
+    });
   }
 
-  return m_collDevices[deviceDescriptor_];
+  return device;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::future<Coordinator::tDevicePtr> Coordinator::connectAsync(
+  const DeviceDescriptor& deviceDescriptor_, tCbInitDevice cbInitDevice_)
+{
+  return std::async(std::launch::async, [this, deviceDescriptor_, cbInitDevice_]() {
+    return connect(deviceDescriptor_, cbInitDevice_);
+  });
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Coordinator::tCollDeviceMemoryUsage Coordinator::memoryUsage()
+{
+  tCollDeviceMemoryUsage collMemoryUsage;
+  std::lock_guard<std::mutex> lock(m_mtxDevices);
+  for (const auto& device : m_collDevices)
+  {
+    if (device.second)
+    {
+      const FrameArena& frameArena = device.second->frameArena();
+      collMemoryUsage.push_back({device.first,
+        device.second->m_connected,
+        device.second->residentMemory(),
+        frameArena.highWaterMark(),
+        frameArena.fallbackAllocations()});
+    }
+  }
+  return collMemoryUsage;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Coordinator::tCollDeviceStartupTime Coordinator::startupTimes()
+{
+  tCollDeviceStartupTime collStartupTimes;
+  std::lock_guard<std::mutex> lock(m_mtxDevices);
+  for (const auto& device : m_collDevices)
+  {
+    if (device.second && device.second->m_connected)
+    {
+      collStartupTimes.push_back({device.first, device.second->startupTime()});
+    }
+  }
+  return collStartupTimes;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Coordinator::tCollDeviceBandwidthUsage Coordinator::bandwidthUsage()
+{
+  std::lock_guard<std::mutex> lock(m_mtxDevices);
+  return m_collBandwidthUsage;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Coordinator::setBusCapacity(unsigned busNumber_, double bytesPerSecond_)
+{
+  std::lock_guard<std::mutex> lock(m_mtxDevices);
+  m_bandwidthBudget.setBusCapacity(busNumber_, bytesPerSecond_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Coordinator::tClock::time_point Coordinator::poll(std::chrono::microseconds budget_)
+{
+  auto deadline = tClock::now() + budget_;
+
+  {
+    // driver() adds drivers from connect() as well. The drivers are polled outside of the lock,
+    // the callbacks invoked from within poll() may need a driver too
+    std::lock_guard<std::mutex> lock(m_mtxDrivers);
+    m_polledDrivers.clear();
+    for (const auto& driver : m_collDrivers)
+    {
+      m_polledDrivers.push_back(driver.second);
+    }
+  }
+  for (const auto& pDriver : m_polledDrivers)
+  {
+    pDriver->poll(std::chrono::microseconds(0));
+  }
+
+  bool expected = true;
+  if (m_scanRequested.compare_exchange_strong(expected, false))
+  {
+    scan();
+  }
+
+  std::lock_guard<std::mutex> lock(m_mtxDevices);
+  size_t nDevices = m_collDevices.size();
+  size_t nTicked = 0;
+  tClock::time_point wakeUp = tClock::time_point::max();
+  if (nDevices > 0)
+  {
+    auto it = m_collDevices.begin();
+    std::advance(it, m_nextDevice % nDevices);
+    while (nTicked < nDevices)
+    {
+      if (it->second)
+      {
+        it->second->onPoll();
+        it->second->onTick();
+        wakeUp = std::min(wakeUp, it->second->nextTick());
+      }
+      nTicked++;
+      if (++it == m_collDevices.end())
+      {
+        it = m_collDevices.begin();
+      }
+      if (tClock::now() >= deadline)
+      {
+        break;
+      }
+    }
+    m_nextDevice = (m_nextDevice + nTicked) % nDevices;
+  }
+  updateBandwidthBudget(tClock::now());
+  m_wakeUps++;
+
+  if (nTicked < nDevices || m_scanRequested)
+  {
+    return tClock::now();
+  }
+
+  // Idle devices are only due when their next input poll is
+  tClock::time_point next = tClock::now() + kPollInterval;
+  if (wakeUp != tClock::time_point::max())
+  {
+    next = std::max(next, wakeUp);
+  }
+  return next;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -154,12 +401,18 @@ Coordinator::tDevicePtr Coordinator::connect(const DeviceDescriptor& deviceDescr
 Coordinator::Coordinator()
 {
   M_LOG("Controller Abstraction Library v. " << Lib::version());
+  s_instantiated = true;
   auto usbDriver = driver(Driver::Type::LibUSB);
 
-  usbDriver->setHotplugCallback(
-    [this](DeviceDescriptor deviceDescriptor_, bool plugged_) { scan(); });
-
-  run();
+  usbDriver->setHotplugCallback([this](DeviceDescriptor deviceDescriptor_, bool plugged_) {
+    if (s_pumpMode == PumpMode::Manual)
+    {
+      // Hotplug events are delivered from within poll(), defer the scan to a safe point
+      m_scanRequested = true;
+      return;
+    }
+    scan();
+  });
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -171,26 +424,29 @@ void Coordinator::scan()
   m_collDeviceDescriptors.clear();
 
 #if defined(_WIN32) || defined(__APPLE__) || defined(__linux)
-  for (const auto& deviceDescriptor : driver(Driver::Type::HIDAPI)->enumerate())
+  Driver::Type tMainDriver(Driver::Type::LibUSB);
+
+  // hidapi doesn't tell where the devices are connected, the bandwidth budget needs to know
+  Driver::tCollDeviceDescriptor usbDeviceDescriptors = driver(tMainDriver)->enumerate();
+  for (auto deviceDescriptor : driver(Driver::Type::HIDAPI)->enumerate())
   {
+    setUsbLocation(deviceDescriptor, usbDeviceDescriptors);
     if (checkAndAddDeviceDescriptor(deviceDescriptor))
     {
       M_LOG("[Coordinator] scan: new device found via HIDAPI");
     }
   }
 
-  for (const auto& deviceDescriptor : driver(Driver::Type::MIDI)->enumerate())
+  for (const auto& deviceDescriptor : driver(kMidiDriver)->enumerate())
   {
     if (checkAndAddDeviceDescriptor(deviceDescriptor))
     {
       M_LOG("[Coordinator] scan: new device found via MIDI");
     }
   }
-
-  Driver::Type tMainDriver(Driver::Type::LibUSB);
 #endif
 
-  for (const auto& deviceDescriptor : driver(tMainDriver)->enumerate())
+  for (const auto& deviceDescriptor : usbDeviceDescriptors)
   {
     if (checkAndAddDeviceDescriptor(deviceDescriptor))
     {
@@ -266,11 +522,53 @@ void Coordinator::devicesListChanged()
 
 //--------------------------------------------------------------------------------------------------
 
+void Coordinator::updateBandwidthBudget(tClock::time_point now_)
+{
+  if (now_ < m_nextBandwidthUpdate)
+  {
+    return;
+  }
+  m_nextBandwidthUpdate = now_ + BandwidthBudget::kUpdateInterval;
+
+  m_budgetedDevices.clear();
+  m_bandwidthDemands.clear();
+  m_collBandwidthUsage.clear();
+  for (const auto& device : m_collDevices)
+  {
+    if (!device.second || !device.second->m_connected)
+    {
+      continue;
+    }
+    TrafficMeter::Rates rates = device.second->m_trafficMeter.sample(now_);
+    m_budgetedDevices.push_back(device.second.get());
+    m_bandwidthDemands.push_back({device.first.busNumber(), rates});
+    m_collBandwidthUsage.push_back({device.first,
+      device.first.busNumber(),
+      device.first.portNumber(),
+      rates.input,
+      rates.leds,
+      rates.display,
+      0.0,
+      rates.displayDeferred});
+  }
+
+  std::vector<double> allowances = m_bandwidthBudget.allocate(m_bandwidthDemands);
+  for (size_t i = 0; i < allowances.size(); i++)
+  {
+    m_budgetedDevices[i]->m_trafficMeter.setDisplayAllowance(allowances[i]);
+    m_collBandwidthUsage[i].displayAllowance = allowances[i];
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
 Coordinator::tDriverPtr Coordinator::driver(Driver::Type tDriver_)
 {
+  std::lock_guard<std::mutex> lock(m_mtxDrivers);
   if (m_collDrivers.find(tDriver_) == m_collDrivers.end())
   {
-    m_collDrivers.emplace(tDriver_, std::make_shared<Driver>(tDriver_));
+    m_collDrivers.emplace(
+      tDriver_, std::make_shared<Driver>(tDriver_, s_pumpMode == PumpMode::Manual));
   }
 
   return m_collDrivers[tDriver_];
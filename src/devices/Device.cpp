@@ -7,6 +7,8 @@
 
 #include "cabl/devices/Device.h"
 #include "cabl/comm/DeviceHandle.h"
+#include "cabl/devices/DisplayMirror.h"
+#include "cabl/util/Log.h"
 
 
 #include "cabl/gfx/Canvas.h"
@@ -24,6 +26,35 @@ namespace cabl
 
 //--------------------------------------------------------------------------------------------------
 
+constexpr size_t Device::InputState::kNumKeys;
+constexpr size_t Device::InputState::kNumEncoders;
+constexpr size_t Device::InputState::kNumControls;
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+MidiMapping::Source mappingSource(InputMask::Class class_)
+{
+  switch (class_)
+  {
+    case InputMask::Class::Buttons:
+      return MidiMapping::Source::Button;
+    case InputMask::Class::Encoders:
+      return MidiMapping::Source::Encoder;
+    case InputMask::Class::Keys:
+      return MidiMapping::Source::Key;
+    case InputMask::Class::Controls:
+    default:
+      return MidiMapping::Source::Control;
+  }
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
 void Device::setDeviceHandle(tPtr<DeviceHandle> pDeviceHandle_)
 {
   std::lock_guard<std::mutex> lock(m_mtxDeviceHandle);
@@ -90,6 +121,51 @@ void Device::sendMidiMsg(tRawData)
 
 //--------------------------------------------------------------------------------------------------
 
+void Device::sendMidiBytes(const uint8_t* pData_, size_t length_)
+{
+  sendMidiMsg(tRawData(pData_, pData_ + length_));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Device::setMidiMapping(MidiMapping::tRules rules_, MidiMapping::tOutput output_)
+{
+  if (!output_)
+  {
+    output_ = [this](const uint8_t* pData_, size_t length_) { sendMidiBytes(pData_, length_); };
+  }
+  m_midiMapping.load(std::move(rules_), std::move(output_));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool Device::postButtonLed(Button button_, const Color& color_) noexcept
+{
+  return m_ledCommands.push(
+    {LedCommand::Type::ButtonLed, static_cast<unsigned>(button_), 0.0, color_, Alignment::Left});
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool Device::postKeyLed(unsigned index_, const Color& color_) noexcept
+{
+  return m_ledCommands.push({LedCommand::Type::KeyLed, index_, 0.0, color_, Alignment::Left});
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool Device::postLedArrayValue(
+  size_t ledArrayIndex_, double value_, const Color& color_, Alignment alignment_) noexcept
+{
+  return m_ledCommands.push({LedCommand::Type::LedArrayValue,
+    static_cast<unsigned>(ledArrayIndex_),
+    value_,
+    color_,
+    alignment_});
+}
+
+//--------------------------------------------------------------------------------------------------
+
 void Device::setCallbackDisconnect(tCbDisconnect cbDisconnect_)
 {
   m_cbDisconnect = cbDisconnect_;
@@ -132,6 +208,13 @@ void Device::setCallbackControlChanged(tCbControlChanged cbControlChanged_)
 
 //--------------------------------------------------------------------------------------------------
 
+void Device::stopCallbacks()
+{
+  m_callbackDispatcher.stop();
+}
+
+//--------------------------------------------------------------------------------------------------
+
 bool Device::hasDeviceHandle()
 {
   std::lock_guard<std::mutex> lock(m_mtxDeviceHandle);
@@ -140,13 +223,15 @@ bool Device::hasDeviceHandle()
 
 //--------------------------------------------------------------------------------------------------
 
-bool Device::writeToDeviceHandle(const Transfer& transfer_, uint8_t endpoint_) const
+bool Device::writeToDeviceHandle(
+  const Transfer& transfer_, uint8_t endpoint_, Traffic traffic_) const
 {
   std::lock_guard<std::mutex> lock(m_mtxDeviceHandle);
 
-  if (m_pDeviceHandle)
+  if (m_pDeviceHandle && m_pDeviceHandle->write(transfer_, endpoint_))
   {
-    return m_pDeviceHandle->write(transfer_, endpoint_);
+    countWritten(traffic_, transfer_.size());
+    return true;
   }
 
   return false;
@@ -157,9 +242,46 @@ bool Device::writeToDeviceHandle(const Transfer& transfer_, uint8_t endpoint_) c
 bool Device::readFromDeviceHandle(Transfer& transfer_, uint8_t endpoint_) const
 {
   std::lock_guard<std::mutex> lock(m_mtxDeviceHandle);
-  if (m_pDeviceHandle)
+  if (m_pDeviceHandle && m_pDeviceHandle->read(transfer_, endpoint_))
+  {
+    m_trafficMeter.add(Traffic::Input, transfer_.size());
+    return true;
+  }
+
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool Device::writeToDeviceHandle(
+  const DeviceHandle::tCollTransfers& transfers_, uint8_t endpoint_, Traffic traffic_) const
+{
+  std::lock_guard<std::mutex> lock(m_mtxDeviceHandle);
+  if (m_pDeviceHandle && m_pDeviceHandle->writeBatch(transfers_, endpoint_))
+  {
+    for (const auto& transfer : transfers_)
+    {
+      countWritten(traffic_, transfer.size());
+    }
+    return true;
+  }
+
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool Device::readFromDeviceHandle(DeviceHandle::tCollTransfers& transfers_, uint8_t endpoint_) const
+{
+  std::lock_guard<std::mutex> lock(m_mtxDeviceHandle);
+  size_t nTransfers = transfers_.size();
+  if (m_pDeviceHandle && m_pDeviceHandle->readBatch(transfers_, endpoint_))
   {
-    return m_pDeviceHandle->read(transfer_, endpoint_);
+    for (size_t i = nTransfers; i < transfers_.size(); i++)
+    {
+      m_trafficMeter.add(Traffic::Input, transfers_[i].size());
+    }
+    return true;
   }
 
   return false;
@@ -172,17 +294,57 @@ void Device::readFromDeviceHandleAsync(uint8_t endpoint_, DeviceHandle::tCbRead
   std::lock_guard<std::mutex> lock(m_mtxDeviceHandle);
   if (m_pDeviceHandle)
   {
-    return m_pDeviceHandle->readAsync(endpoint_, cbRead_);
+    TrafficMeter& trafficMeter = m_trafficMeter;
+    m_cbPolled = [&trafficMeter, cbRead_](Transfer transfer_) {
+      trafficMeter.add(Traffic::Input, transfer_.size());
+      cbRead_(std::move(transfer_));
+    };
+    m_pDeviceHandle->readAsync(endpoint_, m_cbPolled);
   }
 }
 
 //--------------------------------------------------------------------------------------------------
 
+bool Device::displayFrameDue()
+{
+  return m_trafficMeter.displayFrameDue();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool Device::inputPollDue()
+{
+  return m_inputPolling.due();
+}
+
+//--------------------------------------------------------------------------------------------------
+
 void Device::buttonChanged(Button button_, bool buttonState_, bool shiftPressed_)
 {
+  m_inputPolling.activity();
+  m_inputState.modify([button_, buttonState_, shiftPressed_](InputState& state_) {
+    unsigned index = static_cast<unsigned>(button_);
+    uint32_t mask = 1u << (index % 32);
+    state_.buttons[index / 32] = buttonState_ ? (state_.buttons[index / 32] | mask)
+                                              : (state_.buttons[index / 32] & ~mask);
+    state_.shift = shiftPressed_;
+    state_.changes++;
+  });
+
+  if (!acceptInput(InputMask::Class::Buttons, static_cast<unsigned>(button_)))
+  {
+    return;
+  }
+  m_midiMapping.translate(
+    MidiMapping::Source::Button, static_cast<unsigned>(button_), buttonState_ ? 1.0 : 0.0);
+
   if (m_cbButtonChanged)
   {
-    m_cbButtonChanged(button_, buttonState_, shiftPressed_);
+    m_callbackDispatcher.dispatch({CallbackDispatcher::Event::Type::Button,
+      static_cast<unsigned>(button_),
+      0.0,
+      buttonState_,
+      shiftPressed_});
   }
 }
 
@@ -190,9 +352,29 @@ void Device::buttonChanged(Button button_, bool buttonState_, bool shiftPressed_
 
 void Device::encoderChanged(unsigned encoder_, bool valueIncreased_, bool shiftPressed_)
 {
+  m_inputPolling.activity();
+  m_inputState.modify([encoder_, valueIncreased_, shiftPressed_](InputState& state_) {
+    if (encoder_ < InputState::kNumEncoders)
+    {
+      state_.encoders[encoder_] += valueIncreased_ ? 1 : -1;
+    }
+    state_.shift = shiftPressed_;
+    state_.changes++;
+  });
+
+  if (!acceptInput(InputMask::Class::Encoders, encoder_))
+  {
+    return;
+  }
+  m_midiMapping.translate(MidiMapping::Source::Encoder, encoder_, valueIncreased_ ? 1.0 : -1.0);
+
   if (m_cbEncoderChanged)
   {
-    m_cbEncoderChanged(encoder_, valueIncreased_, shiftPressed_);
+    m_callbackDispatcher.dispatch({CallbackDispatcher::Event::Type::Encoder,
+      encoder_,
+      0.0,
+      valueIncreased_,
+      shiftPressed_});
   }
 }
 
@@ -200,9 +382,26 @@ void Device::encoderChanged(unsigned encoder_, bool valueIncreased_, bool shiftP
 
 void Device::keyChanged(unsigned index_, double value_, bool shiftPressed_)
 {
+  m_inputPolling.activity();
+  m_inputState.modify([index_, value_, shiftPressed_](InputState& state_) {
+    if (index_ < InputState::kNumKeys)
+    {
+      state_.keys[index_] = static_cast<float>(value_);
+    }
+    state_.shift = shiftPressed_;
+    state_.changes++;
+  });
+
+  if (!acceptInput(InputMask::Class::Keys, index_))
+  {
+    return;
+  }
+  m_midiMapping.translate(MidiMapping::Source::Key, index_, value_);
+
   if (m_cbKeyChanged)
   {
-    m_cbKeyChanged(index_, value_, shiftPressed_);
+    m_callbackDispatcher.dispatch(
+      {CallbackDispatcher::Event::Type::Key, index_, value_, false, shiftPressed_});
   }
 }
 
@@ -210,14 +409,53 @@ void Device::keyChanged(unsigned index_, double value_, bool shiftPressed_)
 
 void Device::controlChanged(unsigned potentiometer_, double value_, bool shiftPressed_)
 {
+  m_inputPolling.activity();
+  m_inputState.modify([potentiometer_, value_, shiftPressed_](InputState& state_) {
+    if (potentiometer_ < InputState::kNumControls)
+    {
+      state_.controls[potentiometer_] = static_cast<float>(value_);
+    }
+    state_.shift = shiftPressed_;
+    state_.changes++;
+  });
+
+  if (!acceptInput(InputMask::Class::Controls, potentiometer_))
+  {
+    return;
+  }
+  m_midiMapping.translate(MidiMapping::Source::Control, potentiometer_, value_);
+
   if (m_cbControlChanged)
   {
-    m_cbControlChanged(potentiometer_, value_, shiftPressed_);
+    m_callbackDispatcher.dispatch({CallbackDispatcher::Event::Type::Control,
+      potentiometer_,
+      value_,
+      false,
+      shiftPressed_});
   }
 }
 
 //--------------------------------------------------------------------------------------------------
 
+bool Device::inputWanted(InputMask::Class class_) const noexcept
+{
+  return m_inputMask.wantsAny(class_) || m_midiMapping.maps(mappingSource(class_));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool Device::acceptInput(InputMask::Class class_, unsigned index_) noexcept
+{
+  if (m_inputMask.wants(class_, index_) || m_midiMapping.maps(mappingSource(class_)))
+  {
+    return true;
+  }
+  m_inputMask.countSkippedEvent(class_);
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
 bool Device::onTick()
 {
   if (!hasDeviceHandle())
@@ -225,19 +463,192 @@ bool Device::onTick()
     return false;
   }
 
-  Device::render();
-  if (!m_connected)
+  std::unique_lock<std::mutex> lockConnect(m_mtxConnect, std::try_to_lock);
+  if (!lockConnect)
   {
+    // Being initialized by another thread
     return true;
   }
-  return tick();
+
+  // Uncontended until the callbacks are offloaded, which may happen during this tick: the callbacks
+  // queued from then on wait for the tick to complete
+  bool offloaded = m_callbackDispatcher.offloaded();
+  std::unique_lock<std::mutex> lockCallbacks(
+    m_callbackDispatcher.callbackMutex(), std::defer_lock);
+  if (!offloaded)
+  {
+    lockCallbacks.lock();
+  }
+  else if (!lockCallbacks.try_lock())
+  {
+    // The callbacks are running on their own thread, the device state is theirs until they return
+    return true;
+  }
+
+  if (!offloaded)
+  {
+    Device::render();
+  }
+  bool result = true;
+  uint64_t written = m_trafficMeter.bytes(Traffic::Leds) + m_trafficMeter.bytes(Traffic::Display);
+  if (m_connected)
+  {
+    applyLedCommands();
+    result = tick();
+    {
+      // Never waits: while a mirror is being attached or detached this frame isn't captured
+      std::unique_lock<std::mutex> lock(m_mtxDisplayMirror, std::try_to_lock);
+      if (lock && m_pDisplayMirror)
+      {
+        m_pDisplayMirror->capture(*this);
+      }
+    }
+  }
+  m_frameArena.reset();
+  m_tickWrote
+    = m_trafficMeter.bytes(Traffic::Leds) + m_trafficMeter.bytes(Traffic::Display) != written;
+
+  if (offloaded)
+  {
+    // The next frame is drawn on the dispatch thread while the I/O thread serves other devices
+    lockCallbacks.unlock();
+    Device::render();
+  }
+  return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Device::tClock::time_point Device::nextTick() const
+{
+  // The drivers write one kind of output per tick, more may follow
+  return m_tickWrote ? tClock::time_point() : m_inputPolling.next();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Device::setDisplayMirror(DisplayMirror* pDisplayMirror_)
+{
+  std::lock_guard<std::mutex> lock(m_mtxDisplayMirror);
+  m_pDisplayMirror = pDisplayMirror_;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Device::countWritten(Traffic traffic_, size_t bytes_) const
+{
+  m_trafficMeter.add(traffic_, bytes_);
+  if (traffic_ == Traffic::Display && m_firstFramePending && m_firstFramePending.exchange(false))
+  {
+    m_firstFrame =
+      std::chrono::duration_cast<std::chrono::microseconds>(tClock::now() - m_connectStart)
+        .count();
+    M_LOG("[Device] first display frame " << m_firstFrame / 1000 << " ms after connecting");
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Device::applyLedCommands()
+{
+  // Bounded, so that a producer flooding the queue can't stall the I/O thread
+  LedCommand command;
+  for (size_t i = 0; i < kLedQueueSize && m_ledCommands.pop(command); i++)
+  {
+    switch (command.type)
+    {
+      case LedCommand::Type::ButtonLed:
+      {
+        setButtonLed(static_cast<Button>(command.index), command.color);
+        break;
+      }
+      case LedCommand::Type::KeyLed:
+      {
+        setKeyLed(command.index, command.color);
+        break;
+      }
+      case LedCommand::Type::LedArrayValue:
+      {
+        ledArray(command.index)->setValue(command.value, command.color, command.alignment);
+        break;
+      }
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+size_t Device::residentMemory()
+{
+  size_t residentBytes = 0;
+  for (size_t i = 0; i < numOfGraphicDisplays(); i++)
+  {
+    residentBytes += graphicDisplay(i)->residentBytes();
+  }
+  for (size_t i = 0; i < numOfLedMatrices(); i++)
+  {
+    residentBytes += ledMatrix(i)->residentBytes();
+  }
+  return residentBytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Device::onPoll()
+{
+  std::unique_lock<std::mutex> lockConnect(m_mtxConnect, std::try_to_lock);
+  if (!lockConnect)
+  {
+    return; // being initialized by another thread, which registers the read callback
+  }
+
+  m_polled.clear();
+  {
+    std::lock_guard<std::mutex> lock(m_mtxDeviceHandle);
+    if (!m_pDeviceHandle || !m_pDeviceHandle->poll(m_polled))
+    {
+      return;
+    }
+  }
+
+  // The callback may write to the device, which locks the device handle again
+  for (auto& transfer : m_polled)
+  {
+    m_cbPolled(std::move(transfer));
+  }
 }
 
 //--------------------------------------------------------------------------------------------------
 
-void Device::onConnect()
+void Device::onConnect(tClock::time_point connectStart_, const std::function<void()>& cbInit_)
 {
+  std::lock_guard<std::mutex> lock(m_mtxConnect);
+  m_connectStart = connectStart_;
+  m_firstFrame = 0;
+  m_firstFramePending = true;
+
+  // Buffers released on disconnect come back cleared, make sure they are sent in full
+  for (size_t i = 0; i < numOfGraphicDisplays(); i++)
+  {
+    graphicDisplay(i)->setDirty();
+  }
+  for (size_t i = 0; i < numOfLedMatrices(); i++)
+  {
+    ledMatrix(i)->setDirty();
+  }
+
+  // The controls left held before a disconnection have been released since
+  m_inputState.write(InputState{});
+  m_inputPolling.reset(connectStart_);
+
+  tClock::time_point initStart = tClock::now();
   init();
+  m_initDuration =
+    std::chrono::duration_cast<std::chrono::microseconds>(tClock::now() - initStart).count();
+  if (cbInit_)
+  {
+    cbInit_();
+  }
   m_connected = true;
 }
 
@@ -245,11 +656,25 @@ void Device::onConnect()
 
 void Device::onDisconnect()
 {
-  m_connected = false;
-  resetDeviceHandle();
+  {
+    // Like onTick(), so that the render callback never draws on a buffer being released
+    std::lock_guard<std::mutex> lock(m_callbackDispatcher.callbackMutex());
+    m_connected = false;
+    resetDeviceHandle();
+
+    for (size_t i = 0; i < numOfGraphicDisplays(); i++)
+    {
+      graphicDisplay(i)->releaseBuffer();
+    }
+    for (size_t i = 0; i < numOfLedMatrices(); i++)
+    {
+      ledMatrix(i)->releaseBuffer();
+    }
+  }
   if (m_cbDisconnect)
   {
-    m_cbDisconnect();
+    m_callbackDispatcher.dispatch(
+      {CallbackDispatcher::Event::Type::Disconnect, 0, 0.0, false, false});
   }
 }
 
@@ -259,7 +684,49 @@ void Device::render()
 {
   if (m_cbRender)
   {
-    m_cbRender();
+    m_callbackDispatcher.dispatch(
+      {CallbackDispatcher::Event::Type::Render, 0, 0.0, false, false});
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void Device::invokeCallback(const CallbackDispatcher::Event& event_)
+{
+  switch (event_.type)
+  {
+    case CallbackDispatcher::Event::Type::Render:
+    {
+      m_cbRender();
+      break;
+    }
+    case CallbackDispatcher::Event::Type::Disconnect:
+    {
+      m_cbDisconnect();
+      break;
+    }
+    case CallbackDispatcher::Event::Type::Button:
+    {
+      m_cbButtonChanged(static_cast<Button>(event_.index), event_.state, event_.shift);
+      break;
+    }
+    case CallbackDispatcher::Event::Type::Encoder:
+    {
+      m_cbEncoderChanged(event_.index, event_.state, event_.shift);
+      break;
+    }
+    case CallbackDispatcher::Event::Type::Key:
+    {
+      m_cbKeyChanged(event_.index, event_.value, event_.shift);
+      break;
+    }
+    case CallbackDispatcher::Event::Type::Control:
+    {
+      m_cbControlChanged(event_.index, event_.value, event_.shift);
+      break;
+    }
+    default:
+      break;
   }
 }
 
@@ -0,0 +1,69 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include "cabl/devices/Device.h"
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class DeviceDriverAccess
+  \brief Exposes the steps of the Coordinator I/O loop, to drive a device without a Coordinator
+
+  Not part of the public API: the I/O loop steps are only meant to be called from a single thread,
+  in the order the Coordinator calls them.
+*/
+
+class DeviceDriverAccess
+{
+public:
+  static void connect(Device& device_,
+    Device::tClock::time_point connectStart_,
+    const std::function<void()>& cbInit_ = nullptr)
+  {
+    device_.onConnect(connectStart_, cbInit_);
+  }
+
+  static void poll(Device& device_)
+  {
+    device_.onPoll();
+  }
+
+  static bool tick(Device& device_)
+  {
+    return device_.onTick();
+  }
+
+  static void disconnect(Device& device_)
+  {
+    device_.onDisconnect();
+  }
+
+  //! When the device must be ticked again, in the past if it has output in flight
+  static Device::tClock::time_point nextTick(const Device& device_)
+  {
+    return device_.nextTick();
+  }
+
+  static TrafficMeter& trafficMeter(Device& device_)
+  {
+    return device_.m_trafficMeter;
+  }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
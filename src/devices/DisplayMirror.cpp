@@ -0,0 +1,328 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/devices/DisplayMirror.h"
+
+#include <algorithm>
+
+#include "cabl/devices/Device.h"
+#include "cabl/gfx/Canvas.h"
+#include "cabl/gfx/TextDisplay.h"
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+using namespace sl::cabl;
+
+//--------------------------------------------------------------------------------------------------
+
+uint32_t crc32(const uint8_t* pData_, size_t length_, uint32_t crc_ = 0)
+{
+  static const std::vector<uint32_t> s_table = []() {
+    std::vector<uint32_t> table(256);
+    for (uint32_t n = 0; n < 256; n++)
+    {
+      uint32_t c = n;
+      for (unsigned k = 0; k < 8; k++)
+      {
+        c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+      }
+      table[n] = c;
+    }
+    return table;
+  }();
+
+  crc_ = ~crc_;
+  for (size_t i = 0; i < length_; i++)
+  {
+    crc_ = s_table[(crc_ ^ pData_[i]) & 0xFF] ^ (crc_ >> 8);
+  }
+  return ~crc_;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void appendBigEndian(tRawData& data_, uint32_t value_)
+{
+  data_.push_back(static_cast<uint8_t>(value_ >> 24));
+  data_.push_back(static_cast<uint8_t>(value_ >> 16));
+  data_.push_back(static_cast<uint8_t>(value_ >> 8));
+  data_.push_back(static_cast<uint8_t>(value_));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void appendChunk(tRawData& png_, const char* type_, const tRawData& data_)
+{
+  appendBigEndian(png_, static_cast<uint32_t>(data_.size()));
+  size_t start = png_.size();
+  png_.insert(png_.end(), type_, type_ + 4);
+  png_.insert(png_.end(), data_.begin(), data_.end());
+  appendBigEndian(png_, crc32(&png_[start], png_.size() - start));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Encode RGBA pixels as PNG
+/*!
+   The image data is stored uncompressed (in deflate "stored" blocks), so that encoding is a copy:
+   monitoring clients usually recompress or re-encode the images anyway.
+*/
+tRawData encodePng(unsigned width_, unsigned height_, const tRawData& rgba_)
+{
+  const size_t rowSize = width_ * 4;
+  tRawData scanlines;
+  scanlines.reserve(height_ * (rowSize + 1));
+  for (unsigned y = 0; y < height_; y++)
+  {
+    scanlines.push_back(0); // No filter
+    auto row = rgba_.begin() + y * rowSize;
+    scanlines.insert(scanlines.end(), row, row + rowSize);
+  }
+
+  tRawData zlib{0x78, 0x01};
+  const size_t kMaxBlockSize = 65535;
+  size_t offset = 0;
+  do
+  {
+    size_t blockSize = std::min(kMaxBlockSize, scanlines.size() - offset);
+    bool last = offset + blockSize == scanlines.size();
+    zlib.push_back(last ? 1 : 0);
+    zlib.push_back(static_cast<uint8_t>(blockSize));
+    zlib.push_back(static_cast<uint8_t>(blockSize >> 8));
+    zlib.push_back(static_cast<uint8_t>(~blockSize));
+    zlib.push_back(static_cast<uint8_t>(~blockSize >> 8));
+    zlib.insert(zlib.end(), scanlines.begin() + offset, scanlines.begin() + offset + blockSize);
+    offset += blockSize;
+  } while (offset < scanlines.size());
+
+  uint32_t a = 1;
+  uint32_t b = 0;
+  for (uint8_t byte : scanlines)
+  {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  appendBigEndian(zlib, (b << 16) | a);
+
+  tRawData header;
+  appendBigEndian(header, width_);
+  appendBigEndian(header, height_);
+  header.insert(header.end(), {8, 6, 0, 0, 0}); // 8 bit RGBA, no interlacing
+
+  tRawData png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  appendChunk(png, "IHDR", header);
+  appendChunk(png, "IDAT", zlib);
+  appendChunk(png, "IEND", {});
+  return png;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+constexpr double DisplayMirror::kDefaultMaxFrameRate;
+
+//--------------------------------------------------------------------------------------------------
+
+DisplayMirror::DisplayMirror(Device& device_, tCbFrame cbFrame_)
+  : m_device(device_), m_cbFrame(cbFrame_), m_thread(&DisplayMirror::run, this)
+{
+  m_device.setDisplayMirror(this);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+DisplayMirror::~DisplayMirror()
+{
+  // Waits for a capture in progress on the I/O thread
+  m_device.setDisplayMirror(nullptr);
+  {
+    std::lock_guard<std::mutex> lock(m_mtxPending);
+    m_running = false;
+  }
+  m_cvPending.notify_one();
+  m_thread.join();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void DisplayMirror::setMaxFrameRate(double framesPerSecond_)
+{
+  m_maxFrameRate = std::max(0.0, framesPerSecond_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void DisplayMirror::capture(Device& device_)
+{
+  tClock::time_point now = tClock::now();
+  if (now < m_nextCapture)
+  {
+    return;
+  }
+  double maxFrameRate = m_maxFrameRate;
+  m_nextCapture = maxFrameRate > 0
+                    ? now + std::chrono::duration_cast<tClock::duration>(
+                              std::chrono::duration<double>(1.0 / maxFrameRate))
+                    : now;
+
+  prepare(m_capturing, device_);
+  for (auto& surface : m_capturing.surfaces)
+  {
+    std::copy_n(surface.pCanvas->data(), surface.size, surface.pBuffer.get());
+  }
+  for (auto& text : m_capturing.texts)
+  {
+    std::copy_n(device_.textDisplay(text.index)->displayData(), text.data.size(), text.data.data());
+  }
+  m_capturing.sequence = m_capturedFrames++;
+  m_capturing.time = now;
+
+  std::unique_lock<std::mutex> lock(m_mtxPending, std::try_to_lock);
+  if (!lock)
+  {
+    // The background thread is picking up the previous frame, this one is dropped
+    m_droppedFrames++;
+    return;
+  }
+  if (m_hasPending)
+  {
+    m_droppedFrames++;
+  }
+  std::swap(m_capturing, m_pending);
+  m_hasPending = true;
+  lock.unlock();
+  m_cvPending.notify_one();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void DisplayMirror::prepare(Snapshot& snapshot_, Device& device_)
+{
+  if (snapshot_.prepared)
+  {
+    return;
+  }
+
+  auto addSurface = [&snapshot_](Image::Source source_, size_t index_, const Canvas* pCanvas_) {
+    if (pCanvas_ == nullptr || pCanvas_->bufferSize() == 0)
+    {
+      return;
+    }
+    Surface surface;
+    surface.source = source_;
+    surface.index = index_;
+    surface.width = pCanvas_->width();
+    surface.height = pCanvas_->height();
+    surface.pCanvas = pCanvas_;
+    surface.size = pCanvas_->bufferSize();
+    surface.pBuffer = BufferPool::instance().acquire(surface.size);
+    surface.pDecoder = pCanvas_->clone();
+    snapshot_.surfaces.push_back(std::move(surface));
+  };
+
+  for (size_t i = 0; i < device_.numOfGraphicDisplays(); i++)
+  {
+    addSurface(Image::Source::GraphicDisplay, i, device_.graphicDisplay(i));
+  }
+  for (size_t i = 0; i < device_.numOfLedMatrices(); i++)
+  {
+    addSurface(Image::Source::LedMatrix, i, device_.ledMatrix(i));
+  }
+  for (size_t i = 0; i < device_.numOfTextDisplays(); i++)
+  {
+    TextDisplay* pDisplay = device_.textDisplay(i);
+    snapshot_.texts.push_back({i, pDisplay->width(), pDisplay->height(), {}});
+    snapshot_.texts.back().data.resize(pDisplay->dataSize());
+  }
+  snapshot_.prepared = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void DisplayMirror::run()
+{
+  std::unique_lock<std::mutex> lock(m_mtxPending);
+  while (true)
+  {
+    m_cvPending.wait(lock, [this] { return m_hasPending || !m_running; });
+    if (!m_running)
+    {
+      return;
+    }
+    std::swap(m_pending, m_publishing);
+    m_hasPending = false;
+    lock.unlock();
+    publish(m_publishing);
+    lock.lock();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void DisplayMirror::publish(Snapshot& snapshot_)
+{
+  if (!m_cbFrame)
+  {
+    return;
+  }
+
+  Frame frame;
+  frame.sequence = snapshot_.sequence;
+  frame.time = snapshot_.time;
+  frame.texts = snapshot_.texts;
+
+  for (auto& surface : snapshot_.surfaces)
+  {
+    Image image{surface.source, surface.index, surface.width, surface.height, {}, {}, {}};
+    image.native.assign(surface.pBuffer.get(), surface.pBuffer.get() + surface.size);
+
+    // The copy of the canvas decodes the captured pixels, then gets its own buffer back
+    if (surface.pDecoder && surface.pDecoder->swapBuffer(surface.pBuffer))
+    {
+      image.rgba.resize(surface.width * surface.height * 4);
+      auto it = image.rgba.begin();
+      for (unsigned y = 0; y < surface.height; y++)
+      {
+        for (unsigned x = 0; x < surface.width; x++)
+        {
+          Color color = surface.pDecoder->pixel(x, y);
+          *it++ = color.red();
+          *it++ = color.green();
+          *it++ = color.blue();
+          *it++ = 0xFF;
+        }
+      }
+      surface.pDecoder->swapBuffer(surface.pBuffer);
+    }
+
+    if (m_pngEncoding && !image.rgba.empty())
+    {
+      image.png = encodePng(image.width, image.height, image.rgba);
+    }
+    frame.images.push_back(std::move(image));
+  }
+
+  m_cbFrame(frame);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,244 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "cabl/comm/Transfer.h"
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/*
+  Declarative descriptions of HID report layouts.
+
+  A device describes each field of its reports (offset in bytes from the start of the report,
+  including the report ID, first bit and width) with the templates below, e.g.:
+
+    using tButtons = ReportBitmap<1, 64>;                  // 64 buttons starting at byte 1
+    using tEncoders = ReportFieldArray<9, 2, 0, 16, 8>;   // 8 little-endian 16 bit values
+    using tPadIndex = ReportFieldArray<2, 2, 4, 4, 32>;   // the high nibble of every odd byte
+
+  Since offsets and widths are template parameters, every decoder is a handful of loads, shifts
+  and masks the compiler can fully unroll, with no branches on the layout.
+*/
+
+//--------------------------------------------------------------------------------------------------
+
+namespace detail
+{
+
+//! Load nBytes_ bytes as a little-endian value
+template <size_t nBytes_>
+struct LoadLittleEndian
+{
+  static uint32_t load(const uint8_t* pData_) noexcept
+  {
+    return pData_[0] | (LoadLittleEndian<nBytes_ - 1>::load(pData_ + 1) << 8);
+  }
+};
+
+template <>
+struct LoadLittleEndian<1>
+{
+  static uint32_t load(const uint8_t* pData_) noexcept
+  {
+    return pData_[0];
+  }
+};
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class ReportField
+  \brief An unsigned field of kBits bits, starting at bit kBit of byte kOffset
+
+  Fields can span up to four bytes and are little-endian, as HID report fields are.
+*/
+
+template <size_t kOffset, unsigned kBit, unsigned kBits>
+struct ReportField
+{
+  static_assert(kBit < 8, "The first bit must be within the first byte");
+  static_assert(kBits > 0 && kBit + kBits <= 32, "Fields can span at most four bytes");
+
+  static constexpr size_t kBytes = (kBit + kBits + 7) / 8;
+
+  //! Minimum report size for the field to be present
+  static constexpr size_t kEnd = kOffset + kBytes;
+
+  static constexpr uint32_t kMask = kBits == 32 ? 0xFFFFFFFF : ((1u << kBits) - 1);
+
+  static uint32_t decode(const uint8_t* pReport_) noexcept
+  {
+    return (detail::LoadLittleEndian<kBytes>::load(pReport_ + kOffset) >> kBit) & kMask;
+  }
+
+  static void encode(uint8_t* pReport_, uint32_t value_) noexcept
+  {
+    for (size_t i = 0; i < kBytes; i++)
+    {
+      uint32_t mask = (kMask << kBit) >> (i * 8);
+      uint32_t bits = ((value_ & kMask) << kBit) >> (i * 8);
+      pReport_[kOffset + i] = static_cast<uint8_t>((pReport_[kOffset + i] & ~mask) | (bits & mask));
+    }
+  }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class ReportFieldArray
+  \brief kCount fields of the same layout, kStride bytes apart
+*/
+
+template <size_t kOffset, size_t kStride, unsigned kBit, unsigned kBits, size_t kCount>
+struct ReportFieldArray
+{
+  static constexpr size_t kSize = kCount;
+  static constexpr size_t kEnd = ReportField<kOffset + (kCount - 1) * kStride, kBit, kBits>::kEnd;
+
+  static uint32_t decode(const uint8_t* pReport_, size_t index_) noexcept
+  {
+    return ReportField<0, kBit, kBits>::decode(pReport_ + kOffset + index_ * kStride);
+  }
+
+  static void encode(uint8_t* pReport_, size_t index_, uint32_t value_) noexcept
+  {
+    ReportField<0, kBit, kBits>::encode(pReport_ + kOffset + index_ * kStride, value_);
+  }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class ReportBitmap
+  \brief kCount one-bit fields (e.g. buttons) packed LSB first, starting at byte kOffset
+*/
+
+template <size_t kOffset, size_t kCount>
+struct ReportBitmap
+{
+  static constexpr size_t kSize = kCount;
+  static constexpr size_t kBytes = (kCount + 7) / 8;
+  static constexpr size_t kEnd = kOffset + kBytes;
+
+  static bool test(const uint8_t* pReport_, size_t index_) noexcept
+  {
+    return ((pReport_[kOffset + (index_ >> 3)] >> (index_ & 7)) & 1) != 0;
+  }
+
+  //! Compare the bitmap with its previous state, calling onChange_(index, value) for each change
+  /*!
+     Unchanged bytes are skipped with a single comparison. The state of each changed bit is
+     updated before onChange_ is called; if onChange_ returns false the scan stops, leaving the
+     remaining changes to be reported by the next call.
+     \param pReport_    The report
+     \param pState_     The previous state of the bitmap, kBytes bytes
+     \param onChange_   The callback, bool(size_t index, bool value)
+     \return            FALSE if the scan was stopped by onChange_
+  */
+  template <typename F>
+  static bool diff(const uint8_t* pReport_, uint8_t* pState_, F onChange_)
+  {
+    for (size_t i = 0; i < kBytes; i++)
+    {
+      uint8_t changed = pReport_[kOffset + i] ^ pState_[i];
+      for (unsigned k = 0; changed != 0; k++, changed >>= 1)
+      {
+        size_t index = (i * 8) + k;
+        if ((changed & 1) == 0 || index >= kCount)
+        {
+          continue;
+        }
+        uint8_t bit = static_cast<uint8_t>(1 << k);
+        pState_[i] ^= bit;
+        if (!onChange_(index, (pState_[i] & bit) != 0))
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class OutputReport
+  \brief An output report with ID kId and a kSize-byte payload, ready to be written as is
+
+  Indices refer to the payload, the report ID is kept at the start of the underlying transfer so
+  that no header has to be prepended when the report is sent.
+*/
+
+template <uint8_t kId, size_t kSize>
+class OutputReport
+{
+public:
+  OutputReport() : m_transfer(kSize + 1)
+  {
+    m_transfer[0] = kId;
+  }
+
+  uint8_t& operator[](size_t index_)
+  {
+    return m_transfer[static_cast<int>(index_ + 1)];
+  }
+
+  const uint8_t& operator[](size_t index_) const
+  {
+    return m_transfer[static_cast<int>(index_ + 1)];
+  }
+
+  //! Update a payload byte
+  /*!
+     \return TRUE if the value has changed
+  */
+  bool set(size_t index_, uint8_t value_)
+  {
+    uint8_t& current = (*this)[index_];
+    bool changed = current != value_;
+    current = value_;
+    return changed;
+  }
+
+  void fill(uint8_t value_)
+  {
+    std::fill_n(&(*this)[0], kSize, value_);
+  }
+
+  static constexpr size_t size()
+  {
+    return kSize;
+  }
+
+  const Transfer& transfer() const
+  {
+    return m_transfer;
+  }
+
+private:
+  Transfer m_transfer;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,134 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/devices/InputMask.h"
+
+#include <algorithm>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+constexpr size_t InputMask::kNumClasses;
+constexpr unsigned InputMask::kNumIndices;
+constexpr uint64_t InputMask::kTimingInterval;
+
+//--------------------------------------------------------------------------------------------------
+
+InputMask::InputMask()
+{
+  reset();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void InputMask::subscribe(Class class_, unsigned first_, unsigned count_)
+{
+  set(class_, first_, count_, true);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void InputMask::unsubscribe(Class class_, unsigned first_, unsigned count_)
+{
+  set(class_, first_, count_, false);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void InputMask::reset()
+{
+  for (Bits& bits : m_bits)
+  {
+    for (std::atomic<uint32_t>& word : bits)
+    {
+      word = 0xFFFFFFFF;
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool InputMask::wantsAny(Class class_) const noexcept
+{
+  const Bits& bits = m_bits[static_cast<size_t>(class_)];
+  return std::any_of(bits.begin(), bits.end(), [](const std::atomic<uint32_t>& word_) {
+    return word_.load(std::memory_order_relaxed) != 0;
+  });
+}
+
+//--------------------------------------------------------------------------------------------------
+
+InputMask::Usage InputMask::usage(Class class_) const
+{
+  const Counters& counters = m_counters[static_cast<size_t>(class_)];
+  return {counters.reportsDecoded,
+    counters.reportsSkipped,
+    counters.eventsSkipped,
+    std::chrono::nanoseconds(counters.decodeTimeNs)};
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void InputMask::set(Class class_, unsigned first_, unsigned count_, bool subscribed_)
+{
+  Bits& bits = m_bits[static_cast<size_t>(class_)];
+  unsigned last = std::min(first_ + std::min(count_, kNumIndices), kNumIndices);
+  for (unsigned index = first_; index < last; index++)
+  {
+    uint32_t mask = 1u << (index % 32);
+    if (subscribed_)
+    {
+      bits[index / 32].fetch_or(mask);
+    }
+    else
+    {
+      bits[index / 32].fetch_and(~mask);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool InputMask::countDecoded(Class class_) noexcept
+{
+  Counters& counters = m_counters[static_cast<size_t>(class_)];
+  return counters.reportsDecoded.fetch_add(1, std::memory_order_relaxed) % kTimingInterval == 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void InputMask::recordDecodeTime(Class class_, std::chrono::nanoseconds time_) noexcept
+{
+  // Moving average over the last few samples, written by the I/O thread only
+  std::atomic<int64_t>& average = m_counters[static_cast<size_t>(class_)].decodeTimeNs;
+  int64_t previous = average.load(std::memory_order_relaxed);
+  int64_t sample = time_.count();
+  average.store(previous == 0 ? sample : previous + (sample - previous) / 8);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void InputMask::countSkipped(Class class_) noexcept
+{
+  m_counters[static_cast<size_t>(class_)].reportsSkipped.fetch_add(1, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void InputMask::countSkippedEvent(Class class_) noexcept
+{
+  m_counters[static_cast<size_t>(class_)].eventsSkipped.fetch_add(1, std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
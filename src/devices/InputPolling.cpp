@@ -0,0 +1,99 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/devices/InputPolling.h"
+
+#include <algorithm>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+void InputPolling::setSettings(const Settings& settings_)
+{
+  m_activeUs = settings_.active.count();
+  m_idleUs = settings_.idle.count();
+  m_floorUs = settings_.floor.count();
+  m_idleAfterUs
+    = std::chrono::duration_cast<std::chrono::microseconds>(settings_.idleAfter).count();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+InputPolling::Settings InputPolling::settings() const
+{
+  Settings settings;
+  settings.active = std::chrono::microseconds(m_activeUs);
+  settings.idle = std::chrono::microseconds(m_idleUs);
+  settings.floor = std::chrono::microseconds(m_floorUs);
+  settings.idleAfter = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::microseconds(m_idleAfterUs));
+  return settings;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void InputPolling::reset(tClock::time_point now_)
+{
+  m_activity = false;
+  m_intervalUs = m_activeUs.load();
+  m_lastPoll = tClock::time_point();
+  m_lastActivity = now_;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool InputPolling::due(tClock::time_point now_) noexcept
+{
+  int64_t intervalUs = m_intervalUs.load(std::memory_order_relaxed);
+
+  // The changes decoded since the previous poll snap the interval back
+  if (m_activity.exchange(false, std::memory_order_relaxed))
+  {
+    intervalUs = m_activeUs;
+    m_lastActivity = m_lastPoll;
+  }
+
+  if (now_ < m_lastPoll + std::chrono::microseconds(intervalUs))
+  {
+    m_intervalUs.store(intervalUs, std::memory_order_relaxed);
+    return false;
+  }
+
+  // Back off exponentially, the interval of the next poll is set now and reset by the input
+  // decoded from this one, if any
+  if (now_ - m_lastActivity >= std::chrono::microseconds(m_idleAfterUs))
+  {
+    int64_t idleUs = m_idleUs;
+    intervalUs = std::min<int64_t>(intervalUs < idleUs ? idleUs : intervalUs * 2, m_floorUs);
+    intervalUs = std::max<int64_t>(intervalUs, m_activeUs);
+  }
+
+  m_intervalUs.store(intervalUs, std::memory_order_relaxed);
+  m_lastPoll = now_;
+  m_polls.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+InputPolling::tClock::time_point InputPolling::next() const noexcept
+{
+  if (m_activity.load(std::memory_order_relaxed))
+  {
+    return m_lastPoll + std::chrono::microseconds(m_activeUs);
+  }
+  return m_lastPoll + std::chrono::microseconds(m_intervalUs);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
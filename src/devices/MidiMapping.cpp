@@ -0,0 +1,287 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/devices/MidiMapping.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+constexpr size_t MidiMapping::kNumButtons;
+constexpr size_t MidiMapping::kNumKeys;
+constexpr size_t MidiMapping::kNumEncoders;
+constexpr size_t MidiMapping::kNumControls;
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+const uint8_t kNoteOff = 0x80;
+const uint8_t kNoteOn = 0x90;
+const uint8_t kPolyPressure = 0xA0;
+const uint8_t kControlChange = 0xB0;
+const uint8_t kPitchBend = 0xE0;
+
+const uint8_t kEncoderCenter = 64;
+const uint8_t kNoValue = 0xFF;
+
+//--------------------------------------------------------------------------------------------------
+
+uint8_t toMidiValue(double value_)
+{
+  return static_cast<uint8_t>(std::min(std::max(value_, 0.0), 1.0) * 127.0 + 0.5);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+template <size_t N>
+void addRule(std::array<int16_t, N>& lookup_, const MidiMapping::Rule& rule_, int16_t index_)
+{
+  for (unsigned i = rule_.first; i < rule_.first + rule_.count && i < N; i++)
+  {
+    lookup_[i] = index_;
+  }
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+MidiMapping::MidiMapping()
+{
+  m_encoderValues.fill(kEncoderCenter);
+  m_controlValues.fill(kNoValue);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+MidiMapping::~MidiMapping()
+{
+  delete m_pTable.load();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void MidiMapping::load(tRules rules_, tOutput output_)
+{
+  Table* pTable = new Table;
+  pTable->buttons.fill(-1);
+  pTable->keys.fill(-1);
+  pTable->encoders.fill(-1);
+  pTable->controls.fill(-1);
+
+  uint8_t sources = 0;
+  for (size_t i = 0; i < rules_.size() && i < size_t(std::numeric_limits<int16_t>::max()); i++)
+  {
+    const Rule& rule = rules_[i];
+    int16_t index = static_cast<int16_t>(i);
+    sources |= 1 << static_cast<unsigned>(rule.source);
+    switch (rule.source)
+    {
+      case Source::Button:
+        addRule(pTable->buttons, rule, index);
+        break;
+      case Source::Key:
+        addRule(pTable->keys, rule, index);
+        break;
+      case Source::Encoder:
+        addRule(pTable->encoders, rule, index);
+        break;
+      case Source::Control:
+        addRule(pTable->controls, rule, index);
+        break;
+    }
+  }
+  pTable->rules = std::move(rules_);
+  pTable->output = std::move(output_);
+
+  replace(pTable, sources);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void MidiMapping::clear()
+{
+  replace(nullptr, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void MidiMapping::replace(Table* pTable_, uint8_t sources_)
+{
+  std::lock_guard<std::mutex> lock(m_mtxLoad);
+  Table* pPrevious = m_pTable.exchange(pTable_);
+  m_sources = sources_;
+
+  // A translation started before the exchange may still use the previous table, the ones started
+  // after it use the new one
+  while (m_nTranslating != 0)
+  {
+    std::this_thread::yield();
+  }
+  delete pPrevious;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool MidiMapping::translate(Source source_, unsigned index_, double value_) noexcept
+{
+  m_nTranslating++;
+  const Table* pTable = m_pTable.load();
+  bool sent = pTable != nullptr && translate(*pTable, source_, index_, value_);
+  m_nTranslating--;
+  return sent;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool MidiMapping::translate(
+  const Table& table_, Source source_, unsigned index_, double value_) noexcept
+{
+  int16_t ruleIndex = -1;
+  switch (source_)
+  {
+    case Source::Button:
+      ruleIndex = index_ < kNumButtons ? table_.buttons[index_] : -1;
+      break;
+    case Source::Key:
+      ruleIndex = index_ < kNumKeys ? table_.keys[index_] : -1;
+      break;
+    case Source::Encoder:
+      ruleIndex = index_ < kNumEncoders ? table_.encoders[index_] : -1;
+      break;
+    case Source::Control:
+      ruleIndex = index_ < kNumControls ? table_.controls[index_] : -1;
+      break;
+  }
+  if (ruleIndex < 0 || !table_.output)
+  {
+    return false;
+  }
+
+  const Rule& rule = table_.rules[static_cast<size_t>(ruleIndex)];
+  unsigned number = rule.number + (index_ - rule.first);
+  if (number > 127)
+  {
+    return false;
+  }
+
+  uint8_t channel = rule.channel & 0x0F;
+  uint8_t message[3]{0, static_cast<uint8_t>(number), 0};
+  switch (rule.message)
+  {
+    case Message::Note:
+    case Message::NoteWithPressure:
+    {
+      bool pressed = value_ > 0.0;
+      bool held = false;
+      if (source_ == Source::Button)
+      {
+        held = m_heldButtons[index_];
+        m_heldButtons[index_] = pressed;
+      }
+      else if (source_ == Source::Key)
+      {
+        held = m_heldKeys[index_];
+        m_heldKeys[index_] = pressed;
+      }
+      else
+      {
+        return false;
+      }
+
+      if (pressed && !held)
+      {
+        message[0] = kNoteOn | channel;
+        message[2] = source_ == Source::Key ? std::max<uint8_t>(toMidiValue(value_), 1) : 127;
+      }
+      else if (pressed && rule.message == Message::NoteWithPressure && source_ == Source::Key)
+      {
+        message[0] = kPolyPressure | channel;
+        message[2] = toMidiValue(value_);
+      }
+      else if (!pressed && held)
+      {
+        message[0] = kNoteOff | channel;
+      }
+      else
+      {
+        return false;
+      }
+      break;
+    }
+    case Message::ControlChange:
+    case Message::RelativeControlChange:
+    {
+      message[0] = kControlChange | channel;
+      if (source_ == Source::Encoder)
+      {
+        uint8_t& current = m_encoderValues[index_];
+        if (rule.message == Message::RelativeControlChange)
+        {
+          message[2] = value_ > 0.0 ? 1 : 127;
+        }
+        else if (value_ > 0.0 ? current < 127 : current > 0)
+        {
+          current = value_ > 0.0 ? current + 1 : current - 1;
+          message[2] = current;
+        }
+        else
+        {
+          return false;
+        }
+      }
+      else if (source_ == Source::Button)
+      {
+        message[2] = value_ > 0.0 ? 127 : 0;
+      }
+      else
+      {
+        message[2] = toMidiValue(value_);
+        // Pads and strips report more than 7 bits, only send what MIDI can tell apart
+        if (source_ == Source::Control)
+        {
+          if (m_controlValues[index_] == message[2])
+          {
+            return false;
+          }
+          m_controlValues[index_] = message[2];
+        }
+      }
+      break;
+    }
+    case Message::PitchBend:
+    {
+      if (source_ != Source::Key && source_ != Source::Control)
+      {
+        return false;
+      }
+      unsigned bend = static_cast<unsigned>(std::min(std::max(value_, 0.0), 1.0) * 16383.0 + 0.5);
+      message[0] = kPitchBend | channel;
+      message[1] = bend & 0x7F;
+      message[2] = (bend >> 7) & 0x7F;
+      break;
+    }
+  }
+
+  table_.output(message, sizeof(message));
+  m_messagesSent++;
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,325 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/devices/PageCache.h"
+
+#include "cabl/gfx/Canvas.h"
+#include "cabl/gfx/TextDisplay.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+const Color kLedOff(0, 0, 0, 0);
+
+template <typename K, typename F>
+void updateLedMap(const std::map<K, Color>* pPrevious_, const std::map<K, Color>& next_, F setLed_)
+{
+  if (pPrevious_)
+  {
+    for (const auto& led : *pPrevious_)
+    {
+      if (next_.find(led.first) == next_.end())
+      {
+        setLed_(led.first, kLedOff);
+      }
+    }
+  }
+
+  for (const auto& led : next_)
+  {
+    if (pPrevious_)
+    {
+      auto it = pPrevious_->find(led.first);
+      if (it != pPrevious_->end() && it->second == led.second)
+      {
+        continue;
+      }
+    }
+    setLed_(led.first, led.second);
+  }
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+PageCache::PageCache(Device& device_, size_t maxBytes_) : m_device(device_), m_maxBytes(maxBytes_)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+
+PageCache::~PageCache()
+{
+  while (!m_pages.empty())
+  {
+    erase(m_pages.begin());
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool PageCache::show(const std::string& name_)
+{
+  auto itActive = m_pages.find(m_activePage);
+  if (itActive != m_pages.end() && m_activePage == name_)
+  {
+    return true;
+  }
+
+  Page* pPrevious = nullptr;
+  if (itActive != m_pages.end())
+  {
+    store(itActive->second);
+    pPrevious = &itActive->second;
+  }
+
+  auto it = m_pages.find(name_);
+  bool cached = it != m_pages.end();
+  if (cached)
+  {
+    restore(it->second);
+    m_lru.splice(m_lru.begin(), m_lru, it->second.itLru);
+  }
+  else
+  {
+    it = m_pages.emplace(name_, Page{}).first;
+    m_lru.push_front(name_);
+    it->second.itLru = m_lru.begin();
+    clearDevice();
+  }
+
+  updateLeds(pPrevious, it->second);
+  m_activePage = name_;
+  trim();
+
+  return cached;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool PageCache::contains(const std::string& name_) const
+{
+  return m_pages.find(name_) != m_pages.end();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void PageCache::invalidate(const std::string& name_)
+{
+  auto it = m_pages.find(name_);
+  if (it == m_pages.end())
+  {
+    return;
+  }
+
+  if (name_ == m_activePage)
+  {
+    m_activePage.clear();
+  }
+  erase(it);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void PageCache::clear()
+{
+  auto it = m_pages.begin();
+  while (it != m_pages.end())
+  {
+    if (it->first == m_activePage)
+    {
+      it++;
+      continue;
+    }
+    erase(it++);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void PageCache::setButtonLed(Device::Button button_, const Color& color_)
+{
+  auto it = m_pages.find(m_activePage);
+  if (it != m_pages.end())
+  {
+    it->second.buttonLeds[button_] = color_;
+  }
+  m_device.setButtonLed(button_, color_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void PageCache::setKeyLed(unsigned index_, const Color& color_)
+{
+  auto it = m_pages.find(m_activePage);
+  if (it != m_pages.end())
+  {
+    it->second.keyLeds[index_] = color_;
+  }
+  m_device.setKeyLed(index_, color_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void PageCache::setMaxBytes(size_t maxBytes_)
+{
+  m_maxBytes = maxBytes_;
+  trim();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::vector<Canvas*> PageCache::canvases() const
+{
+  std::vector<Canvas*> collCanvases;
+  for (size_t i = 0; i < m_device.numOfGraphicDisplays(); i++)
+  {
+    collCanvases.push_back(m_device.graphicDisplay(i));
+  }
+  for (size_t i = 0; i < m_device.numOfLedMatrices(); i++)
+  {
+    collCanvases.push_back(m_device.ledMatrix(i));
+  }
+  return collCanvases;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void PageCache::store(Page& page_)
+{
+  size_t bytes = 0;
+
+  auto collCanvases = canvases();
+  page_.canvasBuffers.resize(collCanvases.size());
+  for (size_t i = 0; i < collCanvases.size(); i++)
+  {
+    auto& buffer = page_.canvasBuffers[i];
+    if (!buffer)
+    {
+      buffer = BufferPool::instance().acquire(collCanvases[i]->bufferSize());
+    }
+
+    if (!collCanvases[i]->swapBuffer(buffer))
+    {
+      BufferPool::instance().release(collCanvases[i]->bufferSize(), std::move(buffer));
+      continue;
+    }
+    bytes += collCanvases[i]->bufferSize();
+  }
+
+  page_.textDisplays.resize(m_device.numOfTextDisplays());
+  for (size_t i = 0; i < page_.textDisplays.size(); i++)
+  {
+    const TextDisplay* pDisplay = m_device.textDisplay(i);
+    page_.textDisplays[i].assign(
+      pDisplay->displayData(), pDisplay->displayData() + pDisplay->dataSize());
+    bytes += page_.textDisplays[i].size();
+  }
+
+  m_cachedBytes = m_cachedBytes - page_.bytes + bytes;
+  page_.bytes = bytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void PageCache::restore(Page& page_)
+{
+  // The buffers currently in the canvases become the spare buffers of the page
+  auto collCanvases = canvases();
+  for (size_t i = 0; i < collCanvases.size(); i++)
+  {
+    if (i >= page_.canvasBuffers.size() || !collCanvases[i]->swapBuffer(page_.canvasBuffers[i]))
+    {
+      collCanvases[i]->black();
+    }
+  }
+
+  for (size_t i = 0; i < m_device.numOfTextDisplays(); i++)
+  {
+    TextDisplay* pDisplay = m_device.textDisplay(i);
+    if (i < page_.textDisplays.size())
+    {
+      pDisplay->setDisplayData(page_.textDisplays[i].data(), page_.textDisplays[i].size());
+    }
+    else
+    {
+      pDisplay->clear();
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void PageCache::clearDevice()
+{
+  for (auto pCanvas : canvases())
+  {
+    pCanvas->black();
+  }
+
+  for (size_t i = 0; i < m_device.numOfTextDisplays(); i++)
+  {
+    m_device.textDisplay(i)->clear();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void PageCache::updateLeds(const Page* pPrevious_, const Page& next_)
+{
+  updateLedMap(pPrevious_ ? &pPrevious_->buttonLeds : nullptr,
+    next_.buttonLeds,
+    [this](Device::Button button_, const Color& color_) {
+      m_device.setButtonLed(button_, color_);
+    });
+
+  updateLedMap(pPrevious_ ? &pPrevious_->keyLeds : nullptr,
+    next_.keyLeds,
+    [this](unsigned index_, const Color& color_) { m_device.setKeyLed(index_, color_); });
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void PageCache::erase(std::map<std::string, Page>::iterator it_)
+{
+  auto collCanvases = canvases();
+  auto& buffers = it_->second.canvasBuffers;
+  for (size_t i = 0; i < buffers.size() && i < collCanvases.size(); i++)
+  {
+    if (buffers[i])
+    {
+      BufferPool::instance().release(collCanvases[i]->bufferSize(), std::move(buffers[i]));
+    }
+  }
+
+  m_cachedBytes -= it_->second.bytes;
+  m_lru.erase(it_->second.itLru);
+  m_pages.erase(it_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void PageCache::trim()
+{
+  while (m_cachedBytes > m_maxBytes && !m_lru.empty() && m_lru.back() != m_activePage)
+  {
+    erase(m_pages.find(m_lru.back()));
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -14,6 +14,7 @@
 #include "cabl/comm/Driver.h"
 #include "cabl/comm/Transfer.h"
 #include "cabl/util/Functions.h"
+#include "cabl/util/LookupTable.h"
 
 #include "cabl/gfx/TextDisplay.h"
 #include "gfx/displays/NullCanvas.h"
@@ -30,6 +31,7 @@ namespace
 {
 const std::string kPush2_midiPortName = "Ableton Push 2 Live Port";
 const uint8_t kPush_epOut = 0x01;
+const size_t kPush_maxCachedColors = 512; // Animated colors would otherwise grow the cache forever
 
 // clang-format off
 const std::vector<sl::cabl::Color> kPush_colors{
@@ -408,87 +410,84 @@ bool Push2::isRGBLed(Led led_) const noexcept
 
 Push2::Led Push2::led(Device::Button btn_) const noexcept
 {
-#define M_LED_CASE(idLed)     \
-  case Device::Button::idLed: \
-    return Led::idLed
-
-  switch (btn_)
-  {
-    M_LED_CASE(TapTempo);
-    M_LED_CASE(Metronome);
-    M_LED_CASE(TouchStripTap);
-    M_LED_CASE(Btn1Row1);
-    M_LED_CASE(Btn2Row1);
-    M_LED_CASE(Btn3Row1);
-    M_LED_CASE(Btn4Row1);
-    M_LED_CASE(Btn5Row1);
-    M_LED_CASE(Btn6Row1);
-    M_LED_CASE(Btn7Row1);
-    M_LED_CASE(Btn8Row1);
-    M_LED_CASE(Master);
-    M_LED_CASE(Stop);
-    M_LED_CASE(Setup);
-    M_LED_CASE(Layout);
-    M_LED_CASE(Convert);
-    M_LED_CASE(Grid1_4);
-    M_LED_CASE(Grid1_4T);
-    M_LED_CASE(Grid1_8);
-    M_LED_CASE(Grid1_8T);
-    M_LED_CASE(Grid1_16);
-    M_LED_CASE(Grid1_16T);
-    M_LED_CASE(Grid1_32);
-    M_LED_CASE(Grid1_32T);
-    M_LED_CASE(NavigateLeft);
-    M_LED_CASE(NavigateRight);
-    M_LED_CASE(NavigateUp);
-    M_LED_CASE(NavigateDown);
-    M_LED_CASE(Select);
-    M_LED_CASE(Shift);
-    M_LED_CASE(Note);
-    M_LED_CASE(Session);
-    M_LED_CASE(AddEffect);
-    M_LED_CASE(AddTrack);
-    M_LED_CASE(OctaveDown);
-    M_LED_CASE(OctaveUp);
-    M_LED_CASE(Repeat);
-    M_LED_CASE(Accent);
-    M_LED_CASE(Scales);
-    M_LED_CASE(User);
-    M_LED_CASE(Solo);
-    M_LED_CASE(Mute);
-    M_LED_CASE(In);
-    M_LED_CASE(Out);
-    M_LED_CASE(Play);
-    M_LED_CASE(Rec);
-    M_LED_CASE(New);
-    M_LED_CASE(Duplicate);
-    M_LED_CASE(Automation);
-    M_LED_CASE(FixedLength);
-    M_LED_CASE(Btn1Row2);
-    M_LED_CASE(Btn2Row2);
-    M_LED_CASE(Btn3Row2);
-    M_LED_CASE(Btn4Row2);
-    M_LED_CASE(Btn5Row2);
-    M_LED_CASE(Btn6Row2);
-    M_LED_CASE(Btn7Row2);
-    M_LED_CASE(Btn8Row2);
-    M_LED_CASE(Device);
-    M_LED_CASE(Browse);
-    M_LED_CASE(Track);
-    M_LED_CASE(Clip);
-    M_LED_CASE(Volume);
-    M_LED_CASE(PanSend);
-    M_LED_CASE(Quantize);
-    M_LED_CASE(Double);
-    M_LED_CASE(Delete);
-    M_LED_CASE(Undo);
-    default:
-    {
-      return Led::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_LED_MAP(idLed) {Device::Button::idLed, Led::idLed}
+
+  static constexpr Mapping<Device::Button, Led> kMapping[]{
+    M_LED_MAP(TapTempo),
+    M_LED_MAP(Metronome),
+    M_LED_MAP(TouchStripTap),
+    M_LED_MAP(Btn1Row1),
+    M_LED_MAP(Btn2Row1),
+    M_LED_MAP(Btn3Row1),
+    M_LED_MAP(Btn4Row1),
+    M_LED_MAP(Btn5Row1),
+    M_LED_MAP(Btn6Row1),
+    M_LED_MAP(Btn7Row1),
+    M_LED_MAP(Btn8Row1),
+    M_LED_MAP(Master),
+    M_LED_MAP(Stop),
+    M_LED_MAP(Setup),
+    M_LED_MAP(Layout),
+    M_LED_MAP(Convert),
+    M_LED_MAP(Grid1_4),
+    M_LED_MAP(Grid1_4T),
+    M_LED_MAP(Grid1_8),
+    M_LED_MAP(Grid1_8T),
+    M_LED_MAP(Grid1_16),
+    M_LED_MAP(Grid1_16T),
+    M_LED_MAP(Grid1_32),
+    M_LED_MAP(Grid1_32T),
+    M_LED_MAP(NavigateLeft),
+    M_LED_MAP(NavigateRight),
+    M_LED_MAP(NavigateUp),
+    M_LED_MAP(NavigateDown),
+    M_LED_MAP(Select),
+    M_LED_MAP(Shift),
+    M_LED_MAP(Note),
+    M_LED_MAP(Session),
+    M_LED_MAP(AddEffect),
+    M_LED_MAP(AddTrack),
+    M_LED_MAP(OctaveDown),
+    M_LED_MAP(OctaveUp),
+    M_LED_MAP(Repeat),
+    M_LED_MAP(Accent),
+    M_LED_MAP(Scales),
+    M_LED_MAP(User),
+    M_LED_MAP(Solo),
+    M_LED_MAP(Mute),
+    M_LED_MAP(In),
+    M_LED_MAP(Out),
+    M_LED_MAP(Play),
+    M_LED_MAP(Rec),
+    M_LED_MAP(New),
+    M_LED_MAP(Duplicate),
+    M_LED_MAP(Automation),
+    M_LED_MAP(FixedLength),
+    M_LED_MAP(Btn1Row2),
+    M_LED_MAP(Btn2Row2),
+    M_LED_MAP(Btn3Row2),
+    M_LED_MAP(Btn4Row2),
+    M_LED_MAP(Btn5Row2),
+    M_LED_MAP(Btn6Row2),
+    M_LED_MAP(Btn7Row2),
+    M_LED_MAP(Btn8Row2),
+    M_LED_MAP(Device),
+    M_LED_MAP(Browse),
+    M_LED_MAP(Track),
+    M_LED_MAP(Clip),
+    M_LED_MAP(Volume),
+    M_LED_MAP(PanSend),
+    M_LED_MAP(Quantize),
+    M_LED_MAP(Double),
+    M_LED_MAP(Delete),
+    M_LED_MAP(Undo),
+  };
+  static constexpr LookupTable<Device::Button, Led, enumRange<Device::Button>()> kLeds(
+    kMapping, Led::Unknown);
+
+#undef M_LED_MAP
+
+  return kLeds[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -508,98 +507,95 @@ Push2::Led Push2::led(unsigned index_) const noexcept
 
 Device::Button Push2::deviceButton(Button btn_) const noexcept
 {
-#define M_BTN_CASE(idBtn) \
-  case Button::idBtn:     \
-    return Device::Button::idBtn
-
-  switch (btn_)
-  {
-    M_BTN_CASE(TapTempo);
-    M_BTN_CASE(Metronome);
-    M_BTN_CASE(TouchStripTap);
-    M_BTN_CASE(Btn1Row1);
-    M_BTN_CASE(Btn2Row1);
-    M_BTN_CASE(Btn3Row1);
-    M_BTN_CASE(Btn4Row1);
-    M_BTN_CASE(Btn5Row1);
-    M_BTN_CASE(Btn6Row1);
-    M_BTN_CASE(Btn7Row1);
-    M_BTN_CASE(Btn8Row1);
-    M_BTN_CASE(Master);
-    M_BTN_CASE(Stop);
-    M_BTN_CASE(Setup);
-    M_BTN_CASE(Layout);
-    M_BTN_CASE(Convert);
-    M_BTN_CASE(Grid1_4);
-    M_BTN_CASE(Grid1_4T);
-    M_BTN_CASE(Grid1_8);
-    M_BTN_CASE(Grid1_8T);
-    M_BTN_CASE(Grid1_16);
-    M_BTN_CASE(Grid1_16T);
-    M_BTN_CASE(Grid1_32);
-    M_BTN_CASE(Grid1_32T);
-    M_BTN_CASE(NavigateLeft);
-    M_BTN_CASE(NavigateRight);
-    M_BTN_CASE(NavigateUp);
-    M_BTN_CASE(NavigateDown);
-    M_BTN_CASE(Select);
-    M_BTN_CASE(Shift);
-    M_BTN_CASE(Note);
-    M_BTN_CASE(Session);
-    M_BTN_CASE(AddEffect);
-    M_BTN_CASE(AddTrack);
-    M_BTN_CASE(OctaveDown);
-    M_BTN_CASE(OctaveUp);
-    M_BTN_CASE(Repeat);
-    M_BTN_CASE(Accent);
-    M_BTN_CASE(Scales);
-    M_BTN_CASE(User);
-    M_BTN_CASE(Solo);
-    M_BTN_CASE(Mute);
-    M_BTN_CASE(In);
-    M_BTN_CASE(Out);
-    M_BTN_CASE(Play);
-    M_BTN_CASE(Rec);
-    M_BTN_CASE(New);
-    M_BTN_CASE(Duplicate);
-    M_BTN_CASE(Automation);
-    M_BTN_CASE(FixedLength);
-    M_BTN_CASE(Btn1Row2);
-    M_BTN_CASE(Btn2Row2);
-    M_BTN_CASE(Btn3Row2);
-    M_BTN_CASE(Btn4Row2);
-    M_BTN_CASE(Btn5Row2);
-    M_BTN_CASE(Btn6Row2);
-    M_BTN_CASE(Btn7Row2);
-    M_BTN_CASE(Btn8Row2);
-    M_BTN_CASE(Device);
-    M_BTN_CASE(Browse);
-    M_BTN_CASE(Track);
-    M_BTN_CASE(Clip);
-    M_BTN_CASE(Volume);
-    M_BTN_CASE(PanSend);
-    M_BTN_CASE(Quantize);
-    M_BTN_CASE(Double);
-    M_BTN_CASE(Delete);
-    M_BTN_CASE(Undo);
-    M_BTN_CASE(TouchEncoder1);
-    M_BTN_CASE(TouchEncoder2);
-    M_BTN_CASE(TouchEncoder3);
-    M_BTN_CASE(TouchEncoder4);
-    M_BTN_CASE(TouchEncoder5);
-    M_BTN_CASE(TouchEncoder6);
-    M_BTN_CASE(TouchEncoder7);
-    M_BTN_CASE(TouchEncoder8);
-    M_BTN_CASE(TouchEncoder9);
-    M_BTN_CASE(TouchEncoderMain);
-    M_BTN_CASE(TouchEncoderMain2);
-    default:
-    {
-      return Device::Button::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_BTN_MAP(idBtn) {Button::idBtn, Device::Button::idBtn}
+
+  static constexpr Mapping<Button, Device::Button> kMapping[]{
+    M_BTN_MAP(TapTempo),
+    M_BTN_MAP(Metronome),
+    M_BTN_MAP(TouchStripTap),
+    M_BTN_MAP(Btn1Row1),
+    M_BTN_MAP(Btn2Row1),
+    M_BTN_MAP(Btn3Row1),
+    M_BTN_MAP(Btn4Row1),
+    M_BTN_MAP(Btn5Row1),
+    M_BTN_MAP(Btn6Row1),
+    M_BTN_MAP(Btn7Row1),
+    M_BTN_MAP(Btn8Row1),
+    M_BTN_MAP(Master),
+    M_BTN_MAP(Stop),
+    M_BTN_MAP(Setup),
+    M_BTN_MAP(Layout),
+    M_BTN_MAP(Convert),
+    M_BTN_MAP(Grid1_4),
+    M_BTN_MAP(Grid1_4T),
+    M_BTN_MAP(Grid1_8),
+    M_BTN_MAP(Grid1_8T),
+    M_BTN_MAP(Grid1_16),
+    M_BTN_MAP(Grid1_16T),
+    M_BTN_MAP(Grid1_32),
+    M_BTN_MAP(Grid1_32T),
+    M_BTN_MAP(NavigateLeft),
+    M_BTN_MAP(NavigateRight),
+    M_BTN_MAP(NavigateUp),
+    M_BTN_MAP(NavigateDown),
+    M_BTN_MAP(Select),
+    M_BTN_MAP(Shift),
+    M_BTN_MAP(Note),
+    M_BTN_MAP(Session),
+    M_BTN_MAP(AddEffect),
+    M_BTN_MAP(AddTrack),
+    M_BTN_MAP(OctaveDown),
+    M_BTN_MAP(OctaveUp),
+    M_BTN_MAP(Repeat),
+    M_BTN_MAP(Accent),
+    M_BTN_MAP(Scales),
+    M_BTN_MAP(User),
+    M_BTN_MAP(Solo),
+    M_BTN_MAP(Mute),
+    M_BTN_MAP(In),
+    M_BTN_MAP(Out),
+    M_BTN_MAP(Play),
+    M_BTN_MAP(Rec),
+    M_BTN_MAP(New),
+    M_BTN_MAP(Duplicate),
+    M_BTN_MAP(Automation),
+    M_BTN_MAP(FixedLength),
+    M_BTN_MAP(Btn1Row2),
+    M_BTN_MAP(Btn2Row2),
+    M_BTN_MAP(Btn3Row2),
+    M_BTN_MAP(Btn4Row2),
+    M_BTN_MAP(Btn5Row2),
+    M_BTN_MAP(Btn6Row2),
+    M_BTN_MAP(Btn7Row2),
+    M_BTN_MAP(Btn8Row2),
+    M_BTN_MAP(Device),
+    M_BTN_MAP(Browse),
+    M_BTN_MAP(Track),
+    M_BTN_MAP(Clip),
+    M_BTN_MAP(Volume),
+    M_BTN_MAP(PanSend),
+    M_BTN_MAP(Quantize),
+    M_BTN_MAP(Double),
+    M_BTN_MAP(Delete),
+    M_BTN_MAP(Undo),
+    M_BTN_MAP(TouchEncoder1),
+    M_BTN_MAP(TouchEncoder2),
+    M_BTN_MAP(TouchEncoder3),
+    M_BTN_MAP(TouchEncoder4),
+    M_BTN_MAP(TouchEncoder5),
+    M_BTN_MAP(TouchEncoder6),
+    M_BTN_MAP(TouchEncoder7),
+    M_BTN_MAP(TouchEncoder8),
+    M_BTN_MAP(TouchEncoder9),
+    M_BTN_MAP(TouchEncoderMain),
+    M_BTN_MAP(TouchEncoderMain2),
+  };
+  static constexpr LookupTable<Button, Device::Button, enumRange<Button>()> kButtons(
+    kMapping, Device::Button::Unknown);
+
+#undef M_BTN_MAP
+
+  return kButtons[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -627,7 +623,11 @@ uint8_t Push2::getColorIndex(const Color& color_)
       break;
     }
   }
-  m_colorsCache.emplace(std::move(color_), colorIndex);
+  if (m_colorsCache.size() >= kPush_maxCachedColors)
+  {
+    m_colorsCache.clear();
+  }
+  m_colorsCache.emplace(color_, colorIndex);
   return colorIndex;
 }
 
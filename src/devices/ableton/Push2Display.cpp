@@ -52,7 +52,7 @@ Canvas* Push2Display::graphicDisplay(size_t displayIndex_)
 
 bool Push2Display::tick()
 {
-  if (m_display.dirty())
+  if (m_display.dirty() && displayFrameDue())
   {
     return sendDisplayData();
   }
@@ -73,12 +73,12 @@ void Push2Display::init()
 bool Push2Display::sendDisplayData() const
 {
   bool result = true;
-  writeToDeviceHandle(k_frameHeader, 0x01);
+  writeToDeviceHandle(k_frameHeader, 0x01, Traffic::Display);
 
   for (unsigned offset = 0; offset < m_display.bufferSize(); offset += 16384)
   {
     if (!writeToDeviceHandle(
-          Transfer({m_display.data() + offset, m_display.data() + offset + 16384}), 0x01))
+          Transfer::borrow(m_display.data() + offset, 16384), 0x01, Traffic::Display))
     {
       return false;
     }
@@ -104,6 +104,7 @@ private:
 
   std::array<uint8_t, kPush_ledsDataSize> m_leds;
   std::array<uint8_t, kPush_ledsDataSize> m_ledsPrev;
+  DeviceHandle::tCollTransfers m_ledTransfers;
 
   bool m_shiftPressed;
 
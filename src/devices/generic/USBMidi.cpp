@@ -22,9 +22,16 @@ namespace cabl
 //--------------------------------------------------------------------------------------------------
 
 bool USBMidi::sendSysex(const midi::SysEx& sysexMessage_)
+{
+  return sendSysex(sysexMessage_.data().data(), sysexMessage_.data().size());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool USBMidi::sendSysex(const uint8_t* pData_, size_t length_)
 {
 #if !ARDUINO
-  if (writeToDeviceHandle(Transfer(sysexMessage_.data()), 0))
+  if (writeToDeviceHandle(Transfer::borrow(pData_, length_), 0))
   {
     return true;
   }
@@ -33,7 +40,7 @@ bool USBMidi::sendSysex(const midi::SysEx& sysexMessage_)
   tRawData message(4);
   uint8_t nCable = 0;
   unsigned msgIndex = 0;
-  int bytesToSend = sysexMessage_.data().size();
+  int bytesToSend = length_;
 
   while (bytesToSend > 0)
   {
@@ -44,7 +51,7 @@ bool USBMidi::sendSysex(const midi::SysEx& sysexMessage_)
       case 1: // End with one byte
       {
         message[0] = (nCable << 4) | 0x05;
-        message[1] = sysexMessage_.data()[msgIndex++];
+        message[1] = pData_[msgIndex++];
         message[2] = 0x00;
         message[3] = 0x00;
         bytesToSend--;
@@ -53,8 +60,8 @@ bool USBMidi::sendSysex(const midi::SysEx& sysexMessage_)
       case 2: // End with two bytes
       {
         message[0] = (nCable << 4) | 0x06;
-        message[1] = sysexMessage_.data()[msgIndex++];
-        message[2] = sysexMessage_.data()[msgIndex++];
+        message[1] = pData_[msgIndex++];
+        message[2] = pData_[msgIndex++];
         message[3] = 0x00;
         bytesToSend -= 2;
         break;
@@ -65,9 +72,9 @@ bool USBMidi::sendSysex(const midi::SysEx& sysexMessage_)
       }
       default:
       {
-        message[1] = sysexMessage_.data()[msgIndex++];
-        message[2] = sysexMessage_.data()[msgIndex++];
-        message[3] = sysexMessage_.data()[msgIndex++];
+        message[1] = pData_[msgIndex++];
+        message[2] = pData_[msgIndex++];
+        message[3] = pData_[msgIndex++];
         bytesToSend -= 3;
         break;
       }
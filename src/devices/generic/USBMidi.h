@@ -63,6 +63,12 @@ public:
 
   bool sendSysex(const SysEx&);
 
+  //! Send a complete sysex message, including the 0xF0 and 0xF7 delimiters
+  /*!
+     Neither copies nor allocates, so that the message can be assembled in the device frame arena
+  */
+  bool sendSysex(const uint8_t* pData_, size_t length_);
+
 private:
 };
 
@@ -11,6 +11,7 @@
 #include "cabl/comm/Transfer.h"
 #include "cabl/gfx/TextDisplay.h"
 #include "cabl/util/Functions.h"
+#include "cabl/util/LookupTable.h"
 #include "devices/ni/KompleteKontrol.h"
 
 //--------------------------------------------------------------------------------------------------
@@ -391,20 +392,25 @@ void KompleteKontrolBase::init()
 bool KompleteKontrolBase::sendDisplayData()
 {
   bool result = true;
+  if (!displayFrameDue())
+  {
+    return result;
+  }
+
+  const uint8_t header[]{0xe0, 0x00, 0x00, 0x00, 0x00, 0x48, 0x00, 0x01, 0x00};
+  const size_t headerLength = sizeof(header);
+  const size_t messageLength = headerLength + 240;
 
-  tRawData displayData(240);
+  uint8_t* pMessage = frameArena().allocate<uint8_t>(messageLength);
+  std::copy_n(header, headerLength, pMessage);
+  std::fill_n(pMessage + headerLength, messageLength - headerLength, 0);
 
   for (uint8_t row = 0; row < 3; row++)
   {
-    for (uint8_t i = 0; i < kKK_nDisplays; i++)
-    {
-      if (m_displays[i].dirty())
-      {
-        //       std::copy_n(m_displays[i].displayData(row * 16), 16, &displayData[i * 16]);
-      }
-    }
+    pMessage[3] = row;
+    // The message is sent before the next row is written into it
     if (!writeToDeviceHandle(
-          Transfer({0xe0, 0x00, 0x00, row, 0x00, 0x48, 0x00, 0x01, 0x00}, displayData), kKK_epOut))
+          Transfer::borrow(pMessage, messageLength), kKK_epOut, Traffic::Display))
     {
       result = false;
     }
@@ -440,6 +446,11 @@ bool KompleteKontrolBase::sendLeds()
 
 bool KompleteKontrolBase::read()
 {
+  if (!inputPollDue())
+  {
+    return true;
+  }
+
   Transfer input;
 
   if (!readFromDeviceHandle(input, kKK_epInput))
@@ -566,40 +577,37 @@ bool KompleteKontrolBase::isRGBLed(Led led_) const noexcept
 
 KompleteKontrolBase::Led KompleteKontrolBase::led(Device::Button btn_) const noexcept
 {
-#define M_LED_CASE(idLed)     \
-  case Device::Button::idLed: \
-    return Led::idLed
-
-  switch (btn_)
-  {
-    M_LED_CASE(Shift);
-    M_LED_CASE(Scale);
-    M_LED_CASE(Arp);
-    M_LED_CASE(Loop);
-    M_LED_CASE(Rwd);
-    M_LED_CASE(Ffw);
-    M_LED_CASE(Play);
-    M_LED_CASE(Rec);
-    M_LED_CASE(Stop);
-    M_LED_CASE(PageLeft);
-    M_LED_CASE(PageRight);
-    M_LED_CASE(Browse);
-    M_LED_CASE(PresetUp);
-    M_LED_CASE(Instance);
-    M_LED_CASE(PresetDown);
-    M_LED_CASE(Back);
-    M_LED_CASE(NavigateUp);
-    M_LED_CASE(Enter);
-    M_LED_CASE(NavigateLeft);
-    M_LED_CASE(NavigateDown);
-    M_LED_CASE(NavigateRight);
-    default:
-    {
-      return Led::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_LED_MAP(idLed) {Device::Button::idLed, Led::idLed}
+
+  static constexpr Mapping<Device::Button, Led> kMapping[]{
+    M_LED_MAP(Shift),
+    M_LED_MAP(Scale),
+    M_LED_MAP(Arp),
+    M_LED_MAP(Loop),
+    M_LED_MAP(Rwd),
+    M_LED_MAP(Ffw),
+    M_LED_MAP(Play),
+    M_LED_MAP(Rec),
+    M_LED_MAP(Stop),
+    M_LED_MAP(PageLeft),
+    M_LED_MAP(PageRight),
+    M_LED_MAP(Browse),
+    M_LED_MAP(PresetUp),
+    M_LED_MAP(Instance),
+    M_LED_MAP(PresetDown),
+    M_LED_MAP(Back),
+    M_LED_MAP(NavigateUp),
+    M_LED_MAP(Enter),
+    M_LED_MAP(NavigateLeft),
+    M_LED_MAP(NavigateDown),
+    M_LED_MAP(NavigateRight),
+  };
+  static constexpr LookupTable<Device::Button, Led, enumRange<Device::Button>()> kLeds(
+    kMapping, Led::Unknown);
+
+#undef M_LED_MAP
+
+  return kLeds[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -619,43 +627,40 @@ KompleteKontrolBase::Led KompleteKontrolBase::led(unsigned index_) const noexcep
 
 Device::Button KompleteKontrolBase::deviceButton(Button btn_) const noexcept
 {
-#define M_BTN_CASE(idBtn) \
-  case Button::idBtn:     \
-    return Device::Button::idBtn
-
-  switch (btn_)
-  {
-    M_BTN_CASE(MainEncoder);
-    M_BTN_CASE(PresetUp);
-    M_BTN_CASE(Enter);
-    M_BTN_CASE(PresetDown);
-    M_BTN_CASE(Browse);
-    M_BTN_CASE(Instance);
-    M_BTN_CASE(OctaveDown);
-    M_BTN_CASE(OctaveUp);
-    M_BTN_CASE(Stop);
-    M_BTN_CASE(Rec);
-    M_BTN_CASE(Play);
-    M_BTN_CASE(NavigateRight);
-    M_BTN_CASE(NavigateDown);
-    M_BTN_CASE(NavigateLeft);
-    M_BTN_CASE(Back);
-    M_BTN_CASE(NavigateUp);
-    M_BTN_CASE(Shift);
-    M_BTN_CASE(Scale);
-    M_BTN_CASE(Arp);
-    M_BTN_CASE(Loop);
-    M_BTN_CASE(PageRight);
-    M_BTN_CASE(PageLeft);
-    M_BTN_CASE(Rwd);
-    M_BTN_CASE(Ffw);
-    default:
-    {
-      return Device::Button::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_BTN_MAP(idBtn) {Button::idBtn, Device::Button::idBtn}
+
+  static constexpr Mapping<Button, Device::Button> kMapping[]{
+    M_BTN_MAP(MainEncoder),
+    M_BTN_MAP(PresetUp),
+    M_BTN_MAP(Enter),
+    M_BTN_MAP(PresetDown),
+    M_BTN_MAP(Browse),
+    M_BTN_MAP(Instance),
+    M_BTN_MAP(OctaveDown),
+    M_BTN_MAP(OctaveUp),
+    M_BTN_MAP(Stop),
+    M_BTN_MAP(Rec),
+    M_BTN_MAP(Play),
+    M_BTN_MAP(NavigateRight),
+    M_BTN_MAP(NavigateDown),
+    M_BTN_MAP(NavigateLeft),
+    M_BTN_MAP(Back),
+    M_BTN_MAP(NavigateUp),
+    M_BTN_MAP(Shift),
+    M_BTN_MAP(Scale),
+    M_BTN_MAP(Arp),
+    M_BTN_MAP(Loop),
+    M_BTN_MAP(PageRight),
+    M_BTN_MAP(PageLeft),
+    M_BTN_MAP(Rwd),
+    M_BTN_MAP(Ffw),
+  };
+  static constexpr LookupTable<Button, Device::Button, enumRange<Button>()> kButtons(
+    kMapping, Device::Button::Unknown);
+
+#undef M_BTN_MAP
+
+  return kButtons[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -12,6 +12,7 @@
 #include "cabl/comm/Driver.h"
 #include "cabl/comm/Transfer.h"
 #include "cabl/util/Functions.h"
+#include "cabl/util/LookupTable.h"
 
 #include "cabl/gfx/LedArray.h"
 #include "cabl/gfx/LedMatrix.h"
@@ -446,12 +447,13 @@ bool MaschineJam::read()
   }
   else if (input && input[0] == 0x01)
   {
-    processButtons(input);
+    decodeInput({InputMask::Class::Buttons, InputMask::Class::Keys, InputMask::Class::Encoders},
+      [&] { processButtons(input); });
     return true;
   }
   else if (input && input[0] == 0x02)
   {
-    processStrips(input);
+    decodeInput({InputMask::Class::Controls}, [&] { processStrips(input); });
   }
   return true;
 }
@@ -581,134 +583,131 @@ bool MaschineJam::isRGBLed(Led led_) const noexcept
 
 MaschineJam::Led MaschineJam::led(Device::Button btn_) const noexcept
 {
-#define M_LED_CASE(idLed)     \
-  case Device::Button::idLed: \
-    return Led::idLed
-
-  switch (btn_)
-  {
-    M_LED_CASE(Arrange);
-    M_LED_CASE(Step);
-    M_LED_CASE(PadMode);
-    M_LED_CASE(Clear);
-    M_LED_CASE(Duplicate);
-    M_LED_CASE(NavigateUp);
-    M_LED_CASE(NavigateLeft);
-    M_LED_CASE(NavigateRight);
-    M_LED_CASE(NavigateDown);
-    M_LED_CASE(Arp);
-    M_LED_CASE(Mst);
-    M_LED_CASE(Grp);
-    M_LED_CASE(In);
-    M_LED_CASE(Cue);
-    M_LED_CASE(Browse);
-    M_LED_CASE(Macro);
-    M_LED_CASE(Level);
-    M_LED_CASE(Aux);
-    M_LED_CASE(Control);
-    M_LED_CASE(Auto);
-    M_LED_CASE(Perform);
-    M_LED_CASE(Variation);
-    M_LED_CASE(Lock);
-    M_LED_CASE(Tune);
-    M_LED_CASE(Swing);
-    M_LED_CASE(Shift);
-    M_LED_CASE(Play);
-    M_LED_CASE(Rec);
-    M_LED_CASE(TransportLeft);
-    M_LED_CASE(TransportRight);
-    M_LED_CASE(Tempo);
-    M_LED_CASE(Grid);
-    M_LED_CASE(Solo);
-    M_LED_CASE(Mute);
-    M_LED_CASE(Select);
-    M_LED_CASE(DisplayButton1);
-    M_LED_CASE(DisplayButton2);
-    M_LED_CASE(DisplayButton3);
-    M_LED_CASE(DisplayButton4);
-    M_LED_CASE(DisplayButton5);
-    M_LED_CASE(DisplayButton6);
-    M_LED_CASE(DisplayButton7);
-    M_LED_CASE(DisplayButton8);
-    M_LED_CASE(Pad1);
-    M_LED_CASE(Pad2);
-    M_LED_CASE(Pad3);
-    M_LED_CASE(Pad4);
-    M_LED_CASE(Pad5);
-    M_LED_CASE(Pad6);
-    M_LED_CASE(Pad7);
-    M_LED_CASE(Pad8);
-    M_LED_CASE(Pad9);
-    M_LED_CASE(Pad10);
-    M_LED_CASE(Pad11);
-    M_LED_CASE(Pad12);
-    M_LED_CASE(Pad13);
-    M_LED_CASE(Pad14);
-    M_LED_CASE(Pad15);
-    M_LED_CASE(Pad16);
-    M_LED_CASE(Pad17);
-    M_LED_CASE(Pad18);
-    M_LED_CASE(Pad19);
-    M_LED_CASE(Pad20);
-    M_LED_CASE(Pad21);
-    M_LED_CASE(Pad22);
-    M_LED_CASE(Pad23);
-    M_LED_CASE(Pad24);
-    M_LED_CASE(Pad25);
-    M_LED_CASE(Pad26);
-    M_LED_CASE(Pad27);
-    M_LED_CASE(Pad28);
-    M_LED_CASE(Pad29);
-    M_LED_CASE(Pad30);
-    M_LED_CASE(Pad31);
-    M_LED_CASE(Pad32);
-    M_LED_CASE(Pad33);
-    M_LED_CASE(Pad34);
-    M_LED_CASE(Pad35);
-    M_LED_CASE(Pad36);
-    M_LED_CASE(Pad37);
-    M_LED_CASE(Pad38);
-    M_LED_CASE(Pad39);
-    M_LED_CASE(Pad40);
-    M_LED_CASE(Pad41);
-    M_LED_CASE(Pad42);
-    M_LED_CASE(Pad43);
-    M_LED_CASE(Pad44);
-    M_LED_CASE(Pad45);
-    M_LED_CASE(Pad46);
-    M_LED_CASE(Pad47);
-    M_LED_CASE(Pad48);
-    M_LED_CASE(Pad49);
-    M_LED_CASE(Pad50);
-    M_LED_CASE(Pad51);
-    M_LED_CASE(Pad52);
-    M_LED_CASE(Pad53);
-    M_LED_CASE(Pad54);
-    M_LED_CASE(Pad55);
-    M_LED_CASE(Pad56);
-    M_LED_CASE(Pad57);
-    M_LED_CASE(Pad58);
-    M_LED_CASE(Pad59);
-    M_LED_CASE(Pad60);
-    M_LED_CASE(Pad61);
-    M_LED_CASE(Pad62);
-    M_LED_CASE(Pad63);
-    M_LED_CASE(Pad64);
-    M_LED_CASE(GroupA);
-    M_LED_CASE(GroupB);
-    M_LED_CASE(GroupC);
-    M_LED_CASE(GroupD);
-    M_LED_CASE(GroupE);
-    M_LED_CASE(GroupF);
-    M_LED_CASE(GroupG);
-    M_LED_CASE(GroupH);
-    default:
-    {
-      return Led::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_LED_MAP(idLed) {Device::Button::idLed, Led::idLed}
+
+  static constexpr Mapping<Device::Button, Led> kMapping[]{
+    M_LED_MAP(Arrange),
+    M_LED_MAP(Step),
+    M_LED_MAP(PadMode),
+    M_LED_MAP(Clear),
+    M_LED_MAP(Duplicate),
+    M_LED_MAP(NavigateUp),
+    M_LED_MAP(NavigateLeft),
+    M_LED_MAP(NavigateRight),
+    M_LED_MAP(NavigateDown),
+    M_LED_MAP(Arp),
+    M_LED_MAP(Mst),
+    M_LED_MAP(Grp),
+    M_LED_MAP(In),
+    M_LED_MAP(Cue),
+    M_LED_MAP(Browse),
+    M_LED_MAP(Macro),
+    M_LED_MAP(Level),
+    M_LED_MAP(Aux),
+    M_LED_MAP(Control),
+    M_LED_MAP(Auto),
+    M_LED_MAP(Perform),
+    M_LED_MAP(Variation),
+    M_LED_MAP(Lock),
+    M_LED_MAP(Tune),
+    M_LED_MAP(Swing),
+    M_LED_MAP(Shift),
+    M_LED_MAP(Play),
+    M_LED_MAP(Rec),
+    M_LED_MAP(TransportLeft),
+    M_LED_MAP(TransportRight),
+    M_LED_MAP(Tempo),
+    M_LED_MAP(Grid),
+    M_LED_MAP(Solo),
+    M_LED_MAP(Mute),
+    M_LED_MAP(Select),
+    M_LED_MAP(DisplayButton1),
+    M_LED_MAP(DisplayButton2),
+    M_LED_MAP(DisplayButton3),
+    M_LED_MAP(DisplayButton4),
+    M_LED_MAP(DisplayButton5),
+    M_LED_MAP(DisplayButton6),
+    M_LED_MAP(DisplayButton7),
+    M_LED_MAP(DisplayButton8),
+    M_LED_MAP(Pad1),
+    M_LED_MAP(Pad2),
+    M_LED_MAP(Pad3),
+    M_LED_MAP(Pad4),
+    M_LED_MAP(Pad5),
+    M_LED_MAP(Pad6),
+    M_LED_MAP(Pad7),
+    M_LED_MAP(Pad8),
+    M_LED_MAP(Pad9),
+    M_LED_MAP(Pad10),
+    M_LED_MAP(Pad11),
+    M_LED_MAP(Pad12),
+    M_LED_MAP(Pad13),
+    M_LED_MAP(Pad14),
+    M_LED_MAP(Pad15),
+    M_LED_MAP(Pad16),
+    M_LED_MAP(Pad17),
+    M_LED_MAP(Pad18),
+    M_LED_MAP(Pad19),
+    M_LED_MAP(Pad20),
+    M_LED_MAP(Pad21),
+    M_LED_MAP(Pad22),
+    M_LED_MAP(Pad23),
+    M_LED_MAP(Pad24),
+    M_LED_MAP(Pad25),
+    M_LED_MAP(Pad26),
+    M_LED_MAP(Pad27),
+    M_LED_MAP(Pad28),
+    M_LED_MAP(Pad29),
+    M_LED_MAP(Pad30),
+    M_LED_MAP(Pad31),
+    M_LED_MAP(Pad32),
+    M_LED_MAP(Pad33),
+    M_LED_MAP(Pad34),
+    M_LED_MAP(Pad35),
+    M_LED_MAP(Pad36),
+    M_LED_MAP(Pad37),
+    M_LED_MAP(Pad38),
+    M_LED_MAP(Pad39),
+    M_LED_MAP(Pad40),
+    M_LED_MAP(Pad41),
+    M_LED_MAP(Pad42),
+    M_LED_MAP(Pad43),
+    M_LED_MAP(Pad44),
+    M_LED_MAP(Pad45),
+    M_LED_MAP(Pad46),
+    M_LED_MAP(Pad47),
+    M_LED_MAP(Pad48),
+    M_LED_MAP(Pad49),
+    M_LED_MAP(Pad50),
+    M_LED_MAP(Pad51),
+    M_LED_MAP(Pad52),
+    M_LED_MAP(Pad53),
+    M_LED_MAP(Pad54),
+    M_LED_MAP(Pad55),
+    M_LED_MAP(Pad56),
+    M_LED_MAP(Pad57),
+    M_LED_MAP(Pad58),
+    M_LED_MAP(Pad59),
+    M_LED_MAP(Pad60),
+    M_LED_MAP(Pad61),
+    M_LED_MAP(Pad62),
+    M_LED_MAP(Pad63),
+    M_LED_MAP(Pad64),
+    M_LED_MAP(GroupA),
+    M_LED_MAP(GroupB),
+    M_LED_MAP(GroupC),
+    M_LED_MAP(GroupD),
+    M_LED_MAP(GroupE),
+    M_LED_MAP(GroupF),
+    M_LED_MAP(GroupG),
+    M_LED_MAP(GroupH),
+  };
+  static constexpr LookupTable<Device::Button, Led, enumRange<Device::Button>()> kLeds(
+    kMapping, Led::Unknown);
+
+#undef M_LED_MAP
+
+  return kLeds[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -728,137 +727,133 @@ MaschineJam::Led MaschineJam::led(unsigned index_) const noexcept
 
 Device::Button MaschineJam::deviceButton(Button btn_) const noexcept
 {
-#define M_BTN_CASE(idBtn) \
-  case Button::idBtn:     \
-    return Device::Button::idBtn
-
-  switch (btn_)
-  {
-    M_BTN_CASE(Arrange);
-    M_BTN_CASE(Step);
-    M_BTN_CASE(PadMode);
-    M_BTN_CASE(Clear);
-    M_BTN_CASE(Duplicate);
-    M_BTN_CASE(NavigateUp);
-    M_BTN_CASE(NavigateLeft);
-    M_BTN_CASE(NavigateRight);
-    M_BTN_CASE(NavigateDown);
-    M_BTN_CASE(Arp);
-    M_BTN_CASE(Mst);
-    M_BTN_CASE(Grp);
-    M_BTN_CASE(In);
-    M_BTN_CASE(Cue);
-    M_BTN_CASE(Browse);
-    M_BTN_CASE(Macro);
-    M_BTN_CASE(Level);
-    M_BTN_CASE(Aux);
-    M_BTN_CASE(Control);
-    M_BTN_CASE(Auto);
-    M_BTN_CASE(Perform);
-    M_BTN_CASE(Variation);
-    M_BTN_CASE(Lock);
-    M_BTN_CASE(Tune);
-    M_BTN_CASE(Swing);
-    M_BTN_CASE(Shift);
-    M_BTN_CASE(Play);
-    M_BTN_CASE(Rec);
-    M_BTN_CASE(TransportLeft);
-    M_BTN_CASE(TransportRight);
-    M_BTN_CASE(Tempo);
-    M_BTN_CASE(Grid);
-    M_BTN_CASE(Solo);
-    M_BTN_CASE(Mute);
-    M_BTN_CASE(Select);
-    M_BTN_CASE(TouchEncoderMain);
-    M_BTN_CASE(MainEncoder);
-    M_BTN_CASE(DisplayButton1);
-    M_BTN_CASE(DisplayButton2);
-    M_BTN_CASE(DisplayButton3);
-    M_BTN_CASE(DisplayButton4);
-    M_BTN_CASE(DisplayButton5);
-    M_BTN_CASE(DisplayButton6);
-    M_BTN_CASE(DisplayButton7);
-    M_BTN_CASE(DisplayButton8);
-    M_BTN_CASE(Pad1);
-    M_BTN_CASE(Pad2);
-    M_BTN_CASE(Pad3);
-    M_BTN_CASE(Pad4);
-    M_BTN_CASE(Pad5);
-    M_BTN_CASE(Pad6);
-    M_BTN_CASE(Pad7);
-    M_BTN_CASE(Pad8);
-    M_BTN_CASE(Pad9);
-    M_BTN_CASE(Pad10);
-    M_BTN_CASE(Pad11);
-    M_BTN_CASE(Pad12);
-    M_BTN_CASE(Pad13);
-    M_BTN_CASE(Pad14);
-    M_BTN_CASE(Pad15);
-    M_BTN_CASE(Pad16);
-    M_BTN_CASE(Pad17);
-    M_BTN_CASE(Pad18);
-    M_BTN_CASE(Pad19);
-    M_BTN_CASE(Pad20);
-    M_BTN_CASE(Pad21);
-    M_BTN_CASE(Pad22);
-    M_BTN_CASE(Pad23);
-    M_BTN_CASE(Pad24);
-    M_BTN_CASE(Pad25);
-    M_BTN_CASE(Pad26);
-    M_BTN_CASE(Pad27);
-    M_BTN_CASE(Pad28);
-    M_BTN_CASE(Pad29);
-    M_BTN_CASE(Pad30);
-    M_BTN_CASE(Pad31);
-    M_BTN_CASE(Pad32);
-    M_BTN_CASE(Pad33);
-    M_BTN_CASE(Pad34);
-    M_BTN_CASE(Pad35);
-    M_BTN_CASE(Pad36);
-    M_BTN_CASE(Pad37);
-    M_BTN_CASE(Pad38);
-    M_BTN_CASE(Pad39);
-    M_BTN_CASE(Pad40);
-    M_BTN_CASE(Pad41);
-    M_BTN_CASE(Pad42);
-    M_BTN_CASE(Pad43);
-    M_BTN_CASE(Pad44);
-    M_BTN_CASE(Pad45);
-    M_BTN_CASE(Pad46);
-    M_BTN_CASE(Pad47);
-    M_BTN_CASE(Pad48);
-    M_BTN_CASE(Pad49);
-    M_BTN_CASE(Pad50);
-    M_BTN_CASE(Pad51);
-    M_BTN_CASE(Pad52);
-    M_BTN_CASE(Pad53);
-    M_BTN_CASE(Pad54);
-    M_BTN_CASE(Pad55);
-    M_BTN_CASE(Pad56);
-    M_BTN_CASE(Pad57);
-    M_BTN_CASE(Pad58);
-    M_BTN_CASE(Pad59);
-    M_BTN_CASE(Pad60);
-    M_BTN_CASE(Pad61);
-    M_BTN_CASE(Pad62);
-    M_BTN_CASE(Pad63);
-    M_BTN_CASE(Pad64);
-    M_BTN_CASE(GroupA);
-    M_BTN_CASE(GroupB);
-    M_BTN_CASE(GroupC);
-    M_BTN_CASE(GroupD);
-    M_BTN_CASE(GroupE);
-    M_BTN_CASE(GroupF);
-    M_BTN_CASE(GroupG);
-    M_BTN_CASE(GroupH);
-
-    default:
-    {
-      return Device::Button::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_BTN_MAP(idBtn) {Button::idBtn, Device::Button::idBtn}
+
+  static constexpr Mapping<Button, Device::Button> kMapping[]{
+    M_BTN_MAP(Arrange),
+    M_BTN_MAP(Step),
+    M_BTN_MAP(PadMode),
+    M_BTN_MAP(Clear),
+    M_BTN_MAP(Duplicate),
+    M_BTN_MAP(NavigateUp),
+    M_BTN_MAP(NavigateLeft),
+    M_BTN_MAP(NavigateRight),
+    M_BTN_MAP(NavigateDown),
+    M_BTN_MAP(Arp),
+    M_BTN_MAP(Mst),
+    M_BTN_MAP(Grp),
+    M_BTN_MAP(In),
+    M_BTN_MAP(Cue),
+    M_BTN_MAP(Browse),
+    M_BTN_MAP(Macro),
+    M_BTN_MAP(Level),
+    M_BTN_MAP(Aux),
+    M_BTN_MAP(Control),
+    M_BTN_MAP(Auto),
+    M_BTN_MAP(Perform),
+    M_BTN_MAP(Variation),
+    M_BTN_MAP(Lock),
+    M_BTN_MAP(Tune),
+    M_BTN_MAP(Swing),
+    M_BTN_MAP(Shift),
+    M_BTN_MAP(Play),
+    M_BTN_MAP(Rec),
+    M_BTN_MAP(TransportLeft),
+    M_BTN_MAP(TransportRight),
+    M_BTN_MAP(Tempo),
+    M_BTN_MAP(Grid),
+    M_BTN_MAP(Solo),
+    M_BTN_MAP(Mute),
+    M_BTN_MAP(Select),
+    M_BTN_MAP(TouchEncoderMain),
+    M_BTN_MAP(MainEncoder),
+    M_BTN_MAP(DisplayButton1),
+    M_BTN_MAP(DisplayButton2),
+    M_BTN_MAP(DisplayButton3),
+    M_BTN_MAP(DisplayButton4),
+    M_BTN_MAP(DisplayButton5),
+    M_BTN_MAP(DisplayButton6),
+    M_BTN_MAP(DisplayButton7),
+    M_BTN_MAP(DisplayButton8),
+    M_BTN_MAP(Pad1),
+    M_BTN_MAP(Pad2),
+    M_BTN_MAP(Pad3),
+    M_BTN_MAP(Pad4),
+    M_BTN_MAP(Pad5),
+    M_BTN_MAP(Pad6),
+    M_BTN_MAP(Pad7),
+    M_BTN_MAP(Pad8),
+    M_BTN_MAP(Pad9),
+    M_BTN_MAP(Pad10),
+    M_BTN_MAP(Pad11),
+    M_BTN_MAP(Pad12),
+    M_BTN_MAP(Pad13),
+    M_BTN_MAP(Pad14),
+    M_BTN_MAP(Pad15),
+    M_BTN_MAP(Pad16),
+    M_BTN_MAP(Pad17),
+    M_BTN_MAP(Pad18),
+    M_BTN_MAP(Pad19),
+    M_BTN_MAP(Pad20),
+    M_BTN_MAP(Pad21),
+    M_BTN_MAP(Pad22),
+    M_BTN_MAP(Pad23),
+    M_BTN_MAP(Pad24),
+    M_BTN_MAP(Pad25),
+    M_BTN_MAP(Pad26),
+    M_BTN_MAP(Pad27),
+    M_BTN_MAP(Pad28),
+    M_BTN_MAP(Pad29),
+    M_BTN_MAP(Pad30),
+    M_BTN_MAP(Pad31),
+    M_BTN_MAP(Pad32),
+    M_BTN_MAP(Pad33),
+    M_BTN_MAP(Pad34),
+    M_BTN_MAP(Pad35),
+    M_BTN_MAP(Pad36),
+    M_BTN_MAP(Pad37),
+    M_BTN_MAP(Pad38),
+    M_BTN_MAP(Pad39),
+    M_BTN_MAP(Pad40),
+    M_BTN_MAP(Pad41),
+    M_BTN_MAP(Pad42),
+    M_BTN_MAP(Pad43),
+    M_BTN_MAP(Pad44),
+    M_BTN_MAP(Pad45),
+    M_BTN_MAP(Pad46),
+    M_BTN_MAP(Pad47),
+    M_BTN_MAP(Pad48),
+    M_BTN_MAP(Pad49),
+    M_BTN_MAP(Pad50),
+    M_BTN_MAP(Pad51),
+    M_BTN_MAP(Pad52),
+    M_BTN_MAP(Pad53),
+    M_BTN_MAP(Pad54),
+    M_BTN_MAP(Pad55),
+    M_BTN_MAP(Pad56),
+    M_BTN_MAP(Pad57),
+    M_BTN_MAP(Pad58),
+    M_BTN_MAP(Pad59),
+    M_BTN_MAP(Pad60),
+    M_BTN_MAP(Pad61),
+    M_BTN_MAP(Pad62),
+    M_BTN_MAP(Pad63),
+    M_BTN_MAP(Pad64),
+    M_BTN_MAP(GroupA),
+    M_BTN_MAP(GroupB),
+    M_BTN_MAP(GroupC),
+    M_BTN_MAP(GroupD),
+    M_BTN_MAP(GroupE),
+    M_BTN_MAP(GroupF),
+    M_BTN_MAP(GroupG),
+    M_BTN_MAP(GroupH),
+  };
+  static constexpr LookupTable<Button, Device::Button, enumRange<Button>()> kButtons(
+    kMapping, Device::Button::Unknown);
+
+#undef M_BTN_MAP
+
+  return kButtons[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -7,11 +7,14 @@
 
 #include "devices/ni/MaschineMK1.h"
 
+#include <chrono>
 #include <thread>
+#include <vector>
 
 #include "cabl/comm/Driver.h"
 #include "cabl/comm/Transfer.h"
 #include "cabl/util/Functions.h"
+#include "cabl/util/LookupTable.h"
 
 #include "cabl/gfx/TextDisplay.h"
 #include "gfx/displays/NullCanvas.h"
@@ -26,6 +29,29 @@ const uint8_t kMASMK1_epInputPads = 0x84;
 const uint8_t kMASMK1_epInputButtonsAndDials = 0x81;
 const uint8_t kMASMK1_defaultDisplaysBacklight = 0x5C;
 const unsigned kMASMK1_padThreshold = 200;
+
+// Display controller init sequence: the controller takes one command (and its parameters) per
+// packet, and needs some time to settle after each step
+using tMASMK1_displayCommands = std::vector<std::vector<uint8_t>>;
+const std::vector<tMASMK1_displayCommands> kMASMK1_displayInit{
+  {{0x30}, {0xCA, 0x04, 0x0F, 0x00}},
+  {{0xBB, 0x00}, {0xD1}, {0x94}, {0x81, 0x1E, 0x02}},
+  {{0x20, 0x08}},
+  {{0x20, 0x0B}},
+  {{0xA6},
+    {0x31},
+    {0x32, 0x00, 0x00, 0x05},
+    {0x34},
+    {0x30},
+    {0xBC, 0x00, 0x01, 0x02},
+    {0x75, 0x00, 0x3F},
+    {0x15, 0x00, 0x54},
+    {0x5C},
+    {0x25}},
+  {{0xAF}},
+  {{0xBC, 0x02, 0x01, 0x01}, {0xA6}, {0x81, 0x25, 0x02}},
+};
+const std::chrono::milliseconds kMASMK1_displayInitDelay{20};
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
@@ -181,10 +207,16 @@ void MaschineMK1::setKeyLed(unsigned index_, const Color& color_)
 
 void MaschineMK1::sendMidiMsg(tRawData midiMsg_)
 {
-  uint8_t lengthH = (midiMsg_.size() >> 8) & 0xFF;
-  uint8_t lengthL = midiMsg_.size() & 0xFF;
-  writeToDeviceHandle(
-    Transfer({0x07, lengthH, lengthL}, midiMsg_.data(), midiMsg_.size()), kMASMK1_epOut);
+  sendMidiBytes(midiMsg_.data(), midiMsg_.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void MaschineMK1::sendMidiBytes(const uint8_t* pData_, size_t length_)
+{
+  uint8_t lengthH = (length_ >> 8) & 0xFF;
+  uint8_t lengthL = length_ & 0xFF;
+  writeToDeviceHandle(Transfer({0x07, lengthH, lengthL}, pData_, length_), kMASMK1_epOut);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -211,7 +243,7 @@ bool MaschineMK1::tick()
   {
     for (uint8_t displayIndex = 0; displayIndex < 2; displayIndex++)
     {
-      if (m_displays[displayIndex].dirty())
+      if (m_displays[displayIndex].dirty() && displayFrameDue())
       {
         success = sendFrame(displayIndex);
         m_displays[displayIndex].resetDirtyFlags();
@@ -245,9 +277,9 @@ bool MaschineMK1::tick()
 void MaschineMK1::init()
 {
   // Displays
+  initDisplays();
   for (int i = 0; i < kMASMK1_nDisplays; i++)
   {
-    initDisplay(i);
     m_displays[i].black();
   }
   sendFrame(0);
@@ -270,56 +302,29 @@ void MaschineMK1::init()
 
 //--------------------------------------------------------------------------------------------------
 
-void MaschineMK1::initDisplay(uint8_t displayIndex_)
+void MaschineMK1::initDisplays()
 {
-  if (displayIndex_ > 1)
+  // The displays are initialized together, so that they share the waits
+  DeviceHandle::tCollTransfers transfers;
+  for (size_t step = 0; step < kMASMK1_displayInit.size(); step++)
   {
-    return;
-  }
-
-  uint8_t d = displayIndex_ << 1;
-
-  writeToDeviceHandle(Transfer({d, 0x00, 0x01, 0x30}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x04, 0xCA, 0x04, 0x0F, 0x00}), kMASMK1_epDisplay);
-
-  std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Sleep 20 ms
-
-  writeToDeviceHandle(Transfer({d, 0x00, 0x02, 0xBB, 0x00}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x01, 0xD1}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x01, 0x94}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x03, 0x81, 0x1E, 0x02}), kMASMK1_epDisplay);
-
-  std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Sleep 20 ms
-
-  writeToDeviceHandle(Transfer({d, 0x00, 0x02, 0x20, 0x08}), kMASMK1_epDisplay);
-
-  std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Sleep 20 ms
-
-  writeToDeviceHandle(Transfer({d, 0x00, 0x02, 0x20, 0x0B}), kMASMK1_epDisplay);
-
-  std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Sleep 20 ms
-
-  writeToDeviceHandle(Transfer({d, 0x00, 0x01, 0xA6}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x01, 0x31}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x04, 0x32, 0x00, 0x00, 0x05}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x01, 0x34}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x01, 0x30}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x04, 0xBC, 0x00, 0x01, 0x02}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x03, 0x75, 0x00, 0x3F}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x03, 0x15, 0x00, 0x54}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x01, 0x5C}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x01, 0x25}), kMASMK1_epDisplay);
-
-  std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Sleep 20 ms
-
-  writeToDeviceHandle(Transfer({d, 0x00, 0x01, 0xAF}), kMASMK1_epDisplay);
-
-  std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Sleep 20 ms
-
-  writeToDeviceHandle(Transfer({d, 0x00, 0x04, 0xBC, 0x02, 0x01, 0x01}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x01, 0xA6}), kMASMK1_epDisplay);
+    if (step > 0)
+    {
+      std::this_thread::sleep_for(kMASMK1_displayInitDelay);
+    }
 
-  writeToDeviceHandle(Transfer({d, 0x00, 0x03, 0x81, 0x25, 0x02}), kMASMK1_epDisplay);
+    transfers.clear();
+    for (uint8_t i = 0; i < kMASMK1_nDisplays; i++)
+    {
+      uint8_t d = i << 1;
+      for (const auto& command : kMASMK1_displayInit[step])
+      {
+        uint8_t length = static_cast<uint8_t>(command.size());
+        transfers.push_back(Transfer({d, 0x00, length}, command.data(), command.size()));
+      }
+    }
+    writeToDeviceHandle(transfers, kMASMK1_epDisplay);
+  }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -332,15 +337,18 @@ bool MaschineMK1::sendFrame(uint8_t displayIndex_)
   }
 
   uint8_t d = displayIndex_ << 1;
-  writeToDeviceHandle(Transfer({d, 0x00, 0x03, 0x75, 0x00, 0x3F}), kMASMK1_epDisplay);
-  writeToDeviceHandle(Transfer({d, 0x00, 0x03, 0x15, 0x00, 0x54}), kMASMK1_epDisplay);
+  writeToDeviceHandle(
+    Transfer({d, 0x00, 0x03, 0x75, 0x00, 0x3F}), kMASMK1_epDisplay, Traffic::Display);
+  writeToDeviceHandle(
+    Transfer({d, 0x00, 0x03, 0x15, 0x00, 0x54}), kMASMK1_epDisplay, Traffic::Display);
 
   unsigned offset = 0;
   const unsigned dataSize = 502;
 
   if (!writeToDeviceHandle(
         Transfer({d, 0x01, 0xF7, 0x5C}, m_displays[displayIndex_].buffer() + offset, dataSize),
-        kMASMK1_epDisplay))
+        kMASMK1_epDisplay,
+        Traffic::Display))
   {
     return false;
   }
@@ -351,7 +359,8 @@ bool MaschineMK1::sendFrame(uint8_t displayIndex_)
     offset += dataSize;
     if (!writeToDeviceHandle(
           Transfer({d, 0x01, 0xF6}, m_displays[displayIndex_].buffer() + offset, dataSize),
-          kMASMK1_epDisplay))
+          kMASMK1_epDisplay,
+          Traffic::Display))
     {
       return false;
     }
@@ -361,7 +370,8 @@ bool MaschineMK1::sendFrame(uint8_t displayIndex_)
 
   if (!writeToDeviceHandle(
         Transfer({d, 0x01, 0x52}, m_displays[displayIndex_].buffer() + offset, 338),
-        kMASMK1_epDisplay))
+        kMASMK1_epDisplay,
+        Traffic::Display))
   {
     return false;
   }
@@ -399,6 +409,11 @@ bool MaschineMK1::sendLeds()
 
 bool MaschineMK1::read()
 {
+  if (!inputWanted(InputMask::Class::Keys))
+  {
+    // The pads have an endpoint of their own, which isn't read at all if nobody consumes them
+    return true;
+  }
 
   Transfer input;
   if (!readFromDeviceHandle(input, kMASMK1_epInputPads))
@@ -406,7 +421,7 @@ bool MaschineMK1::read()
     M_LOG("[MaschineMK1] read: ERROR");
     return false;
   }
-  processPads(input);
+  decodeInput({InputMask::Class::Keys}, [&] { processPads(input); });
   return true;
 }
 
@@ -564,155 +579,141 @@ void MaschineMK1::setLedImpl(Led led_, const Color& color_)
 
 MaschineMK1::Led MaschineMK1::led(Device::Button btn_) const noexcept
 {
-#define M_LED_CASE(idLed)     \
-  case Device::Button::idLed: \
-    return Led::idLed
-
-  switch (btn_)
-  {
-    M_LED_CASE(Mute);
-    M_LED_CASE(Solo);
-    M_LED_CASE(Select);
-    M_LED_CASE(Duplicate);
-    M_LED_CASE(Navigate);
-    M_LED_CASE(Keyboard);
-    M_LED_CASE(Pattern);
-    M_LED_CASE(Scene);
-    M_LED_CASE(Shift);
-    M_LED_CASE(Erase);
-    M_LED_CASE(Grid);
-    M_LED_CASE(TransportRight);
-    M_LED_CASE(Rec);
-    M_LED_CASE(Play);
-    M_LED_CASE(TransportLeft);
-    M_LED_CASE(Loop);
-    M_LED_CASE(GroupA);
-    M_LED_CASE(GroupB);
-    M_LED_CASE(GroupC);
-    M_LED_CASE(GroupD);
-    M_LED_CASE(GroupE);
-    M_LED_CASE(GroupF);
-    M_LED_CASE(GroupG);
-    M_LED_CASE(GroupH);
-    M_LED_CASE(AutoWrite);
-    M_LED_CASE(Snap);
-    M_LED_CASE(BrowseRight);
-    M_LED_CASE(BrowseLeft);
-    M_LED_CASE(Sampling);
-    M_LED_CASE(Browse);
-    M_LED_CASE(Step);
-    M_LED_CASE(Control);
-    M_LED_CASE(DisplayButton1);
-    M_LED_CASE(DisplayButton2);
-    M_LED_CASE(DisplayButton3);
-    M_LED_CASE(DisplayButton4);
-    M_LED_CASE(DisplayButton5);
-    M_LED_CASE(DisplayButton6);
-    M_LED_CASE(DisplayButton7);
-    M_LED_CASE(DisplayButton8);
-    M_LED_CASE(NoteRepeat);
-
-    default:
-    {
-      return Led::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_LED_MAP(idLed) {Device::Button::idLed, Led::idLed}
+
+  static constexpr Mapping<Device::Button, Led> kMapping[]{
+    M_LED_MAP(Mute),
+    M_LED_MAP(Solo),
+    M_LED_MAP(Select),
+    M_LED_MAP(Duplicate),
+    M_LED_MAP(Navigate),
+    M_LED_MAP(Keyboard),
+    M_LED_MAP(Pattern),
+    M_LED_MAP(Scene),
+    M_LED_MAP(Shift),
+    M_LED_MAP(Erase),
+    M_LED_MAP(Grid),
+    M_LED_MAP(TransportRight),
+    M_LED_MAP(Rec),
+    M_LED_MAP(Play),
+    M_LED_MAP(TransportLeft),
+    M_LED_MAP(Loop),
+    M_LED_MAP(GroupA),
+    M_LED_MAP(GroupB),
+    M_LED_MAP(GroupC),
+    M_LED_MAP(GroupD),
+    M_LED_MAP(GroupE),
+    M_LED_MAP(GroupF),
+    M_LED_MAP(GroupG),
+    M_LED_MAP(GroupH),
+    M_LED_MAP(AutoWrite),
+    M_LED_MAP(Snap),
+    M_LED_MAP(BrowseRight),
+    M_LED_MAP(BrowseLeft),
+    M_LED_MAP(Sampling),
+    M_LED_MAP(Browse),
+    M_LED_MAP(Step),
+    M_LED_MAP(Control),
+    M_LED_MAP(DisplayButton1),
+    M_LED_MAP(DisplayButton2),
+    M_LED_MAP(DisplayButton3),
+    M_LED_MAP(DisplayButton4),
+    M_LED_MAP(DisplayButton5),
+    M_LED_MAP(DisplayButton6),
+    M_LED_MAP(DisplayButton7),
+    M_LED_MAP(DisplayButton8),
+    M_LED_MAP(NoteRepeat),
+  };
+  static constexpr LookupTable<Device::Button, Led, enumRange<Device::Button>()> kLeds(
+    kMapping, Led::Unknown);
+
+#undef M_LED_MAP
+
+  return kLeds[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
 
 MaschineMK1::Led MaschineMK1::led(unsigned index_) const noexcept
 {
-#define M_LED_CASE(val, idLed) \
-  case val:                    \
-    return Led::idLed
-  switch (index_)
-  {
-    M_LED_CASE(0, Pad13);
-    M_LED_CASE(1, Pad14);
-    M_LED_CASE(2, Pad15);
-    M_LED_CASE(3, Pad16);
-    M_LED_CASE(4, Pad9);
-    M_LED_CASE(5, Pad10);
-    M_LED_CASE(6, Pad11);
-    M_LED_CASE(7, Pad12);
-    M_LED_CASE(8, Pad5);
-    M_LED_CASE(9, Pad6);
-    M_LED_CASE(10, Pad7);
-    M_LED_CASE(11, Pad8);
-    M_LED_CASE(12, Pad1);
-    M_LED_CASE(13, Pad2);
-    M_LED_CASE(14, Pad3);
-    M_LED_CASE(15, Pad4);
-    default:
-    {
-      return Led::Unknown;
-    }
-  }
-#undef M_LED_CASE
+  static constexpr Mapping<unsigned, Led> kMapping[]{
+    {0, Led::Pad13},
+    {1, Led::Pad14},
+    {2, Led::Pad15},
+    {3, Led::Pad16},
+    {4, Led::Pad9},
+    {5, Led::Pad10},
+    {6, Led::Pad11},
+    {7, Led::Pad12},
+    {8, Led::Pad5},
+    {9, Led::Pad6},
+    {10, Led::Pad7},
+    {11, Led::Pad8},
+    {12, Led::Pad1},
+    {13, Led::Pad2},
+    {14, Led::Pad3},
+    {15, Led::Pad4},
+  };
+  static constexpr LookupTable<unsigned, Led, 16> kLeds(kMapping, Led::Unknown);
+
+  return kLeds[index_];
 }
 
 //--------------------------------------------------------------------------------------------------
 
 Device::Button MaschineMK1::deviceButton(Button btn_) const noexcept
 {
-#define M_BTN_CASE(idBtn) \
-  case Button::idBtn:     \
-    return Device::Button::idBtn
-
-  switch (btn_)
-  {
-    M_BTN_CASE(Mute);
-    M_BTN_CASE(Solo);
-    M_BTN_CASE(Select);
-    M_BTN_CASE(Duplicate);
-    M_BTN_CASE(Navigate);
-    M_BTN_CASE(Keyboard);
-    M_BTN_CASE(Pattern);
-    M_BTN_CASE(Scene);
-    M_BTN_CASE(Rec);
-    M_BTN_CASE(Erase);
-    M_BTN_CASE(Shift);
-    M_BTN_CASE(Grid);
-    M_BTN_CASE(TransportRight);
-    M_BTN_CASE(TransportLeft);
-    M_BTN_CASE(Loop);
-    M_BTN_CASE(GroupE);
-    M_BTN_CASE(GroupF);
-    M_BTN_CASE(GroupG);
-    M_BTN_CASE(GroupH);
-    M_BTN_CASE(GroupD);
-    M_BTN_CASE(GroupC);
-    M_BTN_CASE(GroupB);
-    M_BTN_CASE(GroupA);
-    M_BTN_CASE(Control);
-    M_BTN_CASE(Browse);
-    M_BTN_CASE(BrowseLeft);
-    M_BTN_CASE(Snap);
-    M_BTN_CASE(AutoWrite);
-    M_BTN_CASE(BrowseRight);
-    M_BTN_CASE(Sampling);
-    M_BTN_CASE(Step);
-    M_BTN_CASE(DisplayButton8);
-    M_BTN_CASE(DisplayButton7);
-    M_BTN_CASE(DisplayButton6);
-    M_BTN_CASE(DisplayButton5);
-    M_BTN_CASE(DisplayButton4);
-    M_BTN_CASE(DisplayButton3);
-    M_BTN_CASE(DisplayButton2);
-    M_BTN_CASE(DisplayButton1);
-    M_BTN_CASE(NoteRepeat);
-    M_BTN_CASE(Play);
-
-    default:
-    {
-      return Device::Button::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_BTN_MAP(idBtn) {Button::idBtn, Device::Button::idBtn}
+
+  static constexpr Mapping<Button, Device::Button> kMapping[]{
+    M_BTN_MAP(Mute),
+    M_BTN_MAP(Solo),
+    M_BTN_MAP(Select),
+    M_BTN_MAP(Duplicate),
+    M_BTN_MAP(Navigate),
+    M_BTN_MAP(Keyboard),
+    M_BTN_MAP(Pattern),
+    M_BTN_MAP(Scene),
+    M_BTN_MAP(Rec),
+    M_BTN_MAP(Erase),
+    M_BTN_MAP(Shift),
+    M_BTN_MAP(Grid),
+    M_BTN_MAP(TransportRight),
+    M_BTN_MAP(TransportLeft),
+    M_BTN_MAP(Loop),
+    M_BTN_MAP(GroupE),
+    M_BTN_MAP(GroupF),
+    M_BTN_MAP(GroupG),
+    M_BTN_MAP(GroupH),
+    M_BTN_MAP(GroupD),
+    M_BTN_MAP(GroupC),
+    M_BTN_MAP(GroupB),
+    M_BTN_MAP(GroupA),
+    M_BTN_MAP(Control),
+    M_BTN_MAP(Browse),
+    M_BTN_MAP(BrowseLeft),
+    M_BTN_MAP(Snap),
+    M_BTN_MAP(AutoWrite),
+    M_BTN_MAP(BrowseRight),
+    M_BTN_MAP(Sampling),
+    M_BTN_MAP(Step),
+    M_BTN_MAP(DisplayButton8),
+    M_BTN_MAP(DisplayButton7),
+    M_BTN_MAP(DisplayButton6),
+    M_BTN_MAP(DisplayButton5),
+    M_BTN_MAP(DisplayButton4),
+    M_BTN_MAP(DisplayButton3),
+    M_BTN_MAP(DisplayButton2),
+    M_BTN_MAP(DisplayButton1),
+    M_BTN_MAP(NoteRepeat),
+    M_BTN_MAP(Play),
+  };
+  static constexpr LookupTable<Button, Device::Button, enumRange<Button>()> kButtons(
+    kMapping, Device::Button::Unknown);
+
+#undef M_BTN_MAP
+
+  return kButtons[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -721,11 +722,11 @@ void MaschineMK1::cbRead(Transfer input_)
 {
   if (input_[0] == 0x02)
   {
-    processEncoders(input_);
+    decodeInput({InputMask::Class::Encoders}, [&] { processEncoders(input_); });
   }
   else if (input_[0] == 0x04)
   {
-    processButtons(input_);
+    decodeInput({InputMask::Class::Buttons}, [&] { processButtons(input_); });
   }
   else if (input_[0] == 0x06)
   {
@@ -31,6 +31,7 @@ public:
   void setKeyLed(unsigned, const Color&) override;
 
   void sendMidiMsg(tRawData) override;
+  void sendMidiBytes(const uint8_t* pData_, size_t length_) override;
 
   Canvas* graphicDisplay(size_t displayIndex_) override;
 
@@ -73,7 +74,7 @@ private:
 
   void init() override;
 
-  void initDisplay(uint8_t displayIndex_);
+  void initDisplays();
   bool sendFrame(uint8_t displayIndex_);
   bool sendLeds();
   bool read();
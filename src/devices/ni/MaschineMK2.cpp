@@ -10,6 +10,7 @@
 #include "cabl/comm/Driver.h"
 #include "cabl/comm/Transfer.h"
 #include "cabl/util/Functions.h"
+#include "cabl/util/LookupTable.h"
 #include <thread>
 
 #include "cabl/gfx/TextDisplay.h"
@@ -23,7 +24,17 @@ const uint8_t kMASMK2_epDisplay = 0x08;
 const uint8_t kMASMK2_epOut = 0x01;
 const uint8_t kMASMK2_epInput = 0x84;
 const std::string kMASMK2_midiOutName = "Maschine Controller MK2";
+const size_t kMASMK2_midiOutMessageSize = 16;
 const unsigned kMASMK2_padThreshold = 200;
+
+// Input report 0x01: buttons, main encoder and display encoders (16 bit, 10 bit resolution)
+using tMASMK2_buttons = sl::cabl::ReportBitmap<1, 48>;
+using tMASMK2_mainEncoder = sl::cabl::ReportField<8, 0, 8>;
+using tMASMK2_encoders = sl::cabl::ReportFieldArray<9, 2, 0, 16, 8>;
+
+// Input report 0x20: pad pressure (12 bit) with the pad index in the high nibble
+using tMASMK2_padValues = sl::cabl::ReportFieldArray<1, 2, 0, 12, 32>;
+using tMASMK2_padIndices = sl::cabl::ReportFieldArray<2, 2, 4, 4, 32>;
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
@@ -213,6 +224,7 @@ MaschineMK2::MaschineMK2()
   {
     m_pMidiout.reset(nullptr);
   }
+  m_midiOutMessage.reserve(kMASMK2_midiOutMessageSize);
 #endif
 }
 
@@ -250,6 +262,20 @@ void MaschineMK2::sendMidiMsg(tRawData midiMsg_)
 
 //--------------------------------------------------------------------------------------------------
 
+void MaschineMK2::sendMidiBytes(const uint8_t* pData_, size_t length_)
+{
+#if defined(_WIN32) || defined(__APPLE__) || defined(__linux)
+  if (m_pMidiout)
+  {
+    // Reuses the capacity reserved by the constructor
+    m_midiOutMessage.assign(pData_, pData_ + length_);
+    m_pMidiout->sendMessage(&m_midiOutMessage);
+  }
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+
 Canvas* MaschineMK2::graphicDisplay(size_t displayIndex_)
 {
   static NullCanvas s_dummyDisplay;
@@ -272,7 +298,7 @@ bool MaschineMK2::tick()
   {
     for (uint8_t displayIndex = 0; displayIndex < 2; displayIndex++)
     {
-      if (m_displays[displayIndex].dirty())
+      if (m_displays[displayIndex].dirty() && displayFrameDue())
       {
         success = sendFrame(displayIndex);
         m_displays[displayIndex].resetDirtyFlags();
@@ -310,9 +336,12 @@ void MaschineMK2::init()
   m_displays[1].white();
 
   // Leds
-  std::fill(std::begin(m_ledsButtons), std::end(m_ledsButtons), 0);
-  std::fill(std::begin(m_ledsGroups), std::end(m_ledsGroups), 0);
-  std::fill(std::begin(m_ledsPads), std::end(m_ledsPads), 0);
+  m_ledsButtons.fill(0);
+  m_ledsGroups.fill(0);
+  m_ledsPads.fill(0);
+
+  // Buttons
+  m_buttons.fill(0);
   m_isDirtyButtonLeds = true;
   m_isDirtyGroupLeds = true;
   m_isDirtyPadLeds = true;
@@ -343,7 +372,8 @@ bool MaschineMK2::sendFrame(uint8_t displayIndex_)
     const uint8_t* ptr = m_displays[displayIndex_].buffer() + (chunk * 256);
     if (!writeToDeviceHandle(
           Transfer({firstByte, 0x00, 0x00, chunkByte, 0x00, 0x20, 0x00, 0x08, 0x00}, ptr, 256),
-          kMASMK2_epDisplay))
+          kMASMK2_epDisplay,
+          Traffic::Display))
     {
       return false;
     }
@@ -359,7 +389,7 @@ bool MaschineMK2::sendLeds()
 {
   if (m_isDirtyButtonLeds)
   {
-    if (!writeToDeviceHandle(Transfer({0x82}, &m_ledsButtons[0], 32), kMASMK2_epOut))
+    if (!writeToDeviceHandle(m_ledsButtons.transfer(), kMASMK2_epOut))
     {
       return false;
     }
@@ -367,7 +397,7 @@ bool MaschineMK2::sendLeds()
   }
   if (m_isDirtyGroupLeds)
   {
-    if (!writeToDeviceHandle(Transfer({0x81}, &m_ledsGroups[0], 57), kMASMK2_epOut))
+    if (!writeToDeviceHandle(m_ledsGroups.transfer(), kMASMK2_epOut))
     {
       return false;
     }
@@ -375,7 +405,7 @@ bool MaschineMK2::sendLeds()
   }
   if (m_isDirtyPadLeds)
   {
-    if (!writeToDeviceHandle(Transfer({0x80}, &m_ledsPads[0], 49), kMASMK2_epOut))
+    if (!writeToDeviceHandle(m_ledsPads.transfer(), kMASMK2_epOut))
     {
       return false;
     }
@@ -388,6 +418,11 @@ bool MaschineMK2::sendLeds()
 
 bool MaschineMK2::read()
 {
+  if (!inputPollDue())
+  {
+    return true;
+  }
+
   Transfer input;
   for (uint8_t n = 0; n < 32; n++)
   {
@@ -397,12 +432,13 @@ bool MaschineMK2::read()
     }
     else if (input && input[0] == 0x01)
     {
-      processButtons(input);
+      decodeInput({InputMask::Class::Buttons, InputMask::Class::Encoders},
+        [&] { processButtons(input); });
       return true;
     }
     else if (input && input[0] == 0x20 && n % 8 == 0) // Too many pad messages, need to skip some...
     {
-      processPads(input);
+      decodeInput({InputMask::Class::Keys}, [&] { processPads(input); });
     }
   }
   return true;
@@ -412,41 +448,32 @@ bool MaschineMK2::read()
 
 void MaschineMK2::processButtons(const Transfer& input_)
 {
-  bool shiftPressed(isButtonPressed(input_, Button::Shift));
-  Device::Button changedButton(Device::Button::Unknown);
-  bool buttonPressed(false);
-
-  for (int i = 0; i < kMASMK2_buttonsDataSize; i++) // Skip the last byte (encoder value)
+  if (input_.size() < tMASMK2_encoders::kEnd)
   {
-    for (int k = 0; k < 8; k++)
+    return;
+  }
+
+  const uint8_t* pReport = input_.data().data();
+  bool shiftPressed(tMASMK2_buttons::test(pReport, static_cast<size_t>(Button::Shift)));
+
+  // One button change per report, the others are picked up by the next ones
+  auto onButtonChanged = [&](size_t btn_, bool buttonPressed_) -> bool {
+    Button currentButton(static_cast<Button>(btn_));
+    Device::Button changedButton = deviceButton(currentButton);
+    if (currentButton == Button::Shift || changedButton == Device::Button::Unknown)
     {
-      uint8_t btn = (i * 8) + k;
-      Button currentButton(static_cast<Button>(btn));
-      if (currentButton > Button::Mute)
-      {
-        continue;
-      }
-      if (currentButton == Button::Shift)
-      {
-        continue;
-      }
-      buttonPressed = isButtonPressed(input_, currentButton);
-      if (buttonPressed != m_buttonStates[btn])
-      {
-        m_buttonStates[btn] = buttonPressed;
-        changedButton = deviceButton(currentButton);
-        if (changedButton != Device::Button::Unknown)
-        {
-          //    std::copy(&input_[1],&input_[kMASMK2_buttonsDataSize],m_buttons.begin());
-          buttonChanged(changedButton, buttonPressed, shiftPressed);
-          return;
-        }
-      }
+      return true;
     }
+    buttonChanged(changedButton, buttonPressed_, shiftPressed);
+    return false;
+  };
+  if (!tMASMK2_buttons::diff(pReport, m_buttons.data(), onButtonChanged))
+  {
+    return;
   }
 
   // Now process the encoder data
-  uint8_t currValue = input_.data()[kMASMK2_buttonsDataSize];
+  uint8_t currValue = tMASMK2_mainEncoder::decode(pReport);
   if (currValue != m_encoderValues[0])
   {
     bool valueIncreased
@@ -456,10 +483,10 @@ void MaschineMK2::processButtons(const Transfer& input_)
     encoderChanged(0, valueIncreased, shiftPressed);
   }
 
-  for (uint8_t encIndex = 0, i = kMASMK2_buttonsDataSize + 1; encIndex < 8; i += 2, encIndex++)
+  for (uint8_t encIndex = 0; encIndex < tMASMK2_encoders::kSize; encIndex++)
   {
-    unsigned value = (input_.data()[i]) | (input_.data()[i + 1] << 8);
-    unsigned hValue = input_.data()[i + 1];
+    unsigned value = tMASMK2_encoders::decode(pReport, encIndex);
+    unsigned hValue = value >> 8;
     if (m_encoderValues[encIndex + 1] != value)
     {
       unsigned prevHValue = (m_encoderValues[encIndex + 1] & 0xF00) >> 8;
@@ -476,26 +503,29 @@ void MaschineMK2::processButtons(const Transfer& input_)
 
 void MaschineMK2::processPads(const Transfer& input_)
 {
-  //!\todo process pad data
-  for (int i = 1; i < kMASMK2_padDataSize; i += 2)
+  if (input_.size() < tMASMK2_padIndices::kEnd)
+  {
+    return;
+  }
+
+  const uint8_t* pReport = input_.data().data();
+  bool shiftPressed(isButtonPressed(Button::Shift));
+  for (size_t i = 0; i < tMASMK2_padValues::kSize; i++)
   {
-    unsigned l = input_[i];
-    unsigned h = input_[i + 1];
-    uint8_t pad = (h & 0xF0) >> 4;
-    m_padsData[pad] = (((h & 0x0F) << 8) | l);
+    uint8_t pad = tMASMK2_padIndices::decode(pReport, i);
+    m_padsData[pad] = tMASMK2_padValues::decode(pReport, i);
 
     if (m_padsData[pad] > kMASMK2_padThreshold)
     {
       m_padsStatus[pad] = true;
-      keyChanged(
-        pad, m_padsData[pad] / 1024.0, m_buttonStates[static_cast<uint8_t>(Button::Shift)]);
+      keyChanged(pad, m_padsData[pad] / 1024.0, shiftPressed);
     }
     else
     {
       if (m_padsStatus[pad])
       {
         m_padsStatus[pad] = false;
-        keyChanged(pad, 0.0, m_buttonStates[static_cast<uint8_t>(Button::Shift)]);
+        keyChanged(pad, 0.0, shiftPressed);
       }
     }
   }
@@ -597,169 +627,154 @@ bool MaschineMK2::isRGBLed(Led led_) const noexcept
 
 MaschineMK2::Led MaschineMK2::led(Device::Button btn_) const noexcept
 {
-#define M_LED_CASE(idLed)     \
-  case Device::Button::idLed: \
-    return Led::idLed
-
-  switch (btn_)
-  {
-    M_LED_CASE(Control);
-    M_LED_CASE(Step);
-    M_LED_CASE(Browse);
-    M_LED_CASE(Sampling);
-    M_LED_CASE(BrowseLeft);
-    M_LED_CASE(BrowseRight);
-    M_LED_CASE(All);
-    M_LED_CASE(AutoWrite);
-    M_LED_CASE(DisplayButton1);
-    M_LED_CASE(DisplayButton2);
-    M_LED_CASE(DisplayButton3);
-    M_LED_CASE(DisplayButton4);
-    M_LED_CASE(DisplayButton5);
-    M_LED_CASE(DisplayButton6);
-    M_LED_CASE(DisplayButton7);
-    M_LED_CASE(DisplayButton8);
-    M_LED_CASE(Scene);
-    M_LED_CASE(Pattern);
-    M_LED_CASE(PadMode);
-    M_LED_CASE(Navigate);
-    M_LED_CASE(Duplicate);
-    M_LED_CASE(Select);
-    M_LED_CASE(Solo);
-    M_LED_CASE(Mute);
-    M_LED_CASE(Volume);
-    M_LED_CASE(Swing);
-    M_LED_CASE(Tempo);
-    M_LED_CASE(MasterLeft);
-    M_LED_CASE(MasterRight);
-    M_LED_CASE(Enter);
-    M_LED_CASE(NoteRepeat);
-    M_LED_CASE(Restart);
-    M_LED_CASE(TransportLeft);
-    M_LED_CASE(TransportRight);
-    M_LED_CASE(Grid);
-    M_LED_CASE(Play);
-    M_LED_CASE(Rec);
-    M_LED_CASE(Erase);
-    M_LED_CASE(Shift);
-    M_LED_CASE(GroupA);
-    M_LED_CASE(GroupB);
-    M_LED_CASE(GroupC);
-    M_LED_CASE(GroupD);
-    M_LED_CASE(GroupE);
-    M_LED_CASE(GroupF);
-    M_LED_CASE(GroupG);
-    M_LED_CASE(GroupH);
-
-    default:
-    {
-      return Led::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_LED_MAP(idLed) {Device::Button::idLed, Led::idLed}
+
+  static constexpr Mapping<Device::Button, Led> kMapping[]{
+    M_LED_MAP(Control),
+    M_LED_MAP(Step),
+    M_LED_MAP(Browse),
+    M_LED_MAP(Sampling),
+    M_LED_MAP(BrowseLeft),
+    M_LED_MAP(BrowseRight),
+    M_LED_MAP(All),
+    M_LED_MAP(AutoWrite),
+    M_LED_MAP(DisplayButton1),
+    M_LED_MAP(DisplayButton2),
+    M_LED_MAP(DisplayButton3),
+    M_LED_MAP(DisplayButton4),
+    M_LED_MAP(DisplayButton5),
+    M_LED_MAP(DisplayButton6),
+    M_LED_MAP(DisplayButton7),
+    M_LED_MAP(DisplayButton8),
+    M_LED_MAP(Scene),
+    M_LED_MAP(Pattern),
+    M_LED_MAP(PadMode),
+    M_LED_MAP(Navigate),
+    M_LED_MAP(Duplicate),
+    M_LED_MAP(Select),
+    M_LED_MAP(Solo),
+    M_LED_MAP(Mute),
+    M_LED_MAP(Volume),
+    M_LED_MAP(Swing),
+    M_LED_MAP(Tempo),
+    M_LED_MAP(MasterLeft),
+    M_LED_MAP(MasterRight),
+    M_LED_MAP(Enter),
+    M_LED_MAP(NoteRepeat),
+    M_LED_MAP(Restart),
+    M_LED_MAP(TransportLeft),
+    M_LED_MAP(TransportRight),
+    M_LED_MAP(Grid),
+    M_LED_MAP(Play),
+    M_LED_MAP(Rec),
+    M_LED_MAP(Erase),
+    M_LED_MAP(Shift),
+    M_LED_MAP(GroupA),
+    M_LED_MAP(GroupB),
+    M_LED_MAP(GroupC),
+    M_LED_MAP(GroupD),
+    M_LED_MAP(GroupE),
+    M_LED_MAP(GroupF),
+    M_LED_MAP(GroupG),
+    M_LED_MAP(GroupH),
+  };
+  static constexpr LookupTable<Device::Button, Led, enumRange<Device::Button>()> kLeds(
+    kMapping, Led::Unknown);
+
+#undef M_LED_MAP
+
+  return kLeds[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
 
 MaschineMK2::Led MaschineMK2::led(unsigned index_) const noexcept
 {
-#define M_LED_CASE(val, idLed) \
-  case val:                    \
-    return Led::idLed
-  switch (index_)
-  {
-    M_LED_CASE(0, Pad13);
-    M_LED_CASE(1, Pad14);
-    M_LED_CASE(2, Pad15);
-    M_LED_CASE(3, Pad16);
-    M_LED_CASE(4, Pad9);
-    M_LED_CASE(5, Pad10);
-    M_LED_CASE(6, Pad11);
-    M_LED_CASE(7, Pad12);
-    M_LED_CASE(8, Pad5);
-    M_LED_CASE(9, Pad6);
-    M_LED_CASE(10, Pad7);
-    M_LED_CASE(11, Pad8);
-    M_LED_CASE(12, Pad1);
-    M_LED_CASE(13, Pad2);
-    M_LED_CASE(14, Pad3);
-    M_LED_CASE(15, Pad4);
-    default:
-    {
-      return Led::Unknown;
-    }
-  }
-#undef M_LED_CASE
+  static constexpr Mapping<unsigned, Led> kMapping[]{
+    {0, Led::Pad13},
+    {1, Led::Pad14},
+    {2, Led::Pad15},
+    {3, Led::Pad16},
+    {4, Led::Pad9},
+    {5, Led::Pad10},
+    {6, Led::Pad11},
+    {7, Led::Pad12},
+    {8, Led::Pad5},
+    {9, Led::Pad6},
+    {10, Led::Pad7},
+    {11, Led::Pad8},
+    {12, Led::Pad1},
+    {13, Led::Pad2},
+    {14, Led::Pad3},
+    {15, Led::Pad4},
+  };
+  static constexpr LookupTable<unsigned, Led, 16> kLeds(kMapping, Led::Unknown);
+
+  return kLeds[index_];
 }
 
 //--------------------------------------------------------------------------------------------------
 
 Device::Button MaschineMK2::deviceButton(Button btn_) const noexcept
 {
-#define M_BTN_CASE(idBtn) \
-  case Button::idBtn:     \
-    return Device::Button::idBtn
-
-  switch (btn_)
-  {
-    M_BTN_CASE(DisplayButton1);
-    M_BTN_CASE(DisplayButton2);
-    M_BTN_CASE(DisplayButton3);
-    M_BTN_CASE(DisplayButton4);
-    M_BTN_CASE(DisplayButton5);
-    M_BTN_CASE(DisplayButton6);
-    M_BTN_CASE(DisplayButton7);
-    M_BTN_CASE(DisplayButton8);
-    M_BTN_CASE(Control);
-    M_BTN_CASE(Step);
-    M_BTN_CASE(Browse);
-    M_BTN_CASE(Sampling);
-    M_BTN_CASE(BrowseLeft);
-    M_BTN_CASE(BrowseRight);
-    M_BTN_CASE(All);
-    M_BTN_CASE(AutoWrite);
-    M_BTN_CASE(Volume);
-    M_BTN_CASE(Swing);
-    M_BTN_CASE(Tempo);
-    M_BTN_CASE(MasterLeft);
-    M_BTN_CASE(MasterRight);
-    M_BTN_CASE(Enter);
-    M_BTN_CASE(NoteRepeat);
-    M_BTN_CASE(GroupA);
-    M_BTN_CASE(GroupB);
-    M_BTN_CASE(GroupC);
-    M_BTN_CASE(GroupD);
-    M_BTN_CASE(GroupE);
-    M_BTN_CASE(GroupF);
-    M_BTN_CASE(GroupG);
-    M_BTN_CASE(GroupH);
-    M_BTN_CASE(Restart);
-    M_BTN_CASE(TransportLeft);
-    M_BTN_CASE(TransportRight);
-    M_BTN_CASE(Grid);
-    M_BTN_CASE(Play);
-    M_BTN_CASE(Rec);
-    M_BTN_CASE(Erase);
-    M_BTN_CASE(Shift);
-    M_BTN_CASE(Scene);
-    M_BTN_CASE(Pattern);
-    M_BTN_CASE(PadMode);
-    M_BTN_CASE(Navigate);
-    M_BTN_CASE(Duplicate);
-    M_BTN_CASE(Select);
-    M_BTN_CASE(Solo);
-    M_BTN_CASE(Mute);
-    M_BTN_CASE(Main);
-
-
-    default:
-    {
-      return Device::Button::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_BTN_MAP(idBtn) {Button::idBtn, Device::Button::idBtn}
+
+  static constexpr Mapping<Button, Device::Button> kMapping[]{
+    M_BTN_MAP(DisplayButton1),
+    M_BTN_MAP(DisplayButton2),
+    M_BTN_MAP(DisplayButton3),
+    M_BTN_MAP(DisplayButton4),
+    M_BTN_MAP(DisplayButton5),
+    M_BTN_MAP(DisplayButton6),
+    M_BTN_MAP(DisplayButton7),
+    M_BTN_MAP(DisplayButton8),
+    M_BTN_MAP(Control),
+    M_BTN_MAP(Step),
+    M_BTN_MAP(Browse),
+    M_BTN_MAP(Sampling),
+    M_BTN_MAP(BrowseLeft),
+    M_BTN_MAP(BrowseRight),
+    M_BTN_MAP(All),
+    M_BTN_MAP(AutoWrite),
+    M_BTN_MAP(Volume),
+    M_BTN_MAP(Swing),
+    M_BTN_MAP(Tempo),
+    M_BTN_MAP(MasterLeft),
+    M_BTN_MAP(MasterRight),
+    M_BTN_MAP(Enter),
+    M_BTN_MAP(NoteRepeat),
+    M_BTN_MAP(GroupA),
+    M_BTN_MAP(GroupB),
+    M_BTN_MAP(GroupC),
+    M_BTN_MAP(GroupD),
+    M_BTN_MAP(GroupE),
+    M_BTN_MAP(GroupF),
+    M_BTN_MAP(GroupG),
+    M_BTN_MAP(GroupH),
+    M_BTN_MAP(Restart),
+    M_BTN_MAP(TransportLeft),
+    M_BTN_MAP(TransportRight),
+    M_BTN_MAP(Grid),
+    M_BTN_MAP(Play),
+    M_BTN_MAP(Rec),
+    M_BTN_MAP(Erase),
+    M_BTN_MAP(Shift),
+    M_BTN_MAP(Scene),
+    M_BTN_MAP(Pattern),
+    M_BTN_MAP(PadMode),
+    M_BTN_MAP(Navigate),
+    M_BTN_MAP(Duplicate),
+    M_BTN_MAP(Select),
+    M_BTN_MAP(Solo),
+    M_BTN_MAP(Mute),
+    M_BTN_MAP(Main),
+  };
+  static constexpr LookupTable<Button, Device::Button, enumRange<Button>()> kButtons(
+    kMapping, Device::Button::Unknown);
+
+#undef M_BTN_MAP
+
+  return kButtons[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -772,13 +787,5 @@ bool MaschineMK2::isButtonPressed(Button button_) const noexcept
 
 //--------------------------------------------------------------------------------------------------
 
-bool MaschineMK2::isButtonPressed(const Transfer& transfer_, Button button_) const noexcept
-{
-  uint8_t buttonPos = static_cast<uint8_t>(button_);
-  return ((transfer_[1 + (buttonPos >> 3)] & (1 << (buttonPos % 8))) != 0);
-}
-
-//--------------------------------------------------------------------------------------------------
-
 } // namespace cabl
 } // namespace sl
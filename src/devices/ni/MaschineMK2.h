@@ -11,6 +11,7 @@
 #include <bitset>
 
 #include "cabl/devices/Device.h"
+#include "devices/HidReport.h"
 #include "gfx/displays/GDisplayMaschineMK2.h"
 
 namespace sl
@@ -31,6 +32,7 @@ public:
   void setKeyLed(unsigned, const Color&) override;
 
   void sendMidiMsg(tRawData) override;
+  void sendMidiBytes(const uint8_t* pData_, size_t length_) override;
 
   Canvas* graphicDisplay(size_t displayIndex_) override;
 
@@ -88,17 +90,15 @@ private:
 
   Device::Button deviceButton(Button btn_) const noexcept;
   bool isButtonPressed(Button button) const noexcept;
-  bool isButtonPressed(const Transfer&, Button button_) const noexcept;
 
   GDisplayMaschineMK2 m_displays[kMASMK2_nDisplays];
 
-  std::array<uint8_t, kMASMK2_nLedsButtons> m_ledsButtons;
-  std::array<uint8_t, kMASMK2_nLedsGroups> m_ledsGroups;
-  std::array<uint8_t, kMASMK2_nLedsPads> m_ledsPads;
+  OutputReport<0x82, kMASMK2_nLedsButtons> m_ledsButtons;
+  OutputReport<0x81, kMASMK2_nLedsGroups> m_ledsGroups;
+  OutputReport<0x80, kMASMK2_nLedsPads> m_ledsPads;
 
   std::array<uint8_t, kMASMK2_buttonsDataSize> m_buttons;
 
-  std::bitset<kMASMK2_nButtons> m_buttonStates;
   unsigned m_encoderValues[kMASMK2_nEncoders];
 
   unsigned m_padsData[kMASMK2_nPads];
@@ -110,6 +110,7 @@ private:
 
 #if defined(_WIN32) || defined(__APPLE__) || defined(__linux)
   tPtr<RtMidiOut> m_pMidiout;
+  std::vector<unsigned char> m_midiOutMessage;
 #endif
 };
 
@@ -9,6 +9,7 @@
 #include "cabl/comm/Driver.h"
 #include "cabl/comm/Transfer.h"
 #include "cabl/util/Functions.h"
+#include "cabl/util/LookupTable.h"
 
 #include <thread>
 
@@ -27,6 +28,14 @@ const uint8_t kMikroMK2_epDisplay = 0x08;
 const uint8_t kMikroMK2_epOut = 0x01;
 const uint8_t kMikroMK2_epInput = 0x84;
 const unsigned kMikroMK2_padThreshold = 200;
+
+// Input report 0x01: buttons and encoder
+using tMikroMK2_buttons = sl::cabl::ReportBitmap<1, 32>;
+using tMikroMK2_encoder = sl::cabl::ReportField<5, 0, 8>;
+
+// Input report 0x20: pad pressure (12 bit) with the pad index in the high nibble
+using tMikroMK2_padValues = sl::cabl::ReportFieldArray<1, 2, 0, 12, 32>;
+using tMikroMK2_padIndices = sl::cabl::ReportFieldArray<2, 2, 4, 4, 32>;
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
@@ -173,7 +182,7 @@ bool MaschineMikroMK2::tick()
   bool success = false;
 
   //!\todo enable once display dirty flag is properly set
-  if (state == 0 && m_display.dirty())
+  if (state == 0 && m_display.dirty() && displayFrameDue())
   {
     success = sendFrame();
   }
@@ -204,8 +213,11 @@ void MaschineMikroMK2::init()
   m_display.white();
 
   // Leds
-  std::fill(std::begin(m_leds), std::end(m_leds), 0);
+  m_leds.fill(0);
   m_isDirtyLeds = true;
+
+  // Buttons
+  m_buttons.fill(0);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -226,7 +238,8 @@ bool MaschineMikroMK2::sendFrame()
     const uint8_t* ptr = m_display.buffer() + (chunk * 256);
     if (!writeToDeviceHandle(
           Transfer({0xE0, 0x00, 0x00, yOffset, 0x00, 0x80, 0x00, 0x02, 0x00}, ptr, 256),
-          kMikroMK2_epDisplay))
+          kMikroMK2_epDisplay,
+          Traffic::Display))
     {
       return false;
     }
@@ -241,7 +254,7 @@ bool MaschineMikroMK2::sendLeds()
 {
   //  if (m_isDirtyLeds)
   {
-    if (!writeToDeviceHandle(Transfer({0x80}, &m_leds[0], 78), kMikroMK2_epOut))
+    if (!writeToDeviceHandle(m_leds.transfer(), kMikroMK2_epOut))
     {
       return false;
     }
@@ -263,12 +276,13 @@ bool MaschineMikroMK2::read()
     }
     else if (input && input[0] == 0x01)
     {
-      processButtons(input);
+      decodeInput({InputMask::Class::Buttons, InputMask::Class::Encoders},
+        [&] { processButtons(input); });
       break;
     }
     else if (input && input[0] == 0x20 && n % 8 == 0) // Too many pad messages, need to skip some...
     {
-      processPads(input);
+      decodeInput({InputMask::Class::Keys}, [&] { processPads(input); });
     }
     /*
             std::cout << std::setfill('0') << std::internal;
@@ -287,36 +301,26 @@ bool MaschineMikroMK2::read()
 
 void MaschineMikroMK2::processButtons(const Transfer& input_)
 {
-  bool shiftPressed(isButtonPressed(input_, Button::Shift));
-  Device::Button changedButton(Device::Button::Unknown);
-  bool buttonPressed(false);
-
-  for (int i = 0; i < kMikroMK2_buttonsDataSize - 1; i++) // Skip the last byte (encoder value)
+  if (input_.size() < tMikroMK2_encoder::kEnd)
   {
-    for (int k = 0; k < 8; k++)
+    return;
+  }
+
+  const uint8_t* pReport = input_.data().data();
+  bool shiftPressed(tMikroMK2_buttons::test(pReport, static_cast<size_t>(Button::Shift)));
+
+  tMikroMK2_buttons::diff(pReport, m_buttons.data(), [&](size_t btn_, bool buttonPressed_) -> bool {
+    Button currentButton(static_cast<Button>(btn_));
+    Device::Button changedButton = deviceButton(currentButton);
+    if (currentButton != Button::Shift && changedButton != Device::Button::Unknown)
     {
-      uint8_t btn = (i * 8) + k;
-      Button currentButton(static_cast<Button>(btn));
-      if (currentButton == Button::Shift)
-      {
-        continue;
-      }
-      buttonPressed = isButtonPressed(input_, currentButton);
-      if (buttonPressed != m_buttonStates[btn])
-      {
-        m_buttonStates[btn] = buttonPressed;
-        changedButton = deviceButton(currentButton);
-        if (changedButton != Device::Button::Unknown)
-        {
-          //    std::copy(&input_[1],&input_[kMikroMK2_buttonsDataSize],m_buttons.begin());
-          buttonChanged(changedButton, buttonPressed, shiftPressed);
-        }
-      }
+      buttonChanged(changedButton, buttonPressed_, shiftPressed);
     }
-  }
+    return true;
+  });
 
   // Now process the encoder data
-  uint8_t currentEncoderValue = input_.data()[kMikroMK2_buttonsDataSize];
+  uint8_t currentEncoderValue = tMikroMK2_encoder::decode(pReport);
   if (m_encoderValue != currentEncoderValue)
   {
     bool valueIncreased = ((m_encoderValue < currentEncoderValue)
@@ -331,26 +335,29 @@ void MaschineMikroMK2::processButtons(const Transfer& input_)
 
 void MaschineMikroMK2::processPads(const Transfer& input_)
 {
-  //!\todo process pad data
-  for (int i = 1; i <= kMikroMK2_padDataSize; i += 2)
+  if (input_.size() < tMikroMK2_padIndices::kEnd)
+  {
+    return;
+  }
+
+  const uint8_t* pReport = input_.data().data();
+  bool shiftPressed(isButtonPressed(Button::Shift));
+  for (size_t i = 0; i < tMikroMK2_padValues::kSize; i++)
   {
-    unsigned l = input_[i];
-    unsigned h = input_[i + 1];
-    uint8_t pad = (h & 0xF0) >> 4;
-    m_padsData[pad] = (((h & 0x0F) << 8) | l);
+    uint8_t pad = tMikroMK2_padIndices::decode(pReport, i);
+    m_padsData[pad] = tMikroMK2_padValues::decode(pReport, i);
 
     if (m_padsData[pad] > kMikroMK2_padThreshold)
     {
       m_padsStatus[pad] = true;
-      keyChanged(
-        pad, m_padsData[pad] / 1024.0, m_buttonStates[static_cast<uint8_t>(Button::Shift)]);
+      keyChanged(pad, m_padsData[pad] / 1024.0, shiftPressed);
     }
     else
     {
       if (m_padsStatus[pad])
       {
         m_padsStatus[pad] = false;
-        keyChanged(pad, 0.0, m_buttonStates[static_cast<uint8_t>(Button::Shift)]);
+        keyChanged(pad, 0.0, shiftPressed);
       }
     }
   }
@@ -419,128 +426,116 @@ bool MaschineMikroMK2::isRGBLed(Led led_) const noexcept
 
 MaschineMikroMK2::Led MaschineMikroMK2::led(Device::Button btn_) const noexcept
 {
-#define M_LED_CASE(idLed)     \
-  case Device::Button::idLed: \
-    return Led::idLed
-
-  switch (btn_)
-  {
-    M_LED_CASE(F1);
-    M_LED_CASE(F2);
-    M_LED_CASE(F3);
-    M_LED_CASE(Control);
-    M_LED_CASE(Nav);
-    M_LED_CASE(BrowseLeft);
-    M_LED_CASE(BrowseRight);
-    M_LED_CASE(Main);
-    M_LED_CASE(Group);
-    M_LED_CASE(Browse);
-    M_LED_CASE(Sampling);
-    M_LED_CASE(NoteRepeat);
-    M_LED_CASE(Restart);
-    M_LED_CASE(TransportLeft);
-    M_LED_CASE(TransportRight);
-    M_LED_CASE(Grid);
-    M_LED_CASE(Play);
-    M_LED_CASE(Rec);
-    M_LED_CASE(Erase);
-    M_LED_CASE(Shift);
-    M_LED_CASE(Scene);
-    M_LED_CASE(Pattern);
-    M_LED_CASE(PadMode);
-    M_LED_CASE(View);
-    M_LED_CASE(Duplicate);
-    M_LED_CASE(Select);
-    M_LED_CASE(Solo);
-    M_LED_CASE(Mute);
-    default:
-    {
-      return Led::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_LED_MAP(idLed) {Device::Button::idLed, Led::idLed}
+
+  static constexpr Mapping<Device::Button, Led> kMapping[]{
+    M_LED_MAP(F1),
+    M_LED_MAP(F2),
+    M_LED_MAP(F3),
+    M_LED_MAP(Control),
+    M_LED_MAP(Nav),
+    M_LED_MAP(BrowseLeft),
+    M_LED_MAP(BrowseRight),
+    M_LED_MAP(Main),
+    M_LED_MAP(Group),
+    M_LED_MAP(Browse),
+    M_LED_MAP(Sampling),
+    M_LED_MAP(NoteRepeat),
+    M_LED_MAP(Restart),
+    M_LED_MAP(TransportLeft),
+    M_LED_MAP(TransportRight),
+    M_LED_MAP(Grid),
+    M_LED_MAP(Play),
+    M_LED_MAP(Rec),
+    M_LED_MAP(Erase),
+    M_LED_MAP(Shift),
+    M_LED_MAP(Scene),
+    M_LED_MAP(Pattern),
+    M_LED_MAP(PadMode),
+    M_LED_MAP(View),
+    M_LED_MAP(Duplicate),
+    M_LED_MAP(Select),
+    M_LED_MAP(Solo),
+    M_LED_MAP(Mute),
+  };
+  static constexpr LookupTable<Device::Button, Led, enumRange<Device::Button>()> kLeds(
+    kMapping, Led::Unknown);
+
+#undef M_LED_MAP
+
+  return kLeds[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
 
 MaschineMikroMK2::Led MaschineMikroMK2::led(unsigned index_) const noexcept
 {
-#define M_LED_CASE(val, idLed) \
-  case val:                    \
-    return Led::idLed
-  switch (index_)
-  {
-    M_LED_CASE(0, Pad13);
-    M_LED_CASE(1, Pad14);
-    M_LED_CASE(2, Pad15);
-    M_LED_CASE(3, Pad16);
-    M_LED_CASE(4, Pad9);
-    M_LED_CASE(5, Pad10);
-    M_LED_CASE(6, Pad11);
-    M_LED_CASE(7, Pad12);
-    M_LED_CASE(8, Pad5);
-    M_LED_CASE(9, Pad6);
-    M_LED_CASE(10, Pad7);
-    M_LED_CASE(11, Pad8);
-    M_LED_CASE(12, Pad1);
-    M_LED_CASE(13, Pad2);
-    M_LED_CASE(14, Pad3);
-    M_LED_CASE(15, Pad4);
-    default:
-    {
-      return Led::Unknown;
-    }
-  }
-#undef M_LED_CASE
+  static constexpr Mapping<unsigned, Led> kMapping[]{
+    {0, Led::Pad13},
+    {1, Led::Pad14},
+    {2, Led::Pad15},
+    {3, Led::Pad16},
+    {4, Led::Pad9},
+    {5, Led::Pad10},
+    {6, Led::Pad11},
+    {7, Led::Pad12},
+    {8, Led::Pad5},
+    {9, Led::Pad6},
+    {10, Led::Pad7},
+    {11, Led::Pad8},
+    {12, Led::Pad1},
+    {13, Led::Pad2},
+    {14, Led::Pad3},
+    {15, Led::Pad4},
+  };
+  static constexpr LookupTable<unsigned, Led, 16> kLeds(kMapping, Led::Unknown);
+
+  return kLeds[index_];
 }
 
 //--------------------------------------------------------------------------------------------------
 
 Device::Button MaschineMikroMK2::deviceButton(Button btn_) const noexcept
 {
-#define M_BTN_CASE(idBtn) \
-  case Button::idBtn:     \
-    return Device::Button::idBtn
-
-  switch (btn_)
-  {
-    M_BTN_CASE(F1);
-    M_BTN_CASE(F2);
-    M_BTN_CASE(F3);
-    M_BTN_CASE(Control);
-    M_BTN_CASE(Nav);
-    M_BTN_CASE(BrowseLeft);
-    M_BTN_CASE(BrowseRight);
-    M_BTN_CASE(Main);
-    M_BTN_CASE(Group);
-    M_BTN_CASE(Browse);
-    M_BTN_CASE(Sampling);
-    M_BTN_CASE(NoteRepeat);
-    M_BTN_CASE(Restart);
-    M_BTN_CASE(TransportLeft);
-    M_BTN_CASE(TransportRight);
-    M_BTN_CASE(Grid);
-    M_BTN_CASE(Play);
-    M_BTN_CASE(Rec);
-    M_BTN_CASE(Erase);
-    M_BTN_CASE(Shift);
-    M_BTN_CASE(Scene);
-    M_BTN_CASE(Pattern);
-    M_BTN_CASE(PadMode);
-    M_BTN_CASE(View);
-    M_BTN_CASE(Duplicate);
-    M_BTN_CASE(Select);
-    M_BTN_CASE(Solo);
-    M_BTN_CASE(Mute);
-    M_BTN_CASE(MainEncoder);
-    default:
-    {
-      return Device::Button::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_BTN_MAP(idBtn) {Button::idBtn, Device::Button::idBtn}
+
+  static constexpr Mapping<Button, Device::Button> kMapping[]{
+    M_BTN_MAP(F1),
+    M_BTN_MAP(F2),
+    M_BTN_MAP(F3),
+    M_BTN_MAP(Control),
+    M_BTN_MAP(Nav),
+    M_BTN_MAP(BrowseLeft),
+    M_BTN_MAP(BrowseRight),
+    M_BTN_MAP(Main),
+    M_BTN_MAP(Group),
+    M_BTN_MAP(Browse),
+    M_BTN_MAP(Sampling),
+    M_BTN_MAP(NoteRepeat),
+    M_BTN_MAP(Restart),
+    M_BTN_MAP(TransportLeft),
+    M_BTN_MAP(TransportRight),
+    M_BTN_MAP(Grid),
+    M_BTN_MAP(Play),
+    M_BTN_MAP(Rec),
+    M_BTN_MAP(Erase),
+    M_BTN_MAP(Shift),
+    M_BTN_MAP(Scene),
+    M_BTN_MAP(Pattern),
+    M_BTN_MAP(PadMode),
+    M_BTN_MAP(View),
+    M_BTN_MAP(Duplicate),
+    M_BTN_MAP(Select),
+    M_BTN_MAP(Solo),
+    M_BTN_MAP(Mute),
+    M_BTN_MAP(MainEncoder),
+  };
+  static constexpr LookupTable<Button, Device::Button, enumRange<Button>()> kButtons(
+    kMapping, Device::Button::Unknown);
+
+#undef M_BTN_MAP
+
+  return kButtons[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -553,13 +548,5 @@ bool MaschineMikroMK2::isButtonPressed(Button button_) const noexcept
 
 //--------------------------------------------------------------------------------------------------
 
-bool MaschineMikroMK2::isButtonPressed(const Transfer& transfer_, Button button_) const noexcept
-{
-  uint8_t buttonPos = static_cast<uint8_t>(button_);
-  return ((transfer_[1 + (buttonPos >> 3)] & (1 << (buttonPos % 8))) != 0);
-}
-
-//--------------------------------------------------------------------------------------------------
-
 } // namespace cabl
 } // namespace sl
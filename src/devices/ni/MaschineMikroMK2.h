@@ -12,6 +12,7 @@
 
 #include "cabl/devices/Device.h"
 #include "cabl/devices/DeviceFactory.h"
+#include "devices/HidReport.h"
 #include "gfx/displays/GDisplayMaschineMikro.h"
 
 namespace sl
@@ -82,14 +83,12 @@ private:
 
   Device::Button deviceButton(Button btn_) const noexcept;
   bool isButtonPressed(Button button) const noexcept;
-  bool isButtonPressed(const Transfer&, Button button_) const noexcept;
 
   GDisplayMaschineMikro m_display;
 
-  std::array<uint8_t, kMikroMK2_ledsDataSize> m_leds;
+  OutputReport<0x80, kMikroMK2_ledsDataSize> m_leds;
   std::array<uint8_t, kMikroMK2_buttonsDataSize> m_buttons;
 
-  std::bitset<kMikroMK2_nButtons> m_buttonStates;
   uint8_t m_encoderValue;
 
   unsigned m_padsData[kMikroMK2_nPads];
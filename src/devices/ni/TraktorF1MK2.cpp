@@ -10,6 +10,7 @@
 #include "cabl/comm/Transfer.h"
 #include "cabl/gfx/TextDisplay.h"
 #include "cabl/util/Functions.h"
+#include "cabl/util/LookupTable.h"
 
 //--------------------------------------------------------------------------------------------------
 
@@ -233,6 +234,11 @@ bool TraktorF1MK2::sendLedsAndDisplay()
 
 bool TraktorF1MK2::read()
 {
+  if (!inputPollDue())
+  {
+    return true;
+  }
+
   Transfer input;
 
   if (!readFromDeviceHandle(input, kF1MK2_epInput))
@@ -358,132 +364,116 @@ bool TraktorF1MK2::isRGBLed(Led led_) const noexcept
 
 TraktorF1MK2::Led TraktorF1MK2::led(Device::Button btn_) const noexcept
 {
-#define M_LED_CASE(idLed)     \
-  case Device::Button::idLed: \
-    return Led::idLed
-
-  switch (btn_)
-  {
-    M_LED_CASE(Browse);
-    M_LED_CASE(Size);
-    M_LED_CASE(Type);
-    M_LED_CASE(Reverse);
-    M_LED_CASE(Shift);
-    M_LED_CASE(Capture);
-    M_LED_CASE(Quant);
-    M_LED_CASE(Sync);
-    M_LED_CASE(Pad1);
-    M_LED_CASE(Pad2);
-    M_LED_CASE(Pad3);
-    M_LED_CASE(Pad4);
-    M_LED_CASE(Pad5);
-    M_LED_CASE(Pad6);
-    M_LED_CASE(Pad7);
-    M_LED_CASE(Pad8);
-    M_LED_CASE(Pad9);
-    M_LED_CASE(Pad10);
-    M_LED_CASE(Pad11);
-    M_LED_CASE(Pad12);
-    M_LED_CASE(Pad13);
-    M_LED_CASE(Pad14);
-    M_LED_CASE(Pad15);
-    M_LED_CASE(Pad16);
-    M_LED_CASE(Stop4);
-    M_LED_CASE(Stop3);
-    M_LED_CASE(Stop2);
-    M_LED_CASE(Stop1);
-    default:
-    {
-      return Led::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_LED_MAP(idLed) {Device::Button::idLed, Led::idLed}
+
+  static constexpr Mapping<Device::Button, Led> kMapping[]{
+    M_LED_MAP(Browse),
+    M_LED_MAP(Size),
+    M_LED_MAP(Type),
+    M_LED_MAP(Reverse),
+    M_LED_MAP(Shift),
+    M_LED_MAP(Capture),
+    M_LED_MAP(Quant),
+    M_LED_MAP(Sync),
+    M_LED_MAP(Pad1),
+    M_LED_MAP(Pad2),
+    M_LED_MAP(Pad3),
+    M_LED_MAP(Pad4),
+    M_LED_MAP(Pad5),
+    M_LED_MAP(Pad6),
+    M_LED_MAP(Pad7),
+    M_LED_MAP(Pad8),
+    M_LED_MAP(Pad9),
+    M_LED_MAP(Pad10),
+    M_LED_MAP(Pad11),
+    M_LED_MAP(Pad12),
+    M_LED_MAP(Pad13),
+    M_LED_MAP(Pad14),
+    M_LED_MAP(Pad15),
+    M_LED_MAP(Pad16),
+    M_LED_MAP(Stop4),
+    M_LED_MAP(Stop3),
+    M_LED_MAP(Stop2),
+    M_LED_MAP(Stop1),
+  };
+  static constexpr LookupTable<Device::Button, Led, enumRange<Device::Button>()> kLeds(
+    kMapping, Led::Unknown);
+
+#undef M_LED_MAP
+
+  return kLeds[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
 
 TraktorF1MK2::Led TraktorF1MK2::led(unsigned index_) const noexcept
 {
-#define M_LED_CASE(val, idLed) \
-  case val:                    \
-    return Led::idLed
-  switch (index_)
-  {
-    M_LED_CASE(0, Pad13);
-    M_LED_CASE(1, Pad14);
-    M_LED_CASE(2, Pad15);
-    M_LED_CASE(3, Pad16);
-    M_LED_CASE(4, Pad9);
-    M_LED_CASE(5, Pad10);
-    M_LED_CASE(6, Pad11);
-    M_LED_CASE(7, Pad12);
-    M_LED_CASE(8, Pad5);
-    M_LED_CASE(9, Pad6);
-    M_LED_CASE(10, Pad7);
-    M_LED_CASE(11, Pad8);
-    M_LED_CASE(12, Pad1);
-    M_LED_CASE(13, Pad2);
-    M_LED_CASE(14, Pad3);
-    M_LED_CASE(15, Pad4);
-    default:
-    {
-      return Led::Unknown;
-    }
-  }
-#undef M_LED_CASE
+  static constexpr Mapping<unsigned, Led> kMapping[]{
+    {0, Led::Pad13},
+    {1, Led::Pad14},
+    {2, Led::Pad15},
+    {3, Led::Pad16},
+    {4, Led::Pad9},
+    {5, Led::Pad10},
+    {6, Led::Pad11},
+    {7, Led::Pad12},
+    {8, Led::Pad5},
+    {9, Led::Pad6},
+    {10, Led::Pad7},
+    {11, Led::Pad8},
+    {12, Led::Pad1},
+    {13, Led::Pad2},
+    {14, Led::Pad3},
+    {15, Led::Pad4},
+  };
+  static constexpr LookupTable<unsigned, Led, 16> kLeds(kMapping, Led::Unknown);
+
+  return kLeds[index_];
 }
 
 //--------------------------------------------------------------------------------------------------
 
 Device::Button TraktorF1MK2::deviceButton(Button btn_) const noexcept
 {
-#define M_BTN_CASE(idBtn) \
-  case Button::idBtn:     \
-    return Device::Button::idBtn
-
-  switch (btn_)
-  {
-    M_BTN_CASE(Pad8);
-    M_BTN_CASE(Pad7);
-    M_BTN_CASE(Pad6);
-    M_BTN_CASE(Pad5);
-    M_BTN_CASE(Pad4);
-    M_BTN_CASE(Pad3);
-    M_BTN_CASE(Pad2);
-    M_BTN_CASE(Pad1);
-
-    M_BTN_CASE(Pad16);
-    M_BTN_CASE(Pad15);
-    M_BTN_CASE(Pad14);
-    M_BTN_CASE(Pad13);
-    M_BTN_CASE(Pad12);
-    M_BTN_CASE(Pad11);
-    M_BTN_CASE(Pad10);
-    M_BTN_CASE(Pad9);
-
-    M_BTN_CASE(MainEncoder);
-    M_BTN_CASE(Browse);
-    M_BTN_CASE(Size);
-    M_BTN_CASE(Type);
-    M_BTN_CASE(Reverse);
-    M_BTN_CASE(Shift);
-
-    M_BTN_CASE(Capture);
-    M_BTN_CASE(Quant);
-    M_BTN_CASE(Sync);
-    M_BTN_CASE(Stop4);
-    M_BTN_CASE(Stop3);
-    M_BTN_CASE(Stop2);
-    M_BTN_CASE(Stop1);
-
-    default:
-    {
-      return Device::Button::Unknown;
-    }
-  }
-
-#undef M_LED_CASE
+#define M_BTN_MAP(idBtn) {Button::idBtn, Device::Button::idBtn}
+
+  static constexpr Mapping<Button, Device::Button> kMapping[]{
+    M_BTN_MAP(Pad8),
+    M_BTN_MAP(Pad7),
+    M_BTN_MAP(Pad6),
+    M_BTN_MAP(Pad5),
+    M_BTN_MAP(Pad4),
+    M_BTN_MAP(Pad3),
+    M_BTN_MAP(Pad2),
+    M_BTN_MAP(Pad1),
+    M_BTN_MAP(Pad16),
+    M_BTN_MAP(Pad15),
+    M_BTN_MAP(Pad14),
+    M_BTN_MAP(Pad13),
+    M_BTN_MAP(Pad12),
+    M_BTN_MAP(Pad11),
+    M_BTN_MAP(Pad10),
+    M_BTN_MAP(Pad9),
+    M_BTN_MAP(MainEncoder),
+    M_BTN_MAP(Browse),
+    M_BTN_MAP(Size),
+    M_BTN_MAP(Type),
+    M_BTN_MAP(Reverse),
+    M_BTN_MAP(Shift),
+    M_BTN_MAP(Capture),
+    M_BTN_MAP(Quant),
+    M_BTN_MAP(Sync),
+    M_BTN_MAP(Stop4),
+    M_BTN_MAP(Stop3),
+    M_BTN_MAP(Stop2),
+    M_BTN_MAP(Stop1),
+  };
+  static constexpr LookupTable<Button, Device::Button, enumRange<Button>()> kButtons(
+    kMapping, Device::Button::Unknown);
+
+#undef M_BTN_MAP
+
+  return kButtons[btn_];
 }
 
 //--------------------------------------------------------------------------------------------------
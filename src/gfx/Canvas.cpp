@@ -52,6 +52,14 @@ void Canvas::fill(uint8_t value_)
 
 //--------------------------------------------------------------------------------------------------
 
+Color Canvas::fillColor(uint8_t value_, unsigned x_, unsigned y_) const
+{
+  // One byte per channel, see setPixel()
+  return {value_, value_, value_};
+}
+
+//--------------------------------------------------------------------------------------------------
+
 void Canvas::setPixel(unsigned x_, unsigned y_, const Color& color_, bool setDirtyFlags_)
 {
   if (x_ >= width() || y_ >= height() || color_.transparent())
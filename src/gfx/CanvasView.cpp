@@ -0,0 +1,193 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/gfx/CanvasView.h"
+
+#include <algorithm>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+CanvasView::CanvasView(Canvas& parent_, unsigned x_, unsigned y_, unsigned w_, unsigned h_)
+  : m_parent(parent_)
+  , m_x(std::min(x_, parent_.width()))
+  , m_y(std::min(y_, parent_.height()))
+  , m_width(std::min(w_, parent_.width() - m_x))
+  , m_height(std::min(h_, parent_.height() - m_y))
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CanvasView::white()
+{
+  if (coversParent())
+  {
+    m_parent.white();
+    return;
+  }
+  // Not fill(0xFF): filling sets bits, which are black on some displays
+  paint({0xFF});
+  setDirty();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CanvasView::black()
+{
+  if (coversParent())
+  {
+    m_parent.black();
+    return;
+  }
+  paint({0x00});
+  setDirty();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CanvasView::invert()
+{
+  if (coversParent())
+  {
+    m_parent.invert();
+    return;
+  }
+
+  for (unsigned y = 0; y < m_height; y++)
+  {
+    for (unsigned x = 0; x < m_width; x++)
+    {
+      m_parent.setPixel(m_x + x, m_y + y, {BlendMode::Invert}, false);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CanvasView::fill(uint8_t value_)
+{
+  if (coversParent())
+  {
+    m_parent.fill(value_);
+    return;
+  }
+
+  // Only the view area is touched, so the pattern is applied per pixel and not per byte, each
+  // pixel taking the color the parent fill would give it
+  for (unsigned y = 0; y < m_height; y++)
+  {
+    for (unsigned x = 0; x < m_width; x++)
+    {
+      m_parent.setPixel(m_x + x, m_y + y, m_parent.fillColor(value_, m_x + x, m_y + y), false);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Color CanvasView::fillColor(uint8_t value_, unsigned x_, unsigned y_) const
+{
+  if (x_ >= m_width || y_ >= m_height)
+  {
+    return {};
+  }
+  return m_parent.fillColor(value_, m_x + x_, m_y + y_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CanvasView::setPixel(unsigned x_, unsigned y_, const Color& color_, bool bSetDirtyChunk_)
+{
+  if (x_ >= m_width || y_ >= m_height)
+  {
+    return;
+  }
+  m_parent.setPixel(m_x + x_, m_y + y_, color_, bSetDirtyChunk_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Color CanvasView::pixel(unsigned x_, unsigned y_) const
+{
+  if (x_ >= m_width || y_ >= m_height)
+  {
+    return {};
+  }
+  return m_parent.pixel(m_x + x_, m_y + y_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CanvasView::setDirty()
+{
+  if (coversParent())
+  {
+    m_parent.setDirty();
+    return;
+  }
+
+  for (unsigned y = 0; y < m_height; y++)
+  {
+    m_parent.setDirtyChunk(m_y + y);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool CanvasView::dirty() const
+{
+  unsigned nChunks = m_parent.numberOfChunks();
+  unsigned chunkHeight = nChunks > 0 ? m_parent.height() / nChunks : 0;
+  if (chunkHeight == 0 || m_height == 0)
+  {
+    return m_parent.dirty();
+  }
+
+  unsigned firstChunk = std::min(m_y / chunkHeight, nChunks - 1);
+  unsigned lastChunk = std::min((m_y + m_height - 1) / chunkHeight, nChunks - 1);
+  for (unsigned chunk = firstChunk; chunk <= lastChunk; chunk++)
+  {
+    if (m_parent.dirtyChunk(chunk))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CanvasView::setDirtyChunk(unsigned yStart_) const
+{
+  if (yStart_ < m_height)
+  {
+    m_parent.setDirtyChunk(m_y + yStart_);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void CanvasView::paint(const Color& color_)
+{
+  for (unsigned y = 0; y < m_height; y++)
+  {
+    for (unsigned x = 0; x < m_width; x++)
+    {
+      m_parent.setPixel(m_x + x, m_y + y, color_, false);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,179 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/gfx/FramePlayer.h"
+
+#include <algorithm>
+
+#include "cabl/gfx/Canvas.h"
+#include "cabl/util/Log.h"
+
+#include "util/MappedFile.h"
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+constexpr double FramePlayer::kDefaultFrameRate;
+
+//--------------------------------------------------------------------------------------------------
+
+FramePlayer::FramePlayer(Canvas& canvas_) : m_canvas(canvas_), m_pFile(new MappedFile)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+
+FramePlayer::~FramePlayer()
+{
+  close();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool FramePlayer::open(const std::string& path_)
+{
+  close();
+
+  m_frameSize = m_canvas.bufferSize();
+  if (m_frameSize == 0 || !m_pFile->open(path_))
+  {
+    M_LOG("[FramePlayer::open] cannot map " << path_);
+    return false;
+  }
+  if (m_pFile->size() % m_frameSize != 0)
+  {
+    M_LOG("[FramePlayer::open] " << path_ << " is not a sequence of " << m_frameSize
+                                 << " bytes frames");
+    m_pFile->close();
+    return false;
+  }
+  if (!m_canvas.attachFrame(m_pFile->data()))
+  {
+    M_LOG("[FramePlayer::open] the canvas doesn't support attached frames");
+    m_pFile->close();
+    return false;
+  }
+
+  m_pFile->adviseSequential();
+  m_numFrames = m_pFile->size() / m_frameSize;
+  m_currentFrame = 0;
+  m_position = 0;
+  m_droppedFrames = 0;
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void FramePlayer::close()
+{
+  m_playing = false;
+  if (m_numFrames > 0)
+  {
+    m_canvas.detachFrame();
+  }
+  m_pFile->close();
+  m_numFrames = 0;
+  m_currentFrame = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void FramePlayer::setFrameRate(double framesPerSecond_)
+{
+  if (framesPerSecond_ <= 0)
+  {
+    return;
+  }
+  m_frameRate = framesPerSecond_;
+  if (m_playing)
+  {
+    // Keep the current position, pacing continues at the new rate from now on
+    m_start = tClock::now() - frameDuration(m_position);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void FramePlayer::play(tClock::time_point now_)
+{
+  if (!isOpen())
+  {
+    return;
+  }
+  m_position = m_currentFrame;
+  m_start = now_ - frameDuration(m_position);
+  m_playing = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void FramePlayer::seek(size_t frame_, tClock::time_point now_)
+{
+  if (!isOpen())
+  {
+    return;
+  }
+  show(std::min(frame_, m_numFrames - 1));
+  m_position = m_currentFrame;
+  m_start = now_ - frameDuration(m_position);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool FramePlayer::update(tClock::time_point now_)
+{
+  if (!m_playing || now_ < m_start)
+  {
+    return false;
+  }
+
+  uint64_t due = static_cast<uint64_t>(
+    std::chrono::duration<double>(now_ - m_start).count() * m_frameRate);
+  if (!m_looping)
+  {
+    due = std::min<uint64_t>(due, m_numFrames - 1);
+  }
+  if (due <= m_position)
+  {
+    return false;
+  }
+
+  m_droppedFrames += due - m_position - 1;
+  m_position = due;
+  show(static_cast<size_t>(due % m_numFrames));
+
+  if (!m_looping && m_currentFrame == m_numFrames - 1)
+  {
+    m_playing = false;
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void FramePlayer::show(size_t frame_)
+{
+  m_currentFrame = frame_;
+  m_canvas.attachFrame(m_pFile->data() + frame_ * m_frameSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+FramePlayer::tClock::duration FramePlayer::frameDuration(uint64_t nFrames_) const
+{
+  return std::chrono::duration_cast<tClock::duration>(
+    std::chrono::duration<double>(nFrames_ / m_frameRate));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,303 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/gfx/RgbaCanvas.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+constexpr unsigned RgbaCanvas::kRowAlignment;
+constexpr unsigned RgbaCanvas::kWordsPerRowAlignment;
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+// Same rounding as the display classes: round(value * max / 255)
+inline uint8_t scale(uint8_t value_, unsigned max_)
+{
+  return static_cast<uint8_t>((value_ * max_ * 2 + 255) / 510);
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+RgbaCanvas::RgbaCanvas(unsigned w_, unsigned h_, unsigned nChunks_)
+  : m_width(w_)
+  , m_height(h_)
+  , m_stride((w_ + kWordsPerRowAlignment - 1) / kWordsPerRowAlignment * kWordsPerRowAlignment)
+  , m_nChunks(nChunks_)
+  , m_chunkDirtyFlags(nChunks_)
+{
+  black();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+RgbaCanvas::RgbaCanvas(const RgbaCanvas& other_)
+  : Canvas(other_)
+  , m_width(other_.m_width)
+  , m_height(other_.m_height)
+  , m_stride(other_.m_stride)
+  , m_nChunks(other_.m_nChunks)
+  , m_chunkDirtyFlags(other_.m_chunkDirtyFlags)
+{
+  // The copy is aligned on its own, the pixels are copied rather than the storage
+  if (!other_.m_storage.empty())
+  {
+    std::copy(other_.pixels(), other_.pixels() + m_height * m_stride, pixels());
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+uint32_t RgbaCanvas::pack(uint8_t red_, uint8_t green_, uint8_t blue_, uint8_t alpha_)
+{
+  const uint8_t bytes[4]{red_, green_, blue_, alpha_};
+  uint32_t pixel;
+  std::memcpy(&pixel, bytes, sizeof(pixel));
+  return pixel;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void RgbaCanvas::fill(uint8_t value_)
+{
+  std::fill_n(pixels(), m_height * m_stride, pack(value_, value_, value_));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void RgbaCanvas::invert()
+{
+  uint32_t mask = pack(0xFF, 0xFF, 0xFF, 0x00);
+  uint32_t* pPixels = pixels();
+  for (size_t i = 0; i < m_height * m_stride; i++)
+  {
+    pPixels[i] ^= mask;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void RgbaCanvas::setPixel(unsigned x_, unsigned y_, const Color& color_, bool bSetDirtyChunk_)
+{
+  if (x_ >= m_width || y_ >= m_height || color_.transparent())
+  {
+    return;
+  }
+
+  Color oldColor = pixel(x_, y_);
+  Color newColor = color_;
+  if (color_.blendMode() == BlendMode::Invert)
+  {
+    newColor = oldColor;
+    newColor.invert();
+  }
+
+  row(y_)[x_] = pack(newColor.red(), newColor.green(), newColor.blue());
+
+  if (bSetDirtyChunk_ && oldColor != newColor)
+  {
+    setDirtyChunk(y_);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Color RgbaCanvas::pixel(unsigned x_, unsigned y_) const
+{
+  if (x_ >= m_width || y_ >= m_height)
+  {
+    return {};
+  }
+  const uint8_t* pPixel = reinterpret_cast<const uint8_t*>(row(y_) + x_);
+  return {pPixel[0], pPixel[1], pPixel[2]};
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void RgbaCanvas::lineHorizontal(unsigned x_, unsigned y_, unsigned w_, const Color& color_)
+{
+  if (x_ >= m_width || y_ >= m_height || w_ == 0 || color_.transparent())
+  {
+    return;
+  }
+
+  uint32_t* pBegin = row(y_) + x_;
+  uint32_t* pEnd = row(y_) + std::min(x_ + w_, m_width);
+  bool changed = true;
+  if (color_.blendMode() == BlendMode::Invert)
+  {
+    uint32_t mask = pack(0xFF, 0xFF, 0xFF, 0x00);
+    std::transform(pBegin, pEnd, pBegin, [mask](uint32_t pixel_) { return pixel_ ^ mask; });
+  }
+  else
+  {
+    // As setPixel(), which compares the colors rather than the pixels
+    Color stored(color_.red(), color_.green(), color_.blue());
+    uint32_t pixel = pack(color_.red(), color_.green(), color_.blue());
+    changed = stored != color_ || std::find_if(pBegin, pEnd, [pixel](uint32_t pixel_) {
+      return pixel_ != pixel;
+    }) != pEnd;
+    std::fill(pBegin, pEnd, pixel);
+  }
+
+  if (changed)
+  {
+    setDirtyChunk(y_);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void RgbaCanvas::putCanvas(const Canvas& c_,
+  unsigned xDest_,
+  unsigned yDest_,
+  unsigned xSource_,
+  unsigned ySource_,
+  unsigned w_,
+  unsigned h_)
+{
+  const RgbaCanvas* pSource = dynamic_cast<const RgbaCanvas*>(&c_);
+  if (pSource == nullptr || pSource == this)
+  {
+    Canvas::putCanvas(c_, xDest_, yDest_, xSource_, ySource_, w_, h_);
+    return;
+  }
+
+  unsigned cw = c_.width();
+  unsigned ch = c_.height();
+  if ((xDest_ >= m_width) || (yDest_ >= m_height) || (xSource_ >= cw) || (ySource_ >= ch))
+  {
+    return;
+  }
+
+  unsigned ww = (w_ <= cw && w_ > 0) ? w_ : cw;
+  unsigned hh = (h_ <= ch && h_ > 0) ? h_ : ch;
+  unsigned drawableHeight = std::min(hh, m_height - yDest_);
+  unsigned drawableWidth = std::min(ww, m_width - xDest_);
+
+  // Same clipping as the generic path, which reads transparent pixels past the source edges
+  drawableHeight = std::min(drawableHeight, ch - ySource_);
+  drawableWidth = std::min(drawableWidth, cw - xSource_);
+
+  for (unsigned j = 0; j < drawableHeight; j++)
+  {
+    const uint32_t* pFrom = pSource->row(ySource_ + j) + xSource_;
+    uint32_t* pTo = row(yDest_ + j) + xDest_;
+    if (!std::equal(pFrom, pFrom + drawableWidth, pTo))
+    {
+      std::copy(pFrom, pFrom + drawableWidth, pTo);
+      setDirtyChunk(yDest_ + j);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void RgbaCanvas::toRgb565(unsigned x_, unsigned y_, unsigned w_, uint8_t* pDest_) const
+{
+  const uint8_t* pPixels = reinterpret_cast<const uint8_t*>(row(y_) + x_);
+  for (unsigned i = 0; i < w_; i++)
+  {
+    uint8_t red = scale(pPixels[4 * i], 31);
+    uint8_t green = scale(pPixels[4 * i + 1], 63);
+    uint8_t blue = scale(pPixels[4 * i + 2], 31);
+    pDest_[2 * i] = static_cast<uint8_t>((red << 3) | ((green >> 3) & 0x07));
+    pDest_[2 * i + 1] = static_cast<uint8_t>(((green << 5) & 0xE0) | blue);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void RgbaCanvas::toMono(unsigned x_, unsigned y_, unsigned w_, uint8_t* pDest_) const
+{
+  const uint8_t* pPixels = reinterpret_cast<const uint8_t*>(row(y_) + x_);
+  for (unsigned i = 0; i < w_; i++)
+  {
+    pDest_[i] = std::max(std::max(pPixels[4 * i], pPixels[4 * i + 1]), pPixels[4 * i + 2]);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void RgbaCanvas::setDirty()
+{
+  std::fill(m_chunkDirtyFlags.begin(), m_chunkDirtyFlags.end(), true);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool RgbaCanvas::dirty() const
+{
+  return std::any_of(
+    m_chunkDirtyFlags.begin(), m_chunkDirtyFlags.end(), [](bool b) { return b; });
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool RgbaCanvas::dirtyChunk(unsigned chunk_) const
+{
+  if (chunk_ >= m_nChunks)
+  {
+    return false;
+  }
+  return m_chunkDirtyFlags[chunk_];
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void RgbaCanvas::setDirtyChunk(unsigned yStart_) const
+{
+  unsigned chunkHeight = m_nChunks > 0 ? m_height / m_nChunks : 0;
+  if (chunkHeight == 0)
+  {
+    return;
+  }
+  if (yStart_ < m_height)
+  {
+    unsigned chunk = std::min(static_cast<unsigned>(yStart_ / chunkHeight), m_nChunks - 1);
+    m_chunkDirtyFlags[chunk] = true;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void RgbaCanvas::resetDirtyFlags() const
+{
+  std::fill(m_chunkDirtyFlags.begin(), m_chunkDirtyFlags.end(), false);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+uint32_t* RgbaCanvas::pixels() const
+{
+  if (m_storage.empty())
+  {
+    size_t nPixels = static_cast<size_t>(m_height) * m_stride;
+    m_storage.resize(nPixels + kWordsPerRowAlignment - 1);
+    size_t misalignment = reinterpret_cast<uintptr_t>(m_storage.data()) % kRowAlignment;
+    m_offset = misalignment == 0 ? 0 : (kRowAlignment - misalignment) / sizeof(uint32_t);
+    std::fill_n(m_storage.data() + m_offset, nPixels, pack(0, 0, 0));
+  }
+  return m_storage.data() + m_offset;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
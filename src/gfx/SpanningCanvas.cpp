@@ -0,0 +1,178 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/gfx/SpanningCanvas.h"
+
+#include <algorithm>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+SpanningCanvas::SpanningCanvas(std::initializer_list<Canvas*> canvases_)
+{
+  unsigned x = 0;
+  for (auto pCanvas : canvases_)
+  {
+    addCanvas(pCanvas, x, 0);
+    x += pCanvas ? pCanvas->width() : 0;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void SpanningCanvas::addCanvas(Canvas* pCanvas_, unsigned x_, unsigned y_)
+{
+  if (pCanvas_ == nullptr)
+  {
+    return;
+  }
+
+  m_regions.push_back({pCanvas_, x_, y_});
+  m_width = std::max(m_width, x_ + pCanvas_->width());
+  m_height = std::max(m_height, y_ + pCanvas_->height());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+unsigned SpanningCanvas::numberOfChunks() const
+{
+  unsigned nChunks = 0;
+  for (const auto& region : m_regions)
+  {
+    nChunks += region.pCanvas->numberOfChunks();
+  }
+  return nChunks;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void SpanningCanvas::invert()
+{
+  for (const auto& region : m_regions)
+  {
+    region.pCanvas->invert();
+    region.pCanvas->setDirty();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void SpanningCanvas::fill(uint8_t value_)
+{
+  for (const auto& region : m_regions)
+  {
+    region.pCanvas->fill(value_);
+    region.pCanvas->setDirty();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Color SpanningCanvas::fillColor(uint8_t value_, unsigned x_, unsigned y_) const
+{
+  const Region* pRegion = region(x_, y_);
+  if (pRegion)
+  {
+    return pRegion->pCanvas->fillColor(value_, x_ - pRegion->x, y_ - pRegion->y);
+  }
+  return {};
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void SpanningCanvas::setPixel(unsigned x_, unsigned y_, const Color& color_, bool bSetDirtyChunk_)
+{
+  const Region* pRegion = region(x_, y_);
+  if (pRegion)
+  {
+    pRegion->pCanvas->setPixel(x_ - pRegion->x, y_ - pRegion->y, color_, bSetDirtyChunk_);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+Color SpanningCanvas::pixel(unsigned x_, unsigned y_) const
+{
+  const Region* pRegion = region(x_, y_);
+  if (pRegion)
+  {
+    return pRegion->pCanvas->pixel(x_ - pRegion->x, y_ - pRegion->y);
+  }
+  return {};
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void SpanningCanvas::setDirty()
+{
+  for (const auto& region : m_regions)
+  {
+    region.pCanvas->setDirty();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool SpanningCanvas::dirty() const
+{
+  return std::any_of(m_regions.begin(), m_regions.end(), [](const Region& region_) {
+    return region_.pCanvas->dirty();
+  });
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool SpanningCanvas::dirtyChunk(unsigned chunk_) const
+{
+  for (const auto& region : m_regions)
+  {
+    unsigned nChunks = region.pCanvas->numberOfChunks();
+    if (chunk_ < nChunks)
+    {
+      return region.pCanvas->dirtyChunk(chunk_);
+    }
+    chunk_ -= nChunks;
+  }
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void SpanningCanvas::setDirtyChunk(unsigned yStart_) const
+{
+  for (const auto& region : m_regions)
+  {
+    if (yStart_ >= region.y && yStart_ < region.y + region.pCanvas->height())
+    {
+      region.pCanvas->setDirtyChunk(yStart_ - region.y);
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+const SpanningCanvas::Region* SpanningCanvas::region(unsigned x_, unsigned y_) const
+{
+  for (const auto& region : m_regions)
+  {
+    if (x_ >= region.x && y_ >= region.y && x_ - region.x < region.pCanvas->width()
+        && y_ - region.y < region.pCanvas->height())
+    {
+      return &region;
+    }
+  }
+  return nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,355 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/gfx/TextLayout.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
+#include "cabl/gfx/Canvas.h"
+#include "cabl/gfx/FontManager.h"
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+using namespace sl::cabl;
+
+const std::string kEllipsis = "...";
+
+//--------------------------------------------------------------------------------------------------
+
+unsigned advance(const Font* pFont_, unsigned spacing_)
+{
+  return pFont_->charSpacing() + spacing_;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+unsigned measureChars(const Font* pFont_, size_t nChars_, unsigned spacing_)
+{
+  return nChars_ == 0 ? 0
+                      : static_cast<unsigned>((nChars_ - 1) * advance(pFont_, spacing_))
+                          + pFont_->width();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Number of characters fitting width_ pixels (fonts are monospaced)
+size_t fittingChars(const Font* pFont_, unsigned width_, unsigned spacing_)
+{
+  return width_ < pFont_->width() ? 0
+                                  : ((width_ - pFont_->width()) / advance(pFont_, spacing_)) + 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! End text with an ellipsis, shortening it so that the result has at most maxChars_ characters
+std::string withEllipsis(const std::string& text_, size_t maxChars_)
+{
+  if (maxChars_ <= kEllipsis.size())
+  {
+    return kEllipsis.substr(0, maxChars_);
+  }
+  std::string text = text_.substr(0, std::min(text_.size(), maxChars_ - kEllipsis.size()));
+  text.erase(text.find_last_not_of(' ') + 1);
+  return text + kEllipsis;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+constexpr size_t TextLayout::kDefaultMaxEntries;
+
+//--------------------------------------------------------------------------------------------------
+
+TextLayout::TextLayout(size_t maxEntries_) : m_maxEntries(std::max<size_t>(1, maxEntries_))
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+
+unsigned TextLayout::measure(const std::string& text_, const std::string& font_, unsigned spacing_)
+{
+  return measureChars(FontManager::instance().getFont(font_), text_.size(), spacing_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::string TextLayout::ellipsize(
+  const std::string& text_, unsigned width_, const std::string& font_, unsigned spacing_)
+{
+  size_t maxChars = fittingChars(FontManager::instance().getFont(font_), width_, spacing_);
+  return text_.size() <= maxChars ? text_ : withEllipsis(text_, maxChars);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::vector<std::string> TextLayout::wrap(
+  const std::string& text_, unsigned width_, const std::string& font_, unsigned spacing_)
+{
+  size_t maxChars = fittingChars(FontManager::instance().getFont(font_), width_, spacing_);
+  std::vector<std::string> lines;
+  if (maxChars == 0)
+  {
+    return lines;
+  }
+
+  std::string line;
+  size_t start = 0;
+  while (start <= text_.size())
+  {
+    size_t end = std::min(text_.find(' ', start), text_.size());
+    std::string word = text_.substr(start, end - start);
+    start = end + 1;
+
+    while (word.size() > maxChars)
+    {
+      if (!line.empty())
+      {
+        lines.push_back(line);
+        line.clear();
+      }
+      lines.push_back(word.substr(0, maxChars));
+      word.erase(0, maxChars);
+    }
+    if (word.empty())
+    {
+      continue;
+    }
+    if (line.empty())
+    {
+      line = word;
+    }
+    else if (line.size() + 1 + word.size() <= maxChars)
+    {
+      line += ' ' + word;
+    }
+    else
+    {
+      lines.push_back(line);
+      line = word;
+    }
+  }
+  if (!line.empty() || lines.empty())
+  {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::vector<std::string> TextLayout::layout(
+  const std::string& text_, unsigned width_, unsigned height_, const TextStyle& style_)
+{
+  const Font* pFont = FontManager::instance().getFont(style_.font);
+  unsigned lineHeight = pFont->height() + style_.lineSpacing;
+  size_t maxLines = height_ < pFont->height() ? 0 : ((height_ - pFont->height()) / lineHeight) + 1;
+  size_t maxChars = fittingChars(pFont, width_, style_.spacing);
+
+  std::vector<std::string> lines;
+  size_t start = 0;
+  while (start <= text_.size() && lines.size() <= maxLines)
+  {
+    size_t end = std::min(text_.find('\n', start), text_.size());
+    std::string paragraph = text_.substr(start, end - start);
+    start = end + 1;
+    if (style_.wrap)
+    {
+      std::vector<std::string> wrapped = wrap(paragraph, width_, style_.font, style_.spacing);
+      lines.insert(lines.end(), wrapped.begin(), wrapped.end());
+    }
+    else
+    {
+      lines.push_back(paragraph);
+    }
+  }
+
+  bool truncated = lines.size() > maxLines;
+  lines.resize(std::min(lines.size(), maxLines));
+  if (style_.ellipsis && truncated && !lines.empty())
+  {
+    lines.back() = withEllipsis(lines.back(), maxChars);
+  }
+  for (auto& line : lines)
+  {
+    if (style_.ellipsis && line.size() > maxChars)
+    {
+      line = withEllipsis(line, maxChars);
+    }
+  }
+  return lines;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void TextLayout::draw(Canvas& canvas_,
+  unsigned x_,
+  unsigned y_,
+  unsigned width_,
+  unsigned height_,
+  const std::string& text_,
+  const Color& color_,
+  const TextStyle& style_)
+{
+  size_t keyHash = hash(text_, width_, height_, style_);
+  auto range = m_index.equal_range(keyHash);
+  auto it = std::find_if(range.first, range.second, [&](const tIndex::value_type& entry_) {
+    return matches(entry_.second->key, text_, width_, height_, style_);
+  });
+
+  if (it != range.second)
+  {
+    m_hits++;
+    m_runs.splice(m_runs.begin(), m_runs, it->second);
+  }
+  else
+  {
+    m_misses++;
+    if (m_runs.size() >= m_maxEntries)
+    {
+      m_index.erase(indexEntry(std::prev(m_runs.end())));
+      m_runs.pop_back();
+    }
+    m_runs.emplace_front();
+    m_runs.front().key = {keyHash, text_, width_, height_, style_};
+    render(m_runs.front(), width_, height_, text_, style_);
+    m_index.emplace(keyHash, m_runs.begin());
+  }
+
+  const Run& run = m_runs.front();
+  if (run.height > 0)
+  {
+    canvas_.putBitmap(x_, y_, run.width, run.height, run.bitmap.data(), color_);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void TextLayout::clear()
+{
+  m_runs.clear();
+  m_index.clear();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+size_t TextLayout::hash(
+  const std::string& text_, unsigned width_, unsigned height_, const TextStyle& style_)
+{
+  size_t seed = std::hash<std::string>()(text_);
+  for (size_t value : {std::hash<std::string>()(style_.font),
+         static_cast<size_t>(width_),
+         static_cast<size_t>(height_),
+         static_cast<size_t>(style_.spacing),
+         static_cast<size_t>(style_.lineSpacing),
+         static_cast<size_t>(style_.alignment),
+         static_cast<size_t>(style_.wrap),
+         static_cast<size_t>(style_.ellipsis)})
+  {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool TextLayout::matches(const Key& key_,
+  const std::string& text_,
+  unsigned width_,
+  unsigned height_,
+  const TextStyle& style_)
+{
+  return key_.boxWidth == width_ && key_.boxHeight == height_ && key_.text == text_
+         && key_.style.font == style_.font && key_.style.spacing == style_.spacing
+         && key_.style.lineSpacing == style_.lineSpacing
+         && key_.style.alignment == style_.alignment && key_.style.wrap == style_.wrap
+         && key_.style.ellipsis == style_.ellipsis;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TextLayout::tIndex::iterator TextLayout::indexEntry(tRuns::iterator run_)
+{
+  auto range = m_index.equal_range(run_->key.hash);
+  return std::find_if(range.first, range.second, [run_](const tIndex::value_type& entry_) {
+    return entry_.second == run_;
+  });
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void TextLayout::render(
+  Run& run_, unsigned width_, unsigned height_, const std::string& text_, const TextStyle& style_)
+{
+  const Font* pFont = FontManager::instance().getFont(style_.font);
+  std::vector<std::string> lines = layout(text_, width_, height_, style_);
+  unsigned lineHeight = pFont->height() + style_.lineSpacing;
+
+  run_.width = (width_ + 7) & ~7u;
+  run_.height = lines.empty()
+                  ? 0
+                  : std::min(height_, static_cast<unsigned>(lines.size()) * lineHeight
+                                        - style_.lineSpacing);
+  unsigned stride = run_.width / 8;
+  run_.bitmap.assign(stride * run_.height, 0);
+
+  for (size_t l = 0; l < lines.size(); l++)
+  {
+    const std::string& line = lines[l];
+    unsigned lineWidth = measureChars(pFont, line.size(), style_.spacing);
+    unsigned xStart = 0;
+    if (lineWidth < width_ && style_.alignment == Alignment::Center)
+    {
+      xStart = (width_ - lineWidth) / 2;
+    }
+    else if (lineWidth < width_ && style_.alignment == Alignment::Right)
+    {
+      xStart = width_ - lineWidth;
+    }
+
+    for (size_t i = 0; i < line.size(); i++)
+    {
+      uint8_t c = static_cast<uint8_t>(line[i]);
+      if (c < pFont->firstChar() || c > pFont->lastChar())
+      {
+        continue;
+      }
+      unsigned xGlyph = xStart + static_cast<unsigned>(i) * advance(pFont, style_.spacing);
+      for (uint8_t y = 0; y < pFont->height(); y++)
+      {
+        unsigned yPixel = static_cast<unsigned>(l) * lineHeight + y;
+        for (uint8_t x = 0; x < pFont->width() && yPixel < run_.height; x++)
+        {
+          unsigned xPixel = xGlyph + x;
+          if (xPixel < width_ && pFont->pixel(c - pFont->firstChar(), x, y))
+          {
+            run_.bitmap[yPixel * stride + (xPixel >> 3)] |= 0x80 >> (xPixel & 7);
+          }
+        }
+      }
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
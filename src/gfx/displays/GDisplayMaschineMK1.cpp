@@ -18,6 +18,33 @@ namespace cabl
 
 //--------------------------------------------------------------------------------------------------
 
+namespace
+{
+
+//! The value of one of the 3 pixels packed in 2 bytes, 5 bits per pixel
+uint8_t pixelValue(const uint8_t* pBlock_, unsigned blockIndex_)
+{
+  uint8_t value{0};
+  switch (blockIndex_)
+  {
+    case 0:
+      value = ~(static_cast<uint8_t>((((pBlock_[0] & 0xF8) >> 3) / 31.0) * 255));
+      break;
+    case 1:
+      value = ~(static_cast<uint8_t>(
+        ((((pBlock_[0] & 0x07) << 2) | (pBlock_[1] & 0xC0) >> 6) / 31.0) * 255));
+      break;
+    case 2:
+      value = ~(static_cast<uint8_t>(((pBlock_[1] & 0x1F) / 31.0) * 255));
+      break;
+  }
+  return value;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
 GDisplayMaschineMK1::GDisplayMaschineMK1()
 {
   black();
@@ -96,24 +123,16 @@ Color GDisplayMaschineMK1::pixel(unsigned x_, unsigned y_) const
     return {};
   }
 
-  uint8_t blockIndex = x_ % 3; // 5 bits per pixel, 2 bytes pack 3 pixels
   unsigned byteIndex = (canvasWidthInBytes() * y_) + ((x_ / 3) * 2);
-  uint8_t pixelValue{0};
-  switch (blockIndex)
-  {
-    case 0:
-      pixelValue = ~(static_cast<uint8_t>((((data()[byteIndex] & 0xF8) >> 3) / 31.0) * 255));
-      break;
-    case 1:
-      pixelValue = ~(static_cast<uint8_t>(
-        ((((data()[byteIndex] & 0x07) << 2) | (data()[byteIndex + 1] & 0xC0) >> 6) / 31.0) * 255));
-      break;
-    case 2:
-      pixelValue = ~(static_cast<uint8_t>(((data()[byteIndex + 1] & 0x1F) / 31.0) * 255));
-      break;
-  }
+  return {pixelValue(&data()[byteIndex], x_ % 3)};
+}
 
-  return {pixelValue};
+//--------------------------------------------------------------------------------------------------
+
+Color GDisplayMaschineMK1::fillColor(uint8_t value_, unsigned x_, unsigned y_) const
+{
+  const uint8_t block[2]{value_, value_};
+  return {pixelValue(block, x_ % 3)};
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -69,5 +69,17 @@ Color GDisplayMaschineMK2::pixel(unsigned x_, unsigned y_) const
 
 //--------------------------------------------------------------------------------------------------
 
+Color GDisplayMaschineMK2::fillColor(uint8_t value_, unsigned x_, unsigned y_) const
+{
+  if ((value_ & (0x80 >> (x_ & 7))) == 0)
+  {
+    return {0};
+  }
+
+  return {0xff};
+}
+
+//--------------------------------------------------------------------------------------------------
+
 } // namespace cabl
 } // namespace sl
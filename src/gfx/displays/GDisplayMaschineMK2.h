@@ -38,6 +38,20 @@ public:
      \return                 The color of the selected pixel
      */
   Color pixel(unsigned x_, unsigned y_) const override;
+
+  //! Get the color a pixel takes when the canvas is filled with a pattern
+  /*!
+     \param value_           The pattern, as passed to fill()
+     \param x_               The X coordinate of the pixel
+     \param y_               The Y coordinate of the pixel
+     \return                 The color of the selected pixel after fill(value_)
+     */
+  Color fillColor(uint8_t value_, unsigned x_, unsigned y_) const override;
+
+  tPtr<Canvas> clone() const override
+  {
+    return tPtr<Canvas>(new GDisplayMaschineMK2(*this));
+  }
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -70,5 +70,18 @@ Color GDisplayMaschineMikro::pixel(unsigned x_, unsigned y_) const
 
 //--------------------------------------------------------------------------------------------------
 
+Color GDisplayMaschineMikro::fillColor(uint8_t value_, unsigned x_, unsigned y_) const
+{
+  // A byte holds 8 vertical pixels
+  if (((value_ >> ((y_)&7)) & 0x01) == 0)
+  {
+    return {0};
+  }
+
+  return {0xff};
+}
+
+//--------------------------------------------------------------------------------------------------
+
 } // namespace cabl
 } // namespace sl
@@ -7,8 +7,13 @@
 
 #include "gfx/displays/GDisplayPush2.h"
 
+#include "cabl/gfx/RgbaCanvas.h"
 #include "cabl/util/Functions.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+
 //--------------------------------------------------------------------------------------------------
 
 namespace sl
@@ -18,6 +23,22 @@ namespace cabl
 
 //--------------------------------------------------------------------------------------------------
 
+namespace
+{
+
+//! Decode an RGB565 pixel, most significant byte first
+Color fromRgb565(const uint8_t* pPixel_)
+{
+  return {static_cast<uint8_t>((((pPixel_[0] >> 3) / 31.0) * 255) + 0.5),
+    static_cast<uint8_t>(
+      ((((pPixel_[0] & 0x07) << 3 | (pPixel_[1] & 0xE0) >> 5) / 63.0) * 255) + 0.5),
+    static_cast<uint8_t>((((pPixel_[1] & 0x1F) / 31.0) * 255) + 0.5)};
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
 void GDisplayPush2::setPixel(
   unsigned x_, unsigned y_, const Color& color_, bool bSetDirtyChunk_)
 {
@@ -56,11 +77,57 @@ Color GDisplayPush2::pixel(unsigned x_, unsigned y_) const
     return {};
   }
   unsigned index = (canvasWidthInBytes() * y_) + (x_ * 2);
+  return fromRgb565(&data()[index]);
+}
 
-  return {static_cast<uint8_t>((((data()[index] >> 3) / 31.0) * 255) + 0.5),
-    static_cast<uint8_t>(
-            ((((data()[index] & 0x07) << 3 | (data()[index + 1] & 0xE0) >> 5) / 63.0) * 255) + 0.5),
-    static_cast<uint8_t>((((data()[index + 1] & 0x1F) / 31.0) * 255) + 0.5)};
+//--------------------------------------------------------------------------------------------------
+
+Color GDisplayPush2::fillColor(uint8_t value_, unsigned x_, unsigned y_) const
+{
+  const uint8_t pixel[2]{value_, value_};
+  return fromRgb565(pixel);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void GDisplayPush2::putCanvas(const Canvas& c_,
+  unsigned xDest_,
+  unsigned yDest_,
+  unsigned xSource_,
+  unsigned ySource_,
+  unsigned w_,
+  unsigned h_)
+{
+  const RgbaCanvas* pSource = dynamic_cast<const RgbaCanvas*>(&c_);
+  if (pSource == nullptr)
+  {
+    Canvas::putCanvas(c_, xDest_, yDest_, xSource_, ySource_, w_, h_);
+    return;
+  }
+
+  unsigned cw = c_.width();
+  unsigned ch = c_.height();
+  if ((xDest_ >= width()) || (yDest_ >= height()) || (xSource_ >= cw) || (ySource_ >= ch))
+  {
+    return;
+  }
+
+  unsigned ww = (w_ <= cw && w_ > 0) ? w_ : cw;
+  unsigned hh = (h_ <= ch && h_ > 0) ? h_ : ch;
+  unsigned drawableHeight = std::min({hh, height() - yDest_, ch - ySource_});
+  unsigned drawableWidth = std::min({ww, width() - xDest_, cw - xSource_});
+
+  std::array<uint8_t, 960 * 2> converted;
+  for (unsigned j = 0; j < drawableHeight; j++)
+  {
+    pSource->toRgb565(xSource_, ySource_ + j, drawableWidth, converted.data());
+    uint8_t* pRow = data() + (canvasWidthInBytes() * (yDest_ + j)) + (xDest_ * 2);
+    if (std::memcmp(pRow, converted.data(), drawableWidth * 2) != 0)
+    {
+      std::memcpy(pRow, converted.data(), drawableWidth * 2);
+      setDirtyChunk(yDest_ + j);
+    }
+  }
 }
 
 //--------------------------------------------------------------------------------------------------
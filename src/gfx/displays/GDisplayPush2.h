@@ -38,6 +38,33 @@ public:
      \return                 The color of the selected pixel
      */
   Color pixel(unsigned x_, unsigned y_) const override;
+
+  //! Get the color a pixel takes when the canvas is filled with a pattern
+  /*!
+     \param value_           The pattern, as passed to fill()
+     \param x_               The X coordinate of the pixel
+     \param y_               The Y coordinate of the pixel
+     \return                 The color of the selected pixel after fill(value_)
+     */
+  Color fillColor(uint8_t value_, unsigned x_, unsigned y_) const override;
+
+  //! Copy a canvas, converting whole rows at once if the source is an RgbaCanvas
+  /*!
+     Rows are only marked as dirty if their bytes change, while the generic copy compares the
+     (lossy) colors of every pixel.
+     */
+  void putCanvas(const Canvas& c_,
+    unsigned xDest_,
+    unsigned yDest_,
+    unsigned xSource_ = 0,
+    unsigned ySource_ = 0,
+    unsigned w_ = 0,
+    unsigned h_ = 0) override;
+
+  tPtr<Canvas> clone() const override
+  {
+    return tPtr<Canvas>(new GDisplayPush2(*this));
+  }
 };
 
 //--------------------------------------------------------------------------------------------------
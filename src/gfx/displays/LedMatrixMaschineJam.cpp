@@ -54,5 +54,12 @@ Color LedMatrixMaschineJam::pixel(unsigned x_, unsigned y_) const
 
 //--------------------------------------------------------------------------------------------------
 
+Color LedMatrixMaschineJam::fillColor(uint8_t value_, unsigned x_, unsigned y_) const
+{
+  return MaschineJamHelper::fromLedColor(value_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 } // namespace cabl
 } // namespace sl
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <cctype>
 #include <cmath>
 #include <cstdint>
 #include <string>
@@ -15,6 +16,7 @@
 #endif
 
 #include "cabl/gfx/TextDisplay.h"
+#include "gfx/displays/TextFormat.h"
 
 //--------------------------------------------------------------------------------------------------
 
@@ -56,46 +58,40 @@ public:
 
   void putText(const std::string& string_, unsigned row_, Alignment align_) override
   {
-    if (row_ > 0)
-    {
-      return;
-    }
-    this->setDirty(0);
-
-    std::string strAligned = alignText(string_, align_);
-    std::transform(strAligned.begin(), strAligned.end(), strAligned.begin(), ::toupper);
-
-    for (size_t i = 0; i < std::min<size_t>(strAligned.length(), this->width()); i++)
-    {
-      const uint8_t& character = strAligned.at(i);
-      this->data()[i] = (character < 45 || character > 90)
-                          ? 0x00
-                          : detail::kTextDisplay7S_FontData[character - 45];
-    }
+    putAlignedText(string_.data(), string_.length(), row_, align_);
   }
 
   //--------------------------------------------------------------------------------------------------
 
   void putText(int value_, unsigned row_, Alignment align_) override
   {
-    putText(std::to_string(value_), row_, align_);
+    TextBuffer<kMaxNumberLength> text;
+    text.appendInt(value_);
+    putAlignedText(text.data(), text.length(), row_, align_);
   }
 
   //--------------------------------------------------------------------------------------------------
 
   void putText(double value_, unsigned row_, Alignment align_) override
   {
-    double integral;
-    double fractional = modf(value_, &integral);
-    std::string strValue = std::to_string(static_cast<int>(integral));
-    std::string strFractional = std::to_string(static_cast<int>(fractional * 10));
-    unsigned emptySpaces = this->width() - strValue.length() - strFractional.length();
-	unsigned leftFills = static_cast<unsigned>(emptySpaces / 2.0f);
+    FixedPoint value(value_, 10);
+    TextBuffer<kMaxNumberLength> text;
+    if (value.negative)
+    {
+      text.append('-');
+    }
+    text.appendUnsigned(value.integral);
+    size_t integralLength = text.length();
+
     resetDots(row_);
-    setDot(strValue.length() - 1 + leftFills, row_);
-    strValue.append(strFractional);
+    size_t valueLength = integralLength + numberOfDigits(value.fractional);
+    if (valueLength <= this->width())
+    {
+      setDot(integralLength - 1 + (this->width() - valueLength) / 2, row_);
+    }
+    text.appendUnsigned(value.fractional);
 
-    putText(strValue, row_, align_);
+    putAlignedText(text.data(), text.length(), row_, align_);
   }
 
   //--------------------------------------------------------------------------------------------------
@@ -110,37 +106,25 @@ public:
 private:
   //--------------------------------------------------------------------------------------------------
 
-  std::string alignText(const std::string& string_, Alignment align_) const
+  static constexpr size_t kMaxNumberLength = 32;
+
+  //--------------------------------------------------------------------------------------------------
+
+  void putAlignedText(const char* pStr_, size_t length_, unsigned row_, Alignment align_)
   {
-    if (string_.length() >= this->width())
+    if (row_ > 0)
     {
-      return string_.substr(0, this->width());
+      return;
     }
+    this->setDirty(0);
 
-    std::string strValue(string_);
-    switch (align_)
-    {
-      case Alignment::Right:
-      {
-        strValue.insert(0, this->width() - strValue.length(), ' ');
-        break;
-      }
-      case Alignment::Center:
-      {
-        unsigned nFills = this->width() - strValue.length();
-		unsigned leftFills = static_cast<unsigned>(nFills / 2.0f);
-        strValue.insert(0, leftFills, ' ');
-        strValue.append(nFills - leftFills, ' ');
-        break;
-      }
-      case Alignment::Left:
-      default:
-      {
-        strValue.append(this->width() - strValue.length(), ' ');
-        break;
-      }
-    }
-    return strValue;
+    uint8_t* pRow = this->data();
+    putAligned(pStr_, length_, this->width(), align_, [pRow](unsigned col_, char c_) {
+      uint8_t character = static_cast<uint8_t>(::toupper(static_cast<uint8_t>(c_)));
+      pRow[col_] = (character < 45 || character > 90)
+                     ? 0x00
+                     : detail::kTextDisplay7S_FontData[character - 45];
+    });
   }
 
   //--------------------------------------------------------------------------------------------------
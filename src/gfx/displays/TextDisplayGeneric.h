@@ -15,6 +15,7 @@
 #endif
 
 #include "cabl/gfx/TextDisplay.h"
+#include "gfx/displays/TextFormat.h"
 
 //--------------------------------------------------------------------------------------------------
 
@@ -56,42 +57,33 @@ public:
 
   void putText(const std::string& string_, unsigned row_, Alignment align_) override
   {
-    if (row_ >= this->height())
-    {
-      return;
-    }
-    this->setDirty(row_);
-
-    unsigned index = row_ * this->width();
-    std::string strAligned = alignText(string_, align_);
-    for (unsigned i = 0; i < std::min<unsigned>(strAligned.length(), this->width()); i++)
-    {
-      const uint8_t& character = strAligned.at(i);
-      this->data()[index++] = character;
-    }
+    putAlignedText(string_.data(), string_.length(), row_, align_);
   }
 
   //--------------------------------------------------------------------------------------------------
 
   void putText(int value_, unsigned row_, Alignment align_) override
   {
-    putText(std::to_string(value_), row_, align_);
+    TextBuffer<kMaxNumberLength> text;
+    text.appendInt(value_);
+    putAlignedText(text.data(), text.length(), row_, align_);
   }
 
   //--------------------------------------------------------------------------------------------------
 
   void putText(double value_, unsigned row_, Alignment align_) override
   {
-    double integral;
-    double fractional = modf(value_, &integral);
-    std::string strValue = std::to_string(static_cast<int>(integral));
-    std::string strFractional = std::to_string(static_cast<int>(fractional * 1000));
-
-    strValue.append(".");
-    strValue.append(std::string(3 - strFractional.length(), '0'));
-    strValue.append(strFractional);
+    FixedPoint value(value_, 1000);
+    TextBuffer<kMaxNumberLength> text;
+    if (value.negative)
+    {
+      text.append('-');
+    }
+    text.appendUnsigned(value.integral);
+    text.append('.');
+    text.appendUnsigned(value.fractional, 3);
 
-    putText(strValue, row_, align_);
+    putAlignedText(text.data(), text.length(), row_, align_);
   }
 
   //--------------------------------------------------------------------------------------------------
@@ -127,37 +119,22 @@ public:
 private:
   //--------------------------------------------------------------------------------------------------
 
-  std::string alignText(const std::string& string_, Alignment align_) const
+  static constexpr size_t kMaxNumberLength = 32;
+
+  //--------------------------------------------------------------------------------------------------
+
+  void putAlignedText(const char* pStr_, size_t length_, unsigned row_, Alignment align_)
   {
-    if (string_.length() >= this->width())
+    if (row_ >= this->height())
     {
-      return string_.substr(0, this->width());
+      return;
     }
+    this->setDirty(row_);
 
-    std::string strValue(string_);
-    switch (align_)
-    {
-      case Alignment::Right:
-      {
-        strValue.insert(0, this->width() - strValue.length(), ' ');
-        break;
-      }
-      case Alignment::Center:
-      {
-        unsigned nFills = this->width() - strValue.length();
-		unsigned leftFills = static_cast<unsigned>(nFills / 2.0f);
-        strValue.insert(0, leftFills, ' ');
-        strValue.append(nFills - leftFills, ' ');
-        break;
-      }
-      case Alignment::Left:
-      default:
-      {
-        strValue.append(this->width() - strValue.length(), ' ');
-        break;
-      }
-    }
-    return strValue;
+    uint8_t* pRow = this->data() + (row_ * this->width());
+    putAligned(pStr_, length_, this->width(), align_, [pRow](unsigned col_, char c_) {
+      pRow[col_] = static_cast<uint8_t>(c_);
+    });
   }
 };
 
@@ -15,6 +15,7 @@
 #endif
 
 #include "cabl/util/Log.h"
+#include "gfx/displays/TextFormat.h"
 
 namespace
 {
@@ -47,32 +48,16 @@ void TextDisplayKompleteKontrol::putCharacter(unsigned col_, unsigned row_, char
 
 void TextDisplayKompleteKontrol::putText(const std::string& string_, unsigned row_, Alignment align_)
 {
-  if (row_ == 0 || row_ >= height())
-  {
-    return;
-  }
-  setDirty(row_);
-
-  unsigned index = row_ * 16;
-  std::string strAligned = alignText(string_, align_);
-  for (size_t i = 0; i < std::min<size_t>(strAligned.length(), 8); i++)
-  {
-    const uint8_t& character = strAligned.at(i);
-    data()[index++] = kTextDisplayKK_FontData[character] & 0xff;
-    data()[index++] = (kTextDisplayKK_FontData[character] >> 8) & 0xff;
-  }
+  putAlignedText(string_.data(), string_.length(), row_, align_);
 }
 
 //--------------------------------------------------------------------------------------------------
 
 void TextDisplayKompleteKontrol::putText(int value_, unsigned row_, Alignment align_)
 {
-  if (row_ == 0 || row_ >= height())
-  {
-    return;
-  }
-
-  putText(std::to_string(value_), row_, align_);
+  TextBuffer<kMaxNumberLength> text;
+  text.appendInt(value_);
+  putAlignedText(text.data(), text.length(), row_, align_);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -84,18 +69,24 @@ void TextDisplayKompleteKontrol::putText(double value_, unsigned row_, Alignment
     return;
   }
 
-  double integral;
-  double fractional = modf(value_, &integral);
-  std::string strValue = std::to_string(static_cast<int>(integral));
-  std::string strFractional = std::to_string(static_cast<int>(fractional * 1000));
-  unsigned emptySpaces = width() - strValue.length() - strFractional.length();
-  unsigned leftFills = static_cast<unsigned>(emptySpaces / 2.0f);
+  FixedPoint value(value_, 1000);
+  TextBuffer<kMaxNumberLength> text;
+  if (value.negative)
+  {
+    text.append('-');
+  }
+  text.appendUnsigned(value.integral);
+  size_t integralLength = text.length();
+
   resetDots(row_);
-  setDot(strValue.length() - 1 + leftFills, row_);
-  strValue.append(std::string(3 - strFractional.length(), '0'));
-  strValue.append(strFractional);
+  size_t valueLength = integralLength + numberOfDigits(value.fractional);
+  if (valueLength <= width())
+  {
+    setDot(integralLength - 1 + (width() - valueLength) / 2, row_);
+  }
+  text.appendUnsigned(value.fractional, 3);
 
-  putText(strValue, row_, align_);
+  putAlignedText(text.data(), text.length(), row_, align_);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -145,38 +136,21 @@ void TextDisplayKompleteKontrol::putValue(float value_, unsigned row_, Alignment
 
 //--------------------------------------------------------------------------------------------------
 
-std::string TextDisplayKompleteKontrol::alignText(
-  const std::string& string_, Alignment align_) const
+void TextDisplayKompleteKontrol::putAlignedText(
+  const char* pStr_, size_t length_, unsigned row_, Alignment align_)
 {
-  if (string_.length() >= width())
+  if (row_ == 0 || row_ >= height())
   {
-    return string_.substr(0, width());
+    return;
   }
+  setDirty(row_);
 
-  std::string strValue(string_);
-  switch (align_)
-  {
-    case Alignment::Right:
-    {
-      strValue.insert(0, width() - strValue.length(), ' ');
-      break;
-    }
-    case Alignment::Center:
-    {
-      unsigned nFills = width() - strValue.length();
-      uint8_t leftFills = static_cast<uint8_t>(nFills / 2.0f);
-      strValue.insert(0, leftFills, ' ');
-      strValue.append(nFills - leftFills, ' ');
-      break;
-    }
-    case Alignment::Left:
-    default:
-    {
-      strValue.append(width() - strValue.length(), ' ');
-      break;
-    }
-  }
-  return strValue;
+  uint8_t* pRow = data() + (row_ * 16);
+  putAligned(pStr_, length_, width(), align_, [pRow](unsigned col_, char c_) {
+    unsigned character = kTextDisplayKK_FontData[static_cast<uint8_t>(c_)];
+    pRow[2 * col_] = character & 0xff;
+    pRow[(2 * col_) + 1] = (character >> 8) & 0xff;
+  });
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -30,7 +30,9 @@ public:
   void putValue(float value_, unsigned row_, Alignment align_) override;
 
 private:
-  std::string alignText(const std::string&, Alignment align_) const;
+  static constexpr size_t kMaxNumberLength = 32;
+
+  void putAlignedText(const char* pStr_, size_t length_, unsigned row_, Alignment align_);
 
   void setDot(unsigned nDot_, unsigned row_, bool visible_ = true);
 
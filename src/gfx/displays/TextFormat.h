@@ -0,0 +1,173 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include "cabl/util/Types.h"
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class TextBuffer
+  \brief A fixed-capacity character buffer, used to format text without heap allocations
+
+  Characters past the capacity are silently dropped.
+*/
+
+template <size_t N>
+class TextBuffer
+{
+public:
+  void append(char c_)
+  {
+    if (m_length < N)
+    {
+      m_data[m_length++] = c_;
+    }
+  }
+
+  void append(char c_, size_t count_)
+  {
+    for (size_t i = 0; i < count_; i++)
+    {
+      append(c_);
+    }
+  }
+
+  //! Append the decimal representation of an unsigned value
+  /*!
+     \param value_      The value
+     \param minDigits_  The minimum number of digits, the value is padded with leading zeros
+  */
+  void appendUnsigned(unsigned long value_, size_t minDigits_ = 1)
+  {
+    char digits[20];
+    size_t nDigits = 0;
+    do
+    {
+      digits[nDigits++] = static_cast<char>('0' + (value_ % 10));
+      value_ /= 10;
+    } while (value_ > 0);
+
+    for (; nDigits < minDigits_; minDigits_--)
+    {
+      append('0');
+    }
+    while (nDigits > 0)
+    {
+      append(digits[--nDigits]);
+    }
+  }
+
+  //! Append the decimal representation of a signed value, same as std::to_string()
+  void appendInt(long value_)
+  {
+    if (value_ < 0)
+    {
+      append('-');
+    }
+    appendUnsigned(value_ < 0 ? 0UL - static_cast<unsigned long>(value_)
+                              : static_cast<unsigned long>(value_));
+  }
+
+  const char* data() const
+  {
+    return m_data.data();
+  }
+
+  size_t length() const
+  {
+    return m_length;
+  }
+
+private:
+  std::array<char, N> m_data;
+  size_t m_length{0};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+//! A number split into its integral part and a truncated, scaled fractional part
+struct FixedPoint
+{
+  //! Split a value
+  /*!
+     \param value_  The value
+     \param scale_  The fractional part multiplier, e.g. 1000 for three decimals
+  */
+  FixedPoint(double value_, unsigned scale_) : negative(value_ < 0)
+  {
+    double integralPart;
+    double fractionalPart = std::modf(value_, &integralPart);
+    integral = static_cast<unsigned long>(std::labs(static_cast<long>(integralPart)));
+    fractional = static_cast<unsigned long>(std::labs(static_cast<long>(fractionalPart * scale_)));
+  }
+
+  bool negative;
+  unsigned long integral;
+  unsigned long fractional;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+//! Number of decimal digits of a value
+inline size_t numberOfDigits(unsigned long value_)
+{
+  size_t nDigits = 1;
+  while (value_ >= 10)
+  {
+    value_ /= 10;
+    nDigits++;
+  }
+  return nDigits;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Lay out a string over a row, padding it with spaces according to the alignment
+/*!
+   Strings longer than the row are truncated. putChar_(column, character) is called once for each
+   of the width_ columns of the row.
+*/
+template <typename F>
+void putAligned(const char* pStr_, size_t length_, unsigned width_, Alignment align_, F putChar_)
+{
+  size_t length = length_ < width_ ? length_ : width_;
+  size_t leftFills = 0;
+  if (align_ == Alignment::Right)
+  {
+    leftFills = width_ - length;
+  }
+  else if (align_ == Alignment::Center)
+  {
+    leftFills = (width_ - length) / 2;
+  }
+
+  for (unsigned col = 0; col < width_; col++)
+  {
+    bool isText = col >= leftFills && col - leftFills < length;
+    putChar_(col, isText ? pStr_[col - leftFills] : ' ');
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -6,8 +6,12 @@
 ##########      ############################################################# shaduzlabs.com #####*/
 
 #include "cabl/cabl.h"
+#include "cabl/gfx/DynamicCanvas.h"
 #include "py/PyClient.h"
 
+#include <algorithm>
+#include <cstring>
+
 //--------------------------------------------------------------------------------------------------
 
 // http://stackoverflow.com/questions/38261530/unresolved-external-symbols-since-visual-studio-2015-update-3-boost-python-link
@@ -84,16 +88,26 @@ public:
 static void writeToDisplay(Canvas& self_, object buffer)
 {
   PyObject* pyBuffer = buffer.ptr();
-  if (!PyBuffer_Check(pyBuffer))
+  if (!PyObject_CheckBuffer(pyBuffer))
   {
-    // raise TypeError using standard boost::python mechanisms
+    PyErr_SetString(PyExc_TypeError, "the display data must support the buffer protocol");
+    throw_error_already_set();
   }
-  PyObject* pobj = buffer.ptr();
   Py_buffer pybuf;
-  PyObject_GetBuffer(pobj, &pybuf, PyBUF_SIMPLE);
+  if (PyObject_GetBuffer(pyBuffer, &pybuf, PyBUF_SIMPLE) != 0)
+  {
+    throw_error_already_set();
+  }
+  if (static_cast<size_t>(pybuf.len) < CanvasHelper::dataSize(&self_))
+  {
+    PyBuffer_Release(&pybuf);
+    PyErr_SetString(PyExc_ValueError, "the display data is smaller than the display buffer");
+    throw_error_already_set();
+  }
 
   CanvasHelper::write(&self_, static_cast<uint8_t*>(pybuf.buf));
   CanvasHelper::setDirty(&self_);
+  PyBuffer_Release(&pybuf);
 }
 
 static void writeTextToDisplay(
@@ -117,6 +131,174 @@ static unsigned canvasWidthInBytes(Canvas& self_)
 
 //--------------------------------------------------------------------------------------------------
 
+// Batch drawing: the items are passed as a contiguous 2D array of int32 (e.g. a NumPy array with
+// dtype=numpy.int32), one row per item, and are drawn in a single call with the GIL released.
+
+class ScopedGILRelease
+{
+public:
+  ScopedGILRelease() : m_pThreadState(PyEval_SaveThread())
+  {
+  }
+
+  ~ScopedGILRelease()
+  {
+    PyEval_RestoreThread(m_pThreadState);
+  }
+
+private:
+  PyThreadState* m_pThreadState;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+class BatchArray
+{
+public:
+  BatchArray(object array_, unsigned nColumns_) : m_nColumns(nColumns_)
+  {
+    if (PyObject_GetBuffer(array_.ptr(), &m_buffer, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0)
+    {
+      throw_error_already_set();
+    }
+
+    char format = m_buffer.format ? m_buffer.format[std::strlen(m_buffer.format) - 1] : 'B';
+    bool validType = m_buffer.itemsize == sizeof(int32_t) && (format == 'i' || format == 'l');
+    bool validShape = m_buffer.ndim == 2 ? m_buffer.shape[1] == nColumns_
+                                         : m_buffer.len % (nColumns_ * sizeof(int32_t)) == 0;
+    if (!validType || !validShape)
+    {
+      PyBuffer_Release(&m_buffer);
+      std::string error = "Expected a contiguous int32 array with " + std::to_string(nColumns_)
+                          + " columns";
+      PyErr_SetString(PyExc_TypeError, error.c_str());
+      throw_error_already_set();
+    }
+  }
+
+  ~BatchArray()
+  {
+    PyBuffer_Release(&m_buffer);
+  }
+
+  BatchArray(const BatchArray&) = delete;
+  BatchArray& operator=(const BatchArray&) = delete;
+
+  size_t rows() const
+  {
+    return static_cast<size_t>(m_buffer.len) / (m_nColumns * sizeof(int32_t));
+  }
+
+  const int32_t* row(size_t index_) const
+  {
+    return static_cast<const int32_t*>(m_buffer.buf) + index_ * m_nColumns;
+  }
+
+private:
+  Py_buffer m_buffer;
+  unsigned m_nColumns;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+// Negative coordinates are clamped to 0, color components to 0...255
+static unsigned coordinate(int32_t value_)
+{
+  return static_cast<unsigned>(std::max(value_, 0));
+}
+
+static Color color(const int32_t* pRGBM_)
+{
+  auto component = [](int32_t value_) {
+    return static_cast<uint8_t>(std::min(std::max(value_, 0), 255));
+  };
+  return {component(pRGBM_[0]), component(pRGBM_[1]), component(pRGBM_[2]), component(pRGBM_[3])};
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Rows: x, y, red, green, blue, mono
+static void drawPoints(Canvas& self_, object points_)
+{
+  BatchArray points(points_, 6);
+  ScopedGILRelease noGIL;
+  for (size_t i = 0; i < points.rows(); i++)
+  {
+    const int32_t* p = points.row(i);
+    self_.setPixel(coordinate(p[0]), coordinate(p[1]), color(p + 2));
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Rows: x0, y0, x1, y1, red, green, blue, mono
+static void drawLines(Canvas& self_, object lines_)
+{
+  BatchArray lines(lines_, 8);
+  ScopedGILRelease noGIL;
+  for (size_t i = 0; i < lines.rows(); i++)
+  {
+    const int32_t* l = lines.row(i);
+    self_.line(
+      coordinate(l[0]), coordinate(l[1]), coordinate(l[2]), coordinate(l[3]), color(l + 4));
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Rows: x, y, w, h, red, green, blue, mono
+static void drawRectangles(Canvas& self_, object rectangles_)
+{
+  BatchArray rectangles(rectangles_, 8);
+  ScopedGILRelease noGIL;
+  for (size_t i = 0; i < rectangles.rows(); i++)
+  {
+    const int32_t* r = rectangles.row(i);
+    self_.rectangle(
+      coordinate(r[0]), coordinate(r[1]), coordinate(r[2]), coordinate(r[3]), color(r + 4));
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Rows: x, y, w, h, red, green, blue, mono (used for both the border and the fill)
+static void drawRectanglesFilled(Canvas& self_, object rectangles_)
+{
+  BatchArray rectangles(rectangles_, 8);
+  ScopedGILRelease noGIL;
+  for (size_t i = 0; i < rectangles.rows(); i++)
+  {
+    const int32_t* r = rectangles.row(i);
+    Color c = color(r + 4);
+    self_.rectangleFilled(
+      coordinate(r[0]), coordinate(r[1]), coordinate(r[2]), coordinate(r[3]), c, c);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! One string per row of positions: x, y, red, green, blue, mono
+static void drawTexts(Canvas& self_, list texts_, object positions_, const std::string& font_)
+{
+  BatchArray positions(positions_, 6);
+  size_t nTexts = std::min(static_cast<size_t>(len(texts_)), positions.rows());
+  std::vector<std::string> texts;
+  texts.reserve(nTexts);
+  for (size_t i = 0; i < nTexts; i++)
+  {
+    texts.push_back(extract<std::string>(texts_[i]));
+  }
+
+  ScopedGILRelease noGIL;
+  for (size_t i = 0; i < nTexts; i++)
+  {
+    const int32_t* p = positions.row(i);
+    self_.putText(coordinate(p[0]), coordinate(p[1]), texts[i].c_str(), color(p + 2), font_);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
 template <class T>
 boost::python::list toPythonList(std::vector<T> vector)
 {
@@ -325,7 +507,34 @@ BOOST_PYTHON_MODULE(pycabl)
       "can also be specified and defaults to 0")
     .def("dataSize", &displayDataSize, "Returns the display buffer size in bytes")
     .def("canvasWidthInBytes", &canvasWidthInBytes, "Returns the display width in bytes")
-    .def("write", &writeToDisplay, args("buffer"), "Write a raw buffer to the display");
+    .def("write", &writeToDisplay, args("buffer"), "Write a raw buffer to the display")
+    .def("drawPoints",
+      &drawPoints,
+      args("points"),
+      "Draws the pixels of an int32 array with one x, y, red, green, blue, mono row per pixel")
+    .def("drawLines",
+      &drawLines,
+      args("lines"),
+      "Draws the lines of an int32 array with one x0, y0, x1, y1, red, green, blue, mono row per "
+      "line")
+    .def("drawRectangles",
+      &drawRectangles,
+      args("rectangles"),
+      "Draws the rectangles of an int32 array with one x, y, w, h, red, green, blue, mono row per "
+      "rectangle")
+    .def("drawRectanglesFilled",
+      &drawRectanglesFilled,
+      args("rectangles"),
+      "Draws the filled rectangles of an int32 array with one x, y, w, h, red, green, blue, mono "
+      "row per rectangle")
+    .def("drawTexts",
+      &drawTexts,
+      args("texts", "positions", "font"),
+      "Draws a list of strings using the specified font, positions is an int32 array with one x, "
+      "y, red, green, blue, mono row per string");
+
+  class_<DynamicCanvas, bases<Canvas>, boost::noncopyable>(
+    "DynamicCanvas", init<unsigned, unsigned>(args("width", "height")));
 
   //------------------------------------------------------------------------------------------------
 
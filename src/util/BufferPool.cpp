@@ -0,0 +1,134 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/util/BufferPool.h"
+
+#include <algorithm>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+constexpr size_t BufferPool::kDefaultMaxPooledBytes;
+
+//--------------------------------------------------------------------------------------------------
+
+BufferPool::tBuffer BufferPool::acquire(size_t size_)
+{
+  if (size_ == 0)
+  {
+    return nullptr;
+  }
+
+  tBuffer buffer;
+  {
+    std::lock_guard<std::mutex> lock(m_mtxBuffers);
+    m_acquiredBytes += size_;
+    auto it = m_buffers.find(size_);
+    if (it != m_buffers.end() && !it->second.empty())
+    {
+      buffer = std::move(it->second.back());
+      it->second.pop_back();
+      m_pooledBytes -= size_;
+    }
+  }
+
+  if (buffer)
+  {
+    std::fill_n(buffer.get(), size_, 0);
+    return buffer;
+  }
+
+  return tBuffer(new uint8_t[size_]());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void BufferPool::release(size_t size_, tBuffer buffer_)
+{
+  if (!buffer_ || size_ == 0)
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mtxBuffers);
+  m_acquiredBytes -= std::min(m_acquiredBytes, size_);
+  if (m_pooledBytes + size_ > m_maxPooledBytes)
+  {
+    return; // buffer_ is freed here
+  }
+
+  m_buffers[size_].push_back(std::move(buffer_));
+  m_pooledBytes += size_;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void BufferPool::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mtxBuffers);
+  m_buffers.clear();
+  m_pooledBytes = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void BufferPool::setMaxPooledBytes(size_t maxPooledBytes_)
+{
+  std::lock_guard<std::mutex> lock(m_mtxBuffers);
+  m_maxPooledBytes = maxPooledBytes_;
+  trim();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+size_t BufferPool::maxPooledBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_mtxBuffers);
+  return m_maxPooledBytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+size_t BufferPool::pooledBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_mtxBuffers);
+  return m_pooledBytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+size_t BufferPool::acquiredBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_mtxBuffers);
+  return m_acquiredBytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void BufferPool::trim()
+{
+  // Drop the largest buffers first, they are the ones worth giving back to the system
+  auto it = m_buffers.rbegin();
+  while (m_pooledBytes > m_maxPooledBytes && it != m_buffers.rend())
+  {
+    while (m_pooledBytes > m_maxPooledBytes && !it->second.empty())
+    {
+      it->second.pop_back();
+      m_pooledBytes -= it->first;
+    }
+    it++;
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,73 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "cabl/util/FrameArena.h"
+
+#include <algorithm>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+FrameArena::FrameArena(size_t capacity_)
+  : m_pBuffer(capacity_ > 0 ? new uint8_t[capacity_] : nullptr), m_capacity(capacity_)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void* FrameArena::allocate(size_t size_, size_t alignment_)
+{
+  size_t address = reinterpret_cast<size_t>(m_pBuffer.get()) + m_offset;
+  size_t padding = (alignment_ - (address & (alignment_ - 1))) & (alignment_ - 1);
+
+  if (m_pBuffer && m_offset + padding + size_ <= m_capacity)
+  {
+    void* pBlock = m_pBuffer.get() + m_offset + padding;
+    m_offset += padding + size_;
+    m_used += padding + size_;
+    return pBlock;
+  }
+
+  // new[] is aligned for any fundamental type, over-aligned requests get extra room
+  size_t blockSize = size_ + (alignment_ > alignof(std::max_align_t) ? alignment_ : 0);
+  m_fallbackBlocks.emplace_back(new uint8_t[std::max<size_t>(blockSize, 1)]);
+  m_fallbackAllocations++;
+  m_used += size_ + alignment_;
+
+  address = reinterpret_cast<size_t>(m_fallbackBlocks.back().get());
+  padding = (alignment_ - (address & (alignment_ - 1))) & (alignment_ - 1);
+  return m_fallbackBlocks.back().get() + padding;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void FrameArena::reset()
+{
+  if (m_used > m_highWaterMark)
+  {
+    m_highWaterMark = m_used;
+  }
+
+  if (!m_fallbackBlocks.empty())
+  {
+    m_fallbackBlocks.clear();
+    m_capacity = std::max(m_capacity * 2, m_highWaterMark.load());
+    m_pBuffer.reset(new uint8_t[m_capacity]);
+  }
+
+  m_offset = 0;
+  m_used = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,187 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "util/MappedFile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__) || defined(__linux)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+#if defined(_WIN32)
+
+bool MappedFile::open(const std::string& path_)
+{
+  close();
+
+  HANDLE hFile = CreateFileA(path_.c_str(),
+    GENERIC_READ,
+    FILE_SHARE_READ,
+    nullptr,
+    OPEN_EXISTING,
+    FILE_FLAG_SEQUENTIAL_SCAN,
+    nullptr);
+  if (hFile == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+  m_hFile = hFile;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0)
+  {
+    close();
+    return false;
+  }
+
+  m_hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (m_hMapping == nullptr)
+  {
+    close();
+    return false;
+  }
+
+  m_pData = static_cast<const uint8_t*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+  if (m_pData == nullptr)
+  {
+    close();
+    return false;
+  }
+  m_size = static_cast<size_t>(size.QuadPart);
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void MappedFile::close()
+{
+  if (m_pData != nullptr)
+  {
+    UnmapViewOfFile(m_pData);
+  }
+  if (m_hMapping != nullptr)
+  {
+    CloseHandle(m_hMapping);
+  }
+  if (m_hFile != nullptr)
+  {
+    CloseHandle(m_hFile);
+  }
+  m_pData = nullptr;
+  m_size = 0;
+  m_hMapping = nullptr;
+  m_hFile = nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void MappedFile::adviseSequential()
+{
+  // Done through FILE_FLAG_SEQUENTIAL_SCAN
+}
+
+//--------------------------------------------------------------------------------------------------
+
+#elif defined(__APPLE__) || defined(__linux)
+
+bool MappedFile::open(const std::string& path_)
+{
+  close();
+
+  int fd = ::open(path_.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  struct stat status;
+  if (fstat(fd, &status) != 0 || status.st_size <= 0)
+  {
+    ::close(fd);
+    return false;
+  }
+
+  size_t size = static_cast<size_t>(status.st_size);
+  void* pData = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd); // The mapping keeps the file referenced
+  if (pData == MAP_FAILED)
+  {
+    return false;
+  }
+
+  m_pData = static_cast<const uint8_t*>(pData);
+  m_size = size;
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void MappedFile::close()
+{
+  if (m_pData != nullptr)
+  {
+    munmap(const_cast<uint8_t*>(m_pData), m_size);
+  }
+  m_pData = nullptr;
+  m_size = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void MappedFile::adviseSequential()
+{
+  if (m_pData != nullptr)
+  {
+    madvise(const_cast<uint8_t*>(m_pData), m_size, MADV_SEQUENTIAL);
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+#else
+
+bool MappedFile::open(const std::string&)
+{
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void MappedFile::close()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void MappedFile::adviseSequential()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+
+#endif
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,74 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sl
+{
+namespace cabl
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class MappedFile
+  \brief A read-only memory mapping of a whole file
+
+  Pages are loaded by the OS on first access, so opening a large file is cheap. Not available on
+  Arduino, where open() always fails.
+*/
+
+class MappedFile
+{
+public:
+  MappedFile() = default;
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  //! Map a file, closing the one currently mapped
+  /*!
+     \param path_  The file path
+     \return       FALSE if the file can't be opened or mapped, or if it's empty
+  */
+  bool open(const std::string& path_);
+
+  void close();
+
+  //! Hint that the file is going to be read sequentially
+  void adviseSequential();
+
+  const uint8_t* data() const
+  {
+    return m_pData;
+  }
+
+  size_t size() const
+  {
+    return m_size;
+  }
+
+private:
+  const uint8_t* m_pData{nullptr};
+  size_t m_size{0};
+
+#if defined(_WIN32)
+  void* m_hFile{nullptr};
+  void* m_hMapping{nullptr};
+#endif
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,57 @@
+"""
+Compares drawing a typical Push2 UI (meter bars, a grid and labels) with one call per item and
+with the batch functions, on an offscreen canvas of the size of the Push2 display.
+"""
+
+from pycabl import *
+import numpy as np
+import timeit
+
+WIDTH, HEIGHT = 960, 160
+N_METERS, N_CELLS, N_LABELS = 500, 512, 64
+N_FRAMES = 50
+
+canvas = DynamicCanvas(WIDTH, HEIGHT)
+rng = np.random.RandomState(0)
+
+def column(values):
+    return np.asarray(values, dtype=np.int32).reshape(-1, 1)
+
+# Meter bars: x, y, w, h, red, green, blue, mono
+meterHeights = rng.randint(1, HEIGHT, N_METERS)
+meters = np.hstack([
+    column(np.arange(N_METERS) * WIDTH // N_METERS), column(HEIGHT - meterHeights),
+    column(np.ones(N_METERS)), column(meterHeights),
+    np.tile(np.array([[0, 255, 0, 255]], dtype=np.int32), (N_METERS, 1))])
+
+# Grid cells: 64 x 8 outlined rectangles
+cellX, cellY = np.meshgrid(np.arange(64) * 15, np.arange(8) * 20)
+cells = np.hstack([
+    column(cellX.ravel()), column(cellY.ravel()), column(np.full(N_CELLS, 14)),
+    column(np.full(N_CELLS, 19)),
+    np.tile(np.array([[80, 80, 80, 255]], dtype=np.int32), (N_CELLS, 1))])
+
+# Labels: x, y, red, green, blue, mono
+labels = ["Track %d" % i for i in range(N_LABELS)]
+labelPositions = np.hstack([
+    column((np.arange(N_LABELS) % 8) * 120), column((np.arange(N_LABELS) // 8) * 20),
+    np.tile(np.array([[255, 255, 255, 255]], dtype=np.int32), (N_LABELS, 1))])
+
+def perCall():
+    for m in meters.tolist():
+        c = Color(m[4], m[5], m[6], m[7])
+        canvas.rectangleFilled(m[0], m[1], m[2], m[3], c, c)
+    for r in cells.tolist():
+        canvas.rectangle(r[0], r[1], r[2], r[3], Color(r[4], r[5], r[6], r[7]))
+    for text, p in zip(labels, labelPositions.tolist()):
+        canvas.putText(p[0], p[1], text, Color(p[2], p[3], p[4], p[5]), "normal", 0)
+
+def batched():
+    canvas.drawRectanglesFilled(meters)
+    canvas.drawRectangles(cells)
+    canvas.drawTexts(labels, labelPositions, "normal")
+
+for name, fn in (("per-call", perCall), ("batched", batched)):
+    seconds = timeit.timeit(fn, number=N_FRAMES) / N_FRAMES
+    nItems = N_METERS + N_CELLS + N_LABELS
+    print("%-9s %8.3f ms/frame %10.0f items/s" % (name, seconds * 1000.0, nItems / seconds))
@@ -0,0 +1,133 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <vector>
+
+#include "comm/drivers/ALSA/RawMidiParser.h"
+
+#if defined(CABL_USE_ALSA)
+#include "comm/drivers/ALSA/DeviceHandleALSA.h"
+#include "comm/drivers/ALSA/DriverALSA.h"
+#endif
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+std::vector<tRawData> parse(RawMidiParser& parser_, const tRawData& stream_)
+{
+  std::vector<tRawData> messages;
+  parser_.parse(stream_.data(), stream_.size(), [&messages](const uint8_t* pData_, size_t length_) {
+    messages.emplace_back(pData_, pData_ + length_);
+  });
+  return messages;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("Channel messages and running status", "[comm][RawMidiParser]")
+{
+  RawMidiParser parser;
+  auto messages = parse(parser, {0x90, 0x24, 0x7F, 0x25, 0x40, 0xC0, 0x05, 0x06, 0xB0, 0x0E, 0x01});
+
+  REQUIRE(messages.size() == 5);
+  CHECK(messages[0] == tRawData({0x90, 0x24, 0x7F}));
+  CHECK(messages[1] == tRawData({0x90, 0x25, 0x40}));
+  CHECK(messages[2] == tRawData({0xC0, 0x05}));
+  CHECK(messages[3] == tRawData({0xC0, 0x06}));
+  CHECK(messages[4] == tRawData({0xB0, 0x0E, 0x01}));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("Messages split across reads", "[comm][RawMidiParser]")
+{
+  RawMidiParser parser;
+  CHECK(parse(parser, {0xB0, 0x10}).empty());
+  auto messages = parse(parser, {0x7F, 0xF0, 0x7E, 0x00});
+  REQUIRE(messages.size() == 1);
+  CHECK(messages[0] == tRawData({0xB0, 0x10, 0x7F}));
+
+  messages = parse(parser, {0x06, 0x02, 0x47, 0xF7, 0x80, 0x24, 0x00});
+  REQUIRE(messages.size() == 2);
+  CHECK(messages[0] == tRawData({0xF0, 0x7E, 0x00, 0x06, 0x02, 0x47, 0xF7}));
+  CHECK(messages[1] == tRawData({0x80, 0x24, 0x00}));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("Realtime and system common messages", "[comm][RawMidiParser]")
+{
+  RawMidiParser parser;
+  auto messages = parse(parser, {0x90, 0xF8, 0x30, 0xFE, 0x7F, 0xF0, 0x01, 0xF8, 0x02, 0xF7, 0xF2,
+                                  0x10, 0x20, 0x31, 0x32, 0xF7});
+
+  REQUIRE(messages.size() == 6);
+  CHECK(messages[0] == tRawData({0xF8}));
+  CHECK(messages[1] == tRawData({0xFE}));
+  CHECK(messages[2] == tRawData({0x90, 0x30, 0x7F}));
+  CHECK(messages[3] == tRawData({0xF8}));
+  CHECK(messages[4] == tRawData({0xF0, 0x01, 0x02, 0xF7}));
+  CHECK(messages[5] == tRawData({0xF2, 0x10, 0x20}));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+#if defined(CABL_USE_ALSA)
+
+TEST_CASE("Batched writes on ALSA virtual ports", "[comm][DriverALSA]")
+{
+  // Requires the snd-virmidi module, the test is a no-op when no virtual port is available
+  for (const auto& port : DriverALSA::ports())
+  {
+    if (port.name.find("Virtual Raw MIDI") == std::string::npos)
+    {
+      continue;
+    }
+
+    CHECK(DriverALSA::hwId(port.portId) == port.hwId);
+
+    DriverALSA driver;
+    auto pHandle = driver.connect(
+      DeviceDescriptor(port.name, DeviceDescriptor::Type::MIDI, 0, 0, "", port.portId, port.portId));
+    if (!pHandle)
+    {
+      continue; // busy
+    }
+
+    DeviceHandle::tCollTransfers transfers;
+    for (uint8_t i = 0; i < 64; i++)
+    {
+      transfers.push_back(Transfer({0x90, i, 0x7F}));
+    }
+    CHECK(pHandle->writeBatch(transfers, 0));
+
+    transfers.clear();
+    pHandle->readBatch(transfers, 0);
+    pHandle->disconnect();
+  }
+}
+
+#endif
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
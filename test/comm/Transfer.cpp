@@ -11,10 +11,13 @@
 #include <cereal/archives/portable_binary.hpp>
 #endif
 
+#include <chrono>
 #include <sstream>
 
 #include <cabl/comm/Transfer.h>
 
+#include "util/RealTimeGuard.h"
+
 namespace sl
 {
 namespace cabl
@@ -80,6 +83,121 @@ TEST_CASE("Transfer comparison", "[comm][Transfer]")
   CHECK(t1.size() == t4.size());
 }
 
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("Short transfers are stored inline", "[comm][Transfer]")
+{
+  tRawData display(Transfer::kInlineCapacity + 1, 0x5A);
+  {
+    RealTimeGuard guard;
+    Transfer note({0x90, 0x24, 0x7F});
+    Transfer report({0x80}, display.data(), 32);
+    Transfer copy(report);
+    Transfer moved(std::move(copy));
+    note.setData(display.data(), Transfer::kInlineCapacity);
+    CHECK(guard.allocations() == 0);
+
+    CHECK(note.isInline());
+    CHECK(note.size() == Transfer::kInlineCapacity);
+    CHECK(moved == report);
+    CHECK_FALSE(copy);
+  }
+
+  Transfer frame(display);
+  CHECK_FALSE(frame.isInline());
+  CHECK(frame.data() == display);
+
+  // Going back to inline storage keeps the heap capacity for the next frame
+  frame.setData(display.data(), 3);
+  CHECK(frame.isInline());
+  CHECK(frame.size() == 3);
+  {
+    RealTimeGuard guard;
+    frame.setData(display.data(), display.size());
+    CHECK(guard.allocations() == 0);
+  }
+  CHECK(frame.data() == display);
+
+  Transfer zeroes(Transfer::kInlineCapacity + 10);
+  CHECK(zeroes.data() == tRawData(Transfer::kInlineCapacity + 10, 0));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("Borrowed transfers", "[comm][Transfer]")
+{
+  tRawData frame(16384, 0x11);
+  Transfer borrowed = Transfer::borrow(frame.data(), frame.size());
+  CHECK(borrowed.data().data() == frame.data());
+  CHECK(borrowed.size() == frame.size());
+
+  // Copies own their data, so they may outlive the frame
+  Transfer copy(borrowed);
+  CHECK(copy.data().data() != frame.data());
+  CHECK(copy == borrowed);
+  Transfer assigned;
+  assigned = borrowed;
+  CHECK(assigned.data().data() != frame.data());
+  CHECK(assigned == borrowed);
+
+  // Writing copies the data first
+  Transfer written = Transfer::borrow(frame.data(), frame.size());
+  written[0] = 0x22;
+  CHECK(written.data().data() != frame.data());
+  CHECK(frame[0] == 0x11);
+  CHECK(written[0] == 0x22);
+  CHECK(written[1] == 0x11);
+  CHECK(borrowed != written);
+
+  Transfer moved(std::move(borrowed));
+  CHECK(moved.data().data() == frame.data());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("Transfer construction and write cost", "[.][benchmark][comm][Transfer]")
+{
+  using tClock = std::chrono::steady_clock;
+  const unsigned nMessages = 1000000;
+  uint8_t leds[58]{};
+
+  // Stands for a device handle write, so that the transfers can't be optimized away
+  unsigned checksum = 0;
+  auto write = [&checksum](const Transfer& transfer_) {
+    checksum += transfer_.size() + transfer_[transfer_.size() - 1];
+  };
+
+  auto measure = [&](const char* name_, void (*build_)(unsigned, const uint8_t*, Transfer&)) {
+    Transfer transfer;
+    auto start = tClock::now();
+    for (unsigned n = 0; n < nMessages; n++)
+    {
+      build_(n, leds, transfer);
+      write(transfer);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(tClock::now() - start);
+    WARN(name_ << ": " << elapsed.count() / nMessages << " ns per message");
+  };
+
+  measure("MIDI note, from a vector", [](unsigned n_, const uint8_t*, Transfer& transfer_) {
+    transfer_ = Transfer(tRawData{0x90, static_cast<uint8_t>(n_ & 0x7F), 0x7F});
+  });
+  measure("MIDI note, inline", [](unsigned n_, const uint8_t*, Transfer& transfer_) {
+    transfer_ = Transfer({0x90, static_cast<uint8_t>(n_ & 0x7F), 0x7F});
+  });
+  measure("LED report, from a vector", [](unsigned n_, const uint8_t* pLeds_, Transfer& transfer_) {
+    tRawData report{0x82};
+    report.insert(report.end(), pLeds_, pLeds_ + 58);
+    report[1 + (n_ % 58)] = static_cast<uint8_t>(n_);
+    transfer_ = Transfer(std::move(report));
+  });
+  measure("LED report, inline", [](unsigned n_, const uint8_t* pLeds_, Transfer& transfer_) {
+    transfer_ = Transfer({0x82}, pLeds_, 58);
+    transfer_[1 + (n_ % 58)] = static_cast<uint8_t>(n_);
+  });
+  WARN("checksum " << checksum);
+}
+
 //--------------------------------------------------------------------------------------------------
 #ifdef CABL_USE_NETWORK
 
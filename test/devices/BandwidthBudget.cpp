@@ -0,0 +1,224 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <thread>
+#include <vector>
+
+#include <cabl/devices/BandwidthBudget.h>
+#include <cabl/devices/Device.h>
+
+#include "devices/DeviceLoop.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+using tClock = TrafficMeter::tClock;
+using tDemand = BandwidthBudget::Demand;
+
+const double kMB = 1024.0 * 1024.0;
+
+//--------------------------------------------------------------------------------------------------
+
+class DeviceTrafficTest : public DeviceTest
+{
+public:
+  unsigned m_framesSent{0};
+
+private:
+  bool tick() override
+  {
+    Transfer input;
+    readFromDeviceHandle(input, 0x84);
+    writeToDeviceHandle(Transfer({0x80, 0x01, 0x02}), 0x01);
+    if (displayFrameDue())
+    {
+      tRawData frame(1000, 0x55);
+      writeToDeviceHandle(Transfer::borrow(frame.data(), frame.size()), 0x08, Traffic::Display);
+      m_framesSent++;
+    }
+    return true;
+  }
+};
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("BandwidthBudget: displays are not limited while the bus has room",
+  "[devices][BandwidthBudget]")
+{
+  BandwidthBudget budget;
+  budget.setBusCapacity(1, 10 * kMB);
+  CHECK(budget.busCapacity(1) == 10 * kMB);
+  CHECK(budget.busCapacity(2) == BandwidthBudget::kDefaultBusCapacity);
+
+  std::vector<tDemand> demands{
+    {1, {0.1 * kMB, 0.1 * kMB, 4 * kMB, false}}, {1, {0.1 * kMB, 0.1 * kMB, 4 * kMB, false}}};
+  CHECK(budget.allocate(demands) == std::vector<double>({0.0, 0.0}));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("BandwidthBudget: input and LEDs come before displays", "[devices][BandwidthBudget]")
+{
+  BandwidthBudget budget;
+  budget.setBusCapacity(1, 10 * kMB);
+
+  // A Push 2 streaming frames and two Maschines sharing a bus, plus a MIDI port
+  std::vector<tDemand> demands{{1, {0.01 * kMB, 0.01 * kMB, 20 * kMB, false}},
+    {1, {1 * kMB, 0.5 * kMB, 0.5 * kMB, false}},
+    {1, {1 * kMB, 0.48 * kMB, 0.5 * kMB, false}},
+    {0, {0.01 * kMB, 0.01 * kMB, 50 * kMB, false}}};
+  std::vector<double> allowances = budget.allocate(demands);
+  REQUIRE(allowances.size() == 4);
+
+  // 7 MB/s are left to the displays, the Maschines need less than their share
+  CHECK(allowances[0] == Approx(6 * kMB));
+  CHECK(allowances[1] == allowances[0]);
+  CHECK(allowances[2] == allowances[0]);
+  CHECK(allowances[3] == 0.0);
+
+  // The displays always get some of the bus
+  demands[1].rates.input = 20 * kMB;
+  allowances = budget.allocate(demands);
+  CHECK(allowances[0] == Approx(BandwidthBudget::kMinDisplayShare * 10 * kMB / 3));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("BandwidthBudget: throttled displays stay throttled until there is room",
+  "[devices][BandwidthBudget]")
+{
+  BandwidthBudget budget;
+  budget.setBusCapacity(1, 10 * kMB);
+
+  // While throttled, a display only uses its allowance: it would use more if it could
+  std::vector<tDemand> demands{{1, {0.0, 0.0, 5 * kMB, true}}, {1, {0.0, 0.0, 5 * kMB, true}}};
+  CHECK(budget.allocate(demands) == std::vector<double>({5 * kMB, 5 * kMB}));
+
+  demands[1].rates = {0.0, 0.0, 1 * kMB, false};
+  CHECK(budget.allocate(demands) == std::vector<double>({9 * kMB, 9 * kMB}));
+
+  demands[0].rates = {0.0, 0.0, 6 * kMB, false};
+  CHECK(budget.allocate(demands) == std::vector<double>({0.0, 0.0}));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("TrafficMeter: display frames are paced by the allowance", "[devices][BandwidthBudget]")
+{
+  TrafficMeter meter;
+  tClock::time_point now = tClock::now();
+  meter.sample(now);
+
+  // One 10 KB frame every 10 ms wants 1 MB/s, 260 KB/s allow one every 40 ms or so
+  meter.setDisplayAllowance(260000.0);
+  unsigned framesSent = 0;
+  for (unsigned ms = 0; ms < 1000; ms += 10)
+  {
+    if (meter.displayFrameDue(now + std::chrono::milliseconds(ms)))
+    {
+      meter.add(Traffic::Display, 10000);
+      framesSent++;
+    }
+    meter.add(Traffic::Input, 64);
+  }
+  CHECK(framesSent >= 24);
+  CHECK(framesSent <= 27);
+
+  TrafficMeter::Rates rates = meter.sample(now + std::chrono::seconds(1));
+  CHECK(rates.display == Approx(framesSent * 10000.0));
+  CHECK(rates.input == Approx(6400.0));
+  CHECK(rates.leds == 0.0);
+  CHECK(rates.displayDeferred);
+  CHECK(meter.bytes(Traffic::Display) == framesSent * 10000);
+
+  // The flag is reset by sampling, and frames are no longer paced without an allowance
+  meter.setDisplayAllowance(0.0);
+  CHECK(meter.displayFrameDue(now + std::chrono::milliseconds(1001)));
+  CHECK_FALSE(meter.sample(now + std::chrono::seconds(2)).displayDeferred);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("TrafficMeter: display traffic can be counted from several threads",
+  "[devices][BandwidthBudget]")
+{
+  TrafficMeter meter;
+  tClock::time_point now = tClock::now() + std::chrono::seconds(1);
+
+  // The burst credit is 50 KB, spent a byte at a time by four threads
+  meter.setDisplayAllowance(1000000.0);
+  REQUIRE(meter.displayFrameDue(now));
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < 4; i++)
+  {
+    threads.emplace_back([&meter]() {
+      for (unsigned n = 0; n < 12500; n++)
+      {
+        meter.add(Traffic::Display, 1);
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  CHECK(meter.bytes(Traffic::Display) == 50000);
+  CHECK_FALSE(meter.displayFrameDue(now));
+  CHECK(meter.displayFrameDue(now + std::chrono::microseconds(10)));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("TrafficMeter: device traffic is accounted by kind", "[devices][BandwidthBudget]")
+{
+  DeviceTrafficTest device;
+  DeviceLoop loop(device);
+  SimulatedDeviceHandle::Stats stats;
+  loop.connect(tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(stats, {}, 16)));
+
+  for (unsigned i = 0; i < 10; i++)
+  {
+    loop.tick();
+  }
+  TrafficMeter& meter = loop.trafficMeter();
+  CHECK(meter.bytes(Traffic::Input) == 160);
+  CHECK(meter.bytes(Traffic::Leds) == 30);
+  CHECK(meter.bytes(Traffic::Display) == 10000);
+  CHECK(device.m_framesSent == 10);
+
+  // A tiny allowance lets the first frame through, the next ones wait for the debt to be paid
+  meter.setDisplayAllowance(1.0);
+  device.m_framesSent = 0;
+  for (unsigned i = 0; i < 10; i++)
+  {
+    loop.tick();
+  }
+  CHECK(device.m_framesSent <= 1);
+  CHECK(meter.bytes(Traffic::Input) == 320);
+  CHECK(meter.bytes(Traffic::Leds) == 60);
+
+  loop.disconnect();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
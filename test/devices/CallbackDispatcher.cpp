@@ -0,0 +1,279 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <cabl/devices/CallbackDispatcher.h>
+#include <cabl/devices/Device.h>
+
+#include "devices/DeviceLoop.h"
+#include "gfx/displays/GDisplayMaschineMK2.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+using tEvent = CallbackDispatcher::Event;
+
+const tEvent kButton{tEvent::Type::Button, 3, 0.0, true, false};
+
+//--------------------------------------------------------------------------------------------------
+
+class DeviceCallbackTest : public DeviceTest
+{
+public:
+  ~DeviceCallbackTest() override
+  {
+    // The render callbacks draw on m_display
+    stopCallbacks();
+  }
+
+  Canvas* graphicDisplay(size_t) override
+  {
+    return &m_display;
+  }
+
+  size_t numOfGraphicDisplays() const override
+  {
+    return 1;
+  }
+
+  std::atomic<unsigned> m_ticks{0};
+
+private:
+  bool tick() override
+  {
+    Transfer input;
+    if (readFromDeviceHandle(input, 0x84) && input.size() > 0)
+    {
+      buttonChanged(Button::Play, (input[0] & 0x01) != 0, false);
+    }
+    m_ticks++;
+    return true;
+  }
+
+  GDisplayMaschineMK2 m_display;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+template <class TPredicate>
+bool waitFor(TPredicate predicate_)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!predicate_())
+  {
+    if (std::chrono::steady_clock::now() > deadline)
+    {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CallbackDispatcher: slow callbacks are counted", "[devices][CallbackDispatcher]")
+{
+  std::chrono::milliseconds delay(0);
+  unsigned invocations = 0;
+  CallbackDispatcher dispatcher([&](const tEvent& event_) {
+    CHECK(event_.index == 3);
+    std::this_thread::sleep_for(delay);
+    invocations++;
+  });
+  dispatcher.setBudget(std::chrono::milliseconds(2));
+
+  dispatcher.dispatch(kButton);
+  CHECK(dispatcher.overruns() == 0);
+
+  delay = std::chrono::milliseconds(5);
+  dispatcher.dispatch(kButton);
+  dispatcher.dispatch(kButton);
+  CHECK(dispatcher.overruns() == 2);
+  CHECK(invocations == 3);
+
+  // Callbacks stay on the calling thread unless offloading is enabled
+  CHECK_FALSE(dispatcher.offloaded());
+
+  dispatcher.setBudget(std::chrono::microseconds(0));
+  dispatcher.dispatch(kButton);
+  CHECK(dispatcher.overruns() == 2);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CallbackDispatcher: callbacks are offloaded after consecutive overruns",
+  "[devices][CallbackDispatcher]")
+{
+  std::atomic<bool> slow{true};
+  std::atomic<unsigned> invocations{0};
+  std::atomic<bool> onCallingThread{true};
+  std::thread::id callingThread = std::this_thread::get_id();
+  CallbackDispatcher dispatcher([&](const tEvent&) {
+    if (slow)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    }
+    onCallingThread = std::this_thread::get_id() == callingThread;
+    invocations++;
+  });
+  dispatcher.setBudget(std::chrono::milliseconds(1));
+  dispatcher.setOffloadThreshold(3);
+
+  // A fast callback resets the count
+  dispatcher.dispatch(kButton);
+  dispatcher.dispatch(kButton);
+  slow = false;
+  dispatcher.dispatch(kButton);
+  slow = true;
+  dispatcher.dispatch(kButton);
+  dispatcher.dispatch(kButton);
+  CHECK_FALSE(dispatcher.offloaded());
+
+  dispatcher.dispatch(kButton);
+  REQUIRE(dispatcher.offloaded());
+  CHECK(invocations == 6);
+  CHECK(onCallingThread);
+
+  dispatcher.dispatch(kButton);
+  REQUIRE(waitFor([&invocations]() { return invocations == 7; }));
+  CHECK_FALSE(onCallingThread);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CallbackDispatcher: offloaded renders are coalesced", "[devices][CallbackDispatcher]")
+{
+  std::atomic<unsigned> renders{0};
+  std::atomic<bool> hold{false};
+  CallbackDispatcher dispatcher([&](const tEvent&) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    while (hold)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    renders++;
+  });
+  dispatcher.setBudget(std::chrono::microseconds(100));
+  dispatcher.setOffloadThreshold(1);
+
+  const tEvent render{tEvent::Type::Render, 0, 0.0, false, false};
+  dispatcher.dispatch(render);
+  REQUIRE(dispatcher.offloaded());
+  CHECK(renders == 1);
+
+  hold = true;
+  for (unsigned i = 0; i < 100; i++)
+  {
+    dispatcher.dispatch(render);
+  }
+  hold = false;
+  REQUIRE(waitFor([&renders]() { return renders == 2; }));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  CHECK(renders == 2);
+  CHECK(dispatcher.droppedEvents() == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CallbackDispatcher: nothing is invoked once stopped", "[devices][CallbackDispatcher]")
+{
+  std::atomic<unsigned> invocations{0};
+  std::atomic<bool> running{false};
+  CallbackDispatcher dispatcher([&](const tEvent&) {
+    running = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    invocations++;
+    running = false;
+  });
+  dispatcher.setBudget(std::chrono::milliseconds(1));
+  dispatcher.setOffloadThreshold(1);
+
+  dispatcher.dispatch(kButton);
+  REQUIRE(dispatcher.offloaded());
+  dispatcher.dispatch(kButton);
+  dispatcher.dispatch(kButton);
+  REQUIRE(waitFor([&running]() { return running.load(); }));
+
+  // Waits for the callback being invoked on the dispatch thread, the next one is dropped
+  dispatcher.stop();
+  CHECK_FALSE(running);
+  unsigned invoked = invocations;
+  CHECK(invoked >= 2);
+  CHECK(invoked <= 3);
+
+  dispatcher.dispatch(kButton);
+  dispatcher.dispatch({tEvent::Type::Disconnect, 0, 0.0, false, false});
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  CHECK(invocations == invoked);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CallbackDispatcher: a slow client doesn't stall the I/O loop once offloaded",
+  "[devices][CallbackDispatcher]")
+{
+  DeviceCallbackTest device;
+  DeviceLoop loop(device);
+  SimulatedDeviceHandle::Stats stats;
+  loop.connect(tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(stats, {{0x01}, {0x00}})));
+
+  std::atomic<unsigned> renders{0};
+  std::atomic<unsigned> buttons{0};
+  device.setCallbackRender([&device, &renders]() {
+    device.graphicDisplay(0)->setPixel(renders % 256, 0, {0xff});
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    renders++;
+  });
+  device.setCallbackButtonChanged([&buttons](Device::Button button_, bool, bool) {
+    CHECK(button_ == Device::Button::Play);
+    buttons++;
+  });
+  device.callbackDispatcher().setBudget(std::chrono::milliseconds(5));
+  device.callbackDispatcher().setOffloadThreshold(2);
+
+  loop.tick();
+  loop.tick();
+  REQUIRE(device.callbackDispatcher().offloaded());
+  CHECK(renders == 2);
+
+  // The I/O loop keeps running while the dispatch thread renders
+  auto start = std::chrono::steady_clock::now();
+  unsigned ticks = device.m_ticks;
+  while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100))
+  {
+    loop.tick();
+  }
+  CHECK(device.m_ticks - ticks > 10);
+  CHECK(renders > 2);
+  CHECK(buttons > 0);
+
+  loop.disconnect();
+  CHECK_FALSE(device.hasDeviceHandle());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,195 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include <cabl/devices/Device.h>
+
+#include "comm/DeviceHandleImpl.h"
+#include "devices/DeviceDriverAccess.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class SimulatedDeviceHandle
+  \brief A device handle replaying recorded input reports, or generating random ones
+
+  Writes are only counted. Reports of up to Transfer::kInlineCapacity bytes are read without
+  allocating, so that the handle can drive the real-time tests.
+*/
+
+class SimulatedDeviceHandle : public DeviceHandleImpl
+{
+public:
+  struct Stats
+  {
+    std::atomic<size_t> reads{0};
+    std::atomic<size_t> writes{0};
+    std::atomic<size_t> bytesWritten{0};
+  };
+
+  //! Constructor
+  /*!
+     \param stats_      Where the handle activity is counted, it must outlive the handle
+     \param recording_  The input reports to replay in a loop, random reports are generated of
+                        reportSize_ bytes if empty
+     \param seed_       The seed of the random reports
+  */
+  SimulatedDeviceHandle(Stats& stats_,
+    std::vector<tRawData> recording_ = {},
+    size_t reportSize_ = 8,
+    uint32_t seed_ = 1)
+    : m_stats(stats_)
+    , m_recording(std::move(recording_))
+    , m_report(reportSize_)
+    , m_random(seed_)
+  {
+  }
+
+  void disconnect() override
+  {
+  }
+
+  bool read(Transfer& transfer_, uint8_t) override
+  {
+    m_stats.reads++;
+    if (!m_recording.empty())
+    {
+      const tRawData& report = m_recording[m_next++ % m_recording.size()];
+      transfer_.setData(report.data(), report.size());
+      return true;
+    }
+    for (auto& byte : m_report)
+    {
+      byte = static_cast<uint8_t>(m_random());
+    }
+    transfer_.setData(m_report.data(), m_report.size());
+    return true;
+  }
+
+  bool write(const Transfer& transfer_, uint8_t) override
+  {
+    m_stats.writes++;
+    m_stats.bytesWritten += transfer_.size();
+    return true;
+  }
+
+private:
+  Stats& m_stats;
+  std::vector<tRawData> m_recording;
+  tRawData m_report;
+  size_t m_next{0};
+  std::minstd_rand m_random;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class DeviceTest
+  \brief A device without displays nor LEDs, whose tick does nothing
+
+  The test devices derive from it and only override what they exercise.
+*/
+
+class DeviceTest : public Device
+{
+public:
+  void init() override
+  {
+  }
+
+  size_t numOfGraphicDisplays() const override
+  {
+    return 0;
+  }
+
+  size_t numOfTextDisplays() const override
+  {
+    return 0;
+  }
+
+  size_t numOfLedMatrices() const override
+  {
+    return 0;
+  }
+
+  size_t numOfLedArrays() const override
+  {
+    return 0;
+  }
+
+protected:
+  bool tick() override
+  {
+    return true;
+  }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class DeviceLoop
+  \brief Drives a device through the same steps as the Coordinator I/O loop
+*/
+
+class DeviceLoop
+{
+public:
+  explicit DeviceLoop(Device& device_) : m_device(device_)
+  {
+  }
+
+  //! Connect the device, cbInit_ is invoked once it is initialized as Coordinator::connect() does
+  void connect(
+    tPtr<DeviceHandleImpl> pDeviceHandle_, const std::function<void()>& cbInit_ = nullptr)
+  {
+    m_device.setDeviceHandle(tPtr<DeviceHandle>(new DeviceHandle(std::move(pDeviceHandle_))));
+    DeviceDriverAccess::connect(m_device, Device::tClock::now(), cbInit_);
+  }
+
+  bool tick()
+  {
+    DeviceDriverAccess::poll(m_device);
+    return DeviceDriverAccess::tick(m_device);
+  }
+
+  void disconnect()
+  {
+    DeviceDriverAccess::disconnect(m_device);
+  }
+
+  TrafficMeter& trafficMeter()
+  {
+    return DeviceDriverAccess::trafficMeter(m_device);
+  }
+
+  //! When the Coordinator would tick the device again
+  Device::tClock::time_point nextTick() const
+  {
+    return DeviceDriverAccess::nextTick(m_device);
+  }
+
+private:
+  Device& m_device;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
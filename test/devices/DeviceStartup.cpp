@@ -0,0 +1,160 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <cabl/devices/Device.h>
+
+#include "devices/DeviceLoop.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+//! Takes a while to initialize, like a device sending an init sequence to its displays
+class DeviceSlowInit : public DeviceTest
+{
+public:
+  void init() override
+  {
+    m_initializing = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    tRawData frame(64, 0);
+    writeToDeviceHandle(Transfer::borrow(frame.data(), frame.size()), 0x08, Traffic::Display);
+    m_initializing = false;
+  }
+
+  std::atomic<bool> m_initializing{false};
+  std::atomic<unsigned> m_ticksDuringInit{0};
+  std::atomic<unsigned> m_ticks{0};
+
+private:
+  bool tick() override
+  {
+    m_ticksDuringInit += m_initializing ? 1 : 0;
+    m_ticks++;
+    return true;
+  }
+};
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("Device startup: a device is not ticked while being initialized", "[devices][Startup]")
+{
+  DeviceSlowInit device;
+  DeviceLoop loop(device);
+  SimulatedDeviceHandle::Stats stats;
+
+  CHECK(device.startupTime().init.count() == 0);
+  std::thread connecting(
+    [&]() { loop.connect(tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(stats))); });
+  while (device.m_ticks < 10)
+  {
+    loop.tick();
+    std::this_thread::yield();
+  }
+  connecting.join();
+
+  CHECK(device.m_ticksDuringInit == 0);
+  Device::StartupTime startupTime = device.startupTime();
+  CHECK(startupTime.init >= std::chrono::milliseconds(30));
+  CHECK(startupTime.firstFrame >= std::chrono::milliseconds(30));
+
+  loop.disconnect();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("Device startup: the client sets the device up before it is ticked", "[devices][Startup]")
+{
+  DeviceSlowInit device;
+  DeviceLoop loop(device);
+  SimulatedDeviceHandle::Stats stats;
+
+  // As Client does, installing its callbacks while the I/O thread keeps ticking
+  unsigned ticksBeforeSetUp = 0;
+  std::atomic<unsigned> renders{0};
+  std::thread connecting([&]() {
+    loop.connect(tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(stats)), [&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      device.setCallbackRender([&renders]() { renders++; });
+      ticksBeforeSetUp = device.m_ticks;
+    });
+  });
+  while (device.m_ticks < 10)
+  {
+    loop.tick();
+    std::this_thread::yield();
+  }
+  connecting.join();
+
+  CHECK(ticksBeforeSetUp == 0);
+  CHECK(renders > 0);
+
+  loop.disconnect();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("Device startup: devices are initialized concurrently", "[devices][Startup]")
+{
+  const unsigned nDevices = 4;
+  DeviceSlowInit devices[nDevices];
+  SimulatedDeviceHandle::Stats stats;
+  std::vector<tPtr<DeviceLoop>> loops;
+  for (auto& device : devices)
+  {
+    loops.emplace_back(new DeviceLoop(device));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> connecting;
+  for (auto& loop : loops)
+  {
+    DeviceLoop* pLoop = loop.get();
+    connecting.emplace_back([pLoop, &stats]() {
+      pLoop->connect(tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(stats)));
+    });
+  }
+  for (auto& thread : connecting)
+  {
+    thread.join();
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  // Connected one after the other, they would take at least 120 ms
+  CHECK(elapsed < std::chrono::milliseconds(30 * nDevices));
+  for (const auto& device : devices)
+  {
+    CHECK(device.startupTime().firstFrame > std::chrono::microseconds(0));
+  }
+
+  for (auto& loop : loops)
+  {
+    loop->disconnect();
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,187 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <lodepng.h>
+
+#include <cabl/devices/Device.h>
+#include <cabl/devices/DisplayMirror.h>
+#include <cabl/gfx/TextDisplay.h>
+
+#include "devices/DeviceLoop.h"
+#include "gfx/displays/GDisplayMaschineMK2.h"
+#include "util/RealTimeGuard.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+class DeviceDisplayMirrorTest : public DeviceTest
+{
+public:
+  Canvas* graphicDisplay(size_t) override
+  {
+    return &m_display;
+  }
+
+  TextDisplay* textDisplay(size_t) override
+  {
+    return &m_textDisplay;
+  }
+
+  size_t numOfGraphicDisplays() const override
+  {
+    return 1;
+  }
+
+  size_t numOfTextDisplays() const override
+  {
+    return 1;
+  }
+
+  GDisplayMaschineMK2 m_display;
+  TextDisplayBase<8, 1> m_textDisplay;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+class FrameReceiver
+{
+public:
+  void operator()(const DisplayMirror::Frame& frame_)
+  {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_frames.push_back(frame_);
+    m_cv.notify_all();
+  }
+
+  //! Wait for the frame with the given sequence number
+  bool wait(uint64_t sequence_, DisplayMirror::Frame& frame_)
+  {
+    std::unique_lock<std::mutex> lock(m_mtx);
+    bool received = m_cv.wait_for(lock, std::chrono::seconds(5), [this, sequence_] {
+      return !m_frames.empty() && m_frames.back().sequence >= sequence_;
+    });
+    if (received)
+    {
+      frame_ = m_frames.back();
+    }
+    return received;
+  }
+
+private:
+  std::mutex m_mtx;
+  std::condition_variable m_cv;
+  std::vector<DisplayMirror::Frame> m_frames;
+};
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("DisplayMirror: frames are decoded on the background thread", "[devices][DisplayMirror]")
+{
+  DeviceDisplayMirrorTest device;
+  FrameReceiver receiver;
+  DisplayMirror mirror(device, std::ref(receiver));
+  mirror.setPngEncoding(true);
+
+  device.m_display.setPixel(3, 2, {0xff});
+  device.m_textDisplay.fill('m');
+  mirror.capture(device);
+
+  DisplayMirror::Frame frame;
+  REQUIRE(receiver.wait(0, frame));
+  REQUIRE(frame.images.size() == 1);
+  REQUIRE(frame.texts.size() == 1);
+
+  const DisplayMirror::Image& image = frame.images[0];
+  CHECK(image.source == DisplayMirror::Image::Source::GraphicDisplay);
+  CHECK(image.width == 256);
+  CHECK(image.height == 64);
+  CHECK(image.native == tRawData(device.m_display.buffer(), device.m_display.buffer() + 2048));
+  REQUIRE(image.rgba.size() == 256 * 64 * 4);
+  CHECK(image.rgba[(2 * 256 + 3) * 4] == 0xff);
+  CHECK(image.rgba[(2 * 256 + 3) * 4 + 3] == 0xff);
+  CHECK(image.rgba[(2 * 256 + 4) * 4] == 0x00);
+
+  std::vector<unsigned char> decoded;
+  unsigned width = 0;
+  unsigned height = 0;
+  CHECK(lodepng::decode(decoded, width, height, image.png) == 0);
+  CHECK(width == 256);
+  CHECK(height == 64);
+  CHECK(decoded == image.rgba);
+
+  CHECK(frame.texts[0].data == tRawData(8, 'm'));
+
+  // The display itself is left untouched
+  CHECK(device.m_display.pixel(3, 2).active());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("DisplayMirror: the frame rate is capped", "[devices][DisplayMirror]")
+{
+  DeviceDisplayMirrorTest device;
+  DisplayMirror mirror(device, nullptr);
+  mirror.setMaxFrameRate(1);
+
+  mirror.capture(device);
+  mirror.capture(device);
+  CHECK(mirror.capturedFrames() == 1);
+  CHECK(mirror.droppedFrames() == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("DisplayMirror: capturing doesn't allocate nor lock", "[devices][DisplayMirror]")
+{
+  DeviceDisplayMirrorTest device;
+  FrameReceiver receiver;
+  DisplayMirror mirror(device, std::ref(receiver));
+  mirror.setMaxFrameRate(0);
+
+  // The first frames allocate the copy buffers
+  DisplayMirror::Frame frame;
+  for (uint64_t i = 0; i < 4; i++)
+  {
+    mirror.capture(device);
+    REQUIRE(receiver.wait(i, frame));
+  }
+
+  RealTimeGuard guard;
+  for (unsigned i = 0; i < 100; i++)
+  {
+    device.m_display.setPixel(i, 0, {0xff});
+    mirror.capture(device);
+  }
+  CHECK(guard.allocations() == 0);
+  CHECK(guard.locks() == 0);
+  CHECK(mirror.capturedFrames() == 104);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,200 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "devices/HidReport.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+using tPadValues = ReportFieldArray<1, 2, 0, 12, 32>;
+using tPadIndices = ReportFieldArray<2, 2, 4, 4, 32>;
+using tEncoders = ReportFieldArray<9, 2, 0, 16, 8>;
+
+std::vector<uint8_t> randomReport(std::mt19937& generator_, size_t size_)
+{
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<uint8_t> report(size_);
+  for (auto& byte : report)
+  {
+    byte = static_cast<uint8_t>(distribution(generator_));
+  }
+  return report;
+}
+
+//! The hand-written pad decoding the layout descriptions replace
+unsigned decodePadsByHand(const uint8_t* pReport_, unsigned* pPadsData_)
+{
+  unsigned checksum = 0;
+  for (int i = 1; i < 64; i += 2)
+  {
+    unsigned l = pReport_[i];
+    unsigned h = pReport_[i + 1];
+    uint8_t pad = (h & 0xF0) >> 4;
+    pPadsData_[pad] = (((h & 0x0F) << 8) | l);
+    checksum += pPadsData_[pad];
+  }
+  return checksum;
+}
+
+unsigned decodePads(const uint8_t* pReport_, unsigned* pPadsData_)
+{
+  unsigned checksum = 0;
+  for (size_t i = 0; i < tPadValues::kSize; i++)
+  {
+    unsigned pad = tPadIndices::decode(pReport_, i);
+    pPadsData_[pad] = tPadValues::decode(pReport_, i);
+    checksum += pPadsData_[pad];
+  }
+  return checksum;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("HidReport: fields are decoded and encoded in place", "[devices][HidReport]")
+{
+  uint8_t report[4]{0x01, 0xAB, 0xCD, 0xEF};
+
+  CHECK(ReportField<1, 0, 8>::decode(report) == 0xAB);
+  CHECK(ReportField<1, 0, 16>::decode(report) == 0xCDAB);
+  CHECK(ReportField<1, 4, 8>::decode(report) == 0xDA);
+  CHECK(ReportField<2, 4, 4>::decode(report) == 0xC);
+  static_assert(ReportField<1, 4, 12>::kEnd == 3, "A 12 bit field at bit 4 spans two bytes");
+
+  ReportField<1, 4, 12>::encode(report, 0x123);
+  CHECK(report[0] == 0x01);
+  CHECK(report[1] == 0x3B);
+  CHECK(report[2] == 0x12);
+  CHECK(report[3] == 0xEF);
+  CHECK(ReportField<1, 4, 12>::decode(report) == 0x123);
+
+  ReportFieldArray<0, 2, 0, 16, 2>::encode(report, 1, 0xBEEF);
+  CHECK(report[2] == 0xEF);
+  CHECK(report[3] == 0xBE);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("HidReport: field arrays match the hand-written decoders", "[devices][HidReport]")
+{
+  std::mt19937 generator(42);
+  for (unsigned n = 0; n < 100; n++)
+  {
+    std::vector<uint8_t> report = randomReport(generator, tPadIndices::kEnd);
+    unsigned expected[16]{};
+    unsigned decoded[16]{};
+    CHECK(decodePadsByHand(report.data(), expected) == decodePads(report.data(), decoded));
+    CHECK(std::equal(std::begin(expected), std::end(expected), std::begin(decoded)));
+
+    for (size_t i = 0; i < tEncoders::kSize; i++)
+    {
+      unsigned value = report[9 + i * 2] | (report[10 + i * 2] << 8);
+      CHECK(tEncoders::decode(report.data(), i) == value);
+    }
+  }
+  static_assert(tPadIndices::kEnd == 65, "32 pads, two bytes each, after the report ID");
+  static_assert(tEncoders::kEnd == 25, "8 encoders, two bytes each, from byte 9");
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("HidReport: bitmaps report changed bits only", "[devices][HidReport]")
+{
+  using tButtons = ReportBitmap<1, 12>;
+  uint8_t state[tButtons::kBytes]{};
+  uint8_t report[3]{0x01, 0x81, 0xF2};
+  std::vector<std::pair<size_t, bool>> changes;
+
+  auto record = [&changes](size_t index_, bool value_) -> bool {
+    changes.emplace_back(index_, value_);
+    return true;
+  };
+
+  CHECK(tButtons::diff(report, state, record));
+  CHECK(changes == (std::vector<std::pair<size_t, bool>>{{0, true}, {7, true}, {9, true}}));
+  CHECK(tButtons::test(report, 9));
+  CHECK_FALSE(tButtons::test(report, 8));
+
+  changes.clear();
+  CHECK(tButtons::diff(report, state, record));
+  CHECK(changes.empty());
+
+  // Stopping the scan leaves the remaining changes for the next call
+  report[1] = 0x00;
+  unsigned nCalls = 0;
+  CHECK_FALSE(tButtons::diff(report, state, [&nCalls](size_t, bool) -> bool {
+    nCalls++;
+    return false;
+  }));
+  CHECK(nCalls == 1);
+  CHECK(tButtons::diff(report, state, record));
+  CHECK(changes == (std::vector<std::pair<size_t, bool>>{{7, false}}));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("HidReport: output reports carry the report ID", "[devices][HidReport]")
+{
+  OutputReport<0x82, 4> report;
+  report.fill(0);
+  CHECK(report.set(1, 0x7F));
+  CHECK_FALSE(report.set(1, 0x7F));
+  CHECK(report[1] == 0x7F);
+  CHECK(report.transfer().data() == tRawData({0x82, 0x00, 0x7F, 0x00, 0x00}));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("HidReport: decoding cost compared to hand-written code", "[.][benchmark][HidReport]")
+{
+  using tClock = std::chrono::steady_clock;
+  const unsigned nReports = 1000000;
+
+  std::mt19937 generator(42);
+  std::vector<uint8_t> report = randomReport(generator, tPadIndices::kEnd);
+  unsigned padsData[16]{};
+
+  auto measure = [&](unsigned (*decode_)(const uint8_t*, unsigned*)) -> double {
+    unsigned checksum = 0;
+    auto start = tClock::now();
+    for (unsigned n = 0; n < nReports; n++)
+    {
+      report[n & 63] ^= static_cast<uint8_t>(n);
+      checksum += decode_(report.data(), padsData);
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(tClock::now() - start);
+    WARN("checksum " << checksum);
+    return elapsed.count() / nReports;
+  };
+
+  double byHand = measure(decodePadsByHand);
+  double described = measure(decodePads);
+  WARN("Pad report decoding: " << byHand << " ns by hand, " << described << " ns described");
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
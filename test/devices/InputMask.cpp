@@ -0,0 +1,251 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <vector>
+
+#include <cabl/devices/Device.h>
+
+#include "devices/DeviceLoop.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+using tClass = InputMask::Class;
+
+//! Decodes reports laid out as the ones of a Maschine: buttons (0x01) and pads (0x20)
+class DeviceReportsTest : public DeviceTest
+{
+public:
+  unsigned m_padsDecoded{0};
+
+private:
+  bool tick() override
+  {
+    Transfer input;
+    if (!readFromDeviceHandle(input, 0x84) || !input)
+    {
+      return false;
+    }
+    if (input[0] == 0x01 && input.size() >= 2)
+    {
+      decodeInput({tClass::Buttons}, [&] { processButtons(input); });
+    }
+    else if (input[0] == 0x20 && input.size() >= 33)
+    {
+      decodeInput({tClass::Keys}, [&] { processPads(input); });
+    }
+    return true;
+  }
+
+  void processButtons(const Transfer& input_)
+  {
+    for (unsigned i = 0; i < 8; i++)
+    {
+      bool pressed = ((input_[1] >> i) & 1) != 0;
+      if (pressed != m_buttons[i])
+      {
+        m_buttons[i] = pressed;
+        buttonChanged(static_cast<Button>(i), pressed, false);
+      }
+    }
+  }
+
+  void processPads(const Transfer& input_)
+  {
+    m_padsDecoded++;
+    for (unsigned i = 0; i < 16; i++)
+    {
+      unsigned value = (input_[1 + 2 * i] << 8) | input_[2 + 2 * i];
+      if (value > 200 || m_pads[i] > 200)
+      {
+        keyChanged(i, value / 4096.0, false);
+      }
+      m_pads[i] = value;
+    }
+  }
+
+  std::vector<bool> m_buttons = std::vector<bool>(8);
+  std::vector<unsigned> m_pads = std::vector<unsigned>(16);
+};
+
+//--------------------------------------------------------------------------------------------------
+
+tRawData padsReport(unsigned value_)
+{
+  tRawData report{0x20};
+  for (unsigned i = 0; i < 16; i++)
+  {
+    report.push_back(static_cast<uint8_t>(value_ >> 8));
+    report.push_back(static_cast<uint8_t>(value_ & 0xFF));
+  }
+  return report;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("InputMask: subscriptions", "[devices][InputMask]")
+{
+  InputMask mask;
+  CHECK(mask.wants(tClass::Keys, 0));
+  CHECK(mask.wants(tClass::Buttons, InputMask::kNumIndices - 1));
+  CHECK_FALSE(mask.wants(tClass::Buttons, InputMask::kNumIndices));
+
+  mask.unsubscribe(tClass::Keys);
+  CHECK_FALSE(mask.wantsAny(tClass::Keys));
+  CHECK(mask.wantsAny(tClass::Buttons));
+
+  mask.subscribe(tClass::Keys, 30, 4);
+  CHECK(mask.wantsAny(tClass::Keys));
+  CHECK_FALSE(mask.wants(tClass::Keys, 29));
+  CHECK(mask.wants(tClass::Keys, 30));
+  CHECK(mask.wants(tClass::Keys, 33));
+  CHECK_FALSE(mask.wants(tClass::Keys, 34));
+
+  mask.unsubscribe(tClass::Encoders, 1, 1000);
+  CHECK(mask.wants(tClass::Encoders, 0));
+  CHECK_FALSE(mask.wants(tClass::Encoders, 255));
+
+  mask.reset();
+  CHECK(mask.wants(tClass::Keys, 0));
+  CHECK(mask.wants(tClass::Encoders, 255));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("InputMask: the reports nobody consumes are not decoded", "[devices][InputMask]")
+{
+  DeviceReportsTest device;
+  DeviceLoop loop(device);
+  SimulatedDeviceHandle::Stats stats;
+  loop.connect(tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(
+    stats, {padsReport(4000), {0x01, 0x03}, padsReport(0), {0x01, 0x00}})));
+
+  unsigned nButtons = 0;
+  unsigned nKeys = 0;
+  device.setCallbackButtonChanged([&](Device::Button, bool, bool) { nButtons++; });
+  device.setCallbackKeyChanged([&](unsigned, double, bool) { nKeys++; });
+
+  // A transport-only client
+  device.inputMask().unsubscribe(tClass::Keys);
+  device.inputMask().unsubscribe(tClass::Buttons, 1, 1);
+  for (unsigned i = 0; i < 8; i++)
+  {
+    loop.tick();
+  }
+
+  CHECK(nKeys == 0);
+  CHECK(device.m_padsDecoded == 0);
+  CHECK(nButtons == 4);
+  CHECK(device.inputState().changes == 8);
+
+  InputMask::Usage keys = device.inputMask().usage(tClass::Keys);
+  CHECK(keys.reportsDecoded == 0);
+  CHECK(keys.reportsSkipped == 4);
+  InputMask::Usage buttons = device.inputMask().usage(tClass::Buttons);
+  CHECK(buttons.reportsDecoded == 4);
+  CHECK(buttons.reportsSkipped == 0);
+  CHECK(buttons.eventsSkipped == 4);
+
+  // Button reports are decoded regardless, the snapshot tracks the masked buttons
+  device.inputMask().unsubscribe(tClass::Buttons);
+  loop.tick();
+  loop.tick();
+  CHECK(nButtons == 4);
+  CHECK(device.inputMask().usage(tClass::Buttons).reportsDecoded == 5);
+  CHECK(device.inputState().buttons[0] == 0x03);
+  loop.tick();
+  loop.tick();
+  CHECK(device.inputState().buttons[0] == 0x00);
+  device.inputMask().reset();
+  device.inputMask().unsubscribe(tClass::Keys);
+
+  // Mapped input is decoded regardless
+  device.setMidiMapping({{MidiMapping::Source::Key, 0, 16, MidiMapping::Message::Note, 0, 36}},
+    [](const uint8_t*, size_t) {});
+  for (unsigned i = 0; i < 4; i++)
+  {
+    loop.tick();
+  }
+  CHECK(device.m_padsDecoded == 2);
+  CHECK(nKeys == 32);
+
+  device.setMidiMapping({});
+  device.inputMask().reset();
+  for (unsigned i = 0; i < 4; i++)
+  {
+    loop.tick();
+  }
+  CHECK(device.m_padsDecoded == 4);
+  CHECK(device.inputMask().usage(tClass::Keys).decodeTime.count() > 0);
+
+  loop.disconnect();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE(
+  "InputMask: CPU time saved by a transport-only client", "[.][benchmark][devices][InputMask]")
+{
+  using tClock = std::chrono::steady_clock;
+  const unsigned nTicks = 200000;
+
+  DeviceReportsTest device;
+  DeviceLoop loop(device);
+  SimulatedDeviceHandle::Stats stats;
+  std::vector<tRawData> recording;
+  for (unsigned i = 0; i < 16; i++)
+  {
+    recording.push_back(padsReport(i * 256));
+  }
+  recording.push_back({0x01, 0x01});
+  recording.push_back({0x01, 0x00});
+  loop.connect(tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(stats, recording)));
+
+  device.setCallbackButtonChanged([](Device::Button, bool, bool) {});
+  device.setCallbackKeyChanged([](unsigned, double, bool) {});
+
+  auto measure = [&]() -> double {
+    auto start = tClock::now();
+    for (unsigned n = 0; n < nTicks; n++)
+    {
+      loop.tick();
+    }
+    return std::chrono::duration<double, std::nano>(tClock::now() - start).count() / nTicks;
+  };
+
+  double everything = measure();
+  device.inputMask().unsubscribe(tClass::Keys);
+  double transportOnly = measure();
+
+  InputMask::Usage keys = device.inputMask().usage(tClass::Keys);
+  double savedMs = std::chrono::duration<double, std::milli>(keys.saved()).count();
+  WARN("Per tick: " << everything << " ns decoding everything, " << transportOnly
+                    << " ns without the pads");
+  WARN("Pad reports skipped: " << keys.reportsSkipped << ", " << keys.decodeTime.count()
+                               << " ns each, " << savedMs << " ms saved");
+  loop.disconnect();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
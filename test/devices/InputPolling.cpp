@@ -0,0 +1,260 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+#include <cabl/devices/Device.h>
+
+#include "devices/DeviceLoop.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+using tClock = InputPolling::tClock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+//! No input until the controller is touched, then a single pad report
+class TouchDeviceHandle : public DeviceHandleImpl
+{
+public:
+  void disconnect() override
+  {
+  }
+
+  bool read(Transfer& transfer_, uint8_t) override
+  {
+    m_reads++;
+    tClock::time_point touch(tClock::duration(m_touchAt.load()));
+    if (m_touchAt.load() != 0 && tClock::now() >= touch)
+    {
+      m_touchAt = 0;
+      transfer_ = Transfer({0x20, 0x80});
+      return true;
+    }
+    transfer_ = Transfer();
+    return true;
+  }
+
+  bool write(const Transfer&, uint8_t) override
+  {
+    return true;
+  }
+
+  void touch(tClock::time_point when_)
+  {
+    m_touchAt = when_.time_since_epoch().count();
+  }
+
+  std::atomic<size_t> m_reads{0};
+
+private:
+  std::atomic<tClock::rep> m_touchAt{0};
+};
+
+//--------------------------------------------------------------------------------------------------
+
+//! Polls its input like the Maschine and Komplete Kontrol drivers
+class DevicePollingTest : public DeviceTest
+{
+private:
+  bool tick() override
+  {
+    if (!inputPollDue())
+    {
+      return true;
+    }
+    Transfer input;
+    if (readFromDeviceHandle(input, 0x84) && input.size() >= 2)
+    {
+      keyChanged(0, input[1] / 255.0, false);
+    }
+    return true;
+  }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+//! Runs the device as the Coordinator I/O loop does, \return the number of wake-ups
+unsigned runFor(DeviceLoop& loop_, microseconds duration_)
+{
+  unsigned wakeUps = 0;
+  tClock::time_point end = tClock::now() + duration_;
+  while (tClock::now() < end)
+  {
+    loop_.tick();
+    wakeUps++;
+    tClock::time_point wakeUp = std::min(loop_.nextTick(), end);
+    if (wakeUp > tClock::now())
+    {
+      std::this_thread::sleep_until(wakeUp);
+    }
+  }
+  return wakeUps;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("InputPolling: backs off while idle and snaps back on input", "[devices][InputPolling]")
+{
+  InputPolling polling;
+  InputPolling::Settings settings;
+  settings.active = microseconds(0);
+  settings.idle = microseconds(1000);
+  settings.floor = microseconds(4000);
+  settings.idleAfter = milliseconds(10);
+  polling.setSettings(settings);
+
+  tClock::time_point t = tClock::now();
+  polling.reset(t);
+
+  // In use: polled on every tick
+  CHECK(polling.due(t));
+  CHECK(polling.due(t));
+  CHECK(polling.interval() == microseconds(0));
+
+  // Idle: 1, 2, 4, 4 ms
+  t += milliseconds(10);
+  CHECK(polling.due(t));
+  CHECK(polling.interval() == microseconds(1000));
+  CHECK(polling.next() == t + milliseconds(1));
+  CHECK_FALSE(polling.due(t + microseconds(999)));
+  t += milliseconds(1);
+  CHECK(polling.due(t));
+  CHECK(polling.interval() == microseconds(2000));
+  t += milliseconds(2);
+  CHECK(polling.due(t));
+  CHECK(polling.interval() == microseconds(4000));
+  t += milliseconds(4);
+  CHECK(polling.due(t));
+  CHECK(polling.interval() == microseconds(4000));
+  CHECK(polling.polls() == 6);
+
+  // The input decoded from the last poll brings the interval back
+  polling.activity();
+  CHECK(polling.next() == t);
+  t += microseconds(10);
+  CHECK(polling.due(t));
+  CHECK(polling.interval() == microseconds(0));
+  CHECK(polling.due(t + milliseconds(9)));
+  CHECK(polling.interval() == microseconds(0));
+
+  // A zero floor never backs off
+  settings.floor = microseconds(0);
+  polling.setSettings(settings);
+  t += milliseconds(100);
+  CHECK(polling.due(t));
+  CHECK(polling.due(t));
+  CHECK(polling.interval() == microseconds(0));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("InputPolling: an idle device is polled less often", "[devices][InputPolling]")
+{
+  DevicePollingTest device;
+  DeviceLoop loop(device);
+  TouchDeviceHandle* pHandle = new TouchDeviceHandle;
+  loop.connect(tPtr<DeviceHandleImpl>(pHandle));
+
+  InputPolling::Settings settings = device.inputPolling().settings();
+  settings.idleAfter = milliseconds(5);
+  settings.floor = microseconds(2000);
+  device.inputPolling().setSettings(settings);
+
+  std::atomic<bool> touched{false};
+  device.setCallbackKeyChanged([&](unsigned, double, bool) { touched = true; });
+
+  // Polled on every tick until idle
+  CHECK(runFor(loop, milliseconds(10)) > 100);
+  CHECK(device.inputPolling().interval() == microseconds(2000));
+  CHECK(runFor(loop, milliseconds(50)) < 100);
+  CHECK(pHandle->m_reads == device.inputPolling().polls());
+
+  pHandle->touch(tClock::now());
+  runFor(loop, milliseconds(10));
+  CHECK(touched);
+
+  loop.disconnect();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE(
+  "InputPolling: idle cost and first-touch latency", "[.][benchmark][devices][InputPolling]")
+{
+  const milliseconds idleTime(500);
+  const unsigned nTouches = 20;
+
+  auto measure = [&](const char* name_, microseconds floor_) {
+    DevicePollingTest device;
+    DeviceLoop loop(device);
+    TouchDeviceHandle* pHandle = new TouchDeviceHandle;
+    loop.connect(tPtr<DeviceHandleImpl>(pHandle));
+
+    InputPolling::Settings settings = device.inputPolling().settings();
+    settings.floor = floor_;
+    device.inputPolling().setSettings(settings);
+
+    tClock::time_point touchedAt;
+    device.setCallbackKeyChanged([&](unsigned, double, bool) { touchedAt = tClock::now(); });
+
+    runFor(loop, settings.idleAfter + milliseconds(10));
+    std::clock_t cpuStart = std::clock();
+    unsigned wakeUps = runFor(loop, idleTime);
+    double cpuMs = 1000.0 * (std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    // Touches spread over the idle intervals
+    double totalLatency = 0.0;
+    double maxLatency = 0.0;
+    for (unsigned n = 0; n < nTouches; n++)
+    {
+      runFor(loop, settings.idleAfter + microseconds(floor_.count() * 2 + 317 * n));
+      tClock::time_point touch = tClock::now();
+      pHandle->touch(touch);
+      touchedAt = tClock::time_point();
+      while (touchedAt == tClock::time_point())
+      {
+        runFor(loop, milliseconds(1));
+      }
+      double latency = std::chrono::duration<double, std::micro>(touchedAt - touch).count();
+      totalLatency += latency;
+      maxLatency = std::max(maxLatency, latency);
+    }
+
+    WARN(name_ << ": " << wakeUps * 1000.0 / idleTime.count() << " wake-ups/s and " << cpuMs
+               << " ms CPU over " << idleTime.count() << " ms idle, first touch in "
+               << totalLatency / nTouches << " us on average, " << maxLatency << " us at most");
+    loop.disconnect();
+  };
+
+  measure("Polling on every tick", microseconds(0));
+  measure("Adaptive polling, 1 ms floor", microseconds(1000));
+  measure("Adaptive polling, 4 ms floor", microseconds(4000));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
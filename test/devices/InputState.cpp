@@ -0,0 +1,114 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <cabl/devices/Device.h>
+
+#include "devices/DeviceLoop.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+class DeviceInputTest : public DeviceTest
+{
+private:
+  // Replays a scripted sequence of input changes, one per tick
+  bool tick() override
+  {
+    switch (m_step++)
+    {
+      case 0:
+        buttonChanged(Button::Play, true, false);
+        break;
+      case 1:
+        buttonChanged(Button::Pad64, true, true);
+        break;
+      case 2:
+        keyChanged(12, 0.75, false);
+        break;
+      case 3:
+        encoderChanged(2, true, false);
+        encoderChanged(2, true, false);
+        encoderChanged(3, false, false);
+        break;
+      case 4:
+        controlChanged(1, 0.5, false);
+        break;
+      case 5:
+        buttonChanged(Button::Play, false, false);
+        keyChanged(12, 0.0, false);
+        break;
+      default:
+        break;
+    }
+    return true;
+  }
+
+  unsigned m_step{0};
+};
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("InputState: devices publish their input state", "[devices][InputState]")
+{
+  DeviceInputTest device;
+  DeviceLoop loop(device);
+  SimulatedDeviceHandle::Stats stats;
+  loop.connect(tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(stats)));
+
+  Device::InputState state = device.inputState();
+  CHECK(state.changes == 0);
+  CHECK_FALSE(state.button(Device::Button::Play));
+
+  for (unsigned i = 0; i < 5; i++)
+  {
+    loop.tick();
+  }
+  state = device.inputState();
+  CHECK(state.changes == 7);
+  CHECK(state.button(Device::Button::Play));
+  CHECK(state.button(Device::Button::Pad64));
+  CHECK_FALSE(state.button(Device::Button::Pad63));
+  CHECK(state.keys[12] == 0.75f);
+  CHECK(state.encoders[2] == 2);
+  CHECK(state.encoders[3] == -1);
+  CHECK(state.controls[1] == 0.5f);
+  CHECK_FALSE(state.shift);
+
+  loop.tick();
+  state = device.inputState();
+  CHECK_FALSE(state.button(Device::Button::Play));
+  CHECK(state.keys[12] == 0.0f);
+  CHECK(state.changes == 9);
+
+  // Reconnecting starts from a clean state
+  loop.disconnect();
+  loop.connect(tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(stats)));
+  state = device.inputState();
+  CHECK(state.changes == 0);
+  CHECK_FALSE(state.button(Device::Button::Pad64));
+  CHECK(state.encoders[2] == 0);
+  loop.disconnect();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
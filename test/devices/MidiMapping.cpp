@@ -0,0 +1,317 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <cabl/devices/Device.h>
+#include <cabl/devices/MidiMapping.h>
+
+#include "devices/DeviceLoop.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+using tSource = MidiMapping::Source;
+using tMessage = MidiMapping::Message;
+using tMessages = std::vector<tRawData>;
+
+MidiMapping::tOutput recordTo(tMessages& messages_)
+{
+  return [&messages_](const uint8_t* pData_, size_t length_) {
+    messages_.emplace_back(pData_, pData_ + length_);
+  };
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Plays the first byte of each input report as a pad index, and the second one as its pressure
+class DeviceMidiTest : public DeviceTest
+{
+public:
+  void sendMidiBytes(const uint8_t* pData_, size_t length_) override
+  {
+    m_midiOut.emplace_back(pData_, pData_ + length_);
+  }
+
+  tMessages m_midiOut;
+
+private:
+  bool tick() override
+  {
+    Transfer input;
+    if (readFromDeviceHandle(input, 0x84) && input.size() >= 2)
+    {
+      keyChanged(input[0] % 16, input[1] / 255.0, false);
+    }
+    return true;
+  }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+//! Receives its input from the read callback, and writes the MIDI messages to the device handle
+class DevicePolledMidiTest : public DeviceMidiTest
+{
+public:
+  void init() override
+  {
+    readFromDeviceHandleAsync(0x84, [this](Transfer input_) {
+      keyChanged(input_[0] % 16, input_[1] / 255.0, false);
+    });
+  }
+
+  void sendMidiBytes(const uint8_t* pData_, size_t length_) override
+  {
+    writeToDeviceHandle(Transfer(pData_, length_), 0x01);
+  }
+
+private:
+  bool tick() override
+  {
+    return true;
+  }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+//! Hands one report per poll to the read callback, as the manually pumped ALSA driver does
+class PolledDeviceHandle : public SimulatedDeviceHandle
+{
+public:
+  using SimulatedDeviceHandle::SimulatedDeviceHandle;
+
+  void readAsync(uint8_t, DeviceHandle::tCbRead) override
+  {
+  }
+
+  bool poll(DeviceHandle::tCollTransfers& transfers_) override
+  {
+    Transfer transfer;
+    read(transfer, 0x84);
+    transfers_.push_back(std::move(transfer));
+    return true;
+  }
+};
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("MidiMapping: keys and buttons play notes", "[devices][MidiMapping]")
+{
+  tMessages messages;
+  MidiMapping mapping;
+  CHECK_FALSE(mapping.translate(tSource::Key, 0, 1.0));
+
+  mapping.load({{tSource::Key, 0, 16, tMessage::NoteWithPressure, 1, 36},
+                 {tSource::Button, 10, 2, tMessage::Note, 0, 100}},
+    recordTo(messages));
+
+  CHECK(mapping.translate(tSource::Key, 2, 0.5));
+  CHECK(mapping.translate(tSource::Key, 2, 1.0));
+  CHECK(mapping.translate(tSource::Key, 2, 0.0));
+  CHECK_FALSE(mapping.translate(tSource::Key, 2, 0.0));
+  CHECK_FALSE(mapping.translate(tSource::Key, 16, 1.0));
+
+  // A very light touch still plays the note
+  CHECK(mapping.translate(tSource::Key, 3, 0.001));
+
+  CHECK(mapping.translate(tSource::Button, 11, 1.0));
+  CHECK_FALSE(mapping.translate(tSource::Button, 11, 1.0));
+  CHECK(mapping.translate(tSource::Button, 11, 0.0));
+
+  CHECK(messages == tMessages({{0x91, 38, 64},
+                      {0xA1, 38, 127},
+                      {0x81, 38, 0},
+                      {0x91, 39, 1},
+                      {0x90, 101, 127},
+                      {0x80, 101, 0}}));
+  CHECK(mapping.messagesSent() == messages.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("MidiMapping: encoders and controls send control changes", "[devices][MidiMapping]")
+{
+  tMessages messages;
+  MidiMapping mapping;
+  mapping.load({{tSource::Encoder, 0, 2, tMessage::ControlChange, 0, 20},
+                 {tSource::Encoder, 1, 1, tMessage::RelativeControlChange, 0, 30},
+                 {tSource::Control, 0, 4, tMessage::ControlChange, 2, 70},
+                 {tSource::Control, 4, 1, tMessage::PitchBend, 0, 0}},
+    recordTo(messages));
+
+  // Later rules take precedence: encoder 1 is relative
+  CHECK(mapping.translate(tSource::Encoder, 0, 1.0));
+  CHECK(mapping.translate(tSource::Encoder, 0, -1.0));
+  CHECK(mapping.translate(tSource::Encoder, 1, -1.0));
+  CHECK(messages == tMessages({{0xB0, 20, 65}, {0xB0, 20, 64}, {0xB0, 30, 127}}));
+
+  // Absolute encoders stop at the ends of the range
+  messages.clear();
+  for (unsigned i = 0; i < 100; i++)
+  {
+    mapping.translate(tSource::Encoder, 0, 1.0);
+  }
+  CHECK(messages.size() == 63);
+  CHECK(messages.back() == tRawData({0xB0, 20, 127}));
+
+  // Changes which don't alter the 7 bit value are not sent
+  messages.clear();
+  CHECK(mapping.translate(tSource::Control, 3, 0.5));
+  CHECK_FALSE(mapping.translate(tSource::Control, 3, 0.501));
+  CHECK(mapping.translate(tSource::Control, 3, 1.0));
+  CHECK(mapping.translate(tSource::Control, 4, 0.5));
+  CHECK(mapping.translate(tSource::Control, 4, 1.0));
+  CHECK(messages == tMessages(
+                      {{0xB2, 73, 64}, {0xB2, 73, 127}, {0xE0, 0x00, 0x40}, {0xE0, 0x7F, 0x7F}}));
+
+  mapping.clear();
+  CHECK_FALSE(mapping.translate(tSource::Control, 3, 0.0));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("MidiMapping: the table can be replaced while translating", "[devices][MidiMapping]")
+{
+  std::atomic<size_t> nMessages{0};
+  auto output = [&nMessages](const uint8_t*, size_t) { nMessages++; };
+
+  MidiMapping mapping;
+  mapping.load({{tSource::Key, 0, 16, tMessage::Note, 0, 36}}, output);
+
+  std::atomic<bool> done{false};
+  std::thread loader([&]() {
+    for (unsigned i = 0; i < 200; i++)
+    {
+      mapping.load({{tSource::Key, 0, 16, tMessage::Note, static_cast<uint8_t>(i % 16), 36}},
+        output);
+    }
+    done = true;
+  });
+
+  size_t nTranslated = 0;
+  for (unsigned n = 0; !done || n < 1000; n++)
+  {
+    nTranslated += mapping.translate(tSource::Key, n % 16, (n / 16) % 2 == 0 ? 1.0 : 0.0);
+  }
+  loader.join();
+  CHECK(nTranslated == nMessages);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("MidiMapping: the device sends MIDI before invoking the callbacks",
+  "[devices][MidiMapping]")
+{
+  DeviceMidiTest device;
+  DeviceLoop loop(device);
+  SimulatedDeviceHandle::Stats stats;
+  loop.connect(tPtr<DeviceHandleImpl>(
+    new SimulatedDeviceHandle(stats, {{0x02, 0xFF}, {0x02, 0x00}, {0x05, 0x80}})));
+
+  size_t nSentBeforeCallback = 0;
+  device.setCallbackKeyChanged([&](unsigned, double, bool) {
+    nSentBeforeCallback += device.midiMapping().messagesSent();
+  });
+  device.setMidiMapping({{tSource::Key, 0, 16, tMessage::Note, 0, 36}});
+
+  for (unsigned i = 0; i < 3; i++)
+  {
+    loop.tick();
+  }
+  CHECK(device.m_midiOut == tMessages({{0x90, 38, 127}, {0x80, 38, 0}, {0x90, 41, 64}}));
+  CHECK(nSentBeforeCallback == 1 + 2 + 3);
+
+  loop.disconnect();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("MidiMapping: polled input writes MIDI to the device handle", "[devices][MidiMapping]")
+{
+  DevicePolledMidiTest device;
+  DeviceLoop loop(device);
+  SimulatedDeviceHandle::Stats stats;
+  loop.connect(
+    tPtr<DeviceHandleImpl>(new PolledDeviceHandle(stats, {{0x02, 0xFF}, {0x02, 0x00}})));
+  device.setMidiMapping({{tSource::Key, 0, 16, tMessage::Note, 0, 36}});
+
+  // The read callback runs after the device handle is released, or writing would deadlock
+  loop.tick();
+  loop.tick();
+  CHECK(stats.writes == 2);
+  CHECK(stats.bytesWritten == 6);
+
+  loop.disconnect();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("MidiMapping: input to MIDI out latency", "[.][benchmark][devices][MidiMapping]")
+{
+  using tClock = std::chrono::steady_clock;
+  const unsigned nTicks = 100000;
+
+  DeviceMidiTest device;
+  DeviceLoop loop(device);
+  SimulatedDeviceHandle::Stats stats;
+  loop.connect(
+    tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(stats, {{0x02, 0xFF}, {0x02, 0x00}})));
+
+  tClock::time_point tickStart;
+  double totalLatency = 0.0;
+  auto output = [&](const uint8_t*, size_t) {
+    totalLatency += std::chrono::duration<double, std::nano>(tClock::now() - tickStart).count();
+  };
+
+  auto measure = [&]() -> double {
+    totalLatency = 0.0;
+    for (unsigned n = 0; n < nTicks; n++)
+    {
+      tickStart = tClock::now();
+      loop.tick();
+    }
+    return totalLatency / nTicks;
+  };
+
+  // The client sends the note from its callback, as it would without a mapping
+  device.setCallbackKeyChanged([&](unsigned index_, double value_, bool) {
+    tRawData message{static_cast<uint8_t>(value_ > 0.0 ? 0x90 : 0x80),
+      static_cast<uint8_t>(36 + index_),
+      static_cast<uint8_t>(value_ * 127.0)};
+    output(message.data(), message.size());
+  });
+  double fromCallback = measure();
+
+  device.setCallbackKeyChanged([](unsigned, double, bool) {});
+  device.setMidiMapping({{tSource::Key, 0, 16, tMessage::Note, 0, 36}}, output);
+  double mapped = measure();
+
+  WARN("Input to MIDI out: " << fromCallback << " ns from the callback, " << mapped
+                             << " ns mapped");
+  loop.disconnect();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
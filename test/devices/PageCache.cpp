@@ -0,0 +1,158 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <map>
+
+#include <cabl/devices/PageCache.h>
+#include <cabl/gfx/CanvasBase.h>
+#include <cabl/gfx/TextDisplay.h>
+
+#include "devices/DeviceLoop.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+class DevicePageCacheTest : public DeviceTest
+{
+public:
+  using tDisplay = CanvasBase<16, 8, 16 * 8>;
+
+  Canvas* graphicDisplay(size_t) override
+  {
+    return &m_display;
+  }
+
+  TextDisplay* textDisplay(size_t) override
+  {
+    return &m_textDisplay;
+  }
+
+  size_t numOfGraphicDisplays() const override
+  {
+    return 1;
+  }
+
+  size_t numOfTextDisplays() const override
+  {
+    return 1;
+  }
+
+  void setButtonLed(Button button_, const Color& color_) override
+  {
+    m_buttonLeds[button_] = color_;
+    m_nLedUpdates++;
+  }
+
+  void setKeyLed(unsigned index_, const Color& color_) override
+  {
+    m_keyLeds[index_] = color_;
+    m_nLedUpdates++;
+  }
+
+  tDisplay m_display;
+  TextDisplayBase<8, 1> m_textDisplay;
+  std::map<Button, Color> m_buttonLeds;
+  std::map<unsigned, Color> m_keyLeds;
+  unsigned m_nLedUpdates{0};
+};
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("PageCache: pages are restored by swapping buffers", "[devices][PageCache]")
+{
+  DevicePageCacheTest device;
+  PageCache cache(device);
+
+  CHECK_FALSE(cache.show("mixer"));
+  device.m_display.setPixel(1, 1, {255});
+  device.m_textDisplay.fill('m');
+  cache.setButtonLed(Device::Button::Mute, {255});
+  cache.setKeyLed(3, {0, 255, 0});
+
+  CHECK_FALSE(cache.show("browser"));
+  CHECK(device.m_display.pixel(1, 1).active() == false);
+  CHECK(device.m_display.dirty());
+  CHECK(device.m_buttonLeds[Device::Button::Mute] == Color(0, 0, 0, 0));
+  CHECK(device.m_keyLeds[3] == Color(0, 0, 0, 0));
+  CHECK(device.m_textDisplay.displayData()[0] == 0);
+  device.m_display.setPixel(2, 2, {255});
+  cache.setKeyLed(3, {0, 255, 0});
+
+  const uint8_t* pBrowserBuffer = device.m_display.buffer();
+  device.m_display.resetDirtyFlags();
+  device.m_textDisplay.resetDirtyFlags();
+  device.m_nLedUpdates = 0;
+
+  CHECK(cache.show("mixer"));
+  CHECK(cache.activePage() == "mixer");
+  CHECK(device.m_display.pixel(1, 1).active());
+  CHECK_FALSE(device.m_display.pixel(2, 2).active());
+  CHECK(device.m_display.buffer() != pBrowserBuffer);
+  CHECK(device.m_display.dirty());
+  CHECK(device.m_textDisplay.displayData()[0] == 'm');
+  CHECK(device.m_textDisplay.dirty());
+  CHECK(device.m_buttonLeds[Device::Button::Mute] == Color(255));
+
+  // Key 3 has the same color on both pages, only the Mute LED is sent
+  CHECK(device.m_nLedUpdates == 1);
+
+  CHECK(cache.show("browser"));
+  CHECK(device.m_display.buffer() == pBrowserBuffer);
+  CHECK(device.m_display.pixel(2, 2).active());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("PageCache: least recently shown pages are evicted", "[devices][PageCache]")
+{
+  DevicePageCacheTest device;
+  size_t pageBytes = device.m_display.bufferSize() + device.m_textDisplay.dataSize();
+  PageCache cache(device, 2 * pageBytes);
+
+  cache.show("a");
+  cache.show("b");
+  cache.show("c");
+  cache.show("a");
+  CHECK(cache.size() == 2);
+  CHECK(cache.cachedBytes() <= cache.maxBytes());
+  CHECK(cache.contains("a"));
+  CHECK(cache.contains("c"));
+  CHECK_FALSE(cache.contains("b"));
+
+  CHECK_FALSE(cache.show("b"));
+  CHECK(cache.cachedBytes() <= cache.maxBytes());
+
+  cache.invalidate("a");
+  CHECK_FALSE(cache.contains("a"));
+  CHECK_FALSE(cache.show("a"));
+
+  cache.setMaxBytes(0);
+  CHECK(cache.size() == 1);
+  CHECK(cache.contains("a"));
+
+  cache.clear();
+  CHECK(cache.size() == 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,218 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <array>
+#include <list>
+#include <thread>
+
+#include <cabl/devices/Device.h>
+#include <cabl/devices/DisplayMirror.h>
+#include <cabl/gfx/TextDisplay.h>
+
+#include "devices/DeviceLoop.h"
+#include "gfx/displays/GDisplayMaschineMK2.h"
+#include "gfx/displays/LedMatrixMaschineJam.h"
+#include "util/SoakHarness.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+const uint8_t kEpDisplay = 0x08;
+const uint8_t kEpOut = 0x01;
+const uint8_t kEpInput = 0x84;
+
+//--------------------------------------------------------------------------------------------------
+
+//! A device flushing its display, LED matrix and LEDs the way the real drivers do
+class DeviceSoakTest : public DeviceTest
+{
+public:
+  void init() override
+  {
+    writeToDeviceHandle(Transfer({0x01, 0x00}), kEpOut);
+  }
+
+  Canvas* graphicDisplay(size_t) override
+  {
+    return &m_display;
+  }
+
+  TextDisplay* textDisplay(size_t) override
+  {
+    return &m_textDisplay;
+  }
+
+  Canvas* ledMatrix(size_t) override
+  {
+    return &m_ledMatrix;
+  }
+
+  size_t numOfGraphicDisplays() const override
+  {
+    return 1;
+  }
+
+  size_t numOfTextDisplays() const override
+  {
+    return 1;
+  }
+
+  size_t numOfLedMatrices() const override
+  {
+    return 1;
+  }
+
+  void setButtonLed(Button button_, const Color& color_) override
+  {
+    m_leds[static_cast<unsigned>(button_) % m_leds.size()] = color_.mono();
+    m_ledsDirty = true;
+  }
+
+  void setKeyLed(unsigned index_, const Color& color_) override
+  {
+    m_leds[index_ % m_leds.size()] = color_.mono();
+    m_ledsDirty = true;
+  }
+
+private:
+  bool tick() override
+  {
+    Transfer input;
+    if (readFromDeviceHandle(input, kEpInput) && input.size() >= 4)
+    {
+      bool shift = (input[1] & 0x02) != 0;
+      buttonChanged(static_cast<Button>(input[0] % static_cast<uint8_t>(Button::Unknown)),
+        (input[1] & 0x01) != 0,
+        shift);
+      keyChanged(input[2] % 16, input[3] / 255.0, shift);
+    }
+
+    flush(m_display, kEpDisplay);
+    flush(m_ledMatrix, kEpOut);
+    if (m_ledsDirty)
+    {
+      writeToDeviceHandle(Transfer({0x80}, m_leds.data(), m_leds.size()), kEpOut);
+      m_ledsDirty = false;
+    }
+    return true;
+  }
+
+  void flush(Canvas& canvas_, uint8_t endpoint_)
+  {
+    unsigned chunkSize = canvas_.bufferSize() / canvas_.numberOfChunks();
+    for (unsigned chunk = 0; chunk < canvas_.numberOfChunks(); chunk++)
+    {
+      if (canvas_.dirtyChunk(chunk))
+      {
+        const uint8_t* pChunk = canvas_.buffer() + chunk * chunkSize;
+        writeToDeviceHandle(
+          Transfer({0xE0, static_cast<uint8_t>(chunk)}, pChunk, chunkSize), endpoint_);
+      }
+    }
+    canvas_.resetDirtyFlags();
+  }
+
+  GDisplayMaschineMK2 m_display;
+  LedMatrixMaschineJam m_ledMatrix;
+  TextDisplayBase<8, 1> m_textDisplay;
+  std::array<uint8_t, 64> m_leds{};
+  bool m_ledsDirty{false};
+};
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("Soak: connect, render and disconnect cycles don't drift", "[devices][Soak]")
+{
+  DeviceSoakTest device;
+  DeviceLoop loop(device);
+  SimulatedDeviceHandle::Stats stats;
+
+  unsigned frame = 0;
+  unsigned buttonChanges = 0;
+  device.setCallbackRender([&device, &frame]() {
+    Canvas* pDisplay = device.graphicDisplay(0);
+    pDisplay->black();
+    pDisplay->rectangleFilled(frame % 200, 8, 48, 24, {0xff}, {BlendMode::Invert});
+    pDisplay->putText(4, 40, "soak", {0xff}, "normal");
+    device.ledMatrix(0)->setPixel(frame % 8, (frame / 8) % 8, {0x7f, 0x00, 0xff, 0xff});
+    device.textDisplay(0)->putValue(static_cast<float>(frame % 100) / 100.f, 0);
+    frame++;
+  });
+  device.setCallbackButtonChanged(
+    [&buttonChanges](Device::Button, bool, bool) { buttonChanges++; });
+  device.setCallbackKeyChanged([&device](unsigned index_, double value_, bool) {
+    device.setKeyLed(index_, {static_cast<uint8_t>(value_ * 255)});
+  });
+
+  // Every other session replays a recorded report, the others get random input
+  const std::vector<tRawData> recording{{0x05, 0x01, 0x03, 0x7f}, {0x05, 0x00, 0x03, 0x00}};
+
+  SoakHarness soak(std::chrono::milliseconds(800));
+  uint32_t session = 0;
+  while (soak.running())
+  {
+    session++;
+    loop.connect(tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(
+      stats, session % 2 == 0 ? recording : std::vector<tRawData>{}, 8, session)));
+    {
+      DisplayMirror mirror(device, nullptr);
+      mirror.setMaxFrameRate(0);
+      for (unsigned i = 0; i < 16; i++)
+      {
+        device.postButtonLed(static_cast<Device::Button>(i), {static_cast<uint8_t>(i * 16)});
+        soak.measure([&loop]() { loop.tick(); });
+      }
+    }
+    loop.disconnect();
+  }
+
+  std::string drift = soak.drift();
+  INFO(soak.report());
+  INFO(drift);
+  CHECK(drift.empty());
+  CHECK(session > soak.samples().size());
+  CHECK(buttonChanges > 0);
+  CHECK(stats.bytesWritten > 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("Soak: growing resource usage is reported", "[devices][Soak]")
+{
+  SoakHarness soak(std::chrono::milliseconds(200), 4);
+  std::list<unsigned> leaked;
+  while (soak.running())
+  {
+    soak.measure([&leaked]() { leaked.push_back(0); });
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+
+  REQUIRE(soak.samples().size() == 4);
+  CHECK(soak.drift().find("live allocations grew") == 0);
+  SoakHarness::Limits limits = SoakHarness::defaultLimits();
+  limits.liveAllocations = static_cast<long>(leaked.size());
+  CHECK(soak.drift(limits).empty());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
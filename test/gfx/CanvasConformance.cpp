@@ -0,0 +1,855 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cabl/gfx/CanvasBase.h>
+#include <cabl/gfx/CanvasView.h>
+#include <cabl/gfx/RgbaCanvas.h>
+
+#include "gfx/displays/GDisplayMaschineMK1.h"
+#include "gfx/displays/GDisplayMaschineMK2.h"
+#include "gfx/displays/GDisplayMaschineMikro.h"
+#include "gfx/displays/GDisplayPush2.h"
+#include "gfx/displays/LedMatrixMaschineJam.h"
+
+//--------------------------------------------------------------------------------------------------
+
+/*
+  Differential conformance tests for the drawing functions.
+
+  Random sequences of draw calls (with coordinates past the canvas edges, and invert and
+  transparent colors) are replayed on a reference canvas, which draws everything pixel by pixel
+  through the generic Canvas algorithms, and on each candidate path (the display classes as they
+  are, views on them...). The pixel buffers and the dirty chunks are compared after every call.
+  Partial views are compared with a view which fills and inverts its area pixel by pixel.
+  The first divergence is reported along with the shortest sequence of calls found to reproduce
+  it, ready to be pasted into a test.
+  An optimized drawing path is covered by adding a candidate to the list below; the golden digests
+  at the end pin the current output of the reference path, i.e. of the display setPixel()
+  implementations.
+*/
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+struct DrawCall
+{
+  enum class Type
+  {
+    Fill,
+    Invert,
+    White,
+    Black,
+    SetPixel,
+    Line,
+    LineVertical,
+    LineHorizontal,
+    Triangle,
+    TriangleFilled,
+    Rectangle,
+    RectangleFilled,
+    RectangleRounded,
+    RectangleRoundedFilled,
+    Circle,
+    CircleFilled,
+    PutBitmap,
+    PutCharacter,
+    PutText,
+    Count,
+  };
+
+  Type type;
+  unsigned args[7];
+  Color color;
+  Color fillColor;
+  std::string text;
+};
+
+const uint8_t kBitmap[16]{0x81, 0x42, 0x24, 0x18, 0xFF, 0x00, 0xAA, 0x55, //
+  0x0F, 0xF0, 0x3C, 0xC3, 0x99, 0x66, 0x01, 0x80};
+
+const char* const kFonts[]{"", "small", "normal", "big"};
+
+//--------------------------------------------------------------------------------------------------
+
+//! Generates the same draw calls for a given seed on every platform
+class DrawCallGenerator
+{
+public:
+  DrawCallGenerator(uint32_t seed_, unsigned width_, unsigned height_)
+    : m_generator(seed_), m_width(width_), m_height(height_)
+  {
+  }
+
+  DrawCall next()
+  {
+    DrawCall call;
+    call.type = static_cast<DrawCall::Type>(uniform(static_cast<unsigned>(DrawCall::Type::Count)));
+    call.args[0] = x();
+    call.args[1] = y();
+    call.args[2] = x();
+    call.args[3] = y();
+    call.args[4] = x();
+    call.args[5] = y();
+    call.args[6] = uniform(std::min(m_width, m_height) / 2 + 8);
+    call.color = color();
+    call.fillColor = color();
+
+    switch (call.type)
+    {
+      case DrawCall::Type::Fill:
+      {
+        call.args[0] = uniform(256);
+        break;
+      }
+      case DrawCall::Type::Circle:
+      case DrawCall::Type::CircleFilled:
+      {
+        call.args[3] = uniform(9);
+        break;
+      }
+      case DrawCall::Type::PutBitmap:
+      {
+        call.args[2] = 8 * (1 + uniform(2));
+        call.args[3] = 1 + uniform(16 / (call.args[2] / 8));
+        break;
+      }
+      case DrawCall::Type::PutCharacter:
+      case DrawCall::Type::PutText:
+      {
+        call.args[2] = uniform(4);
+        call.args[3] = uniform(3);
+        unsigned length = call.type == DrawCall::Type::PutCharacter ? 1 : 1 + uniform(12);
+        for (unsigned i = 0; i < length; i++)
+        {
+          call.text += static_cast<char>(' ' + uniform(95));
+        }
+        break;
+      }
+      default:
+      {
+        break;
+      }
+    }
+    return call;
+  }
+
+private:
+  unsigned uniform(unsigned n_)
+  {
+    return n_ == 0 ? 0 : m_generator() % n_;
+  }
+
+  // Coordinates go past the edges, to exercise clipping
+  unsigned x()
+  {
+    return uniform(m_width + 16);
+  }
+
+  unsigned y()
+  {
+    return uniform(m_height + 16);
+  }
+
+  Color color()
+  {
+    switch (uniform(8))
+    {
+      case 0:
+        return Color(BlendMode::Invert);
+      case 1:
+        return Color();
+      case 2:
+        return Color(0);
+      case 3:
+        return Color(0xFF);
+      default:
+      {
+        uint8_t red = static_cast<uint8_t>(uniform(256));
+        uint8_t green = static_cast<uint8_t>(uniform(256));
+        uint8_t blue = static_cast<uint8_t>(uniform(256));
+        return Color(red, green, blue, static_cast<uint8_t>(uniform(256)));
+      }
+    }
+  }
+
+  std::mt19937 m_generator;
+  unsigned m_width;
+  unsigned m_height;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+Canvas::CircleType circleType(unsigned value_)
+{
+  return static_cast<Canvas::CircleType>(value_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void apply(Canvas& canvas_, const DrawCall& call_)
+{
+  const unsigned* a = call_.args;
+  const Color& c = call_.color;
+  const Color& f = call_.fillColor;
+  switch (call_.type)
+  {
+    // clang-format off
+    case DrawCall::Type::Fill: canvas_.fill(static_cast<uint8_t>(a[0])); break;
+    case DrawCall::Type::Invert: canvas_.invert(); break;
+    case DrawCall::Type::White: canvas_.white(); break;
+    case DrawCall::Type::Black: canvas_.black(); break;
+    case DrawCall::Type::SetPixel: canvas_.setPixel(a[0], a[1], c); break;
+    case DrawCall::Type::Line: canvas_.line(a[0], a[1], a[2], a[3], c); break;
+    case DrawCall::Type::LineVertical: canvas_.lineVertical(a[0], a[1], a[6], c); break;
+    case DrawCall::Type::LineHorizontal: canvas_.lineHorizontal(a[0], a[1], a[6], c); break;
+    case DrawCall::Type::Triangle: canvas_.triangle(a[0], a[1], a[2], a[3], a[4], a[5], c); break;
+    case DrawCall::Type::TriangleFilled:
+      canvas_.triangleFilled(a[0], a[1], a[2], a[3], a[4], a[5], c, f); break;
+    case DrawCall::Type::Rectangle: canvas_.rectangle(a[0], a[1], a[2], a[3], c); break;
+    case DrawCall::Type::RectangleFilled:
+      canvas_.rectangleFilled(a[0], a[1], a[2], a[3], c, f); break;
+    case DrawCall::Type::RectangleRounded:
+      canvas_.rectangleRounded(a[0], a[1], a[2], a[3], a[6], c); break;
+    case DrawCall::Type::RectangleRoundedFilled:
+      canvas_.rectangleRoundedFilled(a[0], a[1], a[2], a[3], a[6], c, f); break;
+    case DrawCall::Type::Circle: canvas_.circle(a[0], a[1], a[6], c, circleType(a[3])); break;
+    case DrawCall::Type::CircleFilled:
+      canvas_.circleFilled(a[0], a[1], a[6], c, f, circleType(a[3])); break;
+    case DrawCall::Type::PutBitmap: canvas_.putBitmap(a[0], a[1], a[2], a[3], kBitmap, c); break;
+    case DrawCall::Type::PutCharacter:
+      canvas_.putCharacter(a[0], a[1], call_.text[0], c, kFonts[a[2]]); break;
+    case DrawCall::Type::PutText:
+      canvas_.putText(a[0], a[1], call_.text.c_str(), c, kFonts[a[2]], a[3]); break;
+    default: break;
+    // clang-format on
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::string describe(const Color& color_)
+{
+  std::ostringstream s;
+  if (color_.blendMode() == BlendMode::Invert)
+  {
+    s << "Color(BlendMode::Invert)";
+  }
+  else if (color_.transparent())
+  {
+    s << "Color()";
+  }
+  else
+  {
+    s << "Color(" << unsigned(color_.red()) << ", " << unsigned(color_.green()) << ", "
+      << unsigned(color_.blue()) << ", " << unsigned(color_.mono()) << ")";
+  }
+  return s.str();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::string quoted(const std::string& text_)
+{
+  std::string result = "\"";
+  for (char c : text_)
+  {
+    if (c == '"' || c == '\\')
+    {
+      result += '\\';
+    }
+    result += c;
+  }
+  return result + "\"";
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! The call as a line of C++
+std::string describe(const DrawCall& call_)
+{
+  const unsigned* a = call_.args;
+  std::string c = describe(call_.color);
+  std::string f = describe(call_.fillColor);
+  std::string type = "Canvas::CircleType(" + std::to_string(a[3]) + ")";
+  std::ostringstream s;
+  s << "canvas.";
+  switch (call_.type)
+  {
+    // clang-format off
+    case DrawCall::Type::Fill: s << "fill(" << a[0] << ")"; break;
+    case DrawCall::Type::Invert: s << "invert()"; break;
+    case DrawCall::Type::White: s << "white()"; break;
+    case DrawCall::Type::Black: s << "black()"; break;
+    case DrawCall::Type::SetPixel:
+      s << "setPixel(" << a[0] << ", " << a[1] << ", " << c << ")"; break;
+    case DrawCall::Type::Line:
+      s << "line(" << a[0] << ", " << a[1] << ", " << a[2] << ", " << a[3] << ", " << c << ")";
+      break;
+    case DrawCall::Type::LineVertical:
+      s << "lineVertical(" << a[0] << ", " << a[1] << ", " << a[6] << ", " << c << ")"; break;
+    case DrawCall::Type::LineHorizontal:
+      s << "lineHorizontal(" << a[0] << ", " << a[1] << ", " << a[6] << ", " << c << ")"; break;
+    case DrawCall::Type::Triangle:
+      s << "triangle(" << a[0] << ", " << a[1] << ", " << a[2] << ", " << a[3] << ", " << a[4]
+        << ", " << a[5] << ", " << c << ")"; break;
+    case DrawCall::Type::TriangleFilled:
+      s << "triangleFilled(" << a[0] << ", " << a[1] << ", " << a[2] << ", " << a[3] << ", "
+        << a[4] << ", " << a[5] << ", " << c << ", " << f << ")"; break;
+    case DrawCall::Type::Rectangle:
+      s << "rectangle(" << a[0] << ", " << a[1] << ", " << a[2] << ", " << a[3] << ", " << c
+        << ")"; break;
+    case DrawCall::Type::RectangleFilled:
+      s << "rectangleFilled(" << a[0] << ", " << a[1] << ", " << a[2] << ", " << a[3] << ", "
+        << c << ", " << f << ")"; break;
+    case DrawCall::Type::RectangleRounded:
+      s << "rectangleRounded(" << a[0] << ", " << a[1] << ", " << a[2] << ", " << a[3] << ", "
+        << a[6] << ", " << c << ")"; break;
+    case DrawCall::Type::RectangleRoundedFilled:
+      s << "rectangleRoundedFilled(" << a[0] << ", " << a[1] << ", " << a[2] << ", " << a[3]
+        << ", " << a[6] << ", " << c << ", " << f << ")"; break;
+    case DrawCall::Type::Circle:
+      s << "circle(" << a[0] << ", " << a[1] << ", " << a[6] << ", " << c << ", " << type << ")";
+      break;
+    case DrawCall::Type::CircleFilled:
+      s << "circleFilled(" << a[0] << ", " << a[1] << ", " << a[6] << ", " << c << ", " << f
+        << ", " << type << ")"; break;
+    case DrawCall::Type::PutBitmap:
+      s << "putBitmap(" << a[0] << ", " << a[1] << ", " << a[2] << ", " << a[3] << ", kBitmap, "
+        << c << ")"; break;
+    case DrawCall::Type::PutCharacter:
+      s << "putCharacter(" << a[0] << ", " << a[1] << ", '" << call_.text << "', " << c << ", "
+        << quoted(kFonts[a[2]]) << ")"; break;
+    case DrawCall::Type::PutText:
+      s << "putText(" << a[0] << ", " << a[1] << ", " << quoted(call_.text) << ", " << c << ", "
+        << quoted(kFonts[a[2]]) << ", " << a[3] << ")"; break;
+    default: break;
+    // clang-format on
+  }
+  s << ";";
+  return s.str();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Draws every primitive pixel by pixel through the generic Canvas algorithms
+template <class TDisplay>
+class ScalarReference : public TDisplay
+{
+public:
+  void line(unsigned x0_, unsigned y0_, unsigned x1_, unsigned y1_, const Color& color_) override
+  {
+    Canvas::line(x0_, y0_, x1_, y1_, color_);
+  }
+
+  void lineVertical(unsigned x_, unsigned y_, unsigned h_, const Color& color_) override
+  {
+    Canvas::lineVertical(x_, y_, h_, color_);
+  }
+
+  void lineHorizontal(unsigned x_, unsigned y_, unsigned w_, const Color& color_) override
+  {
+    Canvas::lineHorizontal(x_, y_, w_, color_);
+  }
+
+  void triangle(unsigned x0_,
+    unsigned y0_,
+    unsigned x1_,
+    unsigned y1_,
+    unsigned x2_,
+    unsigned y2_,
+    const Color& color_) override
+  {
+    Canvas::triangle(x0_, y0_, x1_, y1_, x2_, y2_, color_);
+  }
+
+  void triangleFilled(unsigned x0_,
+    unsigned y0_,
+    unsigned x1_,
+    unsigned y1_,
+    unsigned x2_,
+    unsigned y2_,
+    const Color& color_,
+    const Color& fillColor_) override
+  {
+    Canvas::triangleFilled(x0_, y0_, x1_, y1_, x2_, y2_, color_, fillColor_);
+  }
+
+  void rectangle(unsigned x_, unsigned y_, unsigned w_, unsigned h_, const Color& color_) override
+  {
+    Canvas::rectangle(x_, y_, w_, h_, color_);
+  }
+
+  void rectangleFilled(unsigned x_,
+    unsigned y_,
+    unsigned w_,
+    unsigned h_,
+    const Color& color_,
+    const Color& fillColor_) override
+  {
+    Canvas::rectangleFilled(x_, y_, w_, h_, color_, fillColor_);
+  }
+
+  void rectangleRounded(
+    unsigned x_, unsigned y_, unsigned w_, unsigned h_, unsigned r_, const Color& color_) override
+  {
+    Canvas::rectangleRounded(x_, y_, w_, h_, r_, color_);
+  }
+
+  void rectangleRoundedFilled(unsigned x_,
+    unsigned y_,
+    unsigned w_,
+    unsigned h_,
+    unsigned r_,
+    const Color& color_,
+    const Color& fillColor_) override
+  {
+    Canvas::rectangleRoundedFilled(x_, y_, w_, h_, r_, color_, fillColor_);
+  }
+
+  void circle(unsigned x_,
+    unsigned y_,
+    unsigned r_,
+    const Color& color_,
+    Canvas::CircleType type_ = Canvas::CircleType::Full) override
+  {
+    Canvas::circle(x_, y_, r_, color_, type_);
+  }
+
+  void circleFilled(unsigned x_,
+    unsigned y_,
+    unsigned r_,
+    const Color& color_,
+    const Color& fillColor_,
+    Canvas::CircleType type_ = Canvas::CircleType::Full) override
+  {
+    Canvas::circleFilled(x_, y_, r_, color_, fillColor_, type_);
+  }
+
+  void putBitmap(unsigned x_,
+    unsigned y_,
+    unsigned w_,
+    unsigned h_,
+    const uint8_t* pBitmap_,
+    const Color& color_) override
+  {
+    Canvas::putBitmap(x_, y_, w_, h_, pBitmap_, color_);
+  }
+
+  void putCharacter(
+    unsigned x_, unsigned y_, char c_, const Color& color_, const std::string& font_) override
+  {
+    Canvas::putCharacter(x_, y_, c_, color_, font_);
+  }
+
+  void putText(unsigned x_,
+    unsigned y_,
+    const char* pStr_,
+    const Color& color_,
+    const std::string& font_,
+    unsigned spacing_) override
+  {
+    Canvas::putText(x_, y_, pStr_, color_, font_, spacing_);
+  }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+//! Fills and inverts a view pixel by pixel
+class ScalarViewReference : public CanvasView
+{
+public:
+  using CanvasView::CanvasView;
+
+  void white() override
+  {
+    paint([](unsigned, unsigned) { return Color(0xFF); });
+  }
+
+  void black() override
+  {
+    paint([](unsigned, unsigned) { return Color(0x00); });
+  }
+
+  void invert() override
+  {
+    for (unsigned y = 0; y < height(); y++)
+    {
+      for (unsigned x = 0; x < width(); x++)
+      {
+        setPixel(x, y, {BlendMode::Invert}, false);
+      }
+    }
+  }
+
+  void fill(uint8_t value_) override
+  {
+    for (unsigned y = 0; y < height(); y++)
+    {
+      for (unsigned x = 0; x < width(); x++)
+      {
+        setPixel(x, y, fillColor(value_, x, y), false);
+      }
+    }
+  }
+
+private:
+  void paint(std::function<Color(unsigned, unsigned)> color_)
+  {
+    for (unsigned y = 0; y < height(); y++)
+    {
+      for (unsigned x = 0; x < width(); x++)
+      {
+        setPixel(x, y, color_(x, y), false);
+      }
+      setDirtyChunk(y);
+    }
+  }
+};
+
+//--------------------------------------------------------------------------------------------------
+
+//! A display and the canvas the draw calls go through
+class Target
+{
+public:
+  virtual ~Target() = default;
+
+  //! The canvas to draw on
+  virtual Canvas& canvas() = 0;
+
+  //! The display whose content is compared
+  virtual Canvas& display() = 0;
+};
+
+using tTargetFactory = std::function<tPtr<Target>()>;
+
+template <class TDisplay>
+class DisplayTarget : public Target
+{
+public:
+  Canvas& canvas() override
+  {
+    return m_display;
+  }
+
+  Canvas& display() override
+  {
+    return m_display;
+  }
+
+private:
+  TDisplay m_display;
+};
+
+template <class TDisplay>
+class FullViewTarget : public Target
+{
+public:
+  Canvas& canvas() override
+  {
+    return m_view;
+  }
+
+  Canvas& display() override
+  {
+    return m_display;
+  }
+
+private:
+  TDisplay m_display;
+  CanvasView m_view{m_display, 0, 0, m_display.width(), m_display.height()};
+};
+
+//! A view on the middle of the display, not aligned on bytes nor on chunks
+template <class TView, class TDisplay>
+class PartialViewTarget : public Target
+{
+public:
+  Canvas& canvas() override
+  {
+    return m_view;
+  }
+
+  Canvas& display() override
+  {
+    return m_display;
+  }
+
+private:
+  TDisplay m_display;
+  TView m_view{m_display,
+    m_display.width() / 4 + 3,
+    m_display.height() / 4 + 1,
+    m_display.width() / 2,
+    m_display.height() / 2};
+};
+
+template <class TTarget>
+tTargetFactory factory()
+{
+  return []() { return tPtr<Target>(new TTarget); };
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool sameContent(Canvas& a_, Canvas& b_)
+{
+  if (!std::equal(a_.buffer(), a_.buffer() + a_.bufferSize(), b_.buffer()))
+  {
+    return false;
+  }
+  for (unsigned i = 0; i < a_.numberOfChunks(); i++)
+  {
+    if (a_.dirtyChunk(i) != b_.dirtyChunk(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Index of the first call after which the targets differ, calls_.size() if they never do
+size_t firstDivergence(const tTargetFactory& reference_,
+  const tTargetFactory& candidate_,
+  const std::vector<DrawCall>& calls_)
+{
+  tPtr<Target> pReference = reference_();
+  tPtr<Target> pCandidate = candidate_();
+  for (size_t i = 0; i < calls_.size(); i++)
+  {
+    apply(pReference->canvas(), calls_[i]);
+    apply(pCandidate->canvas(), calls_[i]);
+    if (!sameContent(pReference->display(), pCandidate->display()))
+    {
+      return i;
+    }
+    pReference->display().resetDirtyFlags();
+    pCandidate->display().resetDirtyFlags();
+  }
+  return calls_.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Drop the calls which aren't needed to reproduce a divergence at the last call
+std::vector<DrawCall> minimize(
+  const tTargetFactory& reference_, const tTargetFactory& candidate_, std::vector<DrawCall> calls_)
+{
+  for (size_t i = calls_.size() - 1; i-- > 0;)
+  {
+    std::vector<DrawCall> reduced = calls_;
+    reduced.erase(reduced.begin() + i);
+    if (firstDivergence(reference_, candidate_, reduced) < reduced.size())
+    {
+      calls_ = reduced;
+    }
+  }
+  return calls_;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::vector<DrawCall> generate(uint32_t seed_, unsigned nCalls_, Canvas& canvas_)
+{
+  DrawCallGenerator generator(seed_, canvas_.width(), canvas_.height());
+  std::vector<DrawCall> calls;
+  while (calls.size() < nCalls_)
+  {
+    calls.push_back(generator.next());
+  }
+  return calls;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void checkConformance(const std::string& name_,
+  const tTargetFactory& reference_,
+  const tTargetFactory& candidate_,
+  unsigned nSeeds_,
+  unsigned nCalls_)
+{
+  for (uint32_t seed = 1; seed <= nSeeds_; seed++)
+  {
+    std::vector<DrawCall> calls = generate(seed, nCalls_, reference_()->display());
+    size_t divergence = firstDivergence(reference_, candidate_, calls);
+
+    std::string report;
+    if (divergence < calls.size())
+    {
+      calls.resize(divergence + 1);
+      std::ostringstream s;
+      s << name_ << " differs from the reference after call " << divergence << " of seed " << seed
+        << ", reproducer:\n";
+      for (const auto& call : minimize(reference_, candidate_, calls))
+      {
+        s << "  " << describe(call) << "\n";
+      }
+      report = s.str();
+    }
+    INFO(report);
+    CHECK(divergence == calls.size());
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+template <class TDisplay>
+void checkDisplay(const std::string& name_, unsigned nSeeds_, unsigned nCalls_)
+{
+  tTargetFactory reference = factory<DisplayTarget<ScalarReference<TDisplay>>>();
+  checkConformance(name_, reference, factory<DisplayTarget<TDisplay>>(), nSeeds_, nCalls_);
+  checkConformance(
+    name_ + " (full view)", reference, factory<FullViewTarget<TDisplay>>(), nSeeds_, nCalls_);
+  checkConformance(name_ + " (partial view)",
+    factory<PartialViewTarget<ScalarViewReference, TDisplay>>(),
+    factory<PartialViewTarget<CanvasView, TDisplay>>(),
+    nSeeds_,
+    nCalls_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! Number of pixels whose color after fill() isn't the one given by fillColor()
+unsigned fillColorMismatches(Canvas& canvas_)
+{
+  unsigned nMismatches = 0;
+  for (unsigned value : {0x00, 0xFF, 0xA5, 0x3C, 0x81})
+  {
+    canvas_.fill(static_cast<uint8_t>(value));
+    for (unsigned y = 0; y < canvas_.height(); y++)
+    {
+      for (unsigned x = 0; x < canvas_.width(); x++)
+      {
+        if (canvas_.pixel(x, y) != canvas_.fillColor(static_cast<uint8_t>(value), x, y))
+        {
+          nMismatches++;
+        }
+      }
+    }
+  }
+  return nMismatches;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+//! FNV-1a digest of the reference output for a seed
+template <class TDisplay>
+uint64_t referenceDigest(uint32_t seed_, unsigned nCalls_)
+{
+  ScalarReference<TDisplay> display;
+  for (const auto& call : generate(seed_, nCalls_, display))
+  {
+    apply(display, call);
+  }
+  uint64_t digest = 0xcbf29ce484222325;
+  for (unsigned i = 0; i < display.bufferSize(); i++)
+  {
+    digest = (digest ^ display.buffer()[i]) * 0x100000001b3;
+  }
+  return digest;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CanvasConformance: the reproducer is a minimal sequence of calls", "[gfx][Conformance]")
+{
+  // A deliberately wrong path: it ignores the invert blend mode of horizontal lines
+  class Broken : public GDisplayMaschineMK2
+  {
+  public:
+    void lineHorizontal(unsigned x_, unsigned y_, unsigned w_, const Color& color_) override
+    {
+      Color color = color_.blendMode() == BlendMode::Invert ? Color(0xFF) : color_;
+      GDisplayMaschineMK2::lineHorizontal(x_, y_, w_, color);
+    }
+  };
+
+  tTargetFactory reference = factory<DisplayTarget<ScalarReference<GDisplayMaschineMK2>>>();
+  tTargetFactory broken = factory<DisplayTarget<Broken>>();
+
+  DrawCall fill{DrawCall::Type::Fill, {0xFF}, {}, {}, ""};
+  DrawCall pixel{DrawCall::Type::SetPixel, {1, 1}, {0xFF}, {}, ""};
+  DrawCall line{DrawCall::Type::LineHorizontal, {0, 2, 0, 0, 0, 0, 8}, {BlendMode::Invert}, {}, ""};
+  std::vector<DrawCall> calls{pixel, fill, pixel, line, pixel};
+
+  CHECK(firstDivergence(reference, broken, calls) == 3);
+  calls.resize(4);
+  std::vector<DrawCall> minimal = minimize(reference, broken, calls);
+  REQUIRE(minimal.size() == 2);
+  CHECK(describe(minimal[0]) == "canvas.fill(255);");
+  CHECK(describe(minimal[1]) == "canvas.lineHorizontal(0, 2, 8, Color(BlendMode::Invert));");
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CanvasConformance: display drawing paths match the reference", "[gfx][Conformance]")
+{
+  checkDisplay<GDisplayMaschineMK1>("GDisplayMaschineMK1", 8, 80);
+  checkDisplay<GDisplayMaschineMK2>("GDisplayMaschineMK2", 8, 80);
+  checkDisplay<GDisplayMaschineMikro>("GDisplayMaschineMikro", 8, 80);
+  checkDisplay<GDisplayPush2>("GDisplayPush2", 2, 40);
+  checkDisplay<LedMatrixMaschineJam>("LedMatrixMaschineJam", 32, 80);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CanvasConformance: fillColor() matches fill() in every format", "[gfx][Conformance]")
+{
+  GDisplayMaschineMK1 mk1;
+  GDisplayMaschineMK2 mk2;
+  GDisplayMaschineMikro mikro;
+  GDisplayPush2 push2;
+  LedMatrixMaschineJam ledMatrix;
+  CanvasBase<16, 8> rgb;
+  RgbaCanvas rgba(16, 8);
+  CHECK(fillColorMismatches(mk1) == 0);
+  CHECK(fillColorMismatches(mk2) == 0);
+  CHECK(fillColorMismatches(mikro) == 0);
+  CHECK(fillColorMismatches(push2) == 0);
+  CHECK(fillColorMismatches(ledMatrix) == 0);
+  CHECK(fillColorMismatches(rgb) == 0);
+  CHECK(fillColorMismatches(rgba) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CanvasConformance: the reference output doesn't change", "[gfx][Conformance]")
+{
+  CHECK(referenceDigest<GDisplayMaschineMK1>(1, 80) == 0x9a2e740b612d992d);
+  CHECK(referenceDigest<GDisplayMaschineMK2>(1, 80) == 0xf024277fb3c50b25);
+  CHECK(referenceDigest<GDisplayMaschineMikro>(1, 80) == 0x89bfa3a928539725);
+  CHECK(referenceDigest<GDisplayPush2>(1, 40) == 0x426d5e7f6c34c085);
+  CHECK(referenceDigest<LedMatrixMaschineJam>(1, 80) == 0x84cc4da0e20ecde5);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,103 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include <catch.hpp>
+
+#include <cabl/gfx/CanvasBase.h>
+#include <cabl/gfx/CanvasView.h>
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CanvasView: geometry and clipping", "[gfx][CanvasView]")
+{
+  CanvasBase<32, 16> parent;
+  CanvasView view(parent, 24, 4, 16, 8);
+
+  CHECK(view.width() == 8);
+  CHECK(view.height() == 8);
+  CHECK(view.xOffset() == 24);
+  CHECK(view.yOffset() == 4);
+  CHECK(view.buffer() == parent.buffer());
+  CHECK(view.residentBytes() == 0);
+
+  view.setPixel(0, 0, {0xFF, 0x00, 0x00});
+  view.setPixel(8, 0, {0xFF, 0x00, 0x00});
+  CHECK(parent.pixel(24, 4) == Color(0xFF, 0x00, 0x00));
+  CHECK(parent.pixel(23, 4) == Color(0, 0, 0));
+  CHECK(view.pixel(0, 0) == Color(0xFF, 0x00, 0x00));
+  CHECK(view.pixel(8, 0) == Color());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CanvasView: drawing is confined to the view", "[gfx][CanvasView]")
+{
+  CanvasBase<32, 16> parent;
+  CanvasView view(parent, 8, 4, 8, 8);
+
+  view.white();
+  view.rectangleFilled(0, 0, 100, 100, {0xFF, 0xFF, 0xFF}, {0xFF, 0xFF, 0xFF});
+
+  unsigned nWhite = 0;
+  for (unsigned y = 0; y < parent.height(); y++)
+  {
+    for (unsigned x = 0; x < parent.width(); x++)
+    {
+      bool inside = x >= 8 && x < 16 && y >= 4 && y < 12;
+      bool white = parent.pixel(x, y) == Color(0xFF, 0xFF, 0xFF);
+      CHECK(inside == white);
+      nWhite += white ? 1 : 0;
+    }
+  }
+  CHECK(nWhite == 64);
+
+  view.invert();
+  CHECK(parent.pixel(8, 4) == Color(0, 0, 0));
+
+  CanvasView nested(view, 2, 2, 2, 2);
+  nested.setPixel(1, 1, {0x00, 0xFF, 0x00});
+  CHECK(parent.pixel(11, 7) == Color(0x00, 0xFF, 0x00));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("CanvasView: dirty chunks are those of the parent", "[gfx][CanvasView]")
+{
+  CanvasBase<16, 16, 16 * 16 * 3, 4> parent;
+  CanvasView view(parent, 0, 8, 16, 4);
+
+  parent.resetDirtyFlags();
+  CHECK_FALSE(view.dirty());
+
+  view.setPixel(0, 0, {0xFF, 0xFF, 0xFF});
+  CHECK(parent.dirtyChunk(2));
+  CHECK_FALSE(parent.dirtyChunk(0));
+  CHECK(view.dirty());
+
+  parent.resetDirtyFlags();
+  parent.setDirtyChunk(0);
+  CHECK_FALSE(view.dirty());
+
+  view.setDirty();
+  CHECK(parent.dirtyChunk(2));
+  CHECK_FALSE(parent.dirtyChunk(3));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
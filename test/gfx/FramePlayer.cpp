@@ -0,0 +1,137 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <cabl/gfx/FramePlayer.h>
+
+#include "gfx/displays/GDisplayMaschineMK2.h"
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+const std::string kFramesFile = "FramePlayer-test.bin";
+
+//! Write nFrames_ frames of frameSize_ bytes, frame i filled with the value i + 1
+void writeFrames(size_t nFrames_, size_t frameSize_, size_t extraBytes_ = 0)
+{
+  std::ofstream file(kFramesFile, std::ios::binary | std::ios::trunc);
+  for (size_t i = 0; i < nFrames_; i++)
+  {
+    std::string frame(frameSize_, static_cast<char>(i + 1));
+    file.write(frame.data(), frame.size());
+  }
+  file.write(std::string(extraBytes_, '\0').data(), extraBytes_);
+}
+
+FramePlayer::tClock::time_point at(FramePlayer::tClock::time_point start_, double seconds_)
+{
+  return start_ + std::chrono::duration_cast<FramePlayer::tClock::duration>(
+                    std::chrono::duration<double>(seconds_));
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("FramePlayer: frames are attached by pointer", "[gfx][FramePlayer]")
+{
+  GDisplayMaschineMK2 display;
+  FramePlayer player(display);
+
+  writeFrames(3, display.bufferSize(), 1);
+  CHECK_FALSE(player.open(kFramesFile));
+  CHECK_FALSE(player.open("does-not-exist.bin"));
+
+  writeFrames(3, display.bufferSize());
+  REQUIRE(player.open(kFramesFile));
+  CHECK(player.numFrames() == 3);
+  CHECK(display.buffer()[0] == 1);
+  CHECK(display.dirty());
+
+  const uint8_t* pFirstFrame = display.buffer();
+  player.seek(2);
+  CHECK(display.buffer() == pFirstFrame + 2 * display.bufferSize());
+  CHECK(display.pixel(0, 0).active() == false);
+  CHECK(display.pixel(6, 0).active());
+
+  // Drawing works on a copy of the frame
+  display.setPixel(0, 0, {0xff});
+  CHECK(display.buffer() != pFirstFrame + 2 * display.bufferSize());
+  CHECK(display.buffer()[0] == 0x83);
+  CHECK(pFirstFrame[2 * display.bufferSize()] == 3);
+
+  player.seek(1);
+  player.close();
+  CHECK_FALSE(player.isOpen());
+  CHECK(display.buffer()[0] == 2);
+
+  std::remove(kFramesFile.c_str());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("FramePlayer: pacing doesn't drift and reports dropped frames", "[gfx][FramePlayer]")
+{
+  GDisplayMaschineMK2 display;
+  FramePlayer player(display);
+  writeFrames(4, display.bufferSize());
+  REQUIRE(player.open(kFramesFile));
+  player.setFrameRate(10);
+
+  auto start = FramePlayer::tClock::now();
+  player.play(start);
+  CHECK_FALSE(player.update(at(start, 0.05)));
+  CHECK(player.update(at(start, 0.12)));
+  CHECK(player.currentFrame() == 1);
+  CHECK_FALSE(player.update(at(start, 0.19)));
+
+  // A late update skips frames 2 and 3, then playback wraps around
+  CHECK(player.update(at(start, 0.41)));
+  CHECK(player.currentFrame() == 0);
+  CHECK(player.droppedFrames() == 2);
+
+  // Late and early updates don't shift the following frames
+  for (unsigned i = 5; i < 1000; i++)
+  {
+    CHECK(player.update(at(start, i * 0.1 + 0.001)));
+    CHECK(player.currentFrame() == i % 4);
+  }
+  CHECK(player.droppedFrames() == 2);
+
+  player.setLooping(false);
+  player.seek(1, start);
+  player.play(start);
+  CHECK(player.update(at(start, 10.0)));
+  CHECK(player.currentFrame() == 3);
+  CHECK(player.droppedFrames() == 3);
+  CHECK_FALSE(player.playing());
+
+  player.close();
+  std::remove(kFramesFile.c_str());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
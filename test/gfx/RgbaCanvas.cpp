@@ -0,0 +1,254 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include <cabl/gfx/DynamicCanvas.h>
+#include <cabl/gfx/RgbaCanvas.h>
+#include <gfx/displays/GDisplayPush2.h>
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+Color patternColor(unsigned x_, unsigned y_)
+{
+  return {static_cast<uint8_t>(x_ + y_), static_cast<uint8_t>(x_ * 3), static_cast<uint8_t>(y_)};
+}
+
+void drawPattern(Canvas& c_)
+{
+  for (unsigned y = 0; y < c_.height(); y++)
+  {
+    for (unsigned x = 0; x < c_.width(); x++)
+    {
+      c_.setPixel(x, y, patternColor(x, y));
+    }
+  }
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("RgbaCanvas: rows are aligned and padded", "[gfx][RgbaCanvas]")
+{
+  RgbaCanvas canvas(100, 10);
+
+  CHECK(canvas.width() == 100);
+  CHECK(canvas.height() == 10);
+  CHECK(canvas.stride() == 112);
+  CHECK(canvas.canvasWidthInBytes() == 112 * 4);
+  CHECK(canvas.bufferSize() == 112 * 4 * 10);
+  for (unsigned y = 0; y < canvas.height(); y++)
+  {
+    CHECK(reinterpret_cast<uintptr_t>(canvas.row(y)) % RgbaCanvas::kRowAlignment == 0);
+  }
+
+  RgbaCanvas copy(canvas);
+  CHECK(reinterpret_cast<uintptr_t>(copy.row(0)) % RgbaCanvas::kRowAlignment == 0);
+
+  canvas.releaseBuffer();
+  CHECK(canvas.residentBytes() == 0);
+  CHECK(canvas.pixel(99, 9) == Color(0, 0, 0));
+  CHECK(reinterpret_cast<uintptr_t>(canvas.row(0)) % RgbaCanvas::kRowAlignment == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("RgbaCanvas: pixels, fill and invert", "[gfx][RgbaCanvas]")
+{
+  RgbaCanvas canvas(16, 8, 2);
+  canvas.resetDirtyFlags();
+
+  canvas.setPixel(3, 5, {0x12, 0x34, 0x56});
+  CHECK(canvas.pixel(3, 5) == Color(0x12, 0x34, 0x56));
+  CHECK(canvas.row(5)[3] == RgbaCanvas::pack(0x12, 0x34, 0x56));
+  CHECK_FALSE(canvas.dirtyChunk(0));
+  CHECK(canvas.dirtyChunk(1));
+
+  canvas.setPixel(16, 0, {0xFF, 0xFF, 0xFF});
+  canvas.setPixel(0, 8, {0xFF, 0xFF, 0xFF});
+  CHECK_FALSE(canvas.dirtyChunk(0));
+
+  canvas.setPixel(3, 5, Color(BlendMode::Invert));
+  CHECK(canvas.pixel(3, 5) == Color(0xED, 0xCB, 0xA9));
+
+  canvas.lineHorizontal(2, 1, 100, {0xFF, 0x00, 0x00});
+  CHECK(canvas.pixel(1, 1) == Color(0, 0, 0));
+  CHECK(canvas.pixel(2, 1) == Color(0xFF, 0x00, 0x00));
+  CHECK(canvas.pixel(15, 1) == Color(0xFF, 0x00, 0x00));
+  CHECK(canvas.dirtyChunk(0));
+  CHECK_FALSE(canvas.dirtyChunk(2));
+
+  canvas.white();
+  CHECK(canvas.pixel(0, 0) == Color(0xFF, 0xFF, 0xFF));
+  canvas.invert();
+  CHECK(canvas.pixel(15, 7) == Color(0, 0, 0));
+  CHECK(canvas.row(7)[15] == RgbaCanvas::pack(0, 0, 0));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("RgbaCanvas: draws as the 24 bit canvas", "[gfx][RgbaCanvas]")
+{
+  DynamicCanvas reference(48, 24);
+  RgbaCanvas canvas(48, 24);
+
+  for (Canvas* pCanvas : std::vector<Canvas*>{&reference, &canvas})
+  {
+    drawPattern(*pCanvas);
+    pCanvas->rectangleFilled(4, 4, 20, 10, {0xFF, 0x80, 0x00}, {0x00, 0x80, 0xFF});
+    pCanvas->lineHorizontal(0, 20, 48, Color(BlendMode::Invert));
+    pCanvas->circle(30, 12, 8, {0x40, 0x40, 0x40});
+  }
+
+  RgbaCanvas copy(16, 16);
+  copy.putCanvas(canvas, 8, 8, 40, 16);
+  CHECK(copy.pixel(15, 15) == canvas.pixel(47, 23));
+  CHECK(copy.pixel(8, 8) == canvas.pixel(40, 16));
+  CHECK(copy.pixel(7, 7) == Color(0, 0, 0));
+
+  for (unsigned y = 0; y < canvas.height(); y++)
+  {
+    for (unsigned x = 0; x < canvas.width(); x++)
+    {
+      CHECK(canvas.pixel(x, y) == reference.pixel(x, y));
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("RgbaCanvas: Push 2 blit matches the generic copy", "[gfx][RgbaCanvas]")
+{
+  DynamicCanvas reference(960, 160);
+  RgbaCanvas canvas(960, 160);
+  drawPattern(reference);
+  drawPattern(canvas);
+
+  GDisplayPush2 generic;
+  GDisplayPush2 converted;
+  generic.putCanvas(reference, 0, 0);
+  converted.putCanvas(canvas, 0, 0);
+  CHECK(std::memcmp(generic.buffer(), converted.buffer(), generic.bufferSize()) == 0);
+
+  generic.putCanvas(reference, 100, 50, 10, 20, 300, 40);
+  converted.putCanvas(canvas, 100, 50, 10, 20, 300, 40);
+  CHECK(std::memcmp(generic.buffer(), converted.buffer(), generic.bufferSize()) == 0);
+
+  converted.resetDirtyFlags();
+  converted.putCanvas(canvas, 100, 50, 10, 20, 300, 40);
+  CHECK_FALSE(converted.dirty());
+  converted.putCanvas(canvas, 0, 0);
+  CHECK(converted.dirty());
+
+  std::vector<uint8_t> mono(canvas.width());
+  canvas.toMono(0, 7, canvas.width(), mono.data());
+  for (unsigned x = 0; x < canvas.width(); x++)
+  {
+    CHECK(mono[x] == reference.pixel(x, 7).mono());
+  }
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("RgbaCanvas: conversion cost compared to the 24 bit canvas",
+  "[.][benchmark][gfx][RgbaCanvas]")
+{
+  using tClock = std::chrono::steady_clock;
+  const unsigned nFrames = 200;
+  const unsigned w = 960;
+  const unsigned h = 160;
+
+  DynamicCanvas packed(w, h);
+  RgbaCanvas aligned(w, h);
+  drawPattern(packed);
+  drawPattern(aligned);
+
+  std::vector<uint8_t> output(w * 2);
+  unsigned checksum = 0;
+
+  auto measure = [&](const char* name_, std::function<void(unsigned)> convertRow_) {
+    auto start = tClock::now();
+    for (unsigned n = 0; n < nFrames; n++)
+    {
+      for (unsigned y = 0; y < h; y++)
+      {
+        convertRow_(y);
+      }
+      checksum += output[n % output.size()];
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(tClock::now() - start);
+    WARN(name_ << ": " << elapsed.count() / nFrames << " us per frame");
+  };
+
+  measure("RGB565, 24 bit rows", [&](unsigned y_) {
+    const uint8_t* pRow = packed.buffer() + y_ * packed.canvasWidthInBytes();
+    for (unsigned x = 0; x < w; x++)
+    {
+      unsigned red = (pRow[3 * x] * 62 + 255) / 510;
+      unsigned green = (pRow[3 * x + 1] * 126 + 255) / 510;
+      unsigned blue = (pRow[3 * x + 2] * 62 + 255) / 510;
+      output[2 * x] = static_cast<uint8_t>((red << 3) | ((green >> 3) & 0x07));
+      output[2 * x + 1] = static_cast<uint8_t>(((green << 5) & 0xE0) | blue);
+    }
+  });
+  measure("RGB565, 32 bit aligned rows", [&](unsigned y_) {
+    aligned.toRgb565(0, y_, w, output.data());
+  });
+  measure("Mono, 24 bit rows", [&](unsigned y_) {
+    const uint8_t* pRow = packed.buffer() + y_ * packed.canvasWidthInBytes();
+    for (unsigned x = 0; x < w; x++)
+    {
+      output[x] = std::max(std::max(pRow[3 * x], pRow[3 * x + 1]), pRow[3 * x + 2]);
+    }
+  });
+  measure("Mono, 32 bit aligned rows", [&](unsigned y_) {
+    aligned.toMono(0, y_, w, output.data());
+  });
+
+  GDisplayPush2 display;
+  auto blit = [&](const char* name_, const Canvas& source_) {
+    auto start = tClock::now();
+    for (unsigned n = 0; n < nFrames / 10; n++)
+    {
+      display.black();
+      display.putCanvas(source_, 0, 0);
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(tClock::now() - start);
+    checksum += display.buffer()[0];
+    WARN(name_ << ": " << elapsed.count() / (nFrames / 10) << " us per frame");
+  };
+  blit("Push 2 putCanvas, 24 bit source", packed);
+  blit("Push 2 putCanvas, 32 bit aligned source", aligned);
+
+  WARN("checksum " << checksum);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,94 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include <catch.hpp>
+
+#include <cabl/gfx/SpanningCanvas.h>
+
+#include "gfx/displays/GDisplayMaschineMK2.h"
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("SpanningCanvas: two displays side by side", "[gfx][SpanningCanvas]")
+{
+  GDisplayMaschineMK2 left;
+  GDisplayMaschineMK2 right;
+  SpanningCanvas canvas{&left, &right};
+
+  CHECK(canvas.width() == 512);
+  CHECK(canvas.height() == 64);
+  CHECK(canvas.numberOfChunks() == 16);
+
+  canvas.black();
+  left.resetDirtyFlags();
+  right.resetDirtyFlags();
+  CHECK_FALSE(canvas.dirty());
+
+  canvas.lineHorizontal(250, 10, 12, {0xFF});
+  for (unsigned x = 250; x < 256; x++)
+  {
+    CHECK(left.pixel(x, 10).active());
+  }
+  for (unsigned x = 0; x < 6; x++)
+  {
+    CHECK(right.pixel(x, 10).active());
+  }
+  CHECK_FALSE(right.pixel(6, 10).active());
+  CHECK(canvas.pixel(260, 10).active());
+
+  CHECK(left.dirtyChunk(1));
+  CHECK(right.dirtyChunk(1));
+  CHECK(canvas.dirtyChunk(9));
+  CHECK_FALSE(canvas.dirtyChunk(10));
+  CHECK(canvas.dirty());
+
+  left.resetDirtyFlags();
+  right.resetDirtyFlags();
+  canvas.fill(0xA5);
+  CHECK(left.dirty());
+  CHECK(right.dirty());
+  CHECK(canvas.pixel(264, 0) == canvas.fillColor(0xA5, 264, 0));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("SpanningCanvas: gaps and explicit placement", "[gfx][SpanningCanvas]")
+{
+  GDisplayMaschineMK2 top;
+  GDisplayMaschineMK2 bottom;
+  SpanningCanvas canvas;
+  canvas.addCanvas(&top, 0, 0);
+  canvas.addCanvas(&bottom, 0, 80);
+
+  CHECK(canvas.width() == 256);
+  CHECK(canvas.height() == 144);
+
+  canvas.black();
+  canvas.lineVertical(3, 0, 144, {0xFF});
+  CHECK(top.pixel(3, 63).active());
+  CHECK(bottom.pixel(3, 0).active());
+  CHECK_FALSE(canvas.pixel(3, 70).active());
+
+  canvas.white();
+  CHECK(top.pixel(100, 10).active());
+  CHECK(bottom.pixel(200, 60).active());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
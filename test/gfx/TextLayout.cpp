@@ -0,0 +1,171 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+
+#include <cabl/gfx/TextLayout.h>
+
+#include "gfx/displays/GDisplayMaschineMK2.h"
+#include "util/RealTimeGuard.h"
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+// The small font is 3x5 pixels, with a 4 pixels advance
+TextStyle smallFont()
+{
+  TextStyle style;
+  style.font = "small";
+  return style;
+}
+
+bool sameContent(GDisplayMaschineMK2& a_, GDisplayMaschineMK2& b_)
+{
+  return std::equal(a_.buffer(), a_.buffer() + a_.bufferSize(), b_.buffer());
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("TextLayout: measuring and fitting text", "[gfx][TextLayout]")
+{
+  CHECK(TextLayout::measure("", "small") == 0);
+  CHECK(TextLayout::measure("abc", "small") == 11);
+  CHECK(TextLayout::measure("abc", "small", 1) == 13);
+
+  CHECK(TextLayout::ellipsize("Hello", 23, "small") == "Hello");
+  CHECK(TextLayout::ellipsize("Hello world", 23, "small") == "Hel...");
+  CHECK(TextLayout::ellipsize("Hello world", 27, "small") == "Hell...");
+  CHECK(TextLayout::ellipsize("Hello world", 11, "small") == "...");
+  CHECK(TextLayout::ellipsize("Hello world", 2, "small") == "");
+
+  CHECK(TextLayout::wrap("the quick brown fox", 39, "small")
+        == (std::vector<std::string>{"the quick", "brown fox"}));
+  CHECK(TextLayout::wrap("abcdefghijklmnop xyz", 23, "small")
+        == (std::vector<std::string>{"abcdef", "ghijkl", "mnop", "xyz"}));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("TextLayout: lines are wrapped and truncated to the box", "[gfx][TextLayout]")
+{
+  TextStyle style = smallFont();
+  CHECK(TextLayout::layout("first\nsecond line", 39, 11, style)
+        == (std::vector<std::string>{"first", "second..."}));
+
+  style.wrap = true;
+  CHECK(TextLayout::layout("first\nsecond line", 39, 11, style)
+        == (std::vector<std::string>{"first", "second..."}));
+  CHECK(TextLayout::layout("first\nsecond line", 39, 17, style)
+        == (std::vector<std::string>{"first", "second", "line"}));
+
+  style.ellipsis = false;
+  CHECK(TextLayout::layout("the quick brown fox", 39, 5, style)
+        == (std::vector<std::string>{"the quick"}));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("TextLayout: drawing matches Canvas::putText", "[gfx][TextLayout]")
+{
+  GDisplayMaschineMK2 expected;
+  GDisplayMaschineMK2 drawn;
+  expected.black();
+  drawn.black();
+
+  TextLayout layout;
+  expected.putText(13, 7, "Label", {0xff}, "small");
+  layout.draw(drawn, 13, 7, 60, 5, "Label", {0xff}, smallFont());
+  CHECK(sameContent(expected, drawn));
+
+  // Right aligned: "Label" is 19 pixels wide
+  TextStyle style = smallFont();
+  style.alignment = Alignment::Right;
+  expected.putText(100 + 60 - 19, 30, "Label", {0xff}, "small");
+  layout.draw(drawn, 100, 30, 60, 5, "Label", {0xff}, style);
+  CHECK(sameContent(expected, drawn));
+
+  style.alignment = Alignment::Center;
+  expected.putText(10 + 30, 50, "Label", {0xff}, "small");
+  layout.draw(drawn, 10, 50, 79, 5, "Label", {0xff}, style);
+  CHECK(sameContent(expected, drawn));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("TextLayout: laid out text is cached", "[gfx][TextLayout]")
+{
+  GDisplayMaschineMK2 display;
+  TextLayout layout(2);
+
+  layout.draw(display, 0, 0, 64, 8, "one", {0xff});
+  layout.draw(display, 0, 0, 64, 8, "one", {0xff});
+  CHECK(layout.hits() == 1);
+  CHECK(layout.misses() == 1);
+
+  // A different box is a different run
+  layout.draw(display, 10, 10, 64, 8, "one", {0xff});
+  layout.draw(display, 0, 0, 32, 8, "one", {0xff});
+  CHECK(layout.misses() == 2);
+  CHECK(layout.size() == 2);
+
+  // "one" in a 64x8 box has been evicted
+  layout.draw(display, 0, 0, 64, 16, "two", {0xff});
+  layout.draw(display, 0, 0, 64, 8, "one", {0xff});
+  CHECK(layout.misses() == 4);
+  CHECK(layout.size() == 2);
+
+  layout.clear();
+  CHECK(layout.size() == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("TextLayout: cached runs are drawn without allocating", "[gfx][TextLayout]")
+{
+  GDisplayMaschineMK2 display;
+  TextLayout layout;
+  const std::string labels[]{"Cutoff frequency", "Resonance", "Envelope amount"};
+  TextStyle style = smallFont();
+  style.wrap = true;
+
+  for (const auto& label : labels)
+  {
+    layout.draw(display, 0, 0, 40, 16, label, {0xff}, style);
+  }
+
+  RealTimeGuard guard;
+  for (unsigned i = 0; i < 100; i++)
+  {
+    for (const auto& label : labels)
+    {
+      layout.draw(display, 0, 0, 40, 16, label, {0xff}, style);
+    }
+  }
+  CHECK(guard.allocations() == 0);
+  CHECK(layout.misses() == 3);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
@@ -8,6 +8,8 @@
 #include <catch.hpp>
 #include <gfx/displays/TextDisplayGeneric.h>
 
+#include "util/RealTimeGuard.h"
+
 //--------------------------------------------------------------------------------------------------
 
 namespace sl
@@ -64,6 +66,42 @@ TEST_CASE("TextDisplayGeneric: set text", "[gfx][displays][TextDisplayGeneric]")
 
 //--------------------------------------------------------------------------------------------------
 
+TEST_CASE("TextDisplayGeneric: numbers", "[gfx][displays][TextDisplayGeneric]")
+{
+  TextDisplayGeneric<10, 2> display;
+  auto row = [&display](unsigned row_) {
+    const uint8_t* pRow = display.displayData() + row_ * display.width();
+    return std::string(pRow, pRow + display.width());
+  };
+
+  display.putText(1.25, 0, Alignment::Left);
+  CHECK(row(0) == "1.250     ");
+  display.putText(0.05, 0, Alignment::Center);
+  CHECK(row(0) == "  0.050   ");
+  display.putText(-3.5, 0, Alignment::Right);
+  CHECK(row(0) == "    -3.500");
+  display.putText(42, 1, Alignment::Right);
+  CHECK(row(1) == "        42");
+  display.putText(-2147483647, 1, Alignment::Left);
+  CHECK(row(1) == "-214748364");
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("TextDisplayGeneric: formatting doesn't allocate", "[gfx][displays][TextDisplayGeneric]")
+{
+  TextDisplayGeneric<17, 4> display;
+  std::string text("Volume");
+
+  RealTimeGuard guard;
+  display.putText(text, 0, Alignment::Center);
+  display.putText(-12345, 1, Alignment::Right);
+  display.putText(3.14159, 2, Alignment::Left);
+  CHECK(guard.allocations() == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 } // namespace test
 } // namespace cabl
 } // namespace sl
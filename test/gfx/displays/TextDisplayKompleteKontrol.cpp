@@ -163,6 +163,26 @@ TEST_CASE("TextDisplayKompleteKontrol: set value", "[gfx][displays][TextDisplayK
 
 //--------------------------------------------------------------------------------------------------
 
+TEST_CASE(
+  "TextDisplayKompleteKontrol: negative numbers", "[gfx][displays][TextDisplayKompleteKontrol]")
+{
+  TextDisplayKompleteKontrol display;
+  TextDisplayKompleteKontrol reference;
+
+  CHECK_NOTHROW(display.putText(-1.5, 1, Alignment::Left));
+  reference.putText("-1500", 1, Alignment::Left);
+
+  const uint8_t* pRow = display.displayData() + 16;
+  const uint8_t* pReferenceRow = reference.displayData() + 16;
+  CHECK(std::vector<uint8_t>(pRow, pRow + 16)
+        == std::vector<uint8_t>(pReferenceRow, pReferenceRow + 16));
+
+  // The decimal point follows the integral part "-1", centered on the display
+  CHECK((display.displayData()[5] & 0x01) != 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 } // namespace test
 } // namespace cabl
 } // namespace sl
@@ -0,0 +1,103 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <cabl/gfx/CanvasBase.h>
+#include <cabl/util/BufferPool.h>
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("BufferPool: buffers are recycled and cleared", "[util][BufferPool]")
+{
+  auto& pool = BufferPool::instance();
+  pool.clear();
+  const size_t size = 12345;
+  size_t acquiredBytes = pool.acquiredBytes();
+
+  auto buffer = pool.acquire(size);
+  REQUIRE(buffer);
+  CHECK(pool.acquiredBytes() == acquiredBytes + size);
+  buffer[0] = 0xAA;
+  buffer[size - 1] = 0x55;
+  uint8_t* pBuffer = buffer.get();
+
+  pool.release(size, std::move(buffer));
+  CHECK(pool.pooledBytes() == size);
+  CHECK(pool.acquiredBytes() == acquiredBytes);
+
+  auto recycled = pool.acquire(size);
+  CHECK(recycled.get() == pBuffer);
+  CHECK(recycled[0] == 0);
+  CHECK(recycled[size - 1] == 0);
+  CHECK(pool.pooledBytes() == 0);
+
+  pool.release(size, std::move(recycled));
+  pool.clear();
+  CHECK(pool.pooledBytes() == 0);
+  CHECK_FALSE(pool.acquire(0));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("BufferPool: idle buffers are capped", "[util][BufferPool]")
+{
+  auto& pool = BufferPool::instance();
+  pool.clear();
+  size_t maxPooledBytes = pool.maxPooledBytes();
+
+  pool.setMaxPooledBytes(1000);
+  auto b1 = pool.acquire(600);
+  auto b2 = pool.acquire(600);
+  pool.release(600, std::move(b1));
+  pool.release(600, std::move(b2));
+  CHECK(pool.pooledBytes() == 600);
+
+  pool.setMaxPooledBytes(100);
+  CHECK(pool.pooledBytes() == 0);
+
+  pool.setMaxPooledBytes(maxPooledBytes);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("BufferPool: canvas buffers can be released and reacquired", "[util][BufferPool]")
+{
+  auto& pool = BufferPool::instance();
+  pool.clear();
+
+  CanvasBase<7, 3, 777> canvas;
+  CHECK(canvas.residentBytes() == 777);
+  canvas.setPixel(1, 1, {0xFF, 0xFF, 0xFF});
+  CHECK(canvas.pixel(1, 1) == Color(0xFF, 0xFF, 0xFF));
+
+  canvas.releaseBuffer();
+  CHECK(canvas.residentBytes() == 0);
+  CHECK(pool.pooledBytes() == 777);
+
+  CHECK(canvas.pixel(1, 1) == Color(0, 0, 0));
+  CHECK(canvas.residentBytes() == 777);
+  CHECK(pool.pooledBytes() == 0);
+
+  CanvasBase<7, 3, 777> copy(canvas);
+  CHECK(copy.residentBytes() == 777);
+
+  pool.clear();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
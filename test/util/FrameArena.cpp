@@ -0,0 +1,160 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include <cabl/gfx/TextDisplay.h>
+#include <cabl/util/FrameArena.h>
+
+#include "RealTimeGuard.h"
+#include "devices/DeviceLoop.h"
+#include "devices/akai/Push.h"
+#include "devices/ni/KompleteKontrol.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+//! Number of allocations of the steady-state ticks, which redraw all of the text displays
+unsigned steadyStateAllocations(Device& device_, std::vector<tRawData> inputReports_)
+{
+  DeviceLoop loop(device_);
+  SimulatedDeviceHandle::Stats stats;
+  loop.connect(tPtr<DeviceHandleImpl>(new SimulatedDeviceHandle(stats, inputReports_)));
+
+  std::array<uint8_t, 256> text;
+  text.fill('a');
+  auto frame = [&]() {
+    for (size_t i = 0; i < device_.numOfTextDisplays(); i++)
+    {
+      device_.textDisplay(i)->setDisplayData(text.data(), text.size());
+    }
+    loop.tick();
+    text[0]++;
+  };
+
+  // The first frames grow the arena and the reused buffers
+  for (unsigned i = 0; i < 10; i++)
+  {
+    frame();
+  }
+
+  RealTimeGuard guard;
+  for (unsigned i = 0; i < 100; i++)
+  {
+    frame();
+  }
+  unsigned allocations = guard.allocations();
+
+  loop.disconnect();
+  CHECK(stats.writes > 0);
+  return allocations;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("FrameArena: blocks are aligned and don't overlap", "[util][FrameArena]")
+{
+  FrameArena arena(1024);
+
+  uint8_t* pBytes = arena.allocate<uint8_t>(3);
+  uint32_t* pWords = arena.allocate<uint32_t>(4);
+  void* pBlock = arena.allocate(10, 64);
+
+  CHECK(reinterpret_cast<uintptr_t>(pWords) % alignof(uint32_t) == 0);
+  CHECK(reinterpret_cast<uintptr_t>(pBlock) % 64 == 0);
+  CHECK(reinterpret_cast<uint8_t*>(pWords) >= pBytes + 3);
+  CHECK(static_cast<uint8_t*>(pBlock) >= reinterpret_cast<uint8_t*>(pWords + 4));
+  CHECK(arena.used() >= 3 + 4 * sizeof(uint32_t) + 10);
+  CHECK(arena.fallbackAllocations() == 0);
+
+  arena.reset();
+  CHECK(arena.used() == 0);
+  CHECK(arena.allocate<uint8_t>(1) == pBytes);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("FrameArena: grows to the high-water mark after a fallback", "[util][FrameArena]")
+{
+  FrameArena arena(64);
+
+  uint8_t* pSmall = arena.allocate<uint8_t>(32);
+  uint8_t* pLarge = arena.allocate<uint8_t>(200);
+  std::memset(pSmall, 0xAA, 32);
+  std::memset(pLarge, 0x55, 200);
+  CHECK(pSmall[31] == 0xAA);
+  CHECK(arena.fallbackAllocations() == 1);
+
+  arena.reset();
+  CHECK(arena.highWaterMark() >= 232);
+  CHECK(arena.capacity() >= arena.highWaterMark());
+
+  arena.allocate<uint8_t>(32);
+  arena.allocate<uint8_t>(200);
+  CHECK(arena.fallbackAllocations() == 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("FrameArena: steady-state frames don't allocate", "[util][FrameArena]")
+{
+  FrameArena arena(16);
+
+  auto frame = [&arena]() {
+    uint8_t* pMessage = arena.allocate<uint8_t>(249);
+    std::memset(pMessage, 0, 249);
+    std::vector<int, ArenaAllocator<int>> values{ArenaAllocator<int>(arena)};
+    for (int i = 0; i < 100; i++)
+    {
+      values.push_back(i);
+    }
+    arena.reset();
+  };
+
+  // The first frames grow the arena
+  frame();
+  frame();
+
+  RealTimeGuard guard;
+  for (unsigned i = 0; i < 100; i++)
+  {
+    frame();
+  }
+  CHECK(guard.allocations() == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("FrameArena: steady-state device ticks don't allocate", "[util][FrameArena]")
+{
+  Push push;
+  CHECK(steadyStateAllocations(push, {}) == 0);
+
+  KompleteKontrolS25 kompleteKontrol;
+  CHECK(steadyStateAllocations(kompleteKontrol, {{0x01, 0x00, 0x00, 0x00, 0x00, 0x00}}) == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
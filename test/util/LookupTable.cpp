@@ -0,0 +1,88 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "catch.hpp"
+
+#include <cstdint>
+
+#include <cabl/util/LookupTable.h>
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+enum class Button : uint8_t
+{
+  Play = 3,
+  Rec = 9,
+  Shift = 200,
+  Unknown = 255,
+};
+
+enum class Led : uint8_t
+{
+  Play,
+  Rec,
+  Shift,
+  Unknown,
+};
+
+constexpr Mapping<Button, Led> kMapping[]{
+  {Button::Play, Led::Play},
+  {Button::Rec, Led::Rec},
+  {Button::Shift, Led::Shift},
+};
+
+constexpr LookupTable<Button, Led, enumRange<Button>()> kLedByButton(kMapping, Led::Unknown);
+
+using tButtonByLed = LookupTable<Led, Button, static_cast<size_t>(Led::Unknown) + 1>;
+constexpr tButtonByLed kButtonByLed(kMapping, Button::Unknown, tButtonByLed::Reverse{});
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("LookupTable: lookups are resolved at compile time", "[util][LookupTable]")
+{
+  static_assert(kLedByButton[Button::Play] == Led::Play, "Forward lookup");
+  static_assert(kLedByButton[Button::Shift] == Led::Shift, "Forward lookup");
+  static_assert(kLedByButton[static_cast<Button>(4)] == Led::Unknown, "Missing key");
+  static_assert(kButtonByLed[Led::Rec] == Button::Rec, "Reverse lookup");
+  static_assert(kButtonByLed[Led::Unknown] == Button::Unknown, "Missing value");
+  static_assert(kLedByButton.size() == 256, "Dense over the underlying type");
+
+  CHECK(kLedByButton[Button::Rec] == Led::Rec);
+  CHECK(kLedByButton[Button::Unknown] == Led::Unknown);
+  CHECK(kButtonByLed[Led::Shift] == Button::Shift);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("LookupTable: out-of-range keys map to the default value", "[util][LookupTable]")
+{
+  static constexpr Mapping<unsigned, Led> kPads[]{{0, Led::Rec}, {1, Led::Play}};
+  static constexpr LookupTable<unsigned, Led, 2> kPadLeds(kPads, Led::Unknown);
+
+  CHECK(kPadLeds[0] == Led::Rec);
+  CHECK(kPadLeds[1] == Led::Play);
+  CHECK(kPadLeds[2] == Led::Unknown);
+  CHECK(kPadLeds[1000] == Led::Unknown);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,139 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "util/RealTimeGuard.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(__linux)
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+thread_local bool t_active = false;
+thread_local unsigned t_allocations = 0;
+thread_local unsigned t_locks = 0;
+std::atomic<long> s_liveAllocations{0};
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+void* operator new(std::size_t size_)
+{
+  if (t_active)
+  {
+    t_allocations++;
+  }
+  void* pMemory = std::malloc(size_ == 0 ? 1 : size_);
+  if (pMemory == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  s_liveAllocations.fetch_add(1, std::memory_order_relaxed);
+  return pMemory;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void operator delete(void* pMemory_) noexcept
+{
+  if (pMemory_ != nullptr)
+  {
+    s_liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+  }
+  std::free(pMemory_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void operator delete(void* pMemory_, std::size_t) noexcept
+{
+  operator delete(pMemory_);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+#if defined(__linux)
+extern "C" int pthread_mutex_lock(pthread_mutex_t* pMutex_)
+{
+  using tLockFn = int (*)(pthread_mutex_t*);
+  static tLockFn s_lock = reinterpret_cast<tLockFn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+  if (t_active)
+  {
+    t_locks++;
+  }
+  return s_lock(pMutex_);
+}
+#endif
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+RealTimeGuard::RealTimeGuard()
+  : m_allocations(t_allocations), m_locks(t_locks), m_wasActive(t_active)
+{
+  t_active = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+RealTimeGuard::~RealTimeGuard()
+{
+  t_active = m_wasActive;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+unsigned RealTimeGuard::allocations() const
+{
+  return t_allocations - m_allocations;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+unsigned RealTimeGuard::locks() const
+{
+  return t_locks - m_locks;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool RealTimeGuard::detectsLocks()
+{
+#if defined(__linux)
+  return true;
+#else
+  return false;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------------
+
+long RealTimeGuard::liveAllocations()
+{
+  return s_liveAllocations.load(std::memory_order_relaxed);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
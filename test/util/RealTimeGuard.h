@@ -0,0 +1,59 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class RealTimeGuard
+  \brief Counts the heap allocations and mutex locks performed by the current thread
+
+  Allocations are detected by the replaced global operator new, locks by interposing
+  pthread_mutex_lock, which is only available on Linux. The counters must be read from the thread
+  that created the guard.
+*/
+
+class RealTimeGuard
+{
+public:
+  RealTimeGuard();
+  ~RealTimeGuard();
+
+  RealTimeGuard(const RealTimeGuard&) = delete;
+  RealTimeGuard& operator=(const RealTimeGuard&) = delete;
+
+  //! Number of allocations since the guard has been created
+  unsigned allocations() const;
+
+  //! Number of mutex locks since the guard has been created
+  unsigned locks() const;
+
+  //! \return TRUE if locks can be detected on this platform
+  static bool detectsLocks();
+
+  //! Number of heap blocks allocated and not released yet, by all threads
+  static long liveAllocations();
+
+private:
+  unsigned m_allocations;
+  unsigned m_locks;
+  bool m_wasActive;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
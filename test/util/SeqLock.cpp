@@ -0,0 +1,120 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include <catch.hpp>
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <cabl/util/SeqLock.h>
+
+#include "util/RealTimeGuard.h"
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+struct Snapshot
+{
+  std::array<uint32_t, 64> values;
+  uint8_t tail; // Not a multiple of the word size
+};
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("SeqLock: read, write and modify", "[util][SeqLock]")
+{
+  SeqLock<Snapshot> snapshot;
+  CHECK(snapshot.read().values[10] == 0);
+  CHECK(snapshot.version() == 0);
+
+  Snapshot value{};
+  value.values.fill(7);
+  value.tail = 0x42;
+  snapshot.write(value);
+  snapshot.modify([](Snapshot& value_) { value_.values[3] = 3; });
+
+  Snapshot copy = snapshot.read();
+  CHECK(copy.values[2] == 7);
+  CHECK(copy.values[3] == 3);
+  CHECK(copy.tail == 0x42);
+  CHECK(snapshot.version() == 2);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("SeqLock: readers always get a consistent value", "[util][SeqLock]")
+{
+  constexpr unsigned kNumWrites = 200000;
+  SeqLock<Snapshot> snapshot;
+  std::atomic<bool> writersDone{false};
+
+  // Two writers, as input may come from the I/O thread and from a MIDI thread
+  std::vector<std::thread> writers;
+  for (uint32_t w = 0; w < 2; w++)
+  {
+    writers.emplace_back([&snapshot, w]() {
+      for (uint32_t i = 1; i <= kNumWrites; i++)
+      {
+        snapshot.modify([i, w](Snapshot& value_) {
+          value_.values.fill(i * 2 + w);
+          value_.tail = static_cast<uint8_t>(i * 2 + w);
+        });
+      }
+    });
+  }
+
+  unsigned allocations = 0;
+  unsigned locks = 0;
+  unsigned nReads = 0;
+  bool consistent = true;
+  {
+    RealTimeGuard guard;
+    while (!writersDone)
+    {
+      Snapshot value = snapshot.read();
+      for (uint32_t v : value.values)
+      {
+        consistent = consistent && v == value.values[0];
+      }
+      consistent = consistent && value.tail == static_cast<uint8_t>(value.values[0]);
+      nReads++;
+      writersDone = snapshot.version() == 2 * kNumWrites;
+    }
+    allocations = guard.allocations();
+    locks = guard.locks();
+  }
+  for (auto& writer : writers)
+  {
+    writer.join();
+  }
+
+  CHECK(consistent);
+  CHECK(nReads > 0);
+  CHECK(allocations == 0);
+  CHECK(locks == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,187 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include "util/SoakHarness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux)
+#include <unistd.h>
+#endif
+
+#include "util/RealTimeGuard.h"
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+SoakHarness::SoakHarness(std::chrono::milliseconds duration_, unsigned nSamples_)
+  : m_nSamples(std::max(2u, nSamples_))
+{
+  const char* pSeconds = std::getenv("CABL_SOAK_SECONDS");
+  if (pSeconds != nullptr && std::atof(pSeconds) > 0)
+  {
+    duration_ = std::chrono::milliseconds(static_cast<long long>(std::atof(pSeconds) * 1000));
+  }
+  m_interval = duration_ / m_nSamples;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+bool SoakHarness::running()
+{
+  tClock::time_point now = tClock::now();
+  if (m_start == tClock::time_point())
+  {
+    m_start = now;
+    m_nextSample = now + m_interval;
+    return true;
+  }
+
+  m_iterations++;
+  if (now < m_nextSample)
+  {
+    return true;
+  }
+  sample(now);
+  while (m_nextSample <= now)
+  {
+    m_nextSample += m_interval;
+  }
+  return m_samples.size() < m_nSamples;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+void SoakHarness::sample(tClock::time_point now_)
+{
+  double p99Latency = 0.0;
+  if (!m_latencies.empty())
+  {
+    size_t index = static_cast<size_t>(std::ceil(m_latencies.size() * 0.99)) - 1;
+    std::nth_element(m_latencies.begin(), m_latencies.begin() + index, m_latencies.end());
+    p99Latency = m_latencies[index];
+  }
+
+  m_samples.push_back({std::chrono::duration<double>(now_ - m_start).count(),
+    residentBytes(),
+    RealTimeGuard::liveAllocations(),
+    threads(),
+    p99Latency,
+    m_iterations});
+  m_latencies.clear();
+  m_iterations = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::string SoakHarness::drift(const Limits& limits_) const
+{
+  if (m_samples.empty())
+  {
+    return {};
+  }
+
+  const Sample& baseline = m_samples.front();
+  for (size_t i = 1; i < m_samples.size(); i++)
+  {
+    const Sample& sample = m_samples[i];
+    std::ostringstream s;
+    if (baseline.residentBytes > 0
+        && sample.residentBytes > baseline.residentBytes + limits_.residentBytes)
+    {
+      s << "resident memory grew from " << baseline.residentBytes << " to "
+        << sample.residentBytes << " bytes";
+    }
+    else if (sample.liveAllocations > baseline.liveAllocations + limits_.liveAllocations)
+    {
+      s << "live allocations grew from " << baseline.liveAllocations << " to "
+        << sample.liveAllocations;
+    }
+    else if (baseline.threads > 0 && sample.threads > baseline.threads + limits_.threads)
+    {
+      s << "threads grew from " << baseline.threads << " to " << sample.threads;
+    }
+    else if (sample.p99Latency
+             > baseline.p99Latency * limits_.latencyFactor + limits_.latencyMargin)
+    {
+      s << "p99 latency grew from " << baseline.p99Latency << " to " << sample.p99Latency
+        << " us";
+    }
+    else
+    {
+      continue;
+    }
+    s << " after " << sample.elapsed << " s\n" << report();
+    return s.str();
+  }
+  return {};
+}
+
+//--------------------------------------------------------------------------------------------------
+
+std::string SoakHarness::report() const
+{
+  std::ostringstream s;
+  s << "elapsed (s) | resident (bytes) | allocations | threads | p99 (us) | iterations\n";
+  for (const auto& sample : m_samples)
+  {
+    s << sample.elapsed << " | " << sample.residentBytes << " | " << sample.liveAllocations
+      << " | " << sample.threads << " | " << sample.p99Latency << " | " << sample.iterations
+      << "\n";
+  }
+  return s.str();
+}
+
+//--------------------------------------------------------------------------------------------------
+
+size_t SoakHarness::residentBytes()
+{
+#if defined(__linux)
+  std::ifstream statm("/proc/self/statm");
+  size_t totalPages = 0;
+  size_t residentPages = 0;
+  if (statm >> totalPages >> residentPages)
+  {
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+unsigned SoakHarness::threads()
+{
+#if defined(__linux)
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line))
+  {
+    if (line.compare(0, 8, "Threads:") == 0)
+    {
+      return static_cast<unsigned>(std::strtoul(line.c_str() + 8, nullptr, 10));
+    }
+  }
+#endif
+  return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,122 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+/**
+  \class SoakHarness
+  \brief Runs a workload for a given duration and checks that its resource usage doesn't drift
+
+  The workload loops while running() returns true, calling it between two iterations (e.g. after
+  a full connect, render, disconnect cycle) and timing the operations to watch with measure().
+  The duration is split in equal intervals: at the end of each one, running() samples the resident
+  memory, the live heap allocations, the number of threads and the 99th percentile of the measured
+  latencies. The first sample, taken once the workload has warmed up, is the baseline the others
+  are compared to.
+  The duration can be overridden with the CABL_SOAK_SECONDS environment variable, to soak for
+  hours rather than for the fraction of a second that fits a unit test run.
+*/
+
+class SoakHarness
+{
+public:
+  using tClock = std::chrono::steady_clock;
+
+  struct Sample
+  {
+    double elapsed;         //!< Seconds since the start
+    size_t residentBytes;   //!< Resident set size, 0 if unknown on this platform
+    long liveAllocations;   //!< Heap blocks allocated and not released yet
+    unsigned threads;       //!< Threads in the process, 0 if unknown on this platform
+    double p99Latency;      //!< 99th percentile of the latencies measured in the interval, in us
+    size_t iterations;      //!< Iterations completed in the interval
+  };
+
+  //! Maximum drift from the baseline
+  struct Limits
+  {
+    size_t residentBytes;
+    long liveAllocations;
+    unsigned threads;
+    double latencyFactor;   //!< The p99 latency may grow up to latencyFactor times the baseline...
+    double latencyMargin;   //!< ...plus this margin (in us), which absorbs the scheduling noise
+  };
+
+  static Limits defaultLimits()
+  {
+    return {8 * 1024 * 1024, 64, 0, 4.0, 2000.0};
+  }
+
+  //! Constructor
+  /*!
+     \param duration_  The duration of the run, unless overridden by CABL_SOAK_SECONDS
+     \param nSamples_  Number of intervals the duration is split in
+  */
+  SoakHarness(std::chrono::milliseconds duration_, unsigned nSamples_ = 8);
+
+  //! \return FALSE once the duration has elapsed, sampling the metrics at the interval boundaries
+  bool running();
+
+  //! Run and time an operation
+  template <class TOperation>
+  void measure(TOperation operation_)
+  {
+    tClock::time_point start = tClock::now();
+    operation_();
+    m_latencies.push_back(
+      std::chrono::duration<double, std::micro>(tClock::now() - start).count());
+  }
+
+  const std::vector<Sample>& samples() const
+  {
+    return m_samples;
+  }
+
+  //! Compare the samples with the baseline
+  /*!
+     \param limits_  The maximum drift allowed for each metric
+     \return         A description of the first sample exceeding a limit, empty if none does
+  */
+  std::string drift(const Limits& limits_ = defaultLimits()) const;
+
+  //! Describe the samples as a table
+  std::string report() const;
+
+  static size_t residentBytes();
+  static unsigned threads();
+
+private:
+  void sample(tClock::time_point now_);
+
+  tClock::duration m_interval;
+  unsigned m_nSamples;
+  tClock::time_point m_start;
+  tClock::time_point m_nextSample;
+  size_t m_iterations{0};
+  std::vector<double> m_latencies;
+  std::vector<Sample> m_samples;
+};
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl
@@ -0,0 +1,149 @@
+/*
+        ##########    Copyright (C) 2015 Vincenzo Pacella
+        ##      ##    Distributed under MIT license, see file LICENSE
+        ##      ##    or <http://opensource.org/licenses/MIT>
+        ##      ##
+##########      ############################################################# shaduzlabs.com #####*/
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include <cabl/util/Color.h>
+#include <cabl/util/SpscQueue.h>
+
+#include "util/RealTimeGuard.h"
+
+//--------------------------------------------------------------------------------------------------
+
+namespace sl
+{
+namespace cabl
+{
+namespace test
+{
+
+//--------------------------------------------------------------------------------------------------
+
+namespace
+{
+
+struct LedUpdate
+{
+  unsigned index;
+  Color color;
+};
+
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("SpscQueue: push and pop", "[util][SpscQueue]")
+{
+  SpscQueue<unsigned, 4> queue;
+  unsigned value = 0;
+
+  CHECK(queue.empty());
+  CHECK_FALSE(queue.pop(value));
+
+  for (unsigned i = 0; i < queue.capacity(); i++)
+  {
+    CHECK(queue.push(i));
+  }
+  CHECK(queue.size() == 4);
+  CHECK_FALSE(queue.push(4));
+
+  CHECK(queue.pop(value));
+  CHECK(value == 0);
+  CHECK(queue.push(4));
+
+  for (unsigned i = 1; i <= 4; i++)
+  {
+    CHECK(queue.pop(value));
+    CHECK(value == i);
+  }
+  CHECK(queue.empty());
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("SpscQueue: the detector catches allocations and locks", "[util][SpscQueue]")
+{
+  unsigned allocations = 0;
+  unsigned locks = 0;
+
+  std::thread producer([&]() {
+    RealTimeGuard guard;
+    std::mutex mtx;
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      int* volatile pValue = new int(42); // volatile, or the allocation may be elided
+      delete pValue;
+    }
+    allocations = guard.allocations();
+    locks = guard.locks();
+  });
+  producer.join();
+
+  CHECK(allocations > 0);
+  CHECK((locks > 0 || !RealTimeGuard::detectsLocks()));
+}
+
+//--------------------------------------------------------------------------------------------------
+
+TEST_CASE("SpscQueue: producing is wait-free", "[util][SpscQueue]")
+{
+  constexpr unsigned kNumUpdates = 100000;
+  SpscQueue<LedUpdate, 256> queue;
+
+  unsigned allocations = 0;
+  unsigned locks = 0;
+  std::atomic<bool> producerDone{false};
+  unsigned nDropped = 0;
+
+  std::thread producer([&]() {
+    {
+      RealTimeGuard guard;
+      for (unsigned i = 0; i < kNumUpdates; i++)
+      {
+        if (!queue.push({i, Color(i & 0xFF, 0, 0)}))
+        {
+          nDropped++;
+        }
+      }
+      allocations = guard.allocations();
+      locks = guard.locks();
+    }
+    producerDone = true;
+  });
+
+  unsigned nReceived = 0;
+  unsigned lastIndex = 0;
+  bool ordered = true;
+  LedUpdate update;
+  while (!producerDone || !queue.empty())
+  {
+    while (queue.pop(update))
+    {
+      ordered = ordered && (nReceived == 0 || update.index > lastIndex)
+                && update.color.red() == (update.index & 0xFF);
+      lastIndex = update.index;
+      nReceived++;
+    }
+    std::this_thread::yield();
+  }
+  producer.join();
+
+  CHECK(allocations == 0);
+  CHECK(locks == 0);
+  CHECK(ordered);
+  CHECK(nReceived + nDropped == kNumUpdates);
+}
+
+//--------------------------------------------------------------------------------------------------
+
+} // namespace test
+} // namespace cabl
+} // namespace sl